@@ -28,8 +28,9 @@ function fibonacci(n) {
         return n;
     }
 
-    var p1 = zone.execute("", "fibonacci", [n - 1]);
-    var p2 = zone.execute("", "fibonacci", [n - 2]);
+    // Sub-tasks run right on this worker when all workers are busy, instead of waiting in queue.
+    var p1 = zone.execute("", "fibonacci", [n - 1], { forkJoin: true });
+    var p2 = zone.execute("", "fibonacci", [n - 2], { forkJoin: true });
 
     // Returning promise to avoid blocking each worker.
     return Promise.all([p1, p2]).then(([result1, result2]) => {
@@ -72,6 +72,105 @@ EXTERN_C NAPA_API void napa_zone_execute(
     napa_zone_execute_callback callback,
     void* context);
 
+/// <summary>
+///     Sets the command that starts a helper process of zones created with '--processes'.
+///     The helper is expected to call napa_zone_serve_process with the channel name appended to the command.
+/// </summary>
+/// <param name="command"> Executable followed by its arguments. </param>
+/// <param name="command_count"> Number of strings in the command. </param>
+EXTERN_C NAPA_API void napa_zone_set_process_host(
+    const napa_string_ref* command,
+    size_t command_count);
+
+/// <summary> Serves a zone in a helper process, until the zone is released or its process exits. </summary>
+/// <param name="channel"> The channel name that the helper process was started with. </param>
+EXTERN_C NAPA_API napa_result_code napa_zone_serve_process(napa_string_ref channel);
+
+/// <summary> Serves a zone to remote zones, which are created with '--remote' set to the address. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="address"> The Unix domain socket path to listen on. </param>
+/// <remarks> The zone is kept alive until napa_zone_unlisten is called with the address. </remarks>
+EXTERN_C NAPA_API napa_result_code napa_zone_listen(napa_zone_handle handle, napa_string_ref address);
+
+/// <summary> Stops serving a zone on an address, closing connections of remote zones. </summary>
+/// <param name="address"> The address passed to napa_zone_listen. </param>
+EXTERN_C NAPA_API napa_result_code napa_zone_unlisten(napa_string_ref address);
+
+/// <summary> Retrieves counters of the zone's cache of results, see napa_zone_call_options.cache_ttl_ms. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="statistics"> Receives the counters, all 0 for zones that forward calls to other processes. </param>
+EXTERN_C NAPA_API napa_result_code napa_zone_get_cache_statistics(
+    napa_zone_handle handle,
+    napa_zone_cache_statistics* statistics);
+
+/// <summary> Retrieves the number of zone workers waiting for tasks, which may change right after it's read. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="count"> Receives the number of idle workers. </param>
+/// <returns> NAPA_RESULT_UNDEFINED for the node zone and zones whose workers are not in this process. </returns>
+EXTERN_C NAPA_API napa_result_code napa_zone_get_idle_worker_count(napa_zone_handle handle, uint32_t* count);
+
+/// <summary> Retrieves queue depth and wait time counters of the zone's flows, see napa_zone_call_options.flow_id. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="statistics"> Receives counters of up to 'capacity' flows, ordered by flow id. </param>
+/// <param name="capacity"> The number of elements 'statistics' holds. </param>
+/// <param name="count"> Receives the number of flows, which may be larger than 'capacity'. </param>
+/// <returns> NAPA_RESULT_UNDEFINED for the node zone and zones whose workers are not in this process. </returns>
+EXTERN_C NAPA_API napa_result_code napa_zone_get_flow_statistics(
+    napa_zone_handle handle,
+    napa_zone_flow_statistics* statistics,
+    size_t capacity,
+    size_t* count);
+
+/// <summary> Creates a completion queue, which collects results of napa_zone_execute_cq to be reaped in batches. </summary>
+/// <remarks> The queue must be released by napa_completion_queue_release. </remarks>
+EXTERN_C NAPA_API napa_completion_queue_handle napa_completion_queue_create();
+
+/// <summary>
+///     Releases a completion queue. Executions still in flight hold the queue until they complete, and their
+///     completions are discarded, as are completions not yet reaped.
+/// </summary>
+/// <param name="cq"> The completion queue handle. </param>
+/// <remarks> Completions already reaped stay valid until released by napa_completion_release. </remarks>
+EXTERN_C NAPA_API napa_result_code napa_completion_queue_release(napa_completion_queue_handle cq);
+
+/// <summary> Executes a pre-loaded function asynchronously in a single zone worker, posting the result to a completion queue. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="spec"> The function spec to call. </param>
+/// <param name="cq"> The completion queue to post the result to. </param>
+/// <param name="tag"> An opaque pointer that is returned with the completion. </param>
+EXTERN_C NAPA_API void napa_zone_execute_cq(
+    napa_zone_handle handle,
+    napa_zone_function_spec spec,
+    napa_completion_queue_handle cq,
+    void* tag);
+
+/// <summary> Reaps completions without blocking. </summary>
+/// <param name="cq"> The completion queue handle. </param>
+/// <param name="completions"> An array to receive completions, in order of completion. </param>
+/// <param name="max_completions"> Size of the array. </param>
+/// <returns> Number of completions reaped. Each of them must be released by napa_completion_release. </returns>
+/// <remarks> The ownership of each result's transport_context passes to the caller, same as napa_zone_execute. </remarks>
+EXTERN_C NAPA_API size_t napa_completion_queue_poll(
+    napa_completion_queue_handle cq,
+    napa_completion* completions,
+    size_t max_completions);
+
+/// <summary> Reaps completions, blocking until at least one completes or timeout elapses. </summary>
+/// <param name="cq"> The completion queue handle. </param>
+/// <param name="completions"> An array to receive completions, in order of completion. </param>
+/// <param name="max_completions"> Size of the array. </param>
+/// <param name="timeout"> Timeout in milliseconds - Use 0 for inifinite. </param>
+/// <returns> Number of completions reaped, 0 on timeout. Each of them must be released by napa_completion_release. </returns>
+EXTERN_C NAPA_API size_t napa_completion_queue_wait(
+    napa_completion_queue_handle cq,
+    napa_completion* completions,
+    size_t max_completions,
+    uint32_t timeout);
+
+/// <summary> Releases the result buffer of a completion. </summary>
+/// <param name="completion"> The completion from napa_completion_queue_poll or napa_completion_queue_wait. </param>
+EXTERN_C NAPA_API void napa_completion_release(napa_completion* completion);
+
 /// <summary>
 ///     Global napa initialization. Invokes initialization steps that are cross zones.
 ///     The settings passed represent the defaults for all the zones
@@ -93,6 +192,34 @@ EXTERN_C NAPA_API napa_result_code napa_initialize_from_console(
 /// <summary> Invokes napa shutdown steps. All non released zones will be destroyed. </summary>
 EXTERN_C NAPA_API napa_result_code napa_shutdown();
 
+/// <summary>
+///     Drops cached module resolution results, including modules that could not be found, so the next require
+///     looks at the file system again. Call it after module files are created, changed or removed by other means
+///     than Napa's fs, such as Node's fs, another process or npm install.
+/// </summary>
+/// <param name="path">
+///     Path of a file or directory which changed, relative paths are taken as relative to the current directory.
+///     An empty path drops all cached results.
+/// </param>
+EXTERN_C NAPA_API napa_result_code napa_module_invalidate_cache(napa_string_ref path);
+
+/// <summary> Writes a module bundle that zones can load with the 'bundle' setting. </summary>
+/// <param name="path"> Path of the bundle file to write. </param>
+/// <param name="names"> Module names or paths, as passed to require(). </param>
+/// <param name="from_paths">
+///     Context directories of the require() calls, one per name. Relative paths are taken as relative to the current directory.
+/// </param>
+/// <param name="count"> Number of require() calls to bundle. </param>
+/// <remarks>
+///     Each call is resolved the way workers resolve it, and the resolved module's source is stored in the bundle.
+///     It fails with NAPA_RESULT_MODULE_BUNDLE_ERROR if a call can't be resolved or the bundle can't be written.
+/// </remarks>
+EXTERN_C NAPA_API napa_result_code napa_module_write_bundle(
+    napa_string_ref path,
+    const napa_string_ref* names,
+    const napa_string_ref* from_paths,
+    size_t count);
+
 /// <summary> Convert the napa result code to its string representation. </summary>
 /// <param name="code"> The result code. </param>
 EXTERN_C NAPA_API const char* napa_result_code_to_string(napa_result_code code);
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "napa/zone.h"
+
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace napa {
+
+    /// <summary> A function to run in a zone as one stage of a pipeline. </summary>
+    struct PipelineStage {
+
+        /// <summary> The zone to run the function in. </summary>
+        std::shared_ptr<Zone> zone;
+
+        /// <summary> The module that exports the function. </summary>
+        std::string module;
+
+        /// <summary> The function, which takes the return value of the previous stage as its only argument. </summary>
+        std::string function;
+
+        /// <summary> Execute options, all zero by default: no timeout, AUTO transport and no other options. </summary>
+        CallOptions options = {};
+    };
+
+    /// <summary>
+    ///     Runs functions in a chain of zones, each taking the return value of the previous one.
+    ///     The marshalled return value and transport context of a stage are passed to the next stage natively from
+    ///     the worker that completes it, so intermediate values are never unmarshalled by the caller.
+    /// </summary>
+    class Pipeline {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="stages"> Stages in order of execution. It throws std::invalid_argument if empty. </param>
+        explicit Pipeline(std::vector<PipelineStage> stages)
+            : _stages(std::make_shared<const std::vector<PipelineStage>>(std::move(stages))) {
+            if (_stages->empty()) {
+                throw std::invalid_argument("A pipeline must have at least one stage");
+            }
+            for (const auto& stage : *_stages) {
+                if (stage.zone == nullptr) {
+                    throw std::invalid_argument("Zone of a pipeline stage must not be null");
+                }
+            }
+        }
+
+        /// <summary> Number of stages. </summary>
+        size_t GetStageCount() const {
+            return _stages->size();
+        }
+
+        /// <summary> Runs the pipeline asynchronously. </summary>
+        /// <param name="arguments"> Marshalled arguments of the first stage. </param>
+        /// <param name="transportContext"> Transport context of the arguments, which may be null. </param>
+        /// <param name="callback">
+        ///     A callback that is triggered with the result of the last stage, or the first failure.
+        ///     It is called from a worker of the zone where that stage ran.
+        /// </param>
+        void Execute(
+            std::vector<std::string> arguments,
+            std::unique_ptr<transport::TransportContext> transportContext,
+            ExecuteCallback callback) const {
+            ExecuteStage(_stages, 0, std::move(arguments), std::move(transportContext), std::move(callback));
+        }
+
+        /// <summary> Runs the pipeline synchronously. </summary>
+        /// <param name="arguments"> Marshalled arguments of the first stage. </param>
+        /// <param name="transportContext"> Transport context of the arguments, which may be null. </param>
+        Result ExecuteSync(
+            std::vector<std::string> arguments,
+            std::unique_ptr<transport::TransportContext> transportContext) const {
+            std::promise<Result> prom;
+            auto fut = prom.get_future();
+
+            Execute(std::move(arguments), std::move(transportContext), [&prom](Result result) {
+                prom.set_value(std::move(result));
+            });
+
+            return fut.get();
+        }
+
+    private:
+
+        using Stages = std::shared_ptr<const std::vector<PipelineStage>>;
+
+        static void ExecuteStage(
+            Stages stages,
+            size_t index,
+            std::vector<std::string> arguments,
+            std::unique_ptr<transport::TransportContext> transportContext,
+            ExecuteCallback callback) {
+            const auto& stage = (*stages)[index];
+
+            FunctionSpec spec;
+            spec.module = STD_STRING_TO_NAPA_STRING_REF(stage.module);
+            spec.function = STD_STRING_TO_NAPA_STRING_REF(stage.function);
+            spec.arguments.reserve(arguments.size());
+            for (const auto& argument : arguments) {
+                spec.arguments.emplace_back(STD_STRING_TO_NAPA_STRING_REF(argument));
+            }
+            spec.options = stage.options;
+            spec.transportContext = transportContext != nullptr
+                ? std::move(transportContext)
+                : std::make_unique<transport::TransportContext>();
+
+            stage.zone->Execute(spec, [stages, index, callback = std::move(callback)](Result result) mutable {
+                if (result.code != NAPA_RESULT_SUCCESS) {
+                    result.errorMessage = "Pipeline stage " + std::to_string(index)
+                        + " in zone '" + (*stages)[index].zone->GetId() + "' failed: " + result.errorMessage;
+                    callback(std::move(result));
+                    return;
+                }
+
+                if (index + 1 == stages->size()) {
+                    callback(std::move(result));
+                    return;
+                }
+
+                // Forward the marshalled return value with the transport context holding objects it refers to.
+                std::vector<std::string> nextArguments;
+                nextArguments.emplace_back(std::move(result.returnValue));
+                ExecuteStage(
+                    std::move(stages),
+                    index + 1,
+                    std::move(nextArguments),
+                    std::move(result.transportContext),
+                    std::move(callback));
+            });
+        }
+
+        /// <summary> Stages, shared with pending executions. </summary>
+        Stages _stages;
+    };
+}
@@ -43,7 +43,10 @@ namespace transport {
         /// <param name="pointer"> Shared pointer to transfer ownership to another isolate. </param>
         template <typename T>
         void SaveShared(std::shared_ptr<T> pointer) {
-            _sharedDepot[reinterpret_cast<uintptr_t>(pointer.get())] = std::move(pointer);
+            if (_sharedDepot == nullptr) {
+                _sharedDepot.reset(new SharedDepot());
+            }
+            (*_sharedDepot)[reinterpret_cast<uintptr_t>(pointer.get())] = std::move(pointer);
         }
 
         /// <summary> It loads a previously saved shared pointer. </summary>
@@ -51,22 +54,36 @@ namespace transport {
         /// <returns> shared_ptr for requested handle, or empty shared_ptr if not found. </returns>
         template <typename T>
         std::shared_ptr<T> LoadShared(uintptr_t handle) {
-            auto it = _sharedDepot.find(handle);
-            if (it != _sharedDepot.end()) {
+            if (_sharedDepot == nullptr) {
+                return std::shared_ptr<T>();
+            }
+            auto it = _sharedDepot->find(handle);
+            if (it != _sharedDepot->end()) {
                 return std::static_pointer_cast<T>(it->second);
             }
             return std::shared_ptr<T>();
         }
 
+        /// <summary> Creates a context that extends ownership of the same shared pointers, to hand one result to many receivers. </summary>
+        std::unique_ptr<TransportContext> Clone() const {
+            auto clone = std::make_unique<TransportContext>();
+            if (_sharedDepot != nullptr) {
+                clone->_sharedDepot.reset(new SharedDepot(*_sharedDepot));
+            }
+            return clone;
+        }
+
         /// <summary> Get count of saved shared_ptr. </summary> 
-        uint32_t GetSharedCount() {
-            return static_cast<uint32_t>(_sharedDepot.size());
+        uint32_t GetSharedCount() const {
+            return _sharedDepot != nullptr ? static_cast<uint32_t>(_sharedDepot->size()) : 0;
         }
 
     private:
 
-        /// <summary> shared_ptr depot. </summary>
-        napa::stl::UnorderedMap<uintptr_t, std::shared_ptr<void>> _sharedDepot;
+        using SharedDepot = napa::stl::UnorderedMap<uintptr_t, std::shared_ptr<void>>;
+
+        /// <summary> shared_ptr depot, created on first save as most calls don't transport native objects. </summary>
+        std::unique_ptr<SharedDepot> _sharedDepot;
     };
 }
 }
@@ -77,6 +77,36 @@ typedef struct {
 
     /// <summary> Arguments transport option. Default is AUTO. </summary>
     napa_transport_option transport;
+
+    /// <summary>
+    ///     Milliseconds after which a call still pending is duplicated on another worker, taking the first result.
+    ///     Use 0 to not hedge. Only for idempotent functions.
+    /// </summary>
+    uint32_t hedge_after_ms;
+
+    /// <summary>
+    ///     Milliseconds to cache a successful result for, keyed by module, function and arguments.
+    ///     Use 0 to not cache. Only for deterministic functions.
+    /// </summary>
+    uint32_t cache_ttl_ms;
+
+    /// <summary>
+    ///     Non-zero to coalesce the call with an identical call in flight, whose single execution completes both.
+    ///     Use 0 to always execute. Only for deterministic functions.
+    /// </summary>
+    uint32_t single_flight;
+
+    /// <summary>
+    ///     The flow, such as a tenant, the call is queued in while all workers are busy. Flows share the zone's
+    ///     workers by their weights. Default flow is 0.
+    /// </summary>
+    uint32_t flow_id;
+
+    /// <summary> Share of the zone's workers the flow gets relative to other busy flows. 0 is taken as 1. </summary>
+    uint32_t flow_weight;
+
+    /// <summary> Non-zero to measure the resources the call uses, returned with its result. Use 0 to not measure. </summary>
+    uint32_t accounting;
 } napa_zone_call_options;
 
 #ifdef __cplusplus
@@ -129,8 +159,8 @@ namespace napa {
         /// <summary> The function arguments. </summary>
         std::vector<StringRef> arguments;
 
-        /// <summary> Execute options. </summary>
-        CallOptions options = { 0, AUTO };
+        /// <summary> Execute options, all zero by default: no timeout, AUTO transport and no other options. </summary>
+        CallOptions options = {};
 
         /// <summary> Used for transporting shared_ptr and unique_ptr across zones/workers. </summary>
         mutable std::unique_ptr<napa::transport::TransportContext> transportContext;
@@ -139,6 +169,36 @@ namespace napa {
 
 #endif // __cplusplus
 
+/// <summary> Resources used by a call, see napa_zone_call_options.accounting. </summary>
+typedef struct {
+
+    /// <summary> Microseconds the call waited before a worker started it. </summary>
+    uint64_t queue_wait_us;
+
+    /// <summary> Microseconds from the start of the call until its result, including asynchronous work. </summary>
+    uint64_t execution_us;
+
+    /// <summary> Microseconds of CPU time of the worker thread while it ran the call synchronously. </summary>
+    uint64_t cpu_us;
+
+    /// <summary> Growth of the worker's JavaScript heap while it ran the call synchronously. </summary>
+    uint64_t heap_bytes;
+
+    /// <summary> Bytes of the marshalled arguments. </summary>
+    uint64_t argument_bytes;
+
+    /// <summary> Bytes of the marshalled result. </summary>
+    uint64_t result_bytes;
+} napa_zone_call_accounting;
+
+#ifdef __cplusplus
+
+namespace napa {
+    typedef napa_zone_call_accounting CallAccounting;
+}
+
+#endif // __cplusplus
+
 /// <summary> Represents a result from executing in a zone. </summary>
 typedef struct {
 
@@ -153,6 +213,9 @@ typedef struct {
 
     /// <summary> A context used for transporting handles across zones/workers. </summary>
     void* transport_context;
+
+    /// <summary> Resources used by the call if it was measured, otherwise null. It's valid as long as the strings. </summary>
+    const napa_zone_call_accounting* accounting;
 } napa_zone_result;
 
 #ifdef __cplusplus
@@ -172,6 +235,9 @@ namespace napa {
 
         /// <summary> Used for transporting shared_ptr and unique_ptr across zones/workers. </summary>
         mutable std::unique_ptr<napa::transport::TransportContext> transportContext;
+
+        /// <summary> Resources used by the call if it was measured, otherwise null. </summary>
+        std::shared_ptr<const CallAccounting> accounting;
     };
 }
 
@@ -194,9 +260,81 @@ namespace napa {
 
 #endif // __cplusplus
 
+/// <summary> Counters of a zone's result cache. </summary>
+typedef struct {
+
+    /// <summary> Calls answered from the cache. </summary>
+    uint64_t hits;
+
+    /// <summary> Cacheable calls that were not in the cache. </summary>
+    uint64_t misses;
+
+    /// <summary> Results removed to stay within the cache size. </summary>
+    uint64_t evictions;
+
+    /// <summary> Results removed after their time to live. </summary>
+    uint64_t expirations;
+
+    /// <summary> Bytes of keys and results in the cache. </summary>
+    uint64_t bytes;
+} napa_zone_cache_statistics;
+
+#ifdef __cplusplus
+
+namespace napa {
+    typedef napa_zone_cache_statistics CacheStatistics;
+}
+
+#endif // __cplusplus
+
+/// <summary> Counters of a flow of calls in a zone's scheduler, see napa_zone_call_options.flow_id. </summary>
+typedef struct {
+
+    /// <summary> The flow id. </summary>
+    uint32_t flow_id;
+
+    /// <summary> The weight of the latest call of the flow. </summary>
+    uint32_t weight;
+
+    /// <summary> Tasks of the flow waiting for a worker. </summary>
+    uint64_t queued;
+
+    /// <summary> Tasks of the flow handed to workers. </summary>
+    uint64_t dispatched;
+
+    /// <summary> Total microseconds dispatched tasks waited for a worker. </summary>
+    uint64_t total_wait_us;
+
+    /// <summary> Longest microseconds a dispatched task waited for a worker. </summary>
+    uint64_t max_wait_us;
+} napa_zone_flow_statistics;
+
+#ifdef __cplusplus
+
+namespace napa {
+    typedef napa_zone_flow_statistics FlowStatistics;
+}
+
+#endif // __cplusplus
+
 /// <summary> Zone handle type. </summary>
 typedef struct napa_zone *napa_zone_handle;
 
+/// <summary> Completion queue handle type. </summary>
+typedef struct napa_completion_queue *napa_completion_queue_handle;
+
+/// <summary> Represents an execution completed in a completion queue. </summary>
+typedef struct {
+    /// <summary> The tag given to napa_zone_execute_cq. </summary>
+    void* tag;
+
+    /// <summary> The result. Its strings stay valid until the completion is released. </summary>
+    napa_zone_result result;
+
+    /// <summary> Opaque buffer owning the result, which must be released by napa_completion_release. </summary>
+    void* buffer;
+} napa_completion;
+
 /// <summary> Callback for customized memory allocator. </summary>
 typedef void* (*napa_allocate_callback)(size_t);
 typedef void (*napa_deallocate_callback)(void*, size_t);
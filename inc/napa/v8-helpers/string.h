@@ -6,6 +6,7 @@
 #include <v8.h>
 #include <napa/stl/string.h>
 #include <cstring>
+#include <memory>
 
 namespace napa {
 namespace v8_helpers {
@@ -106,6 +107,56 @@ namespace v8_helpers {
         return MakeExternalV8String(isolate, str.data(), str.length());
     }
 
+    /// <summary> Strings shorter than this are copied into V8 heap, which is cheaper than an external string. </summary>
+    const size_t MIN_EXTERNAL_STRING_LENGTH = 1024;
+
+    /// <summary> External string resource over chars of an owner, which is kept alive until V8 disposes the string. </summary>
+    template <typename ResourceType, typename CharType>
+    class SharedExternalStringResource : public ResourceType {
+    public:
+        SharedExternalStringResource(std::shared_ptr<const void> owner, const CharType* data, size_t length) :
+            _owner(std::move(owner)), _data(data), _length(length) {}
+
+        const CharType* data() const override { return _data; }
+        size_t length() const override { return _length; }
+
+    private:
+        std::shared_ptr<const void> _owner;
+        const CharType* _data;
+        size_t _length;
+    };
+
+    using SharedExternalOneByteString = SharedExternalStringResource<v8::String::ExternalOneByteStringResource, char>;
+    using SharedExternalTwoByteString = SharedExternalStringResource<v8::String::ExternalStringResource, uint16_t>;
+
+    /// <summary> Make a V8 string from Latin-1 chars of an owner, without copying them if the string is long. </summary>
+    /// <param name="owner"> The object holding the chars, kept alive while V8 references them. </param>
+    inline v8::Local<v8::String> MakeSharedExternalV8String(
+        v8::Isolate *isolate, std::shared_ptr<const void> owner, const char* data, size_t length) {
+        if (length < MIN_EXTERNAL_STRING_LENGTH) {
+            return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(data),
+                v8::NewStringType::kNormal, static_cast<int>(length)).ToLocalChecked();
+        }
+
+        // V8 garbage collection frees the resource.
+        auto externalResource = new SharedExternalOneByteString(std::move(owner), data, length);
+        return v8::String::NewExternalOneByte(isolate, externalResource).ToLocalChecked();
+    }
+
+    /// <summary> Make a V8 string from UTF-16 chars of an owner, without copying them if the string is long. </summary>
+    /// <param name="owner"> The object holding the chars, kept alive while V8 references them. </param>
+    inline v8::Local<v8::String> MakeSharedExternalV8String(
+        v8::Isolate *isolate, std::shared_ptr<const void> owner, const char16_t* data, size_t length) {
+        auto chars = reinterpret_cast<const uint16_t*>(data);
+        if (length < MIN_EXTERNAL_STRING_LENGTH) {
+            return v8::String::NewFromTwoByte(isolate, chars, v8::NewStringType::kNormal, static_cast<int>(length)).ToLocalChecked();
+        }
+
+        // V8 garbage collection frees the resource.
+        auto externalResource = new SharedExternalTwoByteString(std::move(owner), chars, length);
+        return v8::String::NewExternalTwoByte(isolate, externalResource).ToLocalChecked();
+    }
+
     /// <summary> Converts a V8 string object to a movable Utf8String which supports an allocator. </summary>
     template <typename Alloc>
     class Utf8StringWithAllocator {
@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <future>
+#include <vector>
 
 namespace napa {
 
@@ -82,6 +83,10 @@ namespace napa {
                 res.transportContext.reset(
                     reinterpret_cast<napa::transport::TransportContext*>(result.transport_context));
 
+                if (result.accounting != nullptr) {
+                    res.accounting = std::make_shared<const CallAccounting>(*result.accounting);
+                }
+
                 (*callback)(std::move(res));
             }, context);
         }
@@ -133,6 +138,10 @@ namespace napa {
                 res.transportContext.reset(
                     reinterpret_cast<napa::transport::TransportContext*>(result.transport_context));
 
+                if (result.accounting != nullptr) {
+                    res.accounting = std::make_shared<const CallAccounting>(*result.accounting);
+                }
+
                 (*callback)(std::move(res));
             }, context);
         }
@@ -150,6 +159,50 @@ namespace napa {
             return fut.get();
         }
 
+        /// <summary> Serves this zone to remote zones on a Unix domain socket path, throws on failure. </summary>
+        void Listen(const std::string& address) {
+            auto res = napa_zone_listen(_handle, STD_STRING_TO_NAPA_STRING_REF(address));
+            if (res != NAPA_RESULT_SUCCESS) {
+                throw std::runtime_error("Failed to listen on '" + address + "'");
+            }
+        }
+
+        /// <summary> Stops serving a zone on an address, returns false if it wasn't served. </summary>
+        static bool Unlisten(const std::string& address) {
+            return napa_zone_unlisten(STD_STRING_TO_NAPA_STRING_REF(address)) == NAPA_RESULT_SUCCESS;
+        }
+
+        /// <summary> Retrieves counters of the zone's result cache. </summary>
+        CacheStatistics GetCacheStatistics() const {
+            CacheStatistics statistics;
+            napa_zone_get_cache_statistics(_handle, &statistics);
+            return statistics;
+        }
+
+        /// <summary> Retrieves the number of idle workers, 0 if the zone's workers are not in this process. </summary>
+        uint32_t GetIdleWorkerCount() const {
+            uint32_t count = 0;
+            if (napa_zone_get_idle_worker_count(_handle, &count) != NAPA_RESULT_SUCCESS) {
+                return 0;
+            }
+            return count;
+        }
+
+        /// <summary> Retrieves counters of the zone's flows, empty if the zone's workers are not in this process. </summary>
+        std::vector<FlowStatistics> GetFlowStatistics() const {
+            std::vector<FlowStatistics> statistics;
+            size_t count = 0;
+            do {
+                statistics.resize(count);
+                if (napa_zone_get_flow_statistics(_handle, statistics.data(), statistics.size(), &count) != NAPA_RESULT_SUCCESS) {
+                    return {};
+                }
+            } while (count > statistics.size());
+
+            statistics.resize(count);
+            return statistics;
+        }
+
         /// <summary> Retrieves a new zone proxy for the zone id, throws if zone is not found. </summary>
         static std::unique_ptr<Zone> Get(const std::string& id) {
             auto handle = napa_zone_get(STD_STRING_TO_NAPA_STRING_REF(id));
@@ -23,6 +23,7 @@ export function setTimeout(func: (...args: any[]) => void, after: number, ...arg
 
 export function clearTimeout(timeout: Timeout): void {
     timeout._active = false;
+    binding.clearTimers(timeout);
 }
 
 export function setInterval(func: (...args: any[]) => void, after: number, ...args: any[]): Timeout {
@@ -33,4 +34,5 @@ export function setInterval(func: (...args: any[]) => void, after: number, ...ar
 
 export function clearInterval(timeout: Timeout): void {
     timeout._active = false;
+    binding.clearTimers(timeout);
 }
@@ -1,10 +1,6 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
-/// <summary> Timer is a facility to run timed callbacks in caller's isolates. </summary>
-export interface Timer {
-}
-
 const TIMEOUT_MAX = 2 ** 31 -1;
 
 export class Timeout {
@@ -13,7 +9,7 @@ export class Timeout {
     private _repeat: number;
     private _args: any[];
     _active: boolean;
-    private _timer: Timer;
+    private _timerId: number;
 
     constructor(callback: (...args: any[]) => void, 
                 after: number, repeat: number, args: any[]) {
@@ -27,7 +23,7 @@ export class Timeout {
         this._after = after;
         this._repeat = repeat;
         this._args = args;
-        this._timer = null;
+        this._timerId = undefined;
 
         this._active = true;
     }
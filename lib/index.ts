@@ -4,6 +4,7 @@
 import { log } from './log';
 import * as memory from './memory';
 import * as metric from './metric';
+import * as moduleApi from './module';
 import * as runtime from './runtime';
 import * as store from './store';
 import * as sync from './sync';
@@ -11,7 +12,10 @@ import * as transport from './transport';
 import * as v8 from './v8';
 import * as zone from './zone';
 
-export { log, memory, metric, runtime, store, sync, transport, v8, zone };
+export { log, memory, metric, moduleApi as module, runtime, store, sync, transport, v8, zone };
+
+// Pipelines chain zones, thus are exposed at top level as 'napa.pipeline'.
+export let pipeline = zone.pipeline;
 
 // Add execute proxy to global context.
 import { call } from './zone/function-call';
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('./binding');
+
+/// <summary>
+///     Drops cached module resolution results of all zones in this process, including modules that could not be
+///     found, so the next require looks at the file system again.
+/// </summary>
+/// <param name="path"> Path of a file or directory that was created, changed or removed. If omitted, all results are dropped. </param>
+export function invalidateCache(path?: string): void {
+    binding.invalidateModuleCache(path);
+}
+
+/// <summary> A require() call to resolve ahead of time into a module bundle. </summary>
+export interface BundledRequire {
+    /// <summary> Module name or path, as passed to require(). </summary>
+    name: string;
+
+    /// <summary> Directory of the requiring module. If omitted, the current directory is used. </summary>
+    from?: string;
+}
+
+/// <summary>
+///     Writes a module bundle for zones created with the 'bundle' setting. Each require() call is resolved the way
+///     workers resolve it, and the resolved module's source is stored in the bundle.
+/// </summary>
+/// <param name="path"> Path of the bundle file to write. </param>
+/// <param name="requires"> require() calls to bundle, given as module names or { name, from } objects. </param>
+export function writeBundle(path: string, requires: (string | BundledRequire)[]): void {
+    let names: string[] = [];
+    let fromPaths: string[] = [];
+    for (let r of requires) {
+        let bundled: BundledRequire = typeof r === 'string' ? { name: r } : r;
+        names.push(bundled.name);
+        fromPaths.push(bundled.from != null ? bundled.from : process.cwd());
+    }
+    binding.writeModuleBundle(path, names, fromPaths);
+}
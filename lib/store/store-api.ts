@@ -1,17 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
-import { Store } from './store';
+import { Store, StoreOptions } from './store';
 
 let binding = require('../binding');
 
 /// <summary> Create a store with an id. </summary>
 /// <param name="id"> String identifier which can be used to get the store from all isolates. </summary>
+/// <param name="options"> Optional limits (maxEntries, maxBytes, default ttl) of the store. </summary>
 /// <returns> A store object or throws Error if store with this id already exists. </returns>
 /// <remarks> Store object will be destroyed when reference from all isolates are unreferenced. 
 /// It's usually a best practice to keep a long-living reference in user modules or global scope. </remarks>
-export function create(id: string): Store {
-    return binding.createStore(id);
+export function create(id: string, options?: StoreOptions): Store {
+    return binding.createStore(id, options);
 }
 
 /// <summary> Get a store with an id. </summary>
@@ -23,11 +24,29 @@ export function get(id: string): Store {
 
 /// <summary> Get a store with an id, or create it if not exist. </summary>
 /// <param name="id"> String identifier which can be used to get the store from all isolates. </summary>
+/// <param name="options"> Optional limits of the store, only applied when the store is created by this call. </summary>
 /// <returns> A store object associated with the id. </returns>
 /// <remarks> Store object will be destroyed when reference from all isolates are unreferenced. 
 /// It's usually a best practice to keep a long-living reference in user modules or global scope. </remarks>
-export function getOrCreate(id: string): Store {
-    return binding.getOrCreateStore(id);
+export function getOrCreate(id: string, options?: StoreOptions): Store {
+    return binding.getOrCreateStore(id, options);
+}
+
+/// <summary> Create a store in shared memory, which can be opened by other processes on the same host. </summary>
+/// <param name="id"> String identifier of characters [A-Za-z0-9._-], which is unique on the host. </summary>
+/// <param name="options"> maxEntries and maxBytes size the shared memory, ttl is the default time-to-live. </summary>
+/// <returns> A store object or throws Error if a shared store with this id already exists. </returns>
+/// <remarks> The shared memory is removed when the store is destroyed in this process. 
+/// Values of transportable types and SharedArrayBuffer cannot be set to a shared store. </remarks>
+export function createShared(id: string, options?: StoreOptions): Store {
+    return binding.createSharedStore(id, options);
+}
+
+/// <summary> Get a shared store created by this or another process. </summary>
+/// <param name="id"> String identifier which is passed to createShared. </summary>
+/// <returns> A store object if exists, otherwise undefined. </returns>
+export function getShared(id: string): Store {
+    return binding.getSharedStore(id);
 }
 
 /// <summary> Returns number of stores that is alive. </summary>
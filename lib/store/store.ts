@@ -1,6 +1,52 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+/// <summary> Limits of a store. 0 or undefined means unlimited. </summary>
+export interface StoreOptions {
+    /// <summary> Max number of keys. Least recently used keys are evicted when exceeded. </summary>
+    maxEntries?: number;
+
+    /// <summary> Max total bytes of serialized values. Least recently used keys are evicted when exceeded. </summary>
+    maxBytes?: number;
+
+    /// <summary> Default time-to-live in milliseconds for keys set without an explicit ttl. </summary>
+    ttl?: number;
+
+    /// <summary> Snapshot file path. If the file exists, the store is loaded from it when created. 
+    /// The store is saved to it when destroyed. </summary>
+    snapshot?: string;
+
+    /// <summary> Interval in milliseconds to save snapshot in background. Requires 'snapshot'. </summary>
+    snapshotInterval?: number;
+
+    /// <summary> Serialized value size in bytes from which values are kept compressed, and decompressed on get. </summary>
+    compressThreshold?: number;
+}
+
+/// <summary> Counters of a store since it was created. </summary>
+export interface StoreStatistics {
+    /// <summary> Number of gets that found a live key. </summary>
+    hits: number;
+
+    /// <summary> Number of gets that found no live key. </summary>
+    misses: number;
+
+    /// <summary> Number of keys evicted due to maxEntries or maxBytes. </summary>
+    evictions: number;
+
+    /// <summary> Number of keys removed after their ttl elapsed. </summary>
+    expirations: number;
+
+    /// <summary> Total bytes of serialized values currently held, after compression. </summary>
+    bytes: number;
+
+    /// <summary> Total bytes of serialized values currently held, before compression. </summary>
+    rawBytes: number;
+
+    /// <summary> Bytes of compressed values currently held, included in 'bytes'. </summary>
+    compressedBytes: number;
+}
+
 /// <summary> Store is a facility to share (built-in JavaScript types or Transportable subclasses) objects across isolates. </summary>
 export interface Store {
     /// <summary> Id of this store. </summary>
@@ -8,7 +54,10 @@ export interface Store {
 
     /// <summary> Number of keys in this store. </summary>
     readonly size: number;
-    
+
+    /// <summary> Hit/miss/eviction/expiration counters and current byte usage of this store. </summary>
+    readonly statistics: StoreStatistics;
+
     /// <summary> Check if this store has a key. </summary>
     /// <param name="key"> Case-sensitive string key. </summary>
     /// <returns> True if this store has the key. </returns>
@@ -22,9 +71,63 @@ export interface Store {
     /// <summary> Insert or update a JavaScript value by key. </summary>
     /// <param name="key"> Case-sensitive string key. </summary>
     /// <param name="value"> Value. Any value of built-in JavaScript types or Transportable subclasses can be accepted. </summary>
-    set(key: string, value: any): void;
+    /// <param name="ttl"> Optional time-to-live in milliseconds, 0 for never expire. Defaults to the store's ttl option. </summary>
+    set(key: string, value: any, ttl?: number): void;
 
     /// <summary> Remove a key with its value from this store. </summary>
     /// <param name="key"> Case-sensitive string key. </summary>
     delete(key: string): void;
+
+    /// <summary> Get JavaScript values of multiple keys in one call. </summary>
+    /// <param name="keys"> Case-sensitive string keys. </summary>
+    /// <returns> Values in the order of keys, undefined for keys not found. </returns>
+    getMany(keys: string[]): any[];
+
+    /// <summary> Insert or update multiple keys in one call. </summary>
+    /// <param name="values"> An object whose own properties are keys and values to set. </summary>
+    setMany(values: { [key: string]: any }): void;
+
+    /// <summary> Get version of a key, which changes on every update of the key. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <returns> Version of the key, 0 if not found. </returns>
+    version(key: string): number;
+
+    /// <summary> Set a value only if version of the key is unchanged. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <param name="value"> Value to set. </summary>
+    /// <param name="version"> Version from store.version(key), 0 to set only if the key doesn't exist. </summary>
+    /// <returns> True if the value is set. </returns>
+    compareAndSet(key: string, value: any, version: number): boolean;
+
+    /// <summary> Atomically add a number to a numeric value. A key not found is treated as 0. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <param name="delta"> Number to add, 1 by default. </summary>
+    /// <returns> Value after increment. Throws if the existing value is not a number. </returns>
+    increment(key: string, delta?: number): number;
+
+    /// <summary> Get value of a key, or compute and set it if the key doesn't exist. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <param name="compute"> Function to compute the value, called without holding store lock. </summary>
+    /// <returns> The existing value, or the computed value. If multiple workers compute concurrently, the first set value is returned to all. </returns>
+    getOrCompute(key: string, compute: () => any): any;
+
+    /// <summary> Save keys with their remaining ttl to a file, which is replaced atomically. </summary>
+    /// <param name="path"> Snapshot file path. </summary>
+    /// <returns> Number of keys saved. Values of transportable types and SharedArrayBuffer are not saved. </returns>
+    save(path: string): number;
+
+    /// <summary> Load keys from a file written by save, overriding existing keys. </summary>
+    /// <param name="path"> Snapshot file path. </summary>
+    /// <returns> Number of keys loaded. </returns>
+    load(path: string): number;
+
+    /// <summary> Watch changes of a key, or of all keys with a prefix. </summary>
+    /// <param name="key"> Case-sensitive string key, or { prefix: string } to watch keys starting with prefix. </summary>
+    /// <param name="callback"> Called asynchronously on the watching worker with key and its new version, 0 if the key is deleted, expired or evicted. </summary>
+    /// <returns> Watch id for unwatch. </returns>
+    watch(key: string | { prefix: string }, callback: (key: string, version: number) => void): number;
+
+    /// <summary> Stop watching. It must be called on the worker that called watch. </summary>
+    /// <param name="watchId"> Watch id returned from watch. </summary>
+    unwatch(watchId: number): void;
 }
\ No newline at end of file
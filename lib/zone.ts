@@ -1,8 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import * as path from 'path';
 import * as zone from './zone/zone';
 import * as impl from './zone/zone-impl';
+import * as pipelineImpl from './zone/pipeline';
 
 import * as platform from './runtime/platform';
 
@@ -16,6 +18,10 @@ declare var __in_napa: boolean;
 /// <param name="settings"> The settings of the new zone. </param>
 export function create(id: string, settings: zone.ZoneSettings = zone.DEFAULT_SETTINGS) : zone.Zone {
     platform.initialize();
+    if (settings.processes > 0 && typeof __in_napa === 'undefined') {
+        // Helper processes run this node executable with the host script, napa workers use the host set from node.
+        binding.setProcessZoneHost([process.execPath, path.resolve(__dirname, 'zone/process-host.js')]);
+    }
     return new impl.ZoneImpl(binding.createZone(id, settings));
 }
 
@@ -25,6 +31,21 @@ export function get(id: string) : zone.Zone {
     return new impl.ZoneImpl(binding.getZone(id));
 }
 
+/// <summary> Creates a pipeline, which runs functions in a chain of zones, each taking the return value of the previous one. </summary>
+/// <param name="stages"> Stages in order of execution. </param>
+export function pipeline(stages: pipelineImpl.PipelineStage[]) : pipelineImpl.Pipeline {
+    platform.initialize();
+    return pipelineImpl.create(stages);
+}
+
+/// <summary> Stops serving a zone on an address, closing connections of its remote zones. </summary>
+/// <param name="address"> The address passed to zone.listen. </param>
+/// <returns> False if no zone was served on the address. </returns>
+export function unlisten(address: string) : boolean {
+    platform.initialize();
+    return binding.unlisten(address);
+}
+
 /// TODO: add function getOrCreate(id: string, settings: zone.ZoneSettings): Zone.
 
 /// <summary> Define a getter property 'current' to retrieve the current zone. </summary>
@@ -45,4 +66,5 @@ Object.defineProperty(exports, "node", {
     }
 });
 
-export * from './zone/zone';
\ No newline at end of file
+export * from './zone/zone';
+export { Pipeline, PipelineStage } from './zone/pipeline';
\ No newline at end of file
@@ -99,6 +99,13 @@ function callFunction(
     transportContext: transport.TransportContext,
     options: CallOptions): any {
 
+    let func = resolveFunction(moduleName, functionName);
+    let args = marshalledArgs.map((arg) => { return transport.unmarshall(arg, transportContext); });
+    return func.apply(this, args);
+}
+
+/// <summary> Find the function to call by module name and function name, see `call` for supported names. </summary>
+export function resolveFunction(moduleName: string, functionName: string): (...args: any[]) => any {
     let module: any = null;
     let useAnonymousFunction: boolean = false;
 
@@ -131,9 +138,7 @@ function callFunction(
             throw new Error("'" + functionName + "' in module '" + moduleName + "' is not a function");
         }
     }
-
-    let args = marshalledArgs.map((arg) => { return transport.unmarshall(arg, transportContext); });
-    return func.apply(this, args);
+    return func;
 }
 
 /// <summary> Finish call with result. </summary>
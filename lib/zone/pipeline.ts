@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as path from 'path';
+import * as zone from './zone';
+import * as impl from './zone-impl';
+import * as transport from '../transport';
+import * as v8 from '../v8';
+
+let binding = require('../binding');
+
+/// <summary> Represents a function to run in a zone as one stage of a pipeline. </summary>
+export interface PipelineStage {
+
+    /// <summary> The zone to run the function in. </summary>
+    zone: zone.Zone;
+
+    /// <summary> The module that contains the function. Ignored when 'function' is a JS function. </summary>
+    module?: string;
+
+    /// <summary>
+    ///     The function name in the module, or a JS function.
+    ///     Functions of later stages take the return value of the previous stage as their only argument.
+    /// </summary>
+    function: string | ((...args: any[]) => any);
+
+    /// <summary> Call options, defaults to DEFAULT_CALL_OPTIONS. </summary>
+    options?: zone.CallOptions;
+}
+
+/// <summary>
+///     Runs functions in a chain of zones, each taking the return value of the previous one.
+///     Return values of intermediate stages are passed from zone to zone natively,
+///     they are never unmarshalled in the calling isolate.
+/// </summary>
+export interface Pipeline {
+
+    /// <summary> Number of stages. </summary>
+    readonly stageCount: number;
+
+    /// <summary> Runs the pipeline. </summary>
+    /// <param name="args"> The arguments that will pass to the function of the first stage. </param>
+    /// <returns> A promise of the result of the last stage, which is rejected when any stage fails. </returns>
+    execute(args?: any[]) : Promise<zone.Result>;
+}
+
+/// <summary> Pipeline backed by a native pipeline. </summary>
+class PipelineImpl implements Pipeline {
+    private _nativePipeline: any;
+
+    constructor(nativePipeline: any) {
+        this._nativePipeline = nativePipeline;
+    }
+
+    public get stageCount(): number {
+        return this._nativePipeline.getStageCount();
+    }
+
+    public execute(args?: any[]) : Promise<zone.Result> {
+        if (args == null) {
+            args = [];
+        }
+
+        // Create a non-owning transport context which will be passed to the first stage.
+        let transportContext: transport.TransportContext = transport.createTransportContext(false);
+        let marshalledArgs = args.map(arg => transport.marshall(arg, transportContext));
+
+        return new Promise<zone.Result>((resolve, reject) => {
+            this._nativePipeline.execute(marshalledArgs, transportContext, (result: any) => {
+                impl.runImmediately(() => {
+                    if (result.code === 0) {
+                        resolve(new impl.Result(
+                            result.returnValue,
+                            transport.createTransportContext(true, result.contextHandle),
+                            result.accounting));
+                    } else {
+                        reject(result.errorMessage);
+                    }
+                });
+            });
+        });
+    }
+}
+
+/// <summary> Creates a pipeline. </summary>
+/// <param name="stages"> Stages in order of execution. </param>
+export function create(stages: PipelineStage[]): Pipeline {
+    // We get caller stack at index 2.
+    // <caller> -> pipeline -> create
+    //   2           1          0
+    let callerFile: string = v8.currentStack(3)[2].getFileName();
+
+    let nativeStages = stages.map((stage: PipelineStage) => {
+        let moduleName: string = stage.module;
+        let functionName: string = null;
+
+        if (typeof stage.function === 'function') {
+            let func: any = stage.function;
+            if (func.origin == null) {
+                func.origin = callerFile;
+            }
+            moduleName = "__function";
+            functionName = transport.saveFunction(func);
+        }
+        else {
+            // If module name is relative path, try to deduce from call site.
+            if (moduleName != null
+                && moduleName.length != 0
+                && !path.isAbsolute(moduleName)) {
+
+                moduleName = path.resolve(path.dirname(callerFile), moduleName);
+            }
+            functionName = stage.function;
+        }
+
+        return {
+            zone: stage.zone.id,
+            module: moduleName,
+            function: functionName,
+            options: stage.options != null ? stage.options : zone.DEFAULT_CALL_OPTIONS
+        };
+    });
+
+    return new PipelineImpl(binding.createPipeline(nativeStages));
+}
@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// Entry of a helper process that runs the workers of a zone created with 'processes' setting.
+// The zone appends the name of the channel to serve to the command line.
+
+import * as platform from '../runtime/platform';
+
+let binding = require('../binding');
+
+platform.initialize();
+
+// Returns when the zone is released or its process exits.
+binding.serveProcessZone(process.argv[process.argv.length - 1]);
+process.exit(0);
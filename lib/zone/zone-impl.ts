@@ -3,6 +3,7 @@
 
 import * as path from 'path';
 import * as zone from './zone';
+import * as functionCall from './function-call';
 import * as transport from '../transport';
 import * as v8 from '../v8';
 
@@ -14,11 +15,12 @@ interface FunctionSpec {
     transportContext: transport.TransportContext;
 }
 
-class Result implements zone.Result{
+export class Result implements zone.Result{
 
-     constructor(payload: string, transportContext: transport.TransportContext) {
+     constructor(payload: string, transportContext: transport.TransportContext, accounting?: zone.CallAccounting) {
           this._payload = payload;
           this._transportContext = transportContext; 
+          this._accounting = accounting;
      }
 
      get value(): any {
@@ -37,6 +39,40 @@ class Result implements zone.Result{
          return this._transportContext; 
      }
 
+     get accounting(): zone.CallAccounting {
+         return this._accounting;
+     }
+
+     private _transportContext: transport.TransportContext;
+     private _payload: string;
+     private _value: any;
+     private _accounting: zone.CallAccounting;
+};
+
+/// <summary> Result of a call that ran inline, which is marshalled only if its payload is asked for. </summary>
+export class InlineResult implements zone.Result {
+
+     constructor(value: any) {
+          this._value = value;
+     }
+
+     get value(): any {
+         return this._value;
+     }
+
+     get payload(): string {
+         if (this._payload === undefined) {
+             this._transportContext = transport.createTransportContext(true);
+             this._payload = transport.marshall(this._value, this._transportContext);
+         }
+         return this._payload;
+     }
+
+     get transportContext(): transport.TransportContext {
+         this.payload;
+         return this._transportContext;
+     }
+
      private _transportContext: transport.TransportContext;
      private _payload: string;
      private _value: any;
@@ -47,7 +83,7 @@ declare var __in_napa: boolean;
 /// <summary> Helper function to workaround possible delay in Promise resolve/reject when working with Node event loop.
 /// See https://github.com/audreyt/node-webworker-threads/issues/123#issuecomment-254019552
 /// </summary>
-function runImmediately(func : () => void) {
+export function runImmediately(func : () => void) {
     if (typeof __in_napa === 'undefined') {
         // In node.
         setImmediate(func);
@@ -57,6 +93,23 @@ function runImmediately(func : () => void) {
     }
 }
 
+/// <summary>
+///     Whether a call may run inline for options.forkJoin. Only calls without other options do, since timeout,
+///     caching, single flight, flows, accounting and manual transport are applied by the zone scheduling the call.
+/// </summary>
+function isInlineCandidate(options: zone.CallOptions): boolean {
+    return options != null
+        && !!options.forkJoin
+        && !options.timeout
+        && !options.hedgeAfterMs
+        && !options.cacheTtlMs
+        && !options.singleFlight
+        && !options.flowId
+        && (options.flowWeight == null || options.flowWeight === 1)
+        && !options.accounting
+        && (options.transport == null || options.transport === zone.TransportOption.AUTO);
+}
+
 /// <summary> Zone consists of Napa isolates. </summary>
 export class ZoneImpl implements zone.Zone {
     private _nativeZone: any;
@@ -69,6 +122,14 @@ export class ZoneImpl implements zone.Zone {
         return this._nativeZone.getId();
     }
 
+    public get cacheStatistics(): zone.CacheStatistics {
+        return this._nativeZone.getCacheStatistics();
+    }
+
+    public get flowStatistics(): zone.FlowStatistics[] {
+        return this._nativeZone.getFlowStatistics();
+    }
+
     public toJSON(): any {
         return { id: this.id, type: this.id === 'node'? 'node': 'napa' };
     }
@@ -98,6 +159,11 @@ export class ZoneImpl implements zone.Zone {
     }
 
     public execute(arg1: any, arg2?: any, arg3?: any, arg4?: any) : Promise<zone.Result> {
+        let options: zone.CallOptions = typeof arg1 === 'function' ? arg3 : arg4;
+        if (isInlineCandidate(options) && this._nativeZone.canRunInline()) {
+            return this.executeInline(arg1, arg2, arg3);
+        }
+
         let spec : FunctionSpec = this.createExecuteRequest(arg1, arg2, arg3, arg4);
         
         return new Promise<zone.Result>((resolve, reject) => {
@@ -106,7 +172,8 @@ export class ZoneImpl implements zone.Zone {
                     if (result.code === 0) {
                         resolve(new Result(
                             result.returnValue,
-                            transport.createTransportContext(true, result.contextHandle)));
+                            transport.createTransportContext(true, result.contextHandle),
+                            result.accounting));
                     } else {
                         reject(result.errorMessage);
                     }
@@ -115,6 +182,52 @@ export class ZoneImpl implements zone.Zone {
         });
     }
 
+    public listen(address: string) : void {
+        this._nativeZone.listen(address);
+    }
+
+    /// <summary> Runs a nested call on the calling worker, passing arguments and result without marshalling. </summary>
+    private executeInline(arg1: any, arg2: any, arg3?: any) : Promise<zone.Result> {
+        let moduleName: string = null;
+        let functionName: string = null;
+        let args: any[] = null;
+
+        if (typeof arg1 !== 'function') {
+            moduleName = arg1;
+            // If module name is relative path, try to deduce from call site.
+            if (moduleName != null 
+                && moduleName.length != 0 
+                && !path.isAbsolute(moduleName)) {
+
+                // We get caller stack at index 2.
+                // <caller> -> execute -> executeInline
+                //   2           1               0
+                moduleName = path.resolve(
+                    path.dirname(v8.currentStack(3)[2].getFileName()), 
+                    moduleName);
+            }
+            functionName = arg2;
+            args = arg3;
+        } else {
+            args = arg2;
+        }
+
+        return new Promise<zone.Result>((resolve, reject) => {
+            try {
+                let func = typeof arg1 === 'function' ? arg1 : functionCall.resolveFunction(moduleName, functionName);
+                Promise.resolve(func.apply(undefined, args != null ? args : []))
+                    .then((value: any) => {
+                        resolve(new InlineResult(value));
+                    }, (error: any) => {
+                        reject(String(error));
+                    });
+            }
+            catch (error) {
+                reject(String(error));
+            }
+        });
+    }
+
     private createBroadcastRequest(arg1: any, arg2?: any) : FunctionSpec {
         if (typeof arg1 === "function") {
             // broadcast with function
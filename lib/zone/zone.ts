@@ -8,6 +8,36 @@ export interface ZoneSettings {
 
     /// <summary> The number of workers that will serve zone requests. </summary>
     workers?: number;
+
+    /// <summary> Path of a prebuilt module bundle to resolve and load modules from. </summary>
+    bundle?: string;
+
+    /// <summary>
+    ///     Max microseconds an idle worker spins before it parks, 0 (default) to park right away.
+    ///     Spinning is tuned down automatically when tasks arrive less often than that.
+    /// </summary>
+    idleSpinMicroseconds?: number;
+
+    /// <summary>
+    ///     Number of helper processes to run workers in, each with 'workers' workers. 0 (default) runs workers in this process.
+    ///     A helper that dies is restarted, failing only the calls it was running.
+    ///     Arguments and results of calls are marshalled across processes, so they must not refer to shared objects.
+    /// </summary>
+    processes?: number;
+
+    /// <summary>
+    ///     Socket path of a zone served by `zone.listen` in another process, to create a zone forwarding calls to it.
+    ///     Arguments and results of calls are marshalled across processes, so they must not refer to shared objects.
+    /// </summary>
+    remote?: string;
+
+    /// <summary> Number of connections to a remote zone, 1 by default. Each connection carries many calls at a time. </summary>
+    connections?: number;
+
+    /// <summary>
+    ///     Max bytes of results cached for calls with `cacheTtlMs`, 16MB by default. 0 disables the result cache.
+    /// </summary>
+    resultCacheBytes?: number;
 }
 
 /// <summary> Default ZoneSettings </summary>
@@ -36,6 +66,42 @@ export interface CallOptions {
     /// <summary> Timeout in milliseconds. By default set to 0 if timeout is not needed. </summary>
     timeout?: number,
 
+    /// <summary>
+    ///     Milliseconds after which a call still pending is duplicated on another idle worker, taking whichever result
+    ///     comes first. By default set to 0 for no hedging. Only use it for idempotent functions.
+    /// </summary>
+    hedgeAfterMs?: number,
+
+    /// <summary>
+    ///     Milliseconds to cache the result for, returning it for later calls with the same function and arguments
+    ///     without running them. By default set to 0 for no caching. Only use it for deterministic functions.
+    /// </summary>
+    cacheTtlMs?: number,
+
+    /// <summary>
+    ///     Whether to coalesce the call with an identical call in flight, taking the result of its single execution.
+    ///     By default set to false. Only use it for deterministic functions.
+    /// </summary>
+    singleFlight?: boolean,
+
+    /// <summary>
+    ///     Whether a call made from a worker to its own zone runs right away on the calling worker when no worker of
+    ///     the zone is idle, passing arguments and result without marshalling. By default set to false.
+    /// </summary>
+    forkJoin?: boolean,
+
+    /// <summary>
+    ///     The flow, such as a tenant, the call waits in while all workers are busy. Busy flows take turns on workers,
+    ///     so one flow flooding the zone doesn't delay the others. By default set to 0.
+    /// </summary>
+    flowId?: number,
+
+    /// <summary> How many calls the flow runs per turn relative to other busy flows. By default set to 1. </summary>
+    flowWeight?: number,
+
+    /// <summary> Whether to measure the resources the call uses, returned as `result.accounting`. By default set to false. </summary>
+    accounting?: boolean,
+
     /// <summary> Transport option on passing arguments. By default set to TransportOption.AUTO </summary>
     transport?: TransportOption
 }
@@ -61,6 +127,69 @@ export interface Result {
 
     /// <summary> Transport context carries additional information needed to unmarshall. </summary>
     readonly transportContext : transport.TransportContext;
+
+    /// <summary> Resources used by the call if `accounting` was set in its options, otherwise undefined. </summary>
+    readonly accounting? : CallAccounting;
+}
+
+/// <summary> Resources used by a call. </summary>
+export interface CallAccounting {
+    /// <summary> Microseconds the call waited in queue before a worker started it. </summary>
+    queueWaitUs: number;
+
+    /// <summary> Microseconds from when a worker started the call until its result, including asynchronous work. </summary>
+    executionUs: number;
+
+    /// <summary> Microseconds of CPU time the worker spent running the call synchronously. </summary>
+    cpuUs: number;
+
+    /// <summary> Bytes the worker's JavaScript heap grew by while running the call synchronously. </summary>
+    heapBytes: number;
+
+    /// <summary> Bytes of the marshalled arguments. </summary>
+    argumentBytes: number;
+
+    /// <summary> Bytes of the marshalled result. </summary>
+    resultBytes: number;
+}
+
+/// <summary> Counters of a zone's result cache since the zone was created. </summary>
+export interface CacheStatistics {
+    /// <summary> Number of calls answered from the cache. </summary>
+    hits: number;
+
+    /// <summary> Number of calls with `cacheTtlMs` that were not in the cache. </summary>
+    misses: number;
+
+    /// <summary> Number of results evicted due to `resultCacheBytes`. </summary>
+    evictions: number;
+
+    /// <summary> Number of results removed after their `cacheTtlMs` elapsed. </summary>
+    expirations: number;
+
+    /// <summary> Total bytes of cached calls and results currently held. </summary>
+    bytes: number;
+}
+
+/// <summary> Counters of a flow of calls in a zone since the zone was created. </summary>
+export interface FlowStatistics {
+    /// <summary> The `flowId` of the calls. </summary>
+    flowId: number;
+
+    /// <summary> The `flowWeight` of the latest call of the flow. </summary>
+    weight: number;
+
+    /// <summary> Number of calls waiting for a worker. </summary>
+    queued: number;
+
+    /// <summary> Number of calls handed to workers. </summary>
+    dispatched: number;
+
+    /// <summary> Total microseconds dispatched calls waited for a worker. </summary>
+    totalWaitUs: number;
+
+    /// <summary> Longest microseconds a dispatched call waited for a worker. </summary>
+    maxWaitUs: number;
 }
 
 /// <summary>
@@ -83,6 +212,12 @@ export interface Zone {
     /// <summary> The zone id. </summary>
     readonly id: string;
 
+    /// <summary> Hit/miss/eviction/expiration counters and current byte usage of the zone's result cache. </summary>
+    readonly cacheStatistics: CacheStatistics;
+
+    /// <summary> Queue depth and wait time counters of each flow that called the zone, empty for the node zone. </summary>
+    readonly flowStatistics: FlowStatistics[];
+
     /// <summary> Compiles and run the provided source code on all zone workers. </summary>
     /// <param name="source"> A valid javascript source code. </param>
     /// <returns> A promise which is resolved when broadcast completes, and rejected when failed. </returns>
@@ -138,5 +273,9 @@ export interface Zone {
     /// <param name="options"> Call options, defaults to DEFAULT_CALL_OPTIONS. </param>
     /// <returns> A promise of result which is resolved when execute completes, and rejected when failed. </returns>
     execute(func: (...args: any[]) => any, args?: any[], options?: CallOptions) : Promise<Result>;
+
+    /// <summary> Serves this zone to zones created with `settings.remote` set to the address, until `zone.unlisten`. </summary>
+    /// <param name="address"> The Unix domain socket path to listen on. </param>
+    listen(address: string) : void;
 }
 
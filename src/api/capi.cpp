@@ -2,16 +2,22 @@
 // Licensed under the MIT license.
 
 #include <napa/capi.h>
+#include <module/loader/module-bundle.h>
+#include <module/loader/module-resolver-cache.h>
 
 #include <providers/providers.h>
 #include <settings/settings-parser.h>
 #include <v8-extensions/v8-common.h>
+#include <zone/completion-queue.h>
 #include <zone/napa-zone.h>
 #include <zone/node-zone.h>
+#include <zone/process-zone.h>
+#include <zone/remote-zone.h>
 #include <zone/worker-context.h>
 
 #include <napa/log.h>
 
+#include <algorithm>
 #include <atomic>
 #include <fstream>
 #include <sstream>
@@ -31,6 +37,37 @@ struct napa_zone {
     std::shared_ptr<zone::Zone> zone;
 };
 
+/// <summary> Converts a C function spec, taking ownership of its transport context. </summary>
+static FunctionSpec ToFunctionSpec(const napa_zone_function_spec& spec) {
+    FunctionSpec req;
+    req.module = spec.module;
+    req.function = spec.function;
+
+    req.arguments.reserve(spec.arguments_count);
+    for (size_t i = 0; i < spec.arguments_count; i++) {
+        req.arguments.emplace_back(spec.arguments[i]);
+    }
+
+    req.options = spec.options;
+
+    // Assume ownership of transport context
+    req.transportContext.reset(reinterpret_cast<napa::transport::TransportContext*>(spec.transport_context));
+    return req;
+}
+
+/// <summary> Converts a result to C result, referencing its strings and releasing its transport context. </summary>
+static napa_zone_result ToZoneResult(Result& result) {
+    napa_zone_result res;
+    res.code = result.code;
+    res.error_message = STD_STRING_TO_NAPA_STRING_REF(result.errorMessage);
+    res.return_value = STD_STRING_TO_NAPA_STRING_REF(result.returnValue);
+
+    // Release ownership of transport context
+    res.transport_context = reinterpret_cast<void*>(result.transportContext.release());
+    res.accounting = result.accounting.get();
+    return res;
+}
+
 napa_zone_handle napa_zone_create(napa_string_ref id) {
     NAPA_ASSERT(_initialized, "Napa wasn't initialized");
 
@@ -47,6 +84,12 @@ napa_zone_handle napa_zone_get(napa_string_ref id) {
         zone = zone::NodeZone::Get();
     } else {
         zone = zone::NapaZone::Get(zoneId);
+        if (!zone) {
+            zone = zone::ProcessZone::Get(zoneId);
+        }
+        if (!zone) {
+            zone = zone::RemoteZone::Get(zoneId);
+        }
     }
 
     if (!zone) {
@@ -80,8 +123,22 @@ napa_result_code napa_zone_init(napa_zone_handle handle, napa_string_ref setting
 
     zoneSettings.id = handle->id;
 
+    // Zone ids are unique across in-process, multi-process and remote zones.
+    if (zone::NapaZone::Get(handle->id) != nullptr
+        || zone::ProcessZone::Get(handle->id) != nullptr
+        || zone::RemoteZone::Get(handle->id) != nullptr) {
+        NAPA_DEBUG("Api", "Failed to create zone '%s': a zone with this name already exists.", handle->id.c_str());
+        return NAPA_RESULT_ZONE_INIT_ERROR;
+    }
+
     // Create the actual zone.
-    handle->zone = zone::NapaZone::Create(zoneSettings);
+    if (!zoneSettings.remote.empty()) {
+        handle->zone = zone::RemoteZone::Create(zoneSettings);
+    } else if (zoneSettings.processes > 0) {
+        handle->zone = zone::ProcessZone::Create(zoneSettings, NAPA_STRING_REF_TO_STD_STRING(settings));
+    } else {
+        handle->zone = zone::NapaZone::Create(zoneSettings);
+    }
     if (handle->zone == nullptr) {
         NAPA_DEBUG("Api", "Failed to create Napa zone '%s' with settings: %s", handle->id.c_str(), settings.data);
         return NAPA_RESULT_ZONE_INIT_ERROR;
@@ -117,67 +174,239 @@ void napa_zone_broadcast(napa_zone_handle handle,
     NAPA_ASSERT(handle, "Zone handle is null");
     NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
 
-    FunctionSpec req;
-    req.module = spec.module;
-    req.function = spec.function;
+    auto req = ToFunctionSpec(spec);
 
-    req.arguments.reserve(spec.arguments_count);
-    for (size_t i = 0; i < spec.arguments_count; i++) {
-        req.arguments.emplace_back(spec.arguments[i]);
+    handle->zone->Broadcast(req, [callback, context](Result result) {
+        callback(ToZoneResult(result), context);
+    });
+}
+
+void napa_zone_execute(napa_zone_handle handle,
+                       napa_zone_function_spec spec,
+                       napa_zone_execute_callback callback,
+                       void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    auto req = ToFunctionSpec(spec);
+
+    handle->zone->Execute(req, [callback, context](Result result) {
+        callback(ToZoneResult(result), context);
+    });
+}
+
+void napa_zone_set_process_host(const napa_string_ref* command, size_t command_count) {
+    NAPA_ASSERT(command != nullptr || command_count == 0, "Command is null");
+
+    std::vector<std::string> hostCommand;
+    hostCommand.reserve(command_count);
+    for (size_t i = 0; i < command_count; i++) {
+        hostCommand.emplace_back(NAPA_STRING_REF_TO_STD_STRING(command[i]));
     }
+    zone::ProcessZone::SetHostCommand(std::move(hostCommand));
+}
 
-    req.options = spec.options;
+napa_result_code napa_zone_serve_process(napa_string_ref channel) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
 
-    // Assume ownership of transport context
-    req.transportContext.reset(reinterpret_cast<napa::transport::TransportContext*>(spec.transport_context));
+    return zone::ProcessZone::Serve(NAPA_STRING_REF_TO_STD_STRING(channel));
+}
 
+napa_result_code napa_zone_listen(napa_zone_handle handle, napa_string_ref address) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
 
-    handle->zone->Broadcast(req, [callback, context](Result result) {
-        napa_zone_result res;
-        res.code = result.code;
-        res.error_message = STD_STRING_TO_NAPA_STRING_REF(result.errorMessage);
-        res.return_value = STD_STRING_TO_NAPA_STRING_REF(result.returnValue);
+    if (!zone::RemoteZoneServer::Listen(handle->zone, NAPA_STRING_REF_TO_STD_STRING(address))) {
+        return NAPA_RESULT_INTERNAL_ERROR;
+    }
+    return NAPA_RESULT_SUCCESS;
+}
 
-        // Release ownership of transport context
-        res.transport_context = reinterpret_cast<void*>(result.transportContext.release());
+napa_result_code napa_zone_unlisten(napa_string_ref address) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
 
-        callback(res, context);
-    });
+    if (!zone::RemoteZoneServer::Unlisten(NAPA_STRING_REF_TO_STD_STRING(address))) {
+        return NAPA_RESULT_INTERNAL_ERROR;
+    }
+    return NAPA_RESULT_SUCCESS;
 }
 
-void napa_zone_execute(napa_zone_handle handle,
-                       napa_zone_function_spec spec,
-                       napa_zone_execute_callback callback,
-                       void* context) {
+napa_result_code napa_module_invalidate_cache(napa_string_ref path) {
+    // The cache is process wide and doesn't need the platform to be initialized.
+    auto& cache = module::ModuleResolverCache::Instance();
+    if (path.data == nullptr || path.size == 0) {
+        cache.Invalidate();
+    } else {
+        cache.Invalidate(filesystem::Path(NAPA_STRING_REF_TO_STD_STRING(path)).Absolute().Normalize());
+    }
+    return NAPA_RESULT_SUCCESS;
+}
+
+napa_result_code napa_module_write_bundle(
+    napa_string_ref path,
+    const napa_string_ref* names,
+    const napa_string_ref* from_paths,
+    size_t count) {
+    NAPA_ASSERT(count == 0 || (names != nullptr && from_paths != nullptr), "Names or context paths are null");
+
+    try {
+        module::ModuleResolver resolver;
+        module::ModuleBundleWriter writer;
+        for (size_t i = 0; i < count; ++i) {
+            auto name = NAPA_STRING_REF_TO_STD_STRING(names[i]);
+
+            // Workers resolve from the directory of the requiring module, which is absolute and normalized.
+            auto fromPath = filesystem::Path(NAPA_STRING_REF_TO_STD_STRING(from_paths[i])).Absolute().Normalize().String();
+            if (!writer.AddRequire(resolver, name, fromPath)) {
+                LOG_ERROR("Api", "Can't bundle require('%s') from '%s': it doesn't resolve to a file", name.c_str(), fromPath.c_str());
+                return NAPA_RESULT_MODULE_BUNDLE_ERROR;
+            }
+        }
+        writer.Write(NAPA_STRING_REF_TO_STD_STRING(path));
+    } catch (const std::exception& ex) {
+        LOG_ERROR("Api", "Failed to write module bundle: %s", ex.what());
+        return NAPA_RESULT_MODULE_BUNDLE_ERROR;
+    }
+    return NAPA_RESULT_SUCCESS;
+}
+
+napa_result_code napa_zone_get_cache_statistics(napa_zone_handle handle, napa_zone_cache_statistics* statistics) {
     NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
     NAPA_ASSERT(handle, "Zone handle is null");
     NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(statistics, "Statistics is null");
 
-    FunctionSpec req;
-    req.module = spec.module;
-    req.function = spec.function;
+    // Zones forwarding calls elsewhere, and the node zone, don't cache results themselves.
+    auto napaZone = std::dynamic_pointer_cast<zone::NapaZone>(handle->zone);
+    *statistics = napaZone != nullptr ? napaZone->GetCacheStatistics() : napa_zone_cache_statistics {};
+    return NAPA_RESULT_SUCCESS;
+}
 
-    req.arguments.reserve(spec.arguments_count);
-    for (size_t i = 0; i < spec.arguments_count; i++) {
-        req.arguments.emplace_back(spec.arguments[i]);
+napa_result_code napa_zone_get_idle_worker_count(napa_zone_handle handle, uint32_t* count) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(count, "Count is null");
+
+    auto napaZone = std::dynamic_pointer_cast<zone::NapaZone>(handle->zone);
+    if (napaZone == nullptr) {
+        return NAPA_RESULT_UNDEFINED;
     }
+    *count = napaZone->GetScheduler()->GetIdleWorkerCount();
+    return NAPA_RESULT_SUCCESS;
+}
 
-    req.options = spec.options;
+napa_result_code napa_zone_get_flow_statistics(
+    napa_zone_handle handle,
+    napa_zone_flow_statistics* statistics,
+    size_t capacity,
+    size_t* count) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(statistics != nullptr || capacity == 0, "Statistics is null");
+    NAPA_ASSERT(count, "Count is null");
 
-    // Assume ownership of transport context
-    req.transportContext.reset(reinterpret_cast<napa::transport::TransportContext*>(spec.transport_context));
+    auto napaZone = std::dynamic_pointer_cast<zone::NapaZone>(handle->zone);
+    if (napaZone == nullptr) {
+        return NAPA_RESULT_UNDEFINED;
+    }
 
-    handle->zone->Execute(req, [callback, context](Result result) {
-        napa_zone_result res;
-        res.code = result.code;
-        res.error_message = STD_STRING_TO_NAPA_STRING_REF(result.errorMessage);
-        res.return_value = STD_STRING_TO_NAPA_STRING_REF(result.returnValue);
+    auto flows = napaZone->GetFlowStatistics();
+    std::copy_n(flows.begin(), std::min(capacity, flows.size()), statistics);
+    *count = flows.size();
+    return NAPA_RESULT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////
+/// Implementation of completion queue C API
 
-        // Release ownership of transport context
-        res.transport_context = reinterpret_cast<void*>(result.transportContext.release());
+namespace {
 
-        callback(res, context);
-    });
+    /// <summary> Number of completions moved out of a queue under one lock acquisition. </summary>
+    const size_t COMPLETION_BATCH_SIZE = 32;
+
+    /// <summary> Moves completions out of a queue, waiting for the first one only if timeout is given. </summary>
+    size_t PopCompletions(zone::CompletionQueue& queue,
+                          napa_completion* completions,
+                          size_t max,
+                          const uint32_t* timeout) {
+        std::unique_ptr<zone::Completion> batch[COMPLETION_BATCH_SIZE];
+        size_t count = 0;
+        while (count < max) {
+            auto popped = queue.Pop(batch, std::min(max - count, COMPLETION_BATCH_SIZE), count == 0 ? timeout : nullptr);
+            for (size_t i = 0; i < popped; ++i, ++count) {
+                auto completion = batch[i].release();
+                completions[count].tag = completion->tag;
+                completions[count].result = ToZoneResult(completion->result);
+                completions[count].buffer = completion;
+            }
+            if (popped < COMPLETION_BATCH_SIZE) {
+                break;
+            }
+        }
+        return count;
+    }
+
+} // namespace
+
+/// <summary> Completion queue handle. Executions in flight keep the queue alive after the handle is released. </summary>
+struct napa_completion_queue {
+    std::shared_ptr<zone::CompletionQueue> queue;
+};
+
+napa_completion_queue_handle napa_completion_queue_create() {
+    return new napa_completion_queue { std::make_shared<zone::CompletionQueue>() };
+}
+
+napa_result_code napa_completion_queue_release(napa_completion_queue_handle cq) {
+    NAPA_ASSERT(cq, "Completion queue handle is null");
+
+    // Nobody can reap completions any more, executions in flight discard theirs.
+    cq->queue->Close();
+    delete cq;
+    return NAPA_RESULT_SUCCESS;
+}
+
+void napa_zone_execute_cq(napa_zone_handle handle,
+                          napa_zone_function_spec spec,
+                          napa_completion_queue_handle cq,
+                          void* tag) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(cq, "Completion queue handle is null");
+
+    auto req = ToFunctionSpec(spec);
+    handle->zone->Execute(req, zone::CompletionQueue::MakeCallback(cq->queue, tag));
+}
+
+size_t napa_completion_queue_poll(napa_completion_queue_handle cq,
+                                  napa_completion* completions,
+                                  size_t max_completions) {
+    NAPA_ASSERT(cq, "Completion queue handle is null");
+    NAPA_ASSERT(completions != nullptr || max_completions == 0, "Completions array is null");
+
+    return PopCompletions(*cq->queue, completions, max_completions, nullptr);
+}
+
+size_t napa_completion_queue_wait(napa_completion_queue_handle cq,
+                                  napa_completion* completions,
+                                  size_t max_completions,
+                                  uint32_t timeout) {
+    NAPA_ASSERT(cq, "Completion queue handle is null");
+    NAPA_ASSERT(completions != nullptr && max_completions > 0, "Completions array is empty");
+
+    return PopCompletions(*cq->queue, completions, max_completions, &timeout);
+}
+
+void napa_completion_release(napa_completion* completion) {
+    NAPA_ASSERT(completion, "Completion is null");
+
+    delete reinterpret_cast<zone::Completion*>(completion->buffer);
+    completion->buffer = nullptr;
 }
 
 static napa_result_code napa_initialize_common() {
@@ -11,6 +11,25 @@ using namespace napa::module;
 
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(CallContextWrap);
 
+namespace {
+    /// <summary> Make a V8 string of an argument without copying it, so workers of a broadcast share one copy. </summary>
+    v8::Local<v8::String> MakeArgumentString(
+        v8::Isolate* isolate,
+        const std::shared_ptr<const zone::CallArguments>& arguments,
+        size_t index) {
+        auto& argument = arguments->GetArguments()[index];
+        if (argument.size() < v8_helpers::MIN_EXTERNAL_STRING_LENGTH) {
+            return v8_helpers::MakeV8String(isolate, argument);
+        }
+
+        if (arguments->IsAsciiArgument(index)) {
+            return v8_helpers::MakeSharedExternalV8String(isolate, arguments, argument.data(), argument.size());
+        }
+        auto& utf16 = arguments->GetUtf16Argument(index);
+        return v8_helpers::MakeSharedExternalV8String(isolate, arguments, utf16.data(), utf16.size());
+    }
+}
+
 void CallContextWrap::Init() {
     auto isolate = v8::Isolate::GetCurrent();
     auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<CallContextWrap>);
@@ -114,11 +133,11 @@ void CallContextWrap::GetArgumentsCallback(v8::Local<v8::String> /*propertyName*
     auto context = isolate->GetCurrentContext();
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
 
-    auto& cppArgs = thisObject->GetRef().GetArguments();
-    auto jsArgs = v8::Array::New(isolate, static_cast<int>(cppArgs.size()));
-    for (size_t i = 0; i < cppArgs.size(); ++i) {
-        // TODO: Switch to 2-bytes external string.
-        (void)jsArgs->CreateDataProperty(context, static_cast<uint32_t>(i), v8_helpers::MakeV8String(isolate, cppArgs[i]));
+    auto& arguments = thisObject->GetRef().GetCallArguments();
+    auto count = arguments->GetArguments().size();
+    auto jsArgs = v8::Array::New(isolate, static_cast<int>(count));
+    for (size_t i = 0; i < count; ++i) {
+        (void)jsArgs->CreateDataProperty(context, static_cast<uint32_t>(i), MakeArgumentString(isolate, arguments, i));
     }
     args.GetReturnValue().Set(jsArgs);
 }
@@ -8,6 +8,7 @@
 #include "call-context-wrap.h"
 #include "lock-wrap.h"
 #include "metric-wrap.h"
+#include "pipeline-wrap.h"
 #include "shared-ptr-wrap.h"
 #include "store-wrap.h"
 #include "timer-wrap.h"
@@ -16,6 +17,7 @@
 
 #include <zone/worker-context.h>
 
+#include <napa/pipeline.h>
 #include <napa/zone.h>
 #include <napa/memory.h>
 #include <napa/module/binding.h>
@@ -103,18 +105,266 @@ static void GetCurrentZone(const v8::FunctionCallbackInfo<v8::Value>& args) {
     args.GetReturnValue().Set(ZoneWrap::NewInstance(napa::Zone::GetCurrent()));
 }
 
+static void SetProcessZoneHost(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args[0]->IsArray(), "first argument to setProcessZoneHost must be an array of strings");
+    auto command = napa::v8_helpers::V8ArrayToVector<std::string>(isolate, v8::Local<v8::Array>::Cast(args[0]));
+
+    std::vector<napa::StringRef> commandRefs;
+    commandRefs.reserve(command.size());
+    for (const auto& arg : command) {
+        commandRefs.emplace_back(STD_STRING_TO_NAPA_STRING_REF(arg));
+    }
+    napa_zone_set_process_host(commandRefs.data(), commandRefs.size());
+}
+
+static void ServeProcessZone(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to serveProcessZone must be a string");
+    v8::String::Utf8Value channel(args[0]->ToString());
+
+    // Blocks the calling thread, a helper process does nothing else.
+    auto code = napa_zone_serve_process(NAPA_STRING_REF(*channel));
+    JS_ENSURE(isolate, code == NAPA_RESULT_SUCCESS, "Failed to serve process zone: %s", napa_result_code_to_string(code));
+}
+
+static void UnlistenZone(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to unlisten must be a string");
+    v8::String::Utf8Value address(args[0]->ToString());
+
+    args.GetReturnValue().Set(napa::Zone::Unlisten(*address));
+}
+
+static void InvalidateModuleCache(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 0 || args[0]->IsUndefined() || args[0]->IsString(),
+        "first argument to invalidateModuleCache must be a string");
+
+    if (args.Length() == 0 || args[0]->IsUndefined()) {
+        napa_module_invalidate_cache(NAPA_STRING_REF(""));
+        return;
+    }
+    v8::String::Utf8Value path(args[0]->ToString());
+    napa_module_invalidate_cache(NAPA_STRING_REF(*path));
+}
+
+static void WriteModuleBundle(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 3, "3 arguments are required for \"writeModuleBundle\"");
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to writeModuleBundle must be a string");
+    CHECK_ARG(isolate, args[1]->IsArray() && args[2]->IsArray(), "names and context paths must be arrays");
+
+    auto names = v8::Local<v8::Array>::Cast(args[1]);
+    auto fromPaths = v8::Local<v8::Array>::Cast(args[2]);
+    CHECK_ARG(isolate, names->Length() == fromPaths->Length(), "each name must have a context path");
+
+    // Utf8 copies keep the strings alive while the string refs point to them.
+    std::vector<std::string> strings;
+    strings.reserve(names->Length() * 2);
+    for (uint32_t i = 0; i < names->Length(); ++i) {
+        auto name = names->Get(context, i).ToLocalChecked();
+        auto fromPath = fromPaths->Get(context, i).ToLocalChecked();
+        CHECK_ARG(isolate, name->IsString() && fromPath->IsString(), "names and context paths must be strings");
+        strings.emplace_back(*v8::String::Utf8Value(name));
+        strings.emplace_back(*v8::String::Utf8Value(fromPath));
+    }
+
+    std::vector<napa_string_ref> nameRefs;
+    std::vector<napa_string_ref> fromPathRefs;
+    for (size_t i = 0; i < strings.size(); i += 2) {
+        nameRefs.push_back(STD_STRING_TO_NAPA_STRING_REF(strings[i]));
+        fromPathRefs.push_back(STD_STRING_TO_NAPA_STRING_REF(strings[i + 1]));
+    }
+
+    v8::String::Utf8Value path(args[0]);
+    auto code = napa_module_write_bundle(NAPA_STRING_REF(*path), nameRefs.data(), fromPathRefs.data(), nameRefs.size());
+    JS_ENSURE(isolate, code == NAPA_RESULT_SUCCESS, "Failed to write module bundle \"%s\": %s", *path, napa_result_code_to_string(code));
+}
+
+/// <summary> Reads a pipeline stage from an object of { zone, module, function, options }. </summary>
+static bool GetPipelineStage(v8::Local<v8::Value> value, napa::PipelineStage& stage) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    JS_ENSURE_WITH_RETURN(isolate, value->IsObject(), false, "Each pipeline stage must be an object.");
+    auto object = v8::Local<v8::Object>::Cast(value);
+
+    auto readOption = [&](v8::Local<v8::Object> from, const char* name) {
+        auto maybe = from->Get(context, napa::v8_helpers::MakeV8String(isolate, name));
+        return maybe.IsEmpty() ? v8::Local<v8::Value>(v8::Undefined(isolate)) : maybe.ToLocalChecked();
+    };
+
+    auto zoneId = readOption(object, "zone");
+    JS_ENSURE_WITH_RETURN(isolate, zoneId->IsString(), false, "Property 'zone' of a pipeline stage must be a zone id.");
+
+    auto module = readOption(object, "module");
+    JS_ENSURE_WITH_RETURN(isolate, module->IsUndefined() || module->IsString(), false,
+        "Property 'module' of a pipeline stage must be a string.");
+
+    auto function = readOption(object, "function");
+    JS_ENSURE_WITH_RETURN(isolate, function->IsString(), false, "Property 'function' of a pipeline stage must be a string.");
+
+    auto options = readOption(object, "options");
+    if (!options->IsUndefined()) {
+        JS_ENSURE_WITH_RETURN(isolate, options->IsObject(), false, "Property 'options' of a pipeline stage must be an object.");
+        auto optionsObject = v8::Local<v8::Object>::Cast(options);
+
+        auto timeout = readOption(optionsObject, "timeout");
+        if (!timeout->IsUndefined()) {
+            stage.options.timeout = timeout->Uint32Value(context).FromJust();
+        }
+
+        auto hedgeAfterMs = readOption(optionsObject, "hedgeAfterMs");
+        if (!hedgeAfterMs->IsUndefined()) {
+            stage.options.hedge_after_ms = hedgeAfterMs->Uint32Value(context).FromJust();
+        }
+
+        auto cacheTtlMs = readOption(optionsObject, "cacheTtlMs");
+        if (!cacheTtlMs->IsUndefined()) {
+            stage.options.cache_ttl_ms = cacheTtlMs->Uint32Value(context).FromJust();
+        }
+
+        auto singleFlight = readOption(optionsObject, "singleFlight");
+        if (!singleFlight->IsUndefined()) {
+            stage.options.single_flight = singleFlight->BooleanValue() ? 1 : 0;
+        }
+
+        auto flowId = readOption(optionsObject, "flowId");
+        if (!flowId->IsUndefined()) {
+            stage.options.flow_id = flowId->Uint32Value(context).FromJust();
+        }
+
+        auto flowWeight = readOption(optionsObject, "flowWeight");
+        if (!flowWeight->IsUndefined()) {
+            stage.options.flow_weight = flowWeight->Uint32Value(context).FromJust();
+        }
+
+        auto accounting = readOption(optionsObject, "accounting");
+        if (!accounting->IsUndefined()) {
+            stage.options.accounting = accounting->BooleanValue() ? 1 : 0;
+        }
+
+        auto transport = readOption(optionsObject, "transport");
+        if (!transport->IsUndefined()) {
+            stage.options.transport = static_cast<napa::TransportOption>(transport->Uint32Value(context).FromJust());
+        }
+    }
+
+    auto id = napa::v8_helpers::V8ValueTo<std::string>(zoneId);
+    try {
+        stage.zone = napa::Zone::Get(id);
+    } catch (const std::runtime_error& ex) {
+        JS_ENSURE_WITH_RETURN(isolate, false, false, "%s", ex.what());
+    }
+
+    if (module->IsString()) {
+        stage.module = napa::v8_helpers::V8ValueTo<std::string>(module);
+    }
+    stage.function = napa::v8_helpers::V8ValueTo<std::string>(function);
+    return true;
+}
+
+static void CreatePipeline(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsArray(), "first argument to createPipeline must be an array of stages");
+    auto stagesArray = v8::Local<v8::Array>::Cast(args[0]);
+    CHECK_ARG(isolate, stagesArray->Length() > 0, "a pipeline must have at least one stage");
+
+    std::vector<napa::PipelineStage> stages(stagesArray->Length());
+    for (uint32_t i = 0; i < stagesArray->Length(); ++i) {
+        if (!GetPipelineStage(stagesArray->Get(context, i).ToLocalChecked(), stages[i])) {
+            return;
+        }
+    }
+
+    args.GetReturnValue().Set(PipelineWrap::NewInstance(std::make_unique<napa::Pipeline>(std::move(stages))));
+}
+
 /////////////////////////////////////////////////////////////////////
 /// Store APIs
 
+/// <summary> Reads optional store options from the 2nd argument of createStore/getOrCreateStore. </summary>
+static bool GetStoreOptions(const v8::FunctionCallbackInfo<v8::Value>& args, napa::store::StoreOptions& options) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    if (args.Length() < 2 || args[1]->IsUndefined()) {
+        return true;
+    }
+    JS_ENSURE_WITH_RETURN(isolate, args[1]->IsObject(), false, "Argument 'options' must be an object.");
+    auto object = v8::Local<v8::Object>::Cast(args[1]);
+
+    auto readOption = [&](const char* name) {
+        auto maybe = object->Get(context, napa::v8_helpers::MakeV8String(isolate, name));
+        return maybe.IsEmpty() ? v8::Local<v8::Value>(v8::Undefined(isolate)) : maybe.ToLocalChecked();
+    };
+
+    auto readNumber = [&](const char* name, double& value) {
+        auto option = readOption(name);
+        if (option->IsUndefined()) {
+            return true;
+        }
+        JS_ENSURE_WITH_RETURN(isolate, option->IsNumber() && option->NumberValue(context).FromJust() >= 0, false,
+            "Option '%s' must be a non-negative number.", name);
+        value = option->NumberValue(context).FromJust();
+        return true;
+    };
+
+    double maxEntries = 0, maxBytes = 0, ttl = 0, snapshotInterval = 0, compressThreshold = 0;
+    if (!readNumber("maxEntries", maxEntries)
+        || !readNumber("maxBytes", maxBytes)
+        || !readNumber("ttl", ttl)
+        || !readNumber("snapshotInterval", snapshotInterval)
+        || !readNumber("compressThreshold", compressThreshold)) {
+        return false;
+    }
+
+    auto snapshot = readOption("snapshot");
+    JS_ENSURE_WITH_RETURN(isolate, snapshot->IsUndefined() || snapshot->IsString(), false,
+        "Option 'snapshot' must be a string.");
+    JS_ENSURE_WITH_RETURN(isolate, snapshotInterval == 0 || snapshot->IsString(), false,
+        "Option 'snapshotInterval' requires option 'snapshot'.");
+
+    options.maxEntries = static_cast<size_t>(maxEntries);
+    options.maxBytes = static_cast<size_t>(maxBytes);
+    options.ttl = static_cast<uint32_t>(ttl);
+    options.compressThreshold = static_cast<size_t>(compressThreshold);
+    if (snapshot->IsString()) {
+        options.snapshotPath = napa::v8_helpers::V8ValueTo<std::string>(snapshot);
+        options.snapshotInterval = static_cast<uint32_t>(snapshotInterval);
+    }
+    return true;
+}
+
 static void CreateStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
 
-    CHECK_ARG(isolate, args.Length() == 1, "1 argument of 'id' is required.");
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "Argument 'id' and optional argument 'options' are required.");
     CHECK_ARG(isolate, args[0]->IsString(), "Argument 'id' must be string.");
 
+    napa::store::StoreOptions options;
+    if (!GetStoreOptions(args, options)) {
+        return;
+    }
+
     auto id = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
-    auto store = napa::store::CreateStore(id.c_str());
+    auto store = napa::store::CreateStore(id.c_str(), options);
 
     JS_ENSURE(isolate, store != nullptr, "Store with id \"%s\" already exists.", id.c_str());
 
@@ -125,11 +375,16 @@ static void GetOrCreateStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
 
-    CHECK_ARG(isolate, args.Length() == 1, "1 argument of 'id' is required.");
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "Argument 'id' and optional argument 'options' are required.");
     CHECK_ARG(isolate, args[0]->IsString(), "Argument 'id' must be string.");
 
+    napa::store::StoreOptions options;
+    if (!GetStoreOptions(args, options)) {
+        return;
+    }
+
     auto id = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
-    auto store = napa::store::GetOrCreateStore(id.c_str());
+    auto store = napa::store::GetOrCreateStore(id.c_str(), options);
 
     args.GetReturnValue().Set(StoreWrap::NewInstance(store));
 }
@@ -149,6 +404,51 @@ static void GetStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
     }
 }
 
+static void CreateSharedStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "Argument 'id' and optional argument 'options' are required.");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'id' must be string.");
+
+    napa::store::StoreOptions options;
+    if (!GetStoreOptions(args, options)) {
+        return;
+    }
+
+    auto id = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
+    std::shared_ptr<napa::store::Store> store;
+    try {
+        store = napa::store::CreateSharedStore(id.c_str(), options);
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
+
+    JS_ENSURE(isolate, store != nullptr, "Shared store with id \"%s\" already exists.", id.c_str());
+
+    args.GetReturnValue().Set(StoreWrap::NewInstance(store));
+}
+
+static void GetSharedStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument of 'id' is required.");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'id' must be string.");
+
+    auto id = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
+    std::shared_ptr<napa::store::Store> store;
+    try {
+        store = napa::store::GetSharedStore(id.c_str());
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
+
+    if (store != nullptr) {
+        args.GetReturnValue().Set(StoreWrap::NewInstance(store));
+    }
+}
+
 static void GetStoreCount(const v8::FunctionCallbackInfo<v8::Value>& args) {
     args.GetReturnValue().Set(static_cast<uint32_t>(napa::store::GetStoreCount()));
 }
@@ -285,6 +585,11 @@ static void SetImmediate(const v8::FunctionCallbackInfo<v8::Value>& args) {
 static void SetTimers(const v8::FunctionCallbackInfo<v8::Value>& args) {
     TimerWrap::SetTimersCallback(args);
 }
+
+// Clear Timeout or Clear Interval
+static void ClearTimers(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    TimerWrap::ClearTimersCallback(args);
+}
 #endif
 
 
@@ -294,6 +599,7 @@ static void InitNapaOnlyBindings(v8::Local<v8::Object> exports) {
 
     NAPA_SET_METHOD(exports, "setImmediate", SetImmediate);
     NAPA_SET_METHOD(exports, "setTimers", SetTimers);
+    NAPA_SET_METHOD(exports, "clearTimers", ClearTimers);
 #endif
 }
 
@@ -306,6 +612,7 @@ void binding::Init(v8::Local<v8::Object> exports, v8::Local<v8::Object> module)
     CallContextWrap::Init();
     LockWrap::Init();
     MetricWrap::Init();
+    PipelineWrap::Init();
     SharedPtrWrap::Init();
     StoreWrap::Init();
     TransportContextWrapImpl::Init();
@@ -322,11 +629,20 @@ void binding::Init(v8::Local<v8::Object> exports, v8::Local<v8::Object> module)
     NAPA_SET_METHOD(exports, "createZone", CreateZone);
     NAPA_SET_METHOD(exports, "getZone", GetZone);
     NAPA_SET_METHOD(exports, "getCurrentZone", GetCurrentZone);
+    NAPA_SET_METHOD(exports, "createPipeline", CreatePipeline);
+    NAPA_SET_METHOD(exports, "setProcessZoneHost", SetProcessZoneHost);
+    NAPA_SET_METHOD(exports, "serveProcessZone", ServeProcessZone);
+    NAPA_SET_METHOD(exports, "unlisten", UnlistenZone);
+
+    NAPA_SET_METHOD(exports, "invalidateModuleCache", InvalidateModuleCache);
+    NAPA_SET_METHOD(exports, "writeModuleBundle", WriteModuleBundle);
 
     NAPA_SET_METHOD(exports, "createStore", CreateStore);
     NAPA_SET_METHOD(exports, "getOrCreateStore", GetOrCreateStore);
     NAPA_SET_METHOD(exports, "getStore", GetStore);
     NAPA_SET_METHOD(exports, "getStoreCount", GetStoreCount);
+    NAPA_SET_METHOD(exports, "createSharedStore", CreateSharedStore);
+    NAPA_SET_METHOD(exports, "getSharedStore", GetSharedStore);
 
     NAPA_SET_METHOD(exports, "createLock", CreateLock);
     
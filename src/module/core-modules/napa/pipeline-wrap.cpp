@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "pipeline-wrap.h"
+#include "transport-context-wrap-impl.h"
+#include "zone-wrap.h"
+
+#include <napa/async.h>
+#include <napa/pipeline.h>
+#include <napa/v8-helpers.h>
+
+#include <string>
+#include <vector>
+
+using namespace napa::module;
+using namespace napa::v8_helpers;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(PipelineWrap);
+
+void PipelineWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    // Prepare constructor template.
+    auto functionTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<PipelineWrap>);
+    functionTemplate->SetClassName(MakeV8String(isolate, exportName));
+    functionTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    // Prototypes.
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getStageCount", GetStageCount);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "execute", Execute);
+
+    // Set persistent constructor into V8.
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, functionTemplate->GetFunction());
+}
+
+v8::Local<v8::Object> PipelineWrap::NewInstance(std::unique_ptr<napa::Pipeline> pipeline) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto constructor = NAPA_GET_PERSISTENT_CONSTRUCTOR(exportName, PipelineWrap);
+    auto object = constructor->NewInstance(context).ToLocalChecked();
+    auto wrap = NAPA_OBJECTWRAP::Unwrap<PipelineWrap>(object);
+
+    wrap->_pipeline = std::move(pipeline);
+    return object;
+}
+
+void PipelineWrap::GetStageCount(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    auto wrap = ObjectWrap::Unwrap<PipelineWrap>(args.Holder());
+
+    args.GetReturnValue().Set(v8::Uint32::NewFromUnsigned(isolate, static_cast<uint32_t>(wrap->_pipeline->GetStageCount())));
+}
+
+void PipelineWrap::Execute(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsArray(), "first argument to pipeline.execute must be the marshalled arguments");
+    CHECK_ARG(isolate, args[1]->IsNull() || args[1]->IsObject(), "second argument to pipeline.execute must be null or a transport context");
+    CHECK_ARG(isolate, args[2]->IsFunction(), "third argument to pipeline.execute must be the callback");
+
+    auto arguments = V8ArrayToVector<std::string>(isolate, v8::Local<v8::Array>::Cast(args[0]));
+
+    std::unique_ptr<napa::transport::TransportContext> transportContext;
+    if (!args[1]->IsNull()) {
+        auto transportContextWrap = NAPA_OBJECTWRAP::Unwrap<TransportContextWrapImpl>(args[1]->ToObject(context).ToLocalChecked());
+        transportContext.reset(transportContextWrap->Get());
+    }
+
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[2]),
+        [&args, &arguments, &transportContext](std::function<void(void*)> complete) {
+            auto wrap = ObjectWrap::Unwrap<PipelineWrap>(args.Holder());
+
+            wrap->_pipeline->Execute(
+                std::move(arguments),
+                std::move(transportContext),
+                [complete = std::move(complete)](napa::Result result) {
+                    complete(new napa::Result(std::move(result)));
+                });
+        },
+        [](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto result = static_cast<napa::Result*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(ZoneWrap::CreateResponseObject(*result));
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete result;
+        }
+    );
+}
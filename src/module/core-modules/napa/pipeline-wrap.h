@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+
+#include <memory>
+
+// Forward declare pipeline.
+namespace napa {
+    class Pipeline;
+}
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap to expose pipeline APIs. </summary>
+    class PipelineWrap : public NAPA_OBJECTWRAP {
+    public:
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "PipelineWrap";
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Create a new PipelineWrap instance that wraps the provided pipeline. </summary>
+        static v8::Local<v8::Object> NewInstance(std::unique_ptr<napa::Pipeline> pipeline);
+
+    private:
+
+        /// <summary> Declare persistent constructor to create Pipeline Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+        std::unique_ptr<napa::Pipeline> _pipeline;
+
+        // PipelineWrap methods
+        static void GetStageCount(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Execute(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> Friend default constructor callback. </summary>
+        template <typename WrapType>
+        friend void napa::module::DefaultConstructorCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+    };
+}
+}
@@ -4,9 +4,238 @@
 #include "store-wrap.h"
 #include <napa/transport.h>
 
+#ifdef BUILDING_NODE_EXTENSION
+#include <uv.h>
+#else
+#include <zone/napa-zone.h>
+#include <zone/scheduler.h>
+#include <zone/task.h>
+#include <zone/worker-context.h>
+#endif
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 using namespace napa::module;
 
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(StoreWrap);
+
+namespace {
+    /// <summary> Marshall a JS value into a store value. </summary>
+    /// <returns> Empty pointer if marshalling threw, with the exception pending. </returns>
+    std::shared_ptr<napa::store::Store::ValueType> MarshallValue(v8::Local<v8::Value> value) {
+        napa::transport::TransportContext transportContext;
+        auto marshalled = napa::transport::Marshall(value, &transportContext);
+        if (marshalled.IsEmpty()) {
+            return nullptr;
+        }
+
+        // JSON is mostly ASCII, so most payloads are kept as Latin-1 at half the size of UTF-16.
+        napa::store::Payload payload;
+        auto json = marshalled.ToLocalChecked();
+        if (json->ContainsOnlyOneByte()) {
+            std::string latin1(json->Length(), '\0');
+            if (!latin1.empty()) {
+                json->WriteOneByte(
+                    v8::Isolate::GetCurrent(), reinterpret_cast<uint8_t*>(&latin1[0]), 0, -1, v8::String::NO_NULL_TERMINATION);
+            }
+            payload = napa::store::Payload::FromLatin1(std::move(latin1));
+        } else {
+            payload = napa::v8_helpers::V8ValueTo<std::u16string>(json);
+        }
+
+        return std::make_shared<napa::store::Store::ValueType>(napa::store::Store::ValueType {
+            std::move(payload),
+            std::move(transportContext)
+        });
+    }
+
+    /// <summary> Unmarshall a store value into a JS value. An empty store value unmarshalls to undefined. </summary>
+    v8::MaybeLocal<v8::Value> UnmarshallValue(
+        v8::Isolate* isolate,
+        const std::shared_ptr<napa::store::Store::ValueType>& storeValue) {
+        if (storeValue == nullptr) {
+            return v8::Undefined(isolate);
+        }
+        // The string keeps the store value alive, which may be replaced in store while V8 still references it.
+        const auto& payload = storeValue->payload;
+        return napa::transport::Unmarshall(
+            payload.IsOneByte()
+                ? napa::v8_helpers::MakeSharedExternalV8String(
+                    isolate, storeValue, payload.GetOneByte().data(), payload.GetOneByte().size())
+                : napa::v8_helpers::MakeSharedExternalV8String(
+                    isolate, storeValue, payload.GetTwoByte().data(), payload.GetTwoByte().size()),
+            &(storeValue->transportContext));
+    }
+
+    /// <summary> A JS watch callback and how to reach the isolate that registered it. </summary>
+    struct WatchContext {
+        std::weak_ptr<napa::store::Store> store;
+        v8::Isolate* isolate;
+        v8::Persistent<v8::Function> callback;
+        v8::Persistent<v8::Context> context;
+
+        /// <summary> Cleared by unwatch, so notifications already queued are dropped. </summary>
+        std::atomic<bool> active { true };
+
+#ifdef BUILDING_NODE_EXTENSION
+        /// <summary> Async handle to wake up node event loop, closed by unwatch. </summary>
+        uv_async_t* async;
+
+        /// <summary> Notifications not yet delivered. uv_async_send coalesces, so they are queued here. </summary>
+        std::vector<std::pair<std::string, uint64_t>> pending;
+        std::mutex pendingAccess;
+#else
+        std::weak_ptr<napa::zone::Scheduler> scheduler;
+        napa::zone::WorkerId workerId;
+#endif
+    };
+
+    /// <summary> Watches registered in this process by watch id, to release JS handles on unwatch. </summary>
+    std::unordered_map<uint64_t, std::shared_ptr<WatchContext>> _watches;
+    std::mutex _watchesAccess;
+
+#ifndef BUILDING_NODE_EXTENSION
+    /// <summary> Isolates that registered a release of their watches on worker exit. </summary>
+    std::unordered_set<v8::Isolate*> _watchingIsolates;
+#endif
+
+    /// <summary> Call JS watch callback with (key, version) in the isolate that registered it. </summary>
+    void InvokeWatchCallback(WatchContext& watch, const std::string& key, uint64_t version) {
+        if (!watch.active) {
+            return;
+        }
+
+        auto isolate = watch.isolate;
+        v8::HandleScope scope(isolate);
+        auto context = v8::Local<v8::Context>::New(isolate, watch.context);
+        v8::Context::Scope contextScope(context);
+
+        v8::Local<v8::Value> argv[] = {
+            napa::v8_helpers::MakeV8String(isolate, key),
+            v8::Number::New(isolate, static_cast<double>(version))
+        };
+        (void)v8::Local<v8::Function>::New(isolate, watch.callback)->Call(context, context->Global(), 2, argv);
+    }
+
+#ifdef BUILDING_NODE_EXTENSION
+    /// <summary> Deliver queued notifications in node event loop. </summary>
+    void RunWatchNotifications(uv_async_t* async) {
+        auto watch = static_cast<WatchContext*>(async->data);
+
+        std::vector<std::pair<std::string, uint64_t>> pending;
+        {
+            std::lock_guard<std::mutex> lock(watch->pendingAccess);
+            pending.swap(watch->pending);
+        }
+        for (const auto& notification : pending) {
+            InvokeWatchCallback(*watch, notification.first, notification.second);
+        }
+    }
+#else
+    /// <summary> A task delivering one notification on the watching worker. </summary>
+    class WatchNotificationTask : public napa::zone::Task {
+    public:
+        WatchNotificationTask(std::shared_ptr<WatchContext> watch, std::string key, uint64_t version)
+            : _watch(std::move(watch)), _key(std::move(key)), _version(version) {}
+
+        void Execute() override {
+            InvokeWatchCallback(*_watch, _key, _version);
+        }
+
+    private:
+        std::shared_ptr<WatchContext> _watch;
+        std::string _key;
+        uint64_t _version;
+    };
+#endif
+
+    /// <summary> Make a store watch callback that posts notifications to the calling isolate. </summary>
+    /// <returns> Empty function if the calling thread can't receive notifications. </returns>
+    napa::store::Store::WatchCallback MakeWatchCallback(std::shared_ptr<WatchContext> watch) {
+#ifdef BUILDING_NODE_EXTENSION
+        watch->async = new uv_async_t();
+        watch->async->data = watch.get();
+        uv_async_init(uv_default_loop(), watch->async, RunWatchNotifications);
+
+        // A watch alone doesn't keep node process alive.
+        uv_unref(reinterpret_cast<uv_handle_t*>(watch->async));
+
+        return [watch](const std::string& key, uint64_t version) {
+            std::lock_guard<std::mutex> lock(watch->pendingAccess);
+            if (watch->active) {
+                watch->pending.emplace_back(key, version);
+                uv_async_send(watch->async);
+            }
+        };
+#else
+        auto zone = reinterpret_cast<napa::zone::NapaZone*>(
+            napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::ZONE));
+        if (zone == nullptr) {
+            return nullptr;
+        }
+        watch->scheduler = zone->GetScheduler();
+        watch->workerId = static_cast<napa::zone::WorkerId>(
+            reinterpret_cast<uintptr_t>(napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::WORKER_ID)));
+
+        return [watch](const std::string& key, uint64_t version) {
+            auto scheduler = watch->scheduler.lock();
+            if (scheduler != nullptr && watch->active) {
+                scheduler->ScheduleOnWorker(
+                    watch->workerId,
+                    std::make_shared<WatchNotificationTask>(watch, key, version));
+            }
+        };
+#endif
+    }
+
+    /// <summary> Stop delivering notifications and release JS handles. Called on the thread that registered the watch. </summary>
+    void ReleaseWatch(std::shared_ptr<WatchContext> watch) {
+#ifdef BUILDING_NODE_EXTENSION
+        {
+            std::lock_guard<std::mutex> lock(watch->pendingAccess);
+            watch->active = false;
+        }
+        uv_close(reinterpret_cast<uv_handle_t*>(watch->async), [](uv_handle_t* handle) {
+            delete reinterpret_cast<uv_async_t*>(handle);
+        });
+#else
+        watch->active = false;
+#endif
+        watch->callback.Reset();
+        watch->context.Reset();
+    }
+
+#ifndef BUILDING_NODE_EXTENSION
+    /// <summary> Unwatch and release all watches of an isolate. Called by its worker on exit, before the isolate is disposed. </summary>
+    void ReleaseIsolateWatches(v8::Isolate* isolate) {
+        std::vector<std::pair<uint64_t, std::shared_ptr<WatchContext>>> watches;
+        {
+            std::lock_guard<std::mutex> lock(_watchesAccess);
+            for (auto it = _watches.begin(); it != _watches.end();) {
+                if (it->second->isolate == isolate) {
+                    watches.emplace_back(it->first, std::move(it->second));
+                    it = _watches.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            _watchingIsolates.erase(isolate);
+        }
+
+        for (auto& watch : watches) {
+            auto store = watch.second->store.lock();
+            if (store != nullptr) {
+                store->Unwatch(watch.first);
+            }
+            ReleaseWatch(std::move(watch.second));
+        }
+    }
+#endif
+}
     
 void StoreWrap::Init() {
     auto isolate = v8::Isolate::GetCurrent();
@@ -18,8 +247,19 @@ void StoreWrap::Init() {
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "get", GetCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "has", HasCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "delete", DeleteCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "getMany", GetManyCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "setMany", SetManyCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "version", VersionCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "compareAndSet", CompareAndSetCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "increment", IncrementCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "getOrCompute", GetOrComputeCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "save", SaveCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "load", LoadCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "watch", WatchCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "unwatch", UnwatchCallback);
     NAPA_SET_ACCESSOR(constructorTemplate, "id", GetIdCallback, nullptr);
     NAPA_SET_ACCESSOR(constructorTemplate, "size", GetSizeCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "statistics", GetStatisticsCallback, nullptr);
 
     NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructorTemplate->GetFunction());
 }
@@ -39,24 +279,31 @@ void StoreWrap::SetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
     
-    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"set\".");
+    CHECK_ARG(isolate, args.Length() == 2 || args.Length() == 3, "2 or 3 arguments are required for \"set\".");
     CHECK_ARG(isolate, args[0]->IsString(), "Argument \"key\" must be string.");
+    CHECK_ARG(isolate, args.Length() == 2 || args[2]->IsUndefined() || args[2]->IsUint32(),
+        "Argument \"ttl\" must be a non-negative integer.");
 
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
     auto& store = thisObject->Get();
 
     // Marshall value object into payload.
-    napa::transport::TransportContext transportContext;
-    auto payload = napa::transport::Marshall(args[1], &transportContext);
-    
-    RETURN_ON_PENDING_EXCEPTION(payload);
-    
-    store.Set(
-        v8_helpers::V8ValueTo<std::string>(args[0]).c_str(),
-        std::make_shared<napa::store::Store::ValueType>(napa::store::Store::ValueType {
-            v8_helpers::V8ValueTo<std::u16string>(payload.ToLocalChecked()),
-            std::move(transportContext)
-        }));
+    auto value = MarshallValue(args[1]);
+    if (value == nullptr) {
+        return;
+    }
+
+    auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
+
+    try {
+        if (args.Length() == 3 && args[2]->IsUint32()) {
+            store.Set(key.c_str(), std::move(value), args[2]->Uint32Value());
+        } else {
+            store.Set(key.c_str(), std::move(value));
+        }
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
 }
 
 void StoreWrap::GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -69,13 +316,11 @@ void StoreWrap::GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
     auto& store = thisObject->Get();
 
-    // Marshall value object into payload.
+    // Unmarshall payload into value object.
     auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
     auto storeValue = store.Get(key.c_str());
     if (storeValue != nullptr) {
-        auto value = napa::transport::Unmarshall(
-            v8_helpers::MakeExternalV8String(isolate, storeValue->payload), 
-            &(storeValue->transportContext));
+        auto value = UnmarshallValue(isolate, storeValue);
 
         RETURN_ON_PENDING_EXCEPTION(value);
         args.GetReturnValue().Set(value.ToLocalChecked());
@@ -108,6 +353,298 @@ void StoreWrap::DeleteCallback(const v8::FunctionCallbackInfo<v8::Value>& args)
     store.Delete(v8_helpers::V8ValueTo<std::string>(args[0]).c_str());
 }
 
+void StoreWrap::GetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"getMany\".");
+    CHECK_ARG(isolate, args[0]->IsArray(), "Argument 'keys' must be an array of string.");
+
+    auto keyArray = v8::Local<v8::Array>::Cast(args[0]);
+    std::vector<std::string> keys;
+    keys.reserve(keyArray->Length());
+    for (uint32_t i = 0; i < keyArray->Length(); ++i) {
+        auto key = keyArray->Get(context, i).ToLocalChecked();
+        CHECK_ARG(isolate, key->IsString(), "Argument 'keys' must be an array of string.");
+        keys.push_back(v8_helpers::V8ValueTo<std::string>(key));
+    }
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto storeValues = thisObject->Get().GetMany(keys);
+
+    auto result = v8::Array::New(isolate, static_cast<int>(storeValues.size()));
+    for (uint32_t i = 0; i < storeValues.size(); ++i) {
+        auto value = UnmarshallValue(isolate, storeValues[i]);
+        RETURN_ON_PENDING_EXCEPTION(value);
+        (void)result->Set(context, i, value.ToLocalChecked());
+    }
+    args.GetReturnValue().Set(result);
+}
+
+void StoreWrap::SetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"setMany\".");
+    CHECK_ARG(isolate, args[0]->IsObject() && !args[0]->IsArray(), "Argument 'values' must be an object of key to value.");
+
+    auto object = v8::Local<v8::Object>::Cast(args[0]);
+    auto names = object->GetOwnPropertyNames(context);
+    RETURN_ON_PENDING_EXCEPTION(names);
+
+    auto keys = names.ToLocalChecked();
+    std::vector<napa::store::Store::KeyValueType> values;
+    values.reserve(keys->Length());
+    for (uint32_t i = 0; i < keys->Length(); ++i) {
+        auto key = keys->Get(context, i).ToLocalChecked();
+        auto maybeValue = object->Get(context, key);
+        RETURN_ON_PENDING_EXCEPTION(maybeValue);
+
+        auto value = MarshallValue(maybeValue.ToLocalChecked());
+        if (value == nullptr) {
+            return;
+        }
+        values.emplace_back(v8_helpers::V8ValueTo<std::string>(key), std::move(value));
+    }
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    try {
+        thisObject->Get().SetMany(std::move(values));
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
+}
+
+void StoreWrap::VersionCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"version\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto version = thisObject->Get().GetVersion(v8_helpers::V8ValueTo<std::string>(args[0]).c_str());
+    args.GetReturnValue().Set(static_cast<double>(version));
+}
+
+void StoreWrap::CompareAndSetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 3, "3 arguments are required for \"compareAndSet\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+    CHECK_ARG(isolate, args[2]->IsNumber() && args[2]->NumberValue(context).FromJust() >= 0,
+        "Argument 'version' must be a non-negative number.");
+
+    auto value = MarshallValue(args[1]);
+    if (value == nullptr) {
+        return;
+    }
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    try {
+        auto version = thisObject->Get().CompareAndSet(
+            v8_helpers::V8ValueTo<std::string>(args[0]).c_str(),
+            std::move(value),
+            static_cast<uint64_t>(args[2]->NumberValue(context).FromJust()));
+        args.GetReturnValue().Set(version != 0);
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
+}
+
+void StoreWrap::IncrementCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "1 or 2 arguments are required for \"increment\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+    CHECK_ARG(isolate, args.Length() == 1 || args[1]->IsUndefined() || args[1]->IsNumber(),
+        "Argument 'delta' must be a number.");
+
+    double delta = 1;
+    if (args.Length() == 2 && args[1]->IsNumber()) {
+        delta = args[1]->NumberValue(context).FromJust();
+    }
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
+
+    double result = 0;
+    bool incremented = false;
+    try {
+        incremented = thisObject->Get().Increment(key.c_str(), delta, result);
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
+    JS_ENSURE(isolate, incremented, "Value of key \"%s\" is not a number or the result is not finite.", key.c_str());
+
+    args.GetReturnValue().Set(result);
+}
+
+void StoreWrap::GetOrComputeCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"getOrCompute\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+    CHECK_ARG(isolate, args[1]->IsFunction(), "Argument 'compute' must be a function.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+    auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
+
+    auto storeValue = store.Get(key.c_str());
+    if (storeValue == nullptr) {
+        // Compute outside of the store lock, then the first writer wins if multiple workers race on the key.
+        auto computed = v8::Local<v8::Function>::Cast(args[1])->Call(context, v8::Undefined(isolate), 0, nullptr);
+        RETURN_ON_PENDING_EXCEPTION(computed);
+
+        auto value = MarshallValue(computed.ToLocalChecked());
+        if (value == nullptr) {
+            return;
+        }
+
+        // The miss is already counted by Get, so set with CompareAndSet which doesn't count the access again.
+        // Only if another writer won the race, GetOrSet reads its value, which counts as a hit.
+        try {
+            if (store.CompareAndSet(key.c_str(), value, 0) != 0) {
+                args.GetReturnValue().Set(computed.ToLocalChecked());
+                return;
+            }
+            storeValue = store.GetOrSet(key.c_str(), value);
+        } catch (const std::exception& ex) {
+            JS_FAIL(isolate, "%s", ex.what());
+        }
+        if (storeValue == value) {
+            args.GetReturnValue().Set(computed.ToLocalChecked());
+            return;
+        }
+    }
+
+    auto value = UnmarshallValue(isolate, storeValue);
+    RETURN_ON_PENDING_EXCEPTION(value);
+    args.GetReturnValue().Set(value.ToLocalChecked());
+}
+
+void StoreWrap::SaveCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"save\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'path' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto path = v8_helpers::V8ValueTo<std::string>(args[0]);
+    try {
+        args.GetReturnValue().Set(static_cast<uint32_t>(thisObject->Get().Save(path.c_str())));
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
+}
+
+void StoreWrap::LoadCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"load\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'path' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto path = v8_helpers::V8ValueTo<std::string>(args[0]);
+    try {
+        args.GetReturnValue().Set(static_cast<uint32_t>(thisObject->Get().Load(path.c_str())));
+    } catch (const std::exception& ex) {
+        JS_FAIL(isolate, "%s", ex.what());
+    }
+}
+
+void StoreWrap::WatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"watch\".");
+    CHECK_ARG(isolate, args[0]->IsString() || args[0]->IsObject(),
+        "Argument 'key' must be string or an object of { prefix: string }.");
+    CHECK_ARG(isolate, args[1]->IsFunction(), "Argument 'callback' must be function.");
+
+    std::string key;
+    bool isPrefix = false;
+    if (args[0]->IsString()) {
+        key = v8_helpers::V8ValueTo<std::string>(args[0]);
+    } else {
+        auto prefix = args[0].As<v8::Object>()->Get(context, v8_helpers::MakeV8String(isolate, "prefix"));
+        RETURN_ON_PENDING_EXCEPTION(prefix);
+        CHECK_ARG(isolate, prefix.ToLocalChecked()->IsString(), "Property 'prefix' must be string.");
+        key = v8_helpers::V8ValueTo<std::string>(prefix.ToLocalChecked());
+        isPrefix = true;
+    }
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto watch = std::make_shared<WatchContext>();
+    watch->store = thisObject->_store;
+    watch->isolate = isolate;
+    watch->callback.Reset(isolate, args[1].As<v8::Function>());
+    watch->context.Reset(isolate, context);
+
+    auto callback = MakeWatchCallback(watch);
+    if (callback == nullptr) {
+        watch->callback.Reset();
+        watch->context.Reset();
+        JS_FAIL(isolate, "\"watch\" can only be called in a zone worker.");
+    }
+
+    auto watchId = thisObject->Get().Watch(key.c_str(), isPrefix, std::move(callback));
+    {
+        std::lock_guard<std::mutex> lock(_watchesAccess);
+        _watches.emplace(watchId, std::move(watch));
+
+#ifndef BUILDING_NODE_EXTENSION
+        // Watches not unwatched by JS are released when the worker stops, while the isolate is still alive.
+        if (_watchingIsolates.insert(isolate).second) {
+            napa::zone::WorkerContext::AddExitCallback([isolate]() {
+                ReleaseIsolateWatches(isolate);
+            });
+        }
+#endif
+    }
+    args.GetReturnValue().Set(static_cast<double>(watchId));
+}
+
+void StoreWrap::UnwatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"unwatch\".");
+    CHECK_ARG(isolate, args[0]->IsNumber(), "Argument 'watchId' must be number.");
+
+    auto watchId = static_cast<uint64_t>(args[0]->NumberValue(context).FromJust());
+    auto& store = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder())->Get();
+
+    std::shared_ptr<WatchContext> watch;
+    {
+        std::lock_guard<std::mutex> lock(_watchesAccess);
+        auto it = _watches.find(watchId);
+        if (it == _watches.end() || it->second->store.lock().get() != &store) {
+            return;
+        }
+        CHECK_ARG(isolate, it->second->isolate == isolate, "\"unwatch\" must be called by the isolate that called \"watch\".");
+        watch = std::move(it->second);
+        _watches.erase(it);
+    }
+
+    // No notification is posted after Unwatch returns.
+    store.Unwatch(watchId);
+    ReleaseWatch(std::move(watch));
+}
+
 void StoreWrap::GetIdCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
@@ -128,3 +665,30 @@ void StoreWrap::GetSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbac
     args.GetReturnValue().Set(static_cast<uint32_t>(store.Size()));
 }
 
+
+void StoreWrap::GetStatisticsCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto statistics = thisObject->Get().GetStatistics();
+
+    auto result = v8::Object::New(isolate);
+    (void)result->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "hits"),
+        v8::Number::New(isolate, static_cast<double>(statistics.hits)));
+    (void)result->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "misses"),
+        v8::Number::New(isolate, static_cast<double>(statistics.misses)));
+    (void)result->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "evictions"),
+        v8::Number::New(isolate, static_cast<double>(statistics.evictions)));
+    (void)result->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "expirations"),
+        v8::Number::New(isolate, static_cast<double>(statistics.expirations)));
+    (void)result->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "bytes"),
+        v8::Number::New(isolate, static_cast<double>(statistics.bytes)));
+    (void)result->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "rawBytes"),
+        v8::Number::New(isolate, static_cast<double>(statistics.rawBytes)));
+    (void)result->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "compressedBytes"),
+        v8::Number::New(isolate, static_cast<double>(statistics.compressedBytes)));
+
+    args.GetReturnValue().Set(result);
+}
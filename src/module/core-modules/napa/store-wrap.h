@@ -31,7 +31,7 @@ namespace module {
         StoreWrap(const StoreWrap&) = delete;
         StoreWrap& operator=(const StoreWrap&) = delete;
 
-        /// <summary> It implements Store.set(key: string, value: any): void </summary>
+        /// <summary> It implements Store.set(key: string, value: any, ttl?: number): void </summary>
         static void SetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
         /// <summary> It implements Store.get(key: string): any </summary>
@@ -43,11 +43,44 @@ namespace module {
         /// <summary> It implements Store.delete(key: string): void </summary>
         static void DeleteCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+        /// <summary> It implements Store.getMany(keys: string[]): any[] </summary>
+        static void GetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.setMany(values: { [key: string]: any }): void </summary>
+        static void SetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.version(key: string): number </summary>
+        static void VersionCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.compareAndSet(key: string, value: any, version: number): boolean </summary>
+        static void CompareAndSetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.increment(key: string, delta?: number): number </summary>
+        static void IncrementCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.getOrCompute(key: string, compute: () => any): any </summary>
+        static void GetOrComputeCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.save(path: string): number </summary>
+        static void SaveCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.load(path: string): number </summary>
+        static void LoadCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.watch(key: string | { prefix: string }, callback: (key: string, version: number) => void): number </summary>
+        static void WatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.unwatch(watchId: number): void </summary>
+        static void UnwatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
         /// <summary> It implements Store.id </summary>
         static void GetIdCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args);
 
         /// <summary> It implements Store.size </summary>
         static void GetSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.statistics </summary>
+        static void GetStatisticsCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args);
         
         /// <summary> Friend default constructor callback. </summary>
         template <typename T>
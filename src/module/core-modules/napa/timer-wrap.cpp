@@ -6,6 +6,7 @@
 #include <node.h>
 #endif
 
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -84,25 +85,20 @@ void TimerWrap::Init() {
     NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructorTemplate->GetFunction());
 }
 
-Local<Object> TimerWrap::NewInstance(std::shared_ptr<napa::zone::Timer> timer) {
-    auto object = napa::module::NewInstance<TimerWrap>().ToLocalChecked();
-    auto wrap = NAPA_OBJECTWRAP::Unwrap<TimerWrap>(object);
-    wrap->_timer = std::move(timer);
-    return object;
-}
-
-void TimerWrap::Reset() {
-    _timer.reset();
-}
-
-napa::zone::Timer& TimerWrap::Get() {
-    return *_timer;
-}
-
 // This is created as SetWeak(void) is not exists in v8 used in NodeJS 6.
 static void EmptyWeakCallback(const v8::WeakCallbackInfo<int>& data) {
 }
 
+// Shares a handle between timer tasks, resetting it once the last task holding it is gone,
+// including a timer task dropped when the timer is cleared.
+template <typename T>
+static std::shared_ptr<Persistent<T>> makeSharedPersistent(Isolate* isolate, Local<T> handle) {
+    return std::shared_ptr<Persistent<T>>(new Persistent<T>(isolate, handle), [](Persistent<T>* persistent) {
+        persistent->Reset();
+        delete persistent;
+    });
+}
+
 std::shared_ptr<napa::zone::CallbackTask> buildTimeoutTask(
         std::shared_ptr<Persistent<Object>> sharedTimeout,
         std::shared_ptr<Persistent<Context>> sharedContext)
@@ -132,12 +128,20 @@ std::shared_ptr<napa::zone::CallbackTask> buildTimeoutTask(
 
                 Local<Number> interval = Local<Number>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_repeat")));
                 bool isInterval = (interval->Value() >= 1);
-                if (isInterval) {
-                    auto jsTimer = NAPA_OBJECTWRAP::Unwrap<TimerWrap>(
-                        Local<Object>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_timer"))));
 
-                    //Re-arm the interval timer in napa's timer schedule thread.
-                    jsTimer->Get().Start();
+                // The callback may have cleared its own interval.
+                active = Local<Boolean>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_active")));
+                if (isInterval && active->Value()) {
+                    auto zone = reinterpret_cast<NapaZone*>(WorkerContext::Get(WorkerContextItem::ZONE));
+                    auto workerId = static_cast<WorkerId>(
+                        reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+
+                    // Re-arm the interval timer in current worker's timer heap.
+                    auto timerId = zone->GetScheduler()->ScheduleOnWorkerAfter(
+                        workerId,
+                        buildTimeoutTask(sharedTimeout, sharedContext),
+                        std::chrono::milliseconds(static_cast<int64_t>(interval->Value())));
+                    timeout->Set(String::NewFromUtf8(isolate, "_timerId"), Number::New(isolate, static_cast<double>(timerId)));
 
                     // If not interval timer, global v8 handle for Timeout and Context will be SetWeak.
                     // Otherwise keep holding the hanle as they will be used some time later.
@@ -176,10 +180,10 @@ void TimerWrap::SetImmediateCallback(const FunctionCallbackInfo<Value>& args) {
     }
 
     Local<Object> timeout = Local<Object>::Cast(args[0]);
-    auto sharedTimeout = std::make_shared<Persistent<Object>>(isolate, timeout);
+    auto sharedTimeout = makeSharedPersistent(isolate, timeout);
 
     auto context = isolate->GetCurrentContext();
-    auto sharedContext = std::make_shared<Persistent<Context>>(isolate, context);
+    auto sharedContext = makeSharedPersistent(isolate, context);
 
     auto immediateCallbackTask = buildTimeoutTask(sharedTimeout, sharedContext);
 
@@ -208,20 +212,48 @@ void TimerWrap::SetTimersCallback(const FunctionCallbackInfo<Value>& args) {
         reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
 
     Local<Object> timeout = Local<Object>::Cast(args[0]);
-    auto sharedTimeout = std::make_shared<Persistent<Object>>(isolate, timeout);
+    auto sharedTimeout = makeSharedPersistent(isolate, timeout);
 
     auto context = isolate->GetCurrentContext();
-    auto sharedContext = std::make_shared<Persistent<Context>>(isolate, context);
+    auto sharedContext = makeSharedPersistent(isolate, context);
 
     Local<Number> after = Local<Number>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_after")));
-    std::chrono::milliseconds msAfter{static_cast<int>(after->Value())};
-    auto sharedTimer = std::make_shared<napa::zone::Timer>(
-        [sharedTimeout, sharedContext, scheduler, workerId]() {
-            auto timerCallbackTask = buildTimeoutTask(sharedTimeout, sharedContext);
-            scheduler->ScheduleOnWorker(workerId, timerCallbackTask, SchedulePhase::DefaultPhase);
-        }, msAfter);
-
-    auto jsTimer = TimerWrap::NewInstance(sharedTimer);
-    timeout->Set(String::NewFromUtf8(isolate, "_timer"), jsTimer);
-    sharedTimer->Start();
+    std::chrono::milliseconds msAfter{static_cast<int64_t>(after->Value())};
+
+    // Timers are always armed from the worker that owns them, so they are kept in the worker's own timer heap
+    // instead of going through the global timer thread and the shared task queue.
+    auto timerCallbackTask = buildTimeoutTask(sharedTimeout, sharedContext);
+    auto timerId = scheduler->ScheduleOnWorkerAfter(workerId, timerCallbackTask, msAfter);
+
+    // Keep the timer id on the timeout, so clearing it can remove the timer from the heap.
+    timeout->Set(String::NewFromUtf8(isolate, "_timerId"), Number::New(isolate, static_cast<double>(timerId)));
+}
+
+void TimerWrap::ClearTimersCallback(const FunctionCallbackInfo<Value>& args) {
+    auto isolate = Isolate::GetCurrent();
+    HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument is required for calling 'ClearTimersCallback'.");
+    CHECK_ARG(isolate, args[0]->IsObject(), "Argument \"timeout\" shall be 'Timeout' type.");
+
+    Local<Object> timeout = Local<Object>::Cast(args[0]);
+    auto timerId = timeout->Get(String::NewFromUtf8(isolate, "_timerId"));
+    if (!timerId->IsNumber()) {
+        // Never armed as a timer, like an immediate.
+        return;
+    }
+
+    auto zone = reinterpret_cast<NapaZone*>(WorkerContext::Get(WorkerContextItem::ZONE));
+    if (zone == nullptr) {
+        throw new std::runtime_error("Null zone encountered!");
+    }
+    auto scheduler = zone->GetScheduler().get();
+    if (scheduler == nullptr) {
+        throw new std::runtime_error("Null scheduler encountered!");
+    }
+    auto workerId = static_cast<WorkerId>(
+        reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+
+    // Dropping the timer task also releases its handles to the timeout and context right away.
+    scheduler->CancelOnWorker(workerId, static_cast<napa::zone::Worker::TimerId>(Local<Number>::Cast(timerId)->Value()));
 }
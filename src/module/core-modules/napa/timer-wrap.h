@@ -4,29 +4,23 @@
 #pragma once
 
 #include <napa/module.h>
-#include <zone/timer.h>
 
 namespace napa {
 namespace module {
     
-    /// <summary> It wraps napa::zone::Timer. </summary>
-    /// <remarks> Reference: napajs/lib/timer.ts#Timer </remarks>
+    /// <summary> It implements JavaScript timers on top of the worker task queues and timer heap. </summary>
+    /// <remarks> Reference: napajs/lib/core/timers/timer.ts#Timer </remarks>
     class TimerWrap: public NAPA_OBJECTWRAP {
     public:
         /// <summary> Init this wrap. </summary>
         static void Init();
 
-        /// <summary> It creates an instance of TimerWrap with a napa::zone::Timer pointer. </summary>
-        static v8::Local<v8::Object> NewInstance(std::shared_ptr<napa::zone::Timer> timer);
-
-        napa::zone::Timer& Get();
-
-        void Reset();
-
         static void SetImmediateCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
         static void SetTimersCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+        static void ClearTimersCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
     private:
         /// <summary> Default constructor. </summary>
         TimerWrap() = default;
@@ -48,8 +42,6 @@ namespace module {
 
         /// <summary> Hid constructor from public access. </summary>
         NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
-
-        std::shared_ptr<napa::zone::Timer> _timer;
     };
 }
 }
@@ -5,12 +5,17 @@
 
 #include "transport-context-wrap-impl.h"
 
+#include <utils/string.h>
+#include <zone/worker-context.h>
+#include <zone/zone.h>
+
 #include <napa/zone.h>
 #include <napa/assert.h>
 #include <napa/async.h>
 #include <napa/v8-helpers.h>
 
 #include <sstream>
+#include <string>
 #include <vector>
 
 using namespace napa::module;
@@ -18,8 +23,19 @@ using namespace napa::v8_helpers;
 
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(ZoneWrap);
 
+namespace {
+    /// <summary> Make a V8 string of a return value, taking over large ASCII ones without decoding or copying them. </summary>
+    v8::Local<v8::String> MakeReturnValueString(v8::Isolate* isolate, std::string& returnValue) {
+        if (returnValue.size() < MIN_EXTERNAL_STRING_LENGTH || !napa::utils::string::IsAscii(returnValue)) {
+            return MakeV8String(isolate, returnValue);
+        }
+
+        auto owner = std::make_shared<std::string>(std::move(returnValue));
+        return MakeSharedExternalV8String(isolate, owner, owner->data(), owner->size());
+    }
+}
+
 // Forward declaration.
-static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result);
 template <typename Func>
 static void CreateRequestAndExecute(v8::Local<v8::Object> obj, Func&& func);
 
@@ -37,6 +53,10 @@ void ZoneWrap::Init() {
     NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "broadcastSync", BroadcastSync);
     NODE_SET_PROTOTYPE_METHOD(functionTemplate, "execute", Execute);
     NODE_SET_PROTOTYPE_METHOD(functionTemplate, "executeSync", ExecuteSync);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "listen", Listen);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getCacheStatistics", GetCacheStatistics);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getFlowStatistics", GetFlowStatistics);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "canRunInline", CanRunInline);
 
     // Set persistent constructor into V8.
     NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, functionTemplate->GetFunction());
@@ -158,7 +178,88 @@ void ZoneWrap::ExecuteSync(const v8::FunctionCallbackInfo<v8::Value>& args) {
     });
 }
 
-static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result) {
+void ZoneWrap::Listen(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to zone.listen must be the socket path");
+    v8::String::Utf8Value address(args[0]->ToString());
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    try {
+        wrap->_zoneProxy->Listen(*address);
+    } catch (const std::runtime_error& ex) {
+        JS_FAIL(isolate, ex.what());
+    }
+}
+
+void ZoneWrap::GetCacheStatistics(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    auto statistics = wrap->_zoneProxy->GetCacheStatistics();
+
+    auto result = v8::Object::New(isolate);
+    (void)result->CreateDataProperty(context, MakeV8String(isolate, "hits"),
+        v8::Number::New(isolate, static_cast<double>(statistics.hits)));
+    (void)result->CreateDataProperty(context, MakeV8String(isolate, "misses"),
+        v8::Number::New(isolate, static_cast<double>(statistics.misses)));
+    (void)result->CreateDataProperty(context, MakeV8String(isolate, "evictions"),
+        v8::Number::New(isolate, static_cast<double>(statistics.evictions)));
+    (void)result->CreateDataProperty(context, MakeV8String(isolate, "expirations"),
+        v8::Number::New(isolate, static_cast<double>(statistics.expirations)));
+    (void)result->CreateDataProperty(context, MakeV8String(isolate, "bytes"),
+        v8::Number::New(isolate, static_cast<double>(statistics.bytes)));
+
+    args.GetReturnValue().Set(result);
+}
+
+void ZoneWrap::GetFlowStatistics(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    auto flows = wrap->_zoneProxy->GetFlowStatistics();
+
+    auto result = v8::Array::New(isolate, static_cast<int>(flows.size()));
+    for (uint32_t i = 0; i < flows.size(); ++i) {
+        const auto& statistics = flows[i];
+
+        auto flow = v8::Object::New(isolate);
+        (void)flow->CreateDataProperty(context, MakeV8String(isolate, "flowId"),
+            v8::Uint32::NewFromUnsigned(isolate, statistics.flow_id));
+        (void)flow->CreateDataProperty(context, MakeV8String(isolate, "weight"),
+            v8::Uint32::NewFromUnsigned(isolate, statistics.weight));
+        (void)flow->CreateDataProperty(context, MakeV8String(isolate, "queued"),
+            v8::Number::New(isolate, static_cast<double>(statistics.queued)));
+        (void)flow->CreateDataProperty(context, MakeV8String(isolate, "dispatched"),
+            v8::Number::New(isolate, static_cast<double>(statistics.dispatched)));
+        (void)flow->CreateDataProperty(context, MakeV8String(isolate, "totalWaitUs"),
+            v8::Number::New(isolate, static_cast<double>(statistics.total_wait_us)));
+        (void)flow->CreateDataProperty(context, MakeV8String(isolate, "maxWaitUs"),
+            v8::Number::New(isolate, static_cast<double>(statistics.max_wait_us)));
+        (void)result->Set(context, i, flow);
+    }
+
+    args.GetReturnValue().Set(result);
+}
+
+void ZoneWrap::CanRunInline(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+    // A nested call on the zone of the calling worker, while all its workers are busy, would only wait in queue.
+    // The node zone has a single thread and no workers to count.
+    auto current = reinterpret_cast<napa::zone::Zone*>(
+        napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::ZONE));
+    auto canRunInline = current != nullptr
+        && current->GetId() != "node"
+        && current->GetId() == wrap->_zoneProxy->GetId()
+        && wrap->_zoneProxy->GetIdleWorkerCount() == 0;
+
+    args.GetReturnValue().Set(canRunInline);
+}
+
+v8::Local<v8::Object> ZoneWrap::CreateResponseObject(napa::Result& result) {
     auto isolate = v8::Isolate::GetCurrent();
     auto context = isolate->GetCurrentContext();
 
@@ -177,7 +278,7 @@ static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result) {
     (void)responseObject->CreateDataProperty(
         context,
         MakeV8String(isolate, "returnValue"),
-        MakeV8String(isolate, result.returnValue));
+        MakeReturnValueString(isolate, result.returnValue));
 
     // Transport context handle
     v8::Local<v8::Value> contextHandleValue;
@@ -192,6 +293,25 @@ static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result) {
         MakeV8String(isolate, "contextHandle"),
         contextHandleValue);
 
+    // Accounting is only set for calls that asked for it.
+    if (result.accounting != nullptr) {
+        auto accounting = v8::Object::New(isolate);
+        (void)accounting->CreateDataProperty(context, MakeV8String(isolate, "queueWaitUs"),
+            v8::Number::New(isolate, static_cast<double>(result.accounting->queue_wait_us)));
+        (void)accounting->CreateDataProperty(context, MakeV8String(isolate, "executionUs"),
+            v8::Number::New(isolate, static_cast<double>(result.accounting->execution_us)));
+        (void)accounting->CreateDataProperty(context, MakeV8String(isolate, "cpuUs"),
+            v8::Number::New(isolate, static_cast<double>(result.accounting->cpu_us)));
+        (void)accounting->CreateDataProperty(context, MakeV8String(isolate, "heapBytes"),
+            v8::Number::New(isolate, static_cast<double>(result.accounting->heap_bytes)));
+        (void)accounting->CreateDataProperty(context, MakeV8String(isolate, "argumentBytes"),
+            v8::Number::New(isolate, static_cast<double>(result.accounting->argument_bytes)));
+        (void)accounting->CreateDataProperty(context, MakeV8String(isolate, "resultBytes"),
+            v8::Number::New(isolate, static_cast<double>(result.accounting->result_bytes)));
+
+        (void)responseObject->CreateDataProperty(context, MakeV8String(isolate, "accounting"), accounting);
+    }
+
     return responseObject;
 }
 
@@ -245,6 +365,42 @@ static void CreateRequestAndExecute(v8::Local<v8::Object> obj, Func&& func) {
             spec.options.timeout = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
         }
 
+        // hedgeAfterMs is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "hedgeAfterMs"));
+        if (!maybe.IsEmpty()) {
+            spec.options.hedge_after_ms = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // cacheTtlMs is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "cacheTtlMs"));
+        if (!maybe.IsEmpty()) {
+            spec.options.cache_ttl_ms = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // singleFlight is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "singleFlight"));
+        if (!maybe.IsEmpty()) {
+            spec.options.single_flight = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // flowId is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "flowId"));
+        if (!maybe.IsEmpty()) {
+            spec.options.flow_id = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // flowWeight is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "flowWeight"));
+        if (!maybe.IsEmpty()) {
+            spec.options.flow_weight = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // accounting is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "accounting"));
+        if (!maybe.IsEmpty()) {
+            spec.options.accounting = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
         // transport option is optional.
         maybe = options->Get(context, MakeV8String(isolate, "transport"));
         if (!maybe.IsEmpty()) {
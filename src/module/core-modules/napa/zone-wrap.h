@@ -7,9 +7,10 @@
 
 #include <memory>
 
-// Forward declare zone.
+// Forward declare zone and result.
 namespace napa {
     class Zone;
+    struct Result;
 }
 
 namespace napa {
@@ -28,6 +29,9 @@ namespace module {
         /// <summary> Create a new ZoneWrap instance that wraps the provided proxy. </summary>
         static v8::Local<v8::Object> NewInstance(std::unique_ptr<napa::Zone> zoneProxy);
 
+        /// <summary> Creates the object passed to JavaScript for a call result, taking over its transport context and return value. </summary>
+        static v8::Local<v8::Object> CreateResponseObject(napa::Result& result);
+
     private:
 
         /// <summary> Declare persistent constructor to create Zone Javascript wrapper instance. </summary>
@@ -41,6 +45,10 @@ namespace module {
         static void BroadcastSync(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void Execute(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void ExecuteSync(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Listen(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GetCacheStatistics(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GetFlowStatistics(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void CanRunInline(const v8::FunctionCallbackInfo<v8::Value>& args);
 
         /// <summary> Friend default constructor callback. </summary>
         template <typename WrapType>
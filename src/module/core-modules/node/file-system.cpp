@@ -4,7 +4,9 @@
 #include "file-system.h"
 #include "file-system-helpers.h"
 
+#include <module/loader/module-resolver-cache.h>
 #include <napa/module.h>
+#include <platform/filesystem.h>
 
 using namespace napa;
 using namespace napa::module;
@@ -87,6 +89,9 @@ namespace {
 
         try {
             file_system_helpers::WriteFileSync(std::string(*fileName), *content, static_cast<size_t>(content.length()));
+
+            // A new file may change how modules are resolved.
+            ModuleResolverCache::Instance().Invalidate(filesystem::Path(*fileName).Absolute().Normalize());
         } catch (const std::exception& ex) {
             isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(isolate, ex.what())));
         }
@@ -108,6 +113,9 @@ namespace {
 
         try {
             file_system_helpers::MkdirSync(std::string(*directory));
+
+            // A new directory may change how modules are resolved.
+            ModuleResolverCache::Instance().Invalidate(filesystem::Path(*directory).Absolute().Normalize());
         } catch (const std::exception& ex) {
             isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(isolate, ex.what())));
         }
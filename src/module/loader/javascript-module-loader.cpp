@@ -10,8 +10,10 @@
 using namespace napa;
 using namespace napa::module;
 
-JavascriptModuleLoader::JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter, ModuleCache& moduleCache)
-    : _builtInModulesSetter(std::move(builtInModulesSetter)) , _moduleCache(moduleCache) {}
+JavascriptModuleLoader::JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter,
+                                               ModuleCache& moduleCache,
+                                               std::shared_ptr<const ModuleBundle> bundle)
+    : _builtInModulesSetter(std::move(builtInModulesSetter)), _moduleCache(moduleCache), _bundle(std::move(bundle)) {}
 
 bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value> arg, v8::Local<v8::Object>& module) {
     auto isolate = v8::Isolate::GetCurrent();
@@ -20,7 +22,11 @@ bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value
     bool fromContent = !arg.IsEmpty();
     v8::Local<v8::String> source;
 
-    if (!fromContent) {
+    const BundledModule* bundled = (fromContent || _bundle == nullptr) ? nullptr : _bundle->Find(path);
+    if (bundled != nullptr) {
+        source = module_loader_helpers::ReadBundledModule(_bundle, *bundled);
+        JS_ENSURE_WITH_RETURN(isolate, !source.IsEmpty(), false, "Can't read bundled Javascript module: \"%s\"", path.c_str());
+    } else if (!fromContent) {
         source = module_loader_helpers::ReadModuleFile(path);
         JS_ENSURE_WITH_RETURN(isolate, !source.IsEmpty(), false, "Can't read Javascript module: \"%s\"", path.c_str());
     } else {
@@ -58,7 +64,20 @@ bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value
                 v8_helpers::MakeV8String(isolate, "}).apply(module.exports);")
             )
         );
-        auto script = v8::Script::Compile(wrappedSource, &origin);
+
+        v8::Local<v8::Script> script;
+        if (bundled != nullptr && bundled->codeCacheLength > 0) {
+            // The bundle owns the code cache bytes. V8 falls back to a full compile if the cache is rejected.
+            v8::ScriptCompiler::Source scriptSource(wrappedSource, origin, new v8::ScriptCompiler::CachedData(
+                bundled->codeCache,
+                static_cast<int>(bundled->codeCacheLength),
+                v8::ScriptCompiler::CachedData::BufferNotOwned));
+            (void)v8::ScriptCompiler::Compile(
+                isolate->GetCurrentContext(), &scriptSource, v8::ScriptCompiler::kConsumeCodeCache).ToLocal(&script);
+        } else {
+            script = v8::Script::Compile(wrappedSource, &origin);
+        }
+
         if (script.IsEmpty() || tryCatch.HasCaught()) {
             tryCatch.ReThrow();
             return false;
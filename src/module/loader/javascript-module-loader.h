@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include "module-bundle.h"
 #include "module-file-loader.h"
 
+#include <memory>
 #include <string>
 
 namespace napa {
@@ -20,7 +22,10 @@ namespace module {
         /// <summary> Constructor. </summary>
         /// <param name="builtInSetter"> Built-in modules registerer. </param>
         /// <param name="moduleCache"> Cache for all modules. </param>
-        JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter, ModuleCache& moduleCache);
+        /// <param name="bundle"> Prebuilt module bundle to read sources from before file system, optional. </param>
+        JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter,
+                               ModuleCache& moduleCache,
+                               std::shared_ptr<const ModuleBundle> bundle = nullptr);
 
         /// <summary> It loads a module from javascript file. </summary>
         /// <param name="path"> Module path called by require(). </param>
@@ -36,6 +41,9 @@ namespace module {
 
         /// Module cache instance.
         ModuleCache& _moduleCache;
+
+        /// Prebuilt module bundle.
+        std::shared_ptr<const ModuleBundle> _bundle;
     };
 
 }   // End of namespace module.
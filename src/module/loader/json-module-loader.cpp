@@ -3,22 +3,135 @@
 
 #include "json-module-loader.h"
 #include "module-loader-helpers.h"
+#include "module-resolver-cache.h"
 
 #include <napa/v8-helpers.h>
 
+#include <v8-extensions/v8-extensions-macros.h>
+#if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+    #include <v8-extensions/v8-extensions.h>
+#endif
+
+#include <mutex>
+#include <unordered_map>
+
 using namespace napa;
 using namespace napa::module;
 
+#if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+namespace {
+
+    /// <summary> Parsed form of a JSON module, shared by all isolates in the process. </summary>
+    struct SharedJsonEntry {
+        /// <summary> Held by the isolate that parses the module, so other isolates wait for its result. </summary>
+        std::mutex parseLock;
+
+        /// <summary> Serialized value. It lives as long as a JsonModuleLoader holds it. </summary>
+        std::weak_ptr<v8_extensions::SerializedData> data;
+    };
+
+    std::mutex sharedJsonEntriesLock;
+    std::unordered_map<std::string, std::shared_ptr<SharedJsonEntry>> sharedJsonEntries;
+
+    /// <summary> Module cache generation the entries were parsed at. </summary>
+    uint64_t sharedJsonGeneration = 0;
+
+    /// <summary> Number of entries after the last sweep of entries no loader holds. </summary>
+    size_t sharedJsonSweptSize = 0;
+
+    std::shared_ptr<SharedJsonEntry> GetSharedJsonEntry(const std::string& path) {
+        auto generation = ModuleResolverCache::Instance().GetGeneration();
+
+        std::lock_guard<std::mutex> lock(sharedJsonEntriesLock);
+
+        // A JSON file may have changed once the module cache is invalidated, so it's parsed again.
+        // Loaders keep the values they already hold.
+        if (generation != sharedJsonGeneration) {
+            sharedJsonEntries.clear();
+            sharedJsonGeneration = generation;
+        }
+
+        // Drop entries of values no loader holds any more, once the map doubled since the last sweep.
+        if (sharedJsonEntries.size() >= 2 * sharedJsonSweptSize + 16) {
+            for (auto it = sharedJsonEntries.begin(); it != sharedJsonEntries.end();) {
+                if (it->second->data.expired()) {
+                    it = sharedJsonEntries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            sharedJsonSweptSize = sharedJsonEntries.size();
+        }
+
+        auto& entry = sharedJsonEntries[path];
+        if (entry == nullptr) {
+            entry = std::make_shared<SharedJsonEntry>();
+        }
+        return entry;
+    }
+
+}   // End of anonymous namespace.
+
+#endif
+
+JsonModuleLoader::JsonModuleLoader(std::shared_ptr<const ModuleBundle> bundle) : _bundle(std::move(bundle)) {}
+
+JsonModuleLoader::~JsonModuleLoader() = default;
+
 bool JsonModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value> arg, v8::Local<v8::Object>& module) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::EscapableHandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+#if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+    // The first isolate to load a JSON module parses it and keeps the serialized value,
+    // other isolates deserialize it, which is much faster than parsing and doesn't read the file again.
+    // Parsing is done under the lock of the entry, deserializing is not.
+    auto entry = GetSharedJsonEntry(path);
+    std::unique_lock<std::mutex> parseLock(entry->parseLock);
+
+    auto data = entry->data.lock();
+    if (data != nullptr) {
+        parseLock.unlock();
 
-    auto source = module_loader_helpers::ReadModuleFile(path);
+        v8::Local<v8::Value> json;
+        JS_ENSURE_WITH_RETURN(isolate,
+                              v8_extensions::Utils::DeserializeValue(isolate, data).ToLocal(&json),
+                              false,
+                              "Can't deserialize JSON module: \"%s\"",
+                              path.c_str());
+
+        _sharedJsons.emplace_back(std::move(data));
+        module = scope.Escape(json->ToObject(context).ToLocalChecked());
+        return true;
+    }
+
+#endif
+
+    const BundledModule* bundled = (_bundle == nullptr) ? nullptr : _bundle->Find(path);
+    auto source = (bundled != nullptr) ?
+        module_loader_helpers::ReadBundledModule(_bundle, *bundled) : module_loader_helpers::ReadModuleFile(path);
     JS_ENSURE_WITH_RETURN(isolate, !source.IsEmpty(), false, "Can't read JSON module: \"%s\"", path.c_str());
 
-    auto json = v8::JSON::Parse(isolate, source).ToLocalChecked();
-    JS_ENSURE_WITH_RETURN(isolate, !json.IsEmpty(), false, "Can't parse JSON from \"%s\"", path.c_str());
+    v8::Local<v8::Value> json;
+    JS_ENSURE_WITH_RETURN(isolate,
+                          v8::JSON::Parse(context, source).ToLocal(&json),
+                          false,
+                          "Can't parse JSON from \"%s\"",
+                          path.c_str());
+
+#if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+    data = v8_extensions::Utils::SerializeValue(isolate, json);
+    if (data != nullptr) {
+        entry->data = data;
+        _sharedJsons.emplace_back(std::move(data));
+    }
+
+#endif
 
-    module = scope.Escape(json->ToObject(isolate->GetCurrentContext()).ToLocalChecked());
+    module = scope.Escape(json->ToObject(context).ToLocalChecked());
     return true;
 }
@@ -3,23 +3,45 @@
 
 #pragma once
 
+#include "module-bundle.h"
 #include "module-file-loader.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace napa {
+namespace v8_extensions {
+    class SerializedData;
+}
+
 namespace module {
 
     /// <summary> It loads an object from json file. </summary>
     class JsonModuleLoader : public ModuleFileLoader {
     public:
 
-        /// <summary> It loads an object from json file. </summary>
+        /// <summary> Constructor. </summary>
+        /// <param name="bundle"> Prebuilt module bundle to read sources from before file system, optional. </param>
+        explicit JsonModuleLoader(std::shared_ptr<const ModuleBundle> bundle = nullptr);
+
+        /// <summary> Destructor. </summary>
+        ~JsonModuleLoader();
+
+        /// <summary> It loads an object from json file, which is parsed only once per process. </summary>
         /// <param name="path"> Module path called by require(). </param>
         /// <param name="arg"> Argument for loading the file. Passed through as arg1 from require. </param>
         /// <param name="module"> Loaded object if successful. </param>
         /// <returns> True if the object is loaded, false otherwise. </returns>
         bool TryGet(const std::string& path, v8::Local<v8::Value> arg, v8::Local<v8::Object>& module) override;
+
+    private:
+
+        /// Prebuilt module bundle.
+        std::shared_ptr<const ModuleBundle> _bundle;
+
+        /// Serialized JSON modules loaded by this loader, shared with loaders of other isolates.
+        std::vector<std::shared_ptr<v8_extensions::SerializedData>> _sharedJsons;
     };
 
 }   // End of namespace module.
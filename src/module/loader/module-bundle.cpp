@@ -0,0 +1,279 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "module-bundle.h"
+
+#include <platform/mapped-file.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+
+    const char BUNDLE_MAGIC[8] = { 'N', 'A', 'P', 'A', 'B', 'N', 'D', 'L' };
+    const uint32_t BUNDLE_VERSION = 1;
+
+    const size_t HEADER_SIZE = 24;
+    const size_t MODULE_RECORD_SIZE = 40;
+    const size_t RESOLUTION_RECORD_SIZE = 24;
+
+    uint32_t ReadUint32(const char* data) {
+        auto bytes = reinterpret_cast<const uint8_t*>(data);
+        return static_cast<uint32_t>(bytes[0])
+            | (static_cast<uint32_t>(bytes[1]) << 8)
+            | (static_cast<uint32_t>(bytes[2]) << 16)
+            | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    void WriteUint32(std::string& buffer, uint32_t value) {
+        buffer.push_back(static_cast<char>(value & 0xff));
+        buffer.push_back(static_cast<char>((value >> 8) & 0xff));
+        buffer.push_back(static_cast<char>((value >> 16) & 0xff));
+        buffer.push_back(static_cast<char>((value >> 24) & 0xff));
+    }
+
+    /// <summary> Key of the resolution index, name and context directory separated by a null character. </summary>
+    std::string MakeResolutionKey(const char* name, size_t nameLength, const char* path, size_t pathLength) {
+        std::string key;
+        key.reserve(nameLength + pathLength + 1);
+        key.append(name, nameLength);
+        key.push_back('\0');
+        key.append(path, pathLength);
+        return key;
+    }
+
+    /// <summary> Bundles opened in this process. </summary>
+    std::mutex bundlesLock;
+    std::unordered_map<std::string, std::weak_ptr<const ModuleBundle>> bundles;
+
+}   // End of anonymous namespace.
+
+class ModuleBundle::ModuleBundleImpl {
+public:
+    explicit ModuleBundleImpl(const std::string& path);
+
+    std::unique_ptr<filesystem::MappedFile> _file;
+    std::vector<BundledModule> _modules;
+    std::unordered_map<std::string, uint32_t> _modulesByPath;
+    std::unordered_map<std::string, uint32_t> _resolutions;
+
+private:
+    /// <summary> Reads a span at the given offset, and makes sure it's within the file. </summary>
+    const char* ReadSpan(size_t offset, size_t& length) const;
+
+    /// <summary> Path of the bundle, for error messages. </summary>
+    std::string _path;
+};
+
+ModuleBundle::ModuleBundleImpl::ModuleBundleImpl(const std::string& path) :
+    _file(std::make_unique<filesystem::MappedFile>(filesystem::Path(path))), _path(path) {
+
+    auto data = _file->Data();
+    auto size = _file->Size();
+
+    if (size < HEADER_SIZE || !std::equal(BUNDLE_MAGIC, BUNDLE_MAGIC + sizeof(BUNDLE_MAGIC), data)) {
+        throw std::runtime_error("\"" + path + "\" is not a module bundle");
+    }
+
+    auto version = ReadUint32(data + 8);
+    if (version != BUNDLE_VERSION) {
+        throw std::runtime_error("\"" + path + "\" has unsupported bundle version " + std::to_string(version));
+    }
+
+    size_t moduleCount = ReadUint32(data + 12);
+    size_t resolutionCount = ReadUint32(data + 16);
+    if (size < HEADER_SIZE + moduleCount * MODULE_RECORD_SIZE + resolutionCount * RESOLUTION_RECORD_SIZE) {
+        throw std::runtime_error("\"" + path + "\" is truncated");
+    }
+
+    _modules.reserve(moduleCount);
+    _modulesByPath.reserve(moduleCount);
+    for (size_t i = 0; i < moduleCount; ++i) {
+        auto record = HEADER_SIZE + i * MODULE_RECORD_SIZE;
+
+        auto type = ReadUint32(data + record);
+        if (type == static_cast<uint32_t>(ModuleType::NONE) || type >= static_cast<uint32_t>(ModuleType::END_OF_MODULE_TYPE)) {
+            throw std::runtime_error("\"" + path + "\" has a module of unknown type");
+        }
+
+        size_t fullPathLength, packageJsonPathLength, sourceLength, codeCacheLength;
+        auto fullPath = ReadSpan(record + 8, fullPathLength);
+        auto packageJsonPath = ReadSpan(record + 16, packageJsonPathLength);
+        auto source = ReadSpan(record + 24, sourceLength);
+        auto codeCache = ReadSpan(record + 32, codeCacheLength);
+
+        _modules.emplace_back(BundledModule {
+            ModuleInfo {
+                static_cast<ModuleType>(type),
+                std::string(fullPath, fullPathLength),
+                std::string(packageJsonPath, packageJsonPathLength)
+            },
+            source,
+            sourceLength,
+            std::all_of(source, source + sourceLength, [](char ch) { return (static_cast<uint8_t>(ch) & 0x80) == 0; }),
+            reinterpret_cast<const uint8_t*>(codeCache),
+            codeCacheLength
+        });
+        _modulesByPath.emplace(_modules.back().info.fullPath, static_cast<uint32_t>(i));
+    }
+
+    _resolutions.reserve(resolutionCount);
+    for (size_t i = 0; i < resolutionCount; ++i) {
+        auto record = HEADER_SIZE + moduleCount * MODULE_RECORD_SIZE + i * RESOLUTION_RECORD_SIZE;
+
+        size_t nameLength, fromPathLength;
+        auto name = ReadSpan(record, nameLength);
+        auto fromPath = ReadSpan(record + 8, fromPathLength);
+
+        auto moduleIndex = ReadUint32(data + record + 16);
+        if (moduleIndex >= moduleCount) {
+            throw std::runtime_error("\"" + path + "\" has a resolution to an unknown module");
+        }
+
+        _resolutions.emplace(MakeResolutionKey(name, nameLength, fromPath, fromPathLength), moduleIndex);
+    }
+}
+
+const char* ModuleBundle::ModuleBundleImpl::ReadSpan(size_t offset, size_t& length) const {
+    auto data = _file->Data();
+    size_t spanOffset = ReadUint32(data + offset);
+    length = ReadUint32(data + offset + 4);
+
+    if (spanOffset > _file->Size() || length > _file->Size() - spanOffset) {
+        throw std::runtime_error("\"" + _path + "\" has data out of range");
+    }
+    return length == 0 ? nullptr : data + spanOffset;
+}
+
+std::shared_ptr<const ModuleBundle> ModuleBundle::Open(const std::string& path) {
+    auto fullPath = filesystem::Path(path).Absolute().Normalize().String();
+
+    std::lock_guard<std::mutex> lock(bundlesLock);
+
+    auto iter = bundles.find(fullPath);
+    if (iter != bundles.end()) {
+        auto bundle = iter->second.lock();
+        if (bundle != nullptr) {
+            return bundle;
+        }
+    }
+
+    std::shared_ptr<const ModuleBundle> bundle(
+        new ModuleBundle(std::make_unique<ModuleBundleImpl>(fullPath)));
+    bundles[fullPath] = bundle;
+
+    return bundle;
+}
+
+ModuleBundle::ModuleBundle(std::unique_ptr<ModuleBundleImpl> impl) : _impl(std::move(impl)) {}
+
+ModuleBundle::~ModuleBundle() = default;
+
+bool ModuleBundle::Resolve(const char* name, const char* path, ModuleInfo& moduleInfo) const {
+    auto iter = _impl->_resolutions.find(MakeResolutionKey(name, strlen(name), path, strlen(path)));
+    if (iter == _impl->_resolutions.end()) {
+        return false;
+    }
+
+    moduleInfo = _impl->_modules[iter->second].info;
+    return true;
+}
+
+const BundledModule* ModuleBundle::Find(const std::string& fullPath) const {
+    auto iter = _impl->_modulesByPath.find(fullPath);
+    if (iter == _impl->_modulesByPath.end()) {
+        return nullptr;
+    }
+    return &_impl->_modules[iter->second];
+}
+
+size_t ModuleBundle::GetModuleCount() const {
+    return _impl->_modules.size();
+}
+
+void ModuleBundleWriter::AddModule(const ModuleInfo& moduleInfo, std::string source, std::string codeCache) {
+    _modules.emplace_back(Module { moduleInfo, std::move(source), std::move(codeCache) });
+}
+
+bool ModuleBundleWriter::AddResolution(const std::string& name, const std::string& fromPath, const std::string& fullPath) {
+    for (size_t i = 0; i < _modules.size(); ++i) {
+        if (_modules[i].info.fullPath == fullPath) {
+            _resolutions.emplace_back(Resolution { name, fromPath, static_cast<uint32_t>(i) });
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModuleBundleWriter::AddRequire(ModuleResolver& resolver, const std::string& name, const std::string& fromPath) {
+    auto moduleInfo = resolver.Resolve(name.c_str(), fromPath.c_str());
+    if (moduleInfo.type == ModuleType::NONE || moduleInfo.type == ModuleType::CORE) {
+        return false;
+    }
+
+    // A module required from several places is stored once.
+    if (AddResolution(name, fromPath, moduleInfo.fullPath)) {
+        return true;
+    }
+
+    std::string source;
+    if (moduleInfo.type != ModuleType::NAPA) {
+        std::ifstream ifs(moduleInfo.fullPath, std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error("Can't read module " + moduleInfo.fullPath);
+        }
+        source.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    AddModule(moduleInfo, std::move(source));
+    return AddResolution(name, fromPath, moduleInfo.fullPath);
+}
+
+void ModuleBundleWriter::Write(const std::string& path) const {
+    std::string records;
+    std::string content;
+    size_t dataOffset = HEADER_SIZE + _modules.size() * MODULE_RECORD_SIZE + _resolutions.size() * RESOLUTION_RECORD_SIZE;
+
+    auto writeSpan = [&](const std::string& value) {
+        if (dataOffset + content.size() + value.size() > UINT32_MAX) {
+            throw std::runtime_error("Module bundle exceeds 4GB");
+        }
+        WriteUint32(records, static_cast<uint32_t>(dataOffset + content.size()));
+        WriteUint32(records, static_cast<uint32_t>(value.size()));
+        content.append(value);
+    };
+
+    for (const auto& module : _modules) {
+        WriteUint32(records, static_cast<uint32_t>(module.info.type));
+        WriteUint32(records, 0);
+        writeSpan(module.info.fullPath);
+        writeSpan(module.info.packageJsonPath);
+        writeSpan(module.source);
+        writeSpan(module.codeCache);
+    }
+
+    for (const auto& resolution : _resolutions) {
+        writeSpan(resolution.name);
+        writeSpan(resolution.fromPath);
+        WriteUint32(records, resolution.moduleIndex);
+        WriteUint32(records, 0);
+    }
+
+    std::string header(BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    WriteUint32(header, BUNDLE_VERSION);
+    WriteUint32(header, static_cast<uint32_t>(_modules.size()));
+    WriteUint32(header, static_cast<uint32_t>(_resolutions.size()));
+    WriteUint32(header, 0);
+
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs << header << records << content;
+    if (!ofs) {
+        throw std::runtime_error("Can't write module bundle " + path);
+    }
+}
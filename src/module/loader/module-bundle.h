@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "module-resolver.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace module {
+
+    /// <summary> A module stored in a bundle. Source and code cache point into the bundle's mapped memory. </summary>
+    struct BundledModule {
+        /// <summary> Module resolution information, as if the module was resolved from file system. </summary>
+        ModuleInfo info;
+
+        /// <summary> Module source. Empty for binary modules, which are still loaded from file. </summary>
+        const char* source;
+        size_t sourceLength;
+
+        /// <summary> True if source is 7-bit ASCII, so V8 can use the mapped bytes in place. </summary>
+        bool isAsciiSource;
+
+        /// <summary> V8 code cache of the wrapped module source, optional. </summary>
+        const uint8_t* codeCache;
+        size_t codeCacheLength;
+    };
+
+    /// <summary>
+    /// A prebuilt, memory-mapped application bundle.
+    /// It holds module sources and a pre-resolved (name, from-path) -> module index, so 'require'
+    /// resolves by hash lookup and reads sources from the mapping instead of probing and reading files.
+    /// </summary>
+    /// <remarks>
+    /// Layout, all integers are little-endian and offsets are from the start of the file:
+    ///     Header:      char magic[8] = "NAPABNDL", uint32 version, uint32 moduleCount, uint32 resolutionCount, uint32 reserved.
+    ///     Modules:     moduleCount x { uint32 type, uint32 reserved, span fullPath, span packageJsonPath, span source, span codeCache }.
+    ///     Resolutions: resolutionCount x { span name, span fromPath, uint32 moduleIndex, uint32 reserved }.
+    ///     Data:        bytes referred by spans, where a span is { uint32 offset, uint32 length }.
+    /// Bundles are opened once per process and shared by all zones using the same bundle path.
+    /// </remarks>
+    class ModuleBundle {
+    public:
+
+        /// <summary> Opens a bundle, or returns the instance already opened in this process. </summary>
+        /// <param name="path"> Bundle file path. </param>
+        /// <returns> The bundle. It throws std::runtime_error if the file can't be mapped or is malformed. </returns>
+        static std::shared_ptr<const ModuleBundle> Open(const std::string& path);
+
+        /// <summary> Default destructor. </summary>
+        ~ModuleBundle();
+
+        /// <summary> Non-copyable. </summary>
+        ModuleBundle(const ModuleBundle&) = delete;
+        ModuleBundle& operator=(const ModuleBundle&) = delete;
+
+        /// <summary> It looks up how a require() call was resolved when the bundle was built. </summary>
+        /// <param name="name"> Module name or path passed to require(). </param>
+        /// <param name="path"> Context directory of the require() call. </param>
+        /// <param name="moduleInfo"> Module resolution information if found. </param>
+        /// <returns> True if the bundle has a resolution for the call. </returns>
+        bool Resolve(const char* name, const char* path, ModuleInfo& moduleInfo) const;
+
+        /// <summary> It finds a bundled module by its full path. </summary>
+        /// <returns> The bundled module, or nullptr if the module is not in the bundle. </returns>
+        const BundledModule* Find(const std::string& fullPath) const;
+
+        /// <summary> Number of modules in the bundle. </summary>
+        size_t GetModuleCount() const;
+
+    private:
+        class ModuleBundleImpl;
+        explicit ModuleBundle(std::unique_ptr<ModuleBundleImpl> impl);
+        std::unique_ptr<ModuleBundleImpl> _impl;
+    };
+
+    /// <summary> It builds a bundle file that can be opened by ModuleBundle. </summary>
+    class ModuleBundleWriter {
+    public:
+
+        /// <summary> Adds a module. </summary>
+        /// <param name="moduleInfo"> Module resolution information, fullPath identifies the module. </param>
+        /// <param name="source"> Module source. </param>
+        /// <param name="codeCache"> Optional V8 code cache of the wrapped module source. </param>
+        void AddModule(const ModuleInfo& moduleInfo, std::string source, std::string codeCache = std::string());
+
+        /// <summary> Records that require(name) from a context directory resolves to a module added by AddModule. </summary>
+        /// <returns> False if there is no module with the full path. </returns>
+        bool AddResolution(const std::string& name, const std::string& fromPath, const std::string& fullPath);
+
+        /// <summary>
+        /// Resolves require(name) from a context directory as a worker would, and adds the resolution with the
+        /// module's source read from file. Binary modules are added without source, as they are loaded from file.
+        /// </summary>
+        /// <returns> False if the call resolves to nothing or to a core module. It throws std::runtime_error if the source can't be read. </returns>
+        bool AddRequire(ModuleResolver& resolver, const std::string& name, const std::string& fromPath);
+
+        /// <summary> Writes the bundle. It throws std::runtime_error on failure. </summary>
+        void Write(const std::string& path) const;
+
+    private:
+        struct Module {
+            ModuleInfo info;
+            std::string source;
+            std::string codeCache;
+        };
+
+        struct Resolution {
+            std::string name;
+            std::string fromPath;
+            uint32_t moduleIndex;
+        };
+
+        std::vector<Module> _modules;
+        std::vector<Resolution> _resolutions;
+    };
+
+}   // End of namespace module.
+}   // End of namespace napa.
@@ -186,6 +186,51 @@ v8::Local<v8::String> module_loader_helpers::ReadModuleFile(const std::string& p
     return scope.Escape(v8_helpers::MakeV8String(isolate, content));
 }
 
+namespace {
+
+    /// <summary> External string over bundled source. It keeps the bundle mapped while V8 holds the string. </summary>
+    class BundledSourceResource : public v8::String::ExternalOneByteStringResource {
+    public:
+        BundledSourceResource(std::shared_ptr<const ModuleBundle> bundle, const char* data, size_t length) :
+            _bundle(std::move(bundle)), _data(data), _length(length) {}
+
+        const char* data() const override {
+            return _data;
+        }
+
+        size_t length() const override {
+            return _length;
+        }
+
+    private:
+        std::shared_ptr<const ModuleBundle> _bundle;
+        const char* _data;
+        size_t _length;
+    };
+
+}   // End of anonymous namespace.
+
+v8::Local<v8::String> module_loader_helpers::ReadBundledModule(std::shared_ptr<const ModuleBundle> bundle,
+                                                                const BundledModule& module) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope scope(isolate);
+
+    JS_ENSURE_WITH_RETURN(isolate,
+                          module.sourceLength > 0,
+                          scope.Escape(v8::Local<v8::String>()),
+                          "\"%s\" is empty",
+                          module.info.fullPath.c_str());
+
+    // One-byte external strings are Latin-1, so only ASCII sources can be used in place.
+    if (!module.isAsciiSource) {
+        return scope.Escape(v8_helpers::MakeV8String(isolate, module.source, static_cast<int>(module.sourceLength)));
+    }
+
+    // V8 garbage collection frees the resource.
+    auto resource = new BundledSourceResource(std::move(bundle), module.source, module.sourceLength);
+    return scope.Escape(v8::String::NewExternalOneByte(isolate, resource).ToLocalChecked());
+}
+
 namespace {
 
     void SetupModulePath(v8::Local<v8::Object> exports, const std::string& dirname, const std::string& filename) {
@@ -3,9 +3,11 @@
 
 #pragma once
 
+#include "module-bundle.h"
+
 #include <napa/module/module-internal.h>
-#include <vector>
 
+#include <memory>
 #include <vector>
 
 namespace napa {
@@ -74,6 +76,12 @@ namespace module_loader_helpers {
     /// <returns> V8 string containing file content. </returns>
     v8::Local<v8::String> ReadModuleFile(const std::string& path);
 
+    /// <summary> It reads a module source from a bundle to javascript string. </summary>
+    /// <param name="bundle"> Bundle holding the module. </param>
+    /// <param name="module"> Bundled module. </param>
+    /// <returns> V8 string containing module source, which refers the bundle's memory when possible. </returns>
+    v8::Local<v8::String> ReadBundledModule(std::shared_ptr<const ModuleBundle> bundle, const BundledModule& module);
+
 }   // End of namespace module_loader_helpers.
 }   // End of namespace module
 }   // End of namespace napa
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "core-module-loader.h"
 #include "javascript-module-loader.h"
 #include "json-module-loader.h"
+#include "module-bundle.h"
 #include "module-cache.h"
 #include "module-loader-helpers.h"
 #include "module-resolver.h"
@@ -44,7 +45,8 @@ class ModuleLoader::ModuleLoaderImpl {
 public:
 
     /// <summary> Constructor. </summary>
-    ModuleLoaderImpl();
+    /// <param name="bundle"> Prebuilt module bundle, optional. </param>
+    explicit ModuleLoaderImpl(std::shared_ptr<const ModuleBundle> bundle);
 
     /// <summary> Bootstrap core modules into module loader. </summary>
     /// <remarks>
@@ -110,10 +112,10 @@ private:
     std::array<std::unique_ptr<ModuleFileLoader>, static_cast<size_t>(ModuleType::END_OF_MODULE_TYPE)> _loaders;
 };
 
-void ModuleLoader::CreateModuleLoader() {
+void ModuleLoader::CreateModuleLoader(std::shared_ptr<const ModuleBundle> bundle) {
     auto moduleLoader = reinterpret_cast<ModuleLoader*>(zone::WorkerContext::Get(zone::WorkerContextItem::MODULE_LOADER));
     if (moduleLoader == nullptr) {
-        moduleLoader = new ModuleLoader();
+        moduleLoader = new ModuleLoader(std::move(bundle));
         zone::WorkerContext::Set(zone::WorkerContextItem::MODULE_LOADER, moduleLoader);
 
         // Now, Javascript core module's 'require' can find module loader instance correctly.
@@ -122,11 +124,14 @@ void ModuleLoader::CreateModuleLoader() {
     NAPA_DEBUG("ModuleLoader", "Module loader is created successfully.");
 }
 
-ModuleLoader::ModuleLoader() : _impl(std::make_unique<ModuleLoader::ModuleLoaderImpl>()) {}
+ModuleLoader::ModuleLoader(std::shared_ptr<const ModuleBundle> bundle) :
+    _impl(std::make_unique<ModuleLoader::ModuleLoaderImpl>(std::move(bundle))) {}
 
 ModuleLoader::~ModuleLoader() = default;
 
-ModuleLoader::ModuleLoaderImpl::ModuleLoaderImpl() {
+ModuleLoader::ModuleLoaderImpl::ModuleLoaderImpl(std::shared_ptr<const ModuleBundle> bundle) {
+    _resolver.SetBundle(bundle);
+
     auto builtInModulesSetter = [this](v8::Local<v8::Context> context) {
         SetupRequire(context);
         SetupBuiltInModules(context);
@@ -136,8 +141,8 @@ ModuleLoader::ModuleLoaderImpl::ModuleLoaderImpl() {
     _loaders = {{
         nullptr,
         std::make_unique<CoreModuleLoader>(builtInModulesSetter, _moduleCache, _bindingCache),
-        std::make_unique<JavascriptModuleLoader>(builtInModulesSetter, _moduleCache),
-        std::make_unique<JsonModuleLoader>(),
+        std::make_unique<JavascriptModuleLoader>(builtInModulesSetter, _moduleCache, bundle),
+        std::make_unique<JsonModuleLoader>(bundle),
         std::make_unique<BinaryModuleLoader>(builtInModulesSetter)
     }};
 }
@@ -8,6 +8,8 @@
 namespace napa {
 namespace module {
 
+    class ModuleBundle;
+
     /// <summary>
     /// It follows node.js's module resolution algorithm, https://nodejs.org/api/modules.html#modules_all_together except,
     /// - Napa module is created in thread-safe way.
@@ -17,7 +19,8 @@ namespace module {
     public:
 
         /// <summary> It creates a module loader. One thread can have only one module loader. </summary>
-        static void CreateModuleLoader();
+        /// <param name="bundle"> Prebuilt module bundle to resolve and read modules from before file system, optional. </param>
+        static void CreateModuleLoader(std::shared_ptr<const ModuleBundle> bundle = nullptr);
 
         /// <summary>
         /// A helper macro to create a module loader instance at current thread.
@@ -34,7 +37,7 @@ namespace module {
     private:
 
         /// <summary> Constructor. </summary>
-        ModuleLoader();
+        explicit ModuleLoader(std::shared_ptr<const ModuleBundle> bundle);
 
         /// <summary> Default destructor. </summary>
         ~ModuleLoader();
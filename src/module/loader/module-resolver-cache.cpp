@@ -4,6 +4,7 @@
 #include "module-resolver-cache.h"
 
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 using namespace napa;
@@ -21,50 +22,173 @@ struct ModuleResolverCacheKey {
 namespace std {
     template<>
     struct hash<ModuleResolverCacheKey> {
-        std::size_t operator()(ModuleResolverCacheKey key) const {
+        std::size_t operator()(const ModuleResolverCacheKey& key) const {
             return std::hash<std::string>{}(key._name) ^ std::hash<std::string>{}(key._path);
         }
     };
 }
 
+namespace {
+
+    /// <summary> Type of a path on file system, as far as module resolution is concerned. </summary>
+    enum class PathType {
+        NOT_EXIST,
+        REGULAR_FILE,
+        DIRECTORY
+    };
+
+}   // End of anonymous namespace.
+
 class ModuleResolverCache::ModuleResolverCacheImpl {
 public:
-    ModuleInfo Lookup(const char* name, const char* path);
-    void Insert(const char* name, const char* path, const ModuleInfo& moduleInfo);
+    bool Lookup(const char* name, const char* path, ModuleInfo& moduleInfo);
+    void Insert(const char* name, const char* path, const ModuleInfo& moduleInfo, const uint64_t* generation);
+    uint64_t GetGeneration();
+    PathType GetPathType(const filesystem::Path& path);
+    void Invalidate();
+    void Invalidate(const filesystem::Path& path);
 private:
-    std::mutex _lock;
+    /// <summary> Lookups happen on every require() from every worker, while updates are rare. </summary>
+    std::shared_timed_mutex _lock;
     std::unordered_map<ModuleResolverCacheKey, ModuleInfo> _resolvedModules;
+    std::unordered_map<std::string, PathType> _pathTypes;
+
+    /// <summary> Incremented by every invalidation, so results computed from stale file system state are not kept. </summary>
+    uint64_t _generation = 0;
 };
 
 ModuleResolverCache::ModuleResolverCache() : _impl(std::make_unique<ModuleResolverCache::ModuleResolverCacheImpl>()) {}
 
 ModuleResolverCache::~ModuleResolverCache() = default;
 
-ModuleInfo ModuleResolverCache::Lookup(const char* name, const char* path) {
-    return _impl->Lookup(name, path);
+ModuleResolverCache& ModuleResolverCache::Instance() {
+    static ModuleResolverCache cache;
+    return cache;
+}
+
+bool ModuleResolverCache::Lookup(const char* name, const char* path, ModuleInfo& moduleInfo) {
+    return _impl->Lookup(name, path, moduleInfo);
 }
 
 void ModuleResolverCache::Insert(const char* name, const char* path, const ModuleInfo& moduleInfo) {
-    _impl->Insert(name, path, moduleInfo);
+    _impl->Insert(name, path, moduleInfo, nullptr);
+}
+
+void ModuleResolverCache::Insert(const char* name, const char* path, const ModuleInfo& moduleInfo, uint64_t generation) {
+    _impl->Insert(name, path, moduleInfo, &generation);
+}
+
+uint64_t ModuleResolverCache::GetGeneration() {
+    return _impl->GetGeneration();
 }
 
-ModuleInfo ModuleResolverCache::ModuleResolverCacheImpl::Lookup(const char* name, const char* path) {
+bool ModuleResolverCache::IsRegularFile(const filesystem::Path& path) {
+    return _impl->GetPathType(path) == PathType::REGULAR_FILE;
+}
+
+bool ModuleResolverCache::IsDirectory(const filesystem::Path& path) {
+    return _impl->GetPathType(path) == PathType::DIRECTORY;
+}
+
+void ModuleResolverCache::Invalidate() {
+    _impl->Invalidate();
+}
+
+void ModuleResolverCache::Invalidate(const filesystem::Path& path) {
+    _impl->Invalidate(path);
+}
+
+bool ModuleResolverCache::ModuleResolverCacheImpl::Lookup(const char* name, const char* path, ModuleInfo& moduleInfo) {
     ModuleResolverCacheKey key{name, path};
 
-    std::lock_guard<std::mutex> lock(_lock);
+    std::shared_lock<std::shared_timed_mutex> lock(_lock);
 
     auto result = _resolvedModules.find(key);
     if (result != _resolvedModules.end()) {
-        return result->second;
+        moduleInfo = result->second;
+        return true;
     }
 
-    return ModuleInfo{ModuleType::NONE, name, path};
+    return false;
 }
 
-void ModuleResolverCache::ModuleResolverCacheImpl::Insert(const char* name, const char* path, const ModuleInfo& moduleInfo) {
+void ModuleResolverCache::ModuleResolverCacheImpl::Insert(
+    const char* name,
+    const char* path,
+    const ModuleInfo& moduleInfo,
+    const uint64_t* generation) {
     ModuleResolverCacheKey key{name, path};
     
-    std::lock_guard<std::mutex> lock(_lock);
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+
+    if (generation != nullptr && *generation != _generation) {
+        return;
+    }
+    _resolvedModules.emplace(std::make_pair(std::move(key), moduleInfo));
+}
 
-    _resolvedModules.emplace(std::make_pair(key, moduleInfo));
+uint64_t ModuleResolverCache::ModuleResolverCacheImpl::GetGeneration() {
+    std::shared_lock<std::shared_timed_mutex> lock(_lock);
+    return _generation;
+}
+
+PathType ModuleResolverCache::ModuleResolverCacheImpl::GetPathType(const filesystem::Path& path) {
+    uint64_t generation;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(_lock);
+
+        auto result = _pathTypes.find(path.String());
+        if (result != _pathTypes.end()) {
+            return result->second;
+        }
+        generation = _generation;
+    }
+
+    // Stat outside of the lock. Concurrent misses on the same path may stat twice, but agree on the result.
+    auto type = PathType::NOT_EXIST;
+    if (filesystem::IsRegularFile(path)) {
+        type = PathType::REGULAR_FILE;
+    } else if (filesystem::IsDirectory(path)) {
+        type = PathType::DIRECTORY;
+    }
+
+    // An invalidation during the stat may be for a change the stat missed, then the result is not kept.
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+    if (generation == _generation) {
+        _pathTypes.emplace(path.String(), type);
+    }
+
+    return type;
+}
+
+void ModuleResolverCache::ModuleResolverCacheImpl::Invalidate() {
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+
+    _resolvedModules.clear();
+    _pathTypes.clear();
+    _generation++;
+}
+
+void ModuleResolverCache::ModuleResolverCacheImpl::Invalidate(const filesystem::Path& path) {
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+
+    // Any resolution may depend on the path, e.g. a new file shadowing 'index.js' or a new 'node_modules'.
+    _resolvedModules.clear();
+    _generation++;
+
+    // Stat results may be kept under the path as given, e.g. a relative NODE_PATH entry.
+    _pathTypes.erase(path.String());
+
+    // Parent directories may be created along with the path. Walk up an absolute path until the root,
+    // whose parent doesn't get any shorter.
+    auto subpath = path.Absolute().Normalize();
+    while (!subpath.IsEmpty()) {
+        _pathTypes.erase(subpath.String());
+
+        auto parent = subpath.Parent().Normalize();
+        if (parent.String().size() >= subpath.String().size()) {
+            break;
+        }
+        subpath = std::move(parent);
+    }
 }
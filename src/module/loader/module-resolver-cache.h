@@ -5,6 +5,9 @@
 
 #include "module-resolver.h"
 
+#include <platform/filesystem.h>
+
+#include <cstdint>
 #include <memory>
 
 namespace napa {
@@ -13,6 +16,8 @@ namespace module {
     /// <summary>
     /// The Module resolver cache helps to reduce the overhead when ModuleResolver
     /// is trying to traversal the file system.
+    /// It keeps resolved (including unresolvable) modules and the results of stat calls,
+    /// and is shared by all module resolvers in the process through Instance().
     /// </summary>
     class ModuleResolverCache {
     public:
@@ -31,17 +36,43 @@ namespace module {
         ModuleResolverCache(ModuleResolverCache&&) = default;
         ModuleResolverCache& operator=(ModuleResolverCache&&) = default;
 
+        /// <summary> Returns the process-wide cache used by all module resolvers. </summary>
+        static ModuleResolverCache& Instance();
+
         /// <summary> Lookup the module info. </summary>
         /// <param name="name"> Module name or path. </param>
         /// <param name="path"> Current context path. If nullptr, it'll be current path. </param>
-        /// <returns> Module resolution information. </returns>
-        ModuleInfo Lookup(const char* name, const char* path);
+        /// <param name="moduleInfo"> Cached module resolution information, type is NONE for a negative entry. </param>
+        /// <returns> True if there is an entry for the module, false otherwise. </returns>
+        bool Lookup(const char* name, const char* path, ModuleInfo& moduleInfo);
 
         /// <summary> Insert the specific module info into the cache. </summary>
         /// <param name="name"> Module name or path. </param>
         /// <param name="path"> Current context path. If nullptr, it'll be current path. </param>
+        /// <param name="moduleInfo"> Module resolution information, type NONE records that it can't be resolved. </param>
         void Insert(const char* name, const char* path, const ModuleInfo& moduleInfo);
 
+        /// <summary> Insert module info resolved since a generation, unless the cache was invalidated since then. </summary>
+        /// <param name="generation"> GetGeneration() before the module was resolved. </param>
+        void Insert(const char* name, const char* path, const ModuleInfo& moduleInfo, uint64_t generation);
+
+        /// <summary> Returns a number that changes on every invalidation. </summary>
+        uint64_t GetGeneration();
+
+        /// <summary> Memoized filesystem::IsRegularFile. </summary>
+        bool IsRegularFile(const filesystem::Path& path);
+
+        /// <summary> Memoized filesystem::IsDirectory. </summary>
+        bool IsDirectory(const filesystem::Path& path);
+
+        /// <summary> Drops all module entries and stat results. </summary>
+        void Invalidate();
+
+        /// <summary> Drops stat results of a path and its parent directories, and all module entries. </summary>
+        /// <param name="path"> Path of a file or directory which was created, changed or removed. A relative path is
+        /// taken as relative to the current directory. </param>
+        void Invalidate(const filesystem::Path& path);
+
     private:
         class ModuleResolverCacheImpl;
         std::unique_ptr<ModuleResolverCacheImpl> _impl;
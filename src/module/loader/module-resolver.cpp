@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "module-resolver.h"
+#include "module-bundle.h"
 #include "module-resolver-cache.h"
 
 #include <platform/filesystem.h>
@@ -50,6 +51,10 @@ public:
     /// </returns>
     bool SetAsCoreModule(const char* name);
 
+    /// <summary> It sets a prebuilt bundle, whose resolutions are used before searching file system. </summary>
+    /// <param name="bundle"> Module bundle, or nullptr to resolve from file system only. </param>
+    void SetBundle(std::shared_ptr<const ModuleBundle> bundle);
+
 private:
 
     /// <summary> It resolves a full module path from a given argument of require(). </summary>
@@ -110,8 +115,11 @@ private:
     /// <summary> Paths in 'NODE_PATH' environment variable. </summary>
     std::vector<std::string> _nodePaths;
 
-    /// <summary> Module info cache for all loaded modules. </summary>
-    ModuleResolverCache _cache;
+    /// <summary> Prebuilt module bundle, optional. </summary>
+    std::shared_ptr<const ModuleBundle> _bundle;
+
+    /// <summary> Process-wide module info and stat cache, shared with the resolvers of other workers. </summary>
+    ModuleResolverCache& _cache;
 };
 
 ModuleResolver::ModuleResolver() : _impl(std::make_unique<ModuleResolver::ModuleResolverImpl>()) {}
@@ -126,14 +134,18 @@ bool ModuleResolver::SetAsCoreModule(const char* name) {
     return _impl->SetAsCoreModule(name);
 }
 
-ModuleResolver::ModuleResolverImpl::ModuleResolverImpl() {
+void ModuleResolver::SetBundle(std::shared_ptr<const ModuleBundle> bundle) {
+    _impl->SetBundle(std::move(bundle));
+}
+
+ModuleResolver::ModuleResolverImpl::ModuleResolverImpl() : _cache(ModuleResolverCache::Instance()) {
     auto envPath = platform::GetEnv("NODE_PATH");
     if (!envPath.empty()) {
         std::vector<std::string> nodePaths;
         utils::string::Split(envPath, nodePaths, std::string(platform::ENV_DELIMITER));
 
         for (auto& nodePath : nodePaths) {
-            if (filesystem::IsDirectory(nodePath)) {
+            if (_cache.IsDirectory(nodePath)) {
                 _nodePaths.emplace_back(std::move(nodePath));
             }
         }
@@ -158,21 +170,28 @@ ModuleInfo ModuleResolver::ModuleResolverImpl::Resolve(const char* name, const c
     filesystem::Path basePath =
         (path == nullptr) ? filesystem::CurrentDirectory() : filesystem::Path(path);
 
-    // Lookup for module info cache.
-    RETURN_IF_NOT_EMPTY(_cache.Lookup(name, basePath.c_str()));
-    
-        // Look up from the given path.
-    ModuleInfo moduleInfo = ResolveFromPath(name, basePath);
-    if (moduleInfo.type != ModuleType::NONE) {
-        _cache.Insert(name, basePath.c_str(), moduleInfo);
+    ModuleInfo moduleInfo;
+
+    // Lookup for the prebuilt bundle, which needs no file system access.
+    if (_bundle != nullptr && _bundle->Resolve(name, basePath.c_str(), moduleInfo)) {
         return moduleInfo;
     }
 
-    // Look up NODE_PATH
-    moduleInfo = ResolveFromEnv(name, basePath);
-    if (moduleInfo.type != ModuleType::NONE) {
-        _cache.Insert(name, basePath.c_str(), moduleInfo);
+    // Lookup for module info cache, which also remembers modules that can't be resolved.
+    auto generation = _cache.GetGeneration();
+    if (_cache.Lookup(name, basePath.c_str(), moduleInfo)) {
+        return moduleInfo;
     }
+
+    // Look up from the given path.
+    moduleInfo = ResolveFromPath(name, basePath);
+    if (moduleInfo.type == ModuleType::NONE) {
+        // Look up NODE_PATH
+        moduleInfo = ResolveFromEnv(name, basePath);
+    }
+
+    // Not kept if the cache was invalidated while resolving, as the resolution may have missed the change.
+    _cache.Insert(name, basePath.c_str(), moduleInfo, generation);
     return moduleInfo;
 }
 
@@ -181,6 +200,10 @@ bool ModuleResolver::ModuleResolverImpl::SetAsCoreModule(const char* name) {
     return result.second;
 }
 
+void ModuleResolver::ModuleResolverImpl::SetBundle(std::shared_ptr<const ModuleBundle> bundle) {
+    _bundle = std::move(bundle);
+}
+
 ModuleInfo ModuleResolver::ModuleResolverImpl::ResolveFromPath(const filesystem::Path& name,
                                                                const filesystem::Path& path) {
     // If name begins with './' or '/' or '../',
@@ -217,7 +240,7 @@ ModuleInfo ModuleResolver::ModuleResolverImpl::LoadAsFile(const filesystem::Path
                                                           const filesystem::Path& path) {
     auto fullPath = (path / name).Normalize();
 
-    if (filesystem::IsRegularFile(fullPath)) {
+    if (_cache.IsRegularFile(fullPath)) {
         ModuleType type = ModuleType::JAVASCRIPT;
 
         auto extension = fullPath.Extension().String();
@@ -238,7 +261,7 @@ ModuleInfo ModuleResolver::ModuleResolverImpl::LoadAsDirectory(const filesystem:
     auto fullPath = (path / name).Normalize();
 
     auto packageJson = fullPath / "package.json";
-    if (filesystem::IsRegularFile(packageJson)) {
+    if (_cache.IsRegularFile(packageJson)) {
         rapidjson::Document package;
         try {
             std::ifstream ifs(packageJson.String());
@@ -288,7 +311,7 @@ std::vector<std::string> ModuleResolver::ModuleResolverImpl::GetNodeModulesPaths
         }
 
         auto modulePath = subpath / "node_modules";
-        if (filesystem::IsDirectory(modulePath)) {
+        if (_cache.IsDirectory(modulePath)) {
             subpaths.emplace_back(modulePath.String());
         }
     }
@@ -301,17 +324,17 @@ ModuleInfo ModuleResolver::ModuleResolverImpl::TryExtensions(const filesystem::P
     oss << path.String() << JAVASCRIPT_MODULE_EXTENSION;
 
     auto modulePath = filesystem::Path(oss.str());
-    if (filesystem::IsRegularFile(modulePath)) {
+    if (_cache.IsRegularFile(modulePath)) {
         return ModuleInfo{ModuleType::JAVASCRIPT, modulePath.String(), std::string()};
     }
 
     modulePath.ReplaceExtension(JSON_OBJECT_EXTENSION);
-    if (filesystem::IsRegularFile(modulePath)) {
+    if (_cache.IsRegularFile(modulePath)) {
         return ModuleInfo{ModuleType::JSON, modulePath.String(), std::string()};
     }
 
     modulePath.ReplaceExtension(NAPA_MODULE_EXTENSION);
-    if (filesystem::IsRegularFile(modulePath)) {
+    if (_cache.IsRegularFile(modulePath)) {
         return ModuleInfo{ModuleType::NAPA, modulePath.String(), std::string()};
     }
 
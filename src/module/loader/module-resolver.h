@@ -9,6 +9,8 @@
 namespace napa {
 namespace module {
 
+    class ModuleBundle;
+
     enum class ModuleType : size_t {
         /// <summary> Module is not resolved correctly. </summary>
         NONE,
@@ -45,6 +47,8 @@ namespace module {
     /// It resolves a module path by the algorithm described at
     /// https://nodejs.org/api/modules.html#modules_all_together.
     /// One module loader has one module resolver, so each thread has its own instance of this class.
+    /// Resolution results and file system probes are kept in the process-wide ModuleResolverCache,
+    /// so a module is resolved from the file system only once for all workers.
     /// </summary>
     class ModuleResolver {
     public:
@@ -77,6 +81,10 @@ namespace module {
         /// </returns>
         bool SetAsCoreModule(const char* name);
 
+        /// <summary> It sets a prebuilt bundle, whose resolutions are used before searching file system. </summary>
+        /// <param name="bundle"> Module bundle, or nullptr to resolve from file system only. </param>
+        void SetBundle(std::shared_ptr<const ModuleBundle> bundle);
+
     private:
 
         /// <summary> Implementation of module resolver. </summary>
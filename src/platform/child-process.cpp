@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/child-process.h>
+#include <platform/platform.h>
+
+#ifdef SUPPORT_POSIX
+
+#include <cerrno>
+#include <csignal>
+#include <spawn.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+#else
+
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#include <windows.h>
+#pragma pop_macro("NOMINMAX")
+
+#endif
+
+#include <sstream>
+#include <stdexcept>
+
+namespace napa {
+namespace platform {
+
+ChildProcess::ChildProcess(int32_t id, void* handle) : _id(id), _handle(handle), _exited(false) {
+}
+
+std::unique_ptr<ChildProcess> ChildProcess::Spawn(const std::vector<std::string>& command) {
+    if (command.empty()) {
+        throw std::runtime_error("Command of a child process must not be empty");
+    }
+
+#ifdef SUPPORT_POSIX
+    std::vector<char*> argv;
+    argv.reserve(command.size() + 1);
+    for (const auto& arg : command) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    auto error = ::posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+    if (error != 0) {
+        throw std::runtime_error("Can't start process " + command[0]);
+    }
+    return std::unique_ptr<ChildProcess>(new ChildProcess(static_cast<int32_t>(pid), nullptr));
+#else
+    // Quote each argument, escaping quotes, as CreateProcess takes a single command line.
+    std::ostringstream commandLine;
+    for (size_t i = 0; i < command.size(); ++i) {
+        if (i != 0) {
+            commandLine << ' ';
+        }
+        commandLine << '"';
+        for (auto c : command[i]) {
+            if (c == '"') {
+                commandLine << '\\';
+            }
+            commandLine << c;
+        }
+        commandLine << '"';
+    }
+    auto commandLineString = commandLine.str();
+
+    STARTUPINFOA startupInfo = { sizeof(STARTUPINFOA) };
+    PROCESS_INFORMATION processInfo;
+    if (!::CreateProcessA(nullptr, &commandLineString[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo)) {
+        throw std::runtime_error("Can't start process " + command[0]);
+    }
+    ::CloseHandle(processInfo.hThread);
+    return std::unique_ptr<ChildProcess>(new ChildProcess(static_cast<int32_t>(processInfo.dwProcessId), processInfo.hProcess));
+#endif
+}
+
+ChildProcess::~ChildProcess() {
+    Kill();
+#ifndef SUPPORT_POSIX
+    ::CloseHandle(_handle);
+#endif
+}
+
+bool ChildProcess::IsRunning() {
+    if (_exited) {
+        return false;
+    }
+
+#ifdef SUPPORT_POSIX
+    int status;
+    auto result = ::waitpid(static_cast<pid_t>(_id), &status, WNOHANG);
+    _exited = result == static_cast<pid_t>(_id) || (result < 0 && errno == ECHILD);
+#else
+    _exited = ::WaitForSingleObject(_handle, 0) == WAIT_OBJECT_0;
+#endif
+    return !_exited;
+}
+
+void ChildProcess::Kill() {
+    if (!IsRunning()) {
+        return;
+    }
+
+#ifdef SUPPORT_POSIX
+    ::kill(static_cast<pid_t>(_id), SIGKILL);
+
+    int status;
+    while (::waitpid(static_cast<pid_t>(_id), &status, 0) < 0 && errno == EINTR) {
+    }
+#else
+    ::TerminateProcess(_handle, 1);
+    ::WaitForSingleObject(_handle, INFINITE);
+#endif
+    _exited = true;
+}
+
+bool IsProcessRunning(int32_t id) {
+#ifdef SUPPORT_POSIX
+    return ::kill(static_cast<pid_t>(id), 0) == 0 || errno == EPERM;
+#else
+    auto handle = ::OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(id));
+    if (handle == nullptr) {
+        return false;
+    }
+    auto running = ::WaitForSingleObject(handle, 0) == WAIT_TIMEOUT;
+    ::CloseHandle(handle);
+    return running;
+#endif
+}
+
+}
+}
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> Cross-platform child process, which is killed when this object is destroyed. </summary>
+    class ChildProcess {
+    public:
+        /// <summary> Starts a child process. </summary>
+        /// <param name="command"> Executable, searched in PATH if it's not a path, followed by its arguments. </param>
+        /// <returns> The process. It throws std::runtime_error if the process can't be started. </returns>
+        static std::unique_ptr<ChildProcess> Spawn(const std::vector<std::string>& command);
+
+        /// <summary> Kills the process if it's still running, and waits for it to exit. </summary>
+        ~ChildProcess();
+
+        /// <summary> Non-copyable. </summary>
+        ChildProcess(const ChildProcess&) = delete;
+        ChildProcess& operator=(const ChildProcess&) = delete;
+
+        /// <summary> Process id. </summary>
+        int32_t GetId() const {
+            return _id;
+        }
+
+        /// <summary> Returns true if the process hasn't exited. </summary>
+        bool IsRunning();
+
+        /// <summary> Kills the process and waits for it to exit. </summary>
+        void Kill();
+
+    private:
+        ChildProcess(int32_t id, void* handle);
+
+        int32_t _id;
+        void* _handle;
+        bool _exited;
+    };
+
+    /// <summary> Returns true if a process with the id exists. </summary>
+    bool IsProcessRunning(int32_t id);
+}
+}
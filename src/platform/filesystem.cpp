@@ -554,6 +554,14 @@ bool MakeDirectories(const Path& path) {
     return MakeDirectory(path);
 }
 
+bool ReplaceFile(const Path& source, const Path& target) {
+#ifdef SUPPORT_POSIX
+    return ::rename(source.c_str(), target.c_str()) == 0;
+#else
+    return ::MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) == TRUE;
+#endif
+}
+
 PathIterator::PathIterator(Path path)
     : _base(std::move(path)) {
 #ifdef SUPPORT_POSIX
@@ -188,6 +188,10 @@ namespace filesystem {
     /// <summary> Make directories recursively. </summary>
     bool MakeDirectories(const Path& path);
 
+    /// <summary> Move a file to a target path, atomically replacing the target if it exists. </summary>
+    /// <returns> True if succeeded, false if operation failed. </returns>
+    bool ReplaceFile(const Path& source, const Path& target);
+
     /// <summary> Path iterator </summary>
     class PathIterator {
     public:
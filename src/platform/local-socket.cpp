@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/local-socket.h>
+#include <platform/platform.h>
+
+#ifdef SUPPORT_POSIX
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#else
+
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#include <winsock2.h>
+#include <afunix.h>
+#pragma pop_macro("NOMINMAX")
+
+#endif
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace napa {
+namespace platform {
+
+namespace {
+
+#ifdef SUPPORT_POSIX
+    using SocketHandle = int;
+    const SocketHandle INVALID_SOCKET_HANDLE = -1;
+
+    void CloseSocket(SocketHandle handle) {
+        ::close(handle);
+    }
+
+    void RemoveSocketFile(const std::string& path) {
+        ::unlink(path.c_str());
+    }
+
+    bool IsInterrupted() {
+        return errno == EINTR;
+    }
+
+    /// <summary> Returns true if the path doesn't exist. </summary>
+    bool IsMissing(const std::string& path) {
+        struct stat status;
+        return ::lstat(path.c_str(), &status) != 0 && errno == ENOENT;
+    }
+
+    /// <summary> Returns true if the path is a socket file. </summary>
+    bool IsSocketFile(const std::string& path) {
+        struct stat status;
+        return ::lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode);
+    }
+
+    /// <summary> Returns true if the last connect failed because nothing listens on the socket file. </summary>
+    bool IsConnectionRefused() {
+        return errno == ECONNREFUSED;
+    }
+
+#ifdef MSG_NOSIGNAL
+    // A write to a closed peer returns an error instead of raising SIGPIPE.
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+    int PollSocket(SocketHandle handle, int milliseconds) {
+        pollfd entry = { handle, POLLIN, 0 };
+        return ::poll(&entry, 1, milliseconds);
+    }
+#else
+    using SocketHandle = SOCKET;
+    const SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+
+    void CloseSocket(SocketHandle handle) {
+        ::closesocket(handle);
+    }
+
+    void RemoveSocketFile(const std::string& path) {
+        ::DeleteFileA(path.c_str());
+    }
+
+    bool IsInterrupted() {
+        return false;
+    }
+
+    bool IsMissing(const std::string& path) {
+        return ::GetFileAttributesA(path.c_str()) == INVALID_FILE_ATTRIBUTES && ::GetLastError() == ERROR_FILE_NOT_FOUND;
+    }
+
+    /// <remarks> Unix domain socket files are reparse points on Windows. </remarks>
+    bool IsSocketFile(const std::string& path) {
+        auto attributes = ::GetFileAttributesA(path.c_str());
+        return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+    }
+
+    bool IsConnectionRefused() {
+        return ::WSAGetLastError() == WSAECONNREFUSED;
+    }
+
+    const int SEND_FLAGS = 0;
+
+    int PollSocket(SocketHandle handle, int milliseconds) {
+        WSAPOLLFD entry = { handle, POLLRDNORM, 0 };
+        return ::WSAPoll(&entry, 1, milliseconds);
+    }
+#endif
+
+    /// <summary> Creates a socket and fills in the address of a path. </summary>
+    SocketHandle CreateSocket(const std::string& path, sockaddr_un& address) {
+#ifndef SUPPORT_POSIX
+        static std::once_flag startup;
+        std::call_once(startup, []() {
+            WSADATA data;
+            ::WSAStartup(MAKEWORD(2, 2), &data);
+        });
+#endif
+
+        std::memset(&address, 0, sizeof(address));
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path is too long: " + path);
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        auto handle = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (handle == INVALID_SOCKET_HANDLE) {
+            throw std::runtime_error("Can't create socket for " + path);
+        }
+
+#if defined(SO_NOSIGPIPE)
+        int enabled = 1;
+        ::setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+        return handle;
+    }
+
+    /// <summary>
+    /// Removes a socket file left behind by a server that is no longer running, which would fail the bind.
+    /// A socket some server still listens on, or a file that isn't a socket, is left alone.
+    /// </summary>
+    /// <returns> True if the path is free to bind. </returns>
+    bool RemoveStaleSocketFile(const std::string& path, const sockaddr_un& address) {
+        if (IsMissing(path)) {
+            return true;
+        }
+        if (!IsSocketFile(path)) {
+            return false;
+        }
+
+        auto probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe == INVALID_SOCKET_HANDLE) {
+            return false;
+        }
+        auto connected = ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        auto stale = !connected && IsConnectionRefused();
+        CloseSocket(probe);
+
+        if (stale) {
+            RemoveSocketFile(path);
+        }
+        return stale;
+    }
+
+} // namespace
+
+LocalSocket::LocalSocket(intptr_t handle) : _handle(handle) {
+}
+
+std::unique_ptr<LocalSocket> LocalSocket::Connect(const std::string& path) {
+    sockaddr_un address;
+    auto handle = CreateSocket(path, address);
+
+    if (::connect(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        CloseSocket(handle);
+        throw std::runtime_error("Can't connect to " + path);
+    }
+    return std::unique_ptr<LocalSocket>(new LocalSocket(static_cast<intptr_t>(handle)));
+}
+
+LocalSocket::~LocalSocket() {
+    CloseSocket(static_cast<SocketHandle>(_handle));
+}
+
+bool LocalSocket::Write(const char* data, size_t size) {
+    while (size > 0) {
+        auto written = ::send(static_cast<SocketHandle>(_handle), data, static_cast<int>(size), SEND_FLAGS);
+        if (written < 0 && IsInterrupted()) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+size_t LocalSocket::Read(char* buffer, size_t size) {
+    while (true) {
+        auto read = ::recv(static_cast<SocketHandle>(_handle), buffer, static_cast<int>(size), 0);
+        if (read < 0 && IsInterrupted()) {
+            continue;
+        }
+        return read > 0 ? static_cast<size_t>(read) : 0;
+    }
+}
+
+void LocalSocket::Shutdown() {
+#ifdef SUPPORT_POSIX
+    ::shutdown(static_cast<SocketHandle>(_handle), SHUT_RDWR);
+#else
+    ::shutdown(static_cast<SocketHandle>(_handle), SD_BOTH);
+#endif
+}
+
+LocalSocketListener::LocalSocketListener(intptr_t handle, std::string path) : _handle(handle), _path(std::move(path)) {
+}
+
+std::unique_ptr<LocalSocketListener> LocalSocketListener::Listen(const std::string& path) {
+    sockaddr_un address;
+    auto handle = CreateSocket(path, address);
+
+    if (!RemoveStaleSocketFile(path, address)) {
+        CloseSocket(handle);
+        throw std::runtime_error("Can't listen on " + path + ": address in use");
+    }
+
+    if (::bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(handle, SOMAXCONN) != 0) {
+        CloseSocket(handle);
+        throw std::runtime_error("Can't listen on " + path);
+    }
+    return std::unique_ptr<LocalSocketListener>(new LocalSocketListener(static_cast<intptr_t>(handle), path));
+}
+
+LocalSocketListener::~LocalSocketListener() {
+    CloseSocket(static_cast<SocketHandle>(_handle));
+    RemoveSocketFile(_path);
+}
+
+std::unique_ptr<LocalSocket> LocalSocketListener::Accept(std::chrono::milliseconds timeout) {
+    auto handle = static_cast<SocketHandle>(_handle);
+    if (PollSocket(handle, static_cast<int>(timeout.count())) <= 0) {
+        return nullptr;
+    }
+
+    auto connection = ::accept(handle, nullptr, nullptr);
+    if (connection == INVALID_SOCKET_HANDLE) {
+        return nullptr;
+    }
+
+#if defined(SO_NOSIGPIPE)
+    int enabled = 1;
+    ::setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+    return std::unique_ptr<LocalSocket>(new LocalSocket(static_cast<intptr_t>(connection)));
+}
+
+}
+}
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> Cross-platform stream socket over a Unix domain socket path. </summary>
+    /// <remarks> Windows supports Unix domain sockets since Windows 10 1803. </remarks>
+    class LocalSocket {
+    public:
+        /// <summary> Connects to a listening socket. </summary>
+        /// <returns> The connected socket. It throws std::runtime_error on failures. </returns>
+        static std::unique_ptr<LocalSocket> Connect(const std::string& path);
+
+        ~LocalSocket();
+
+        /// <summary> Non-copyable. </summary>
+        LocalSocket(const LocalSocket&) = delete;
+        LocalSocket& operator=(const LocalSocket&) = delete;
+
+        /// <summary> Writes all bytes, blocking until they are sent. </summary>
+        /// <returns> False if the connection is broken. </returns>
+        bool Write(const char* data, size_t size);
+
+        /// <summary> Reads available bytes, blocking until there are some. </summary>
+        /// <returns> Number of bytes read, 0 if the connection is closed or broken. </returns>
+        size_t Read(char* buffer, size_t size);
+
+        /// <summary> Shuts down both directions, which wakes up blocked reads and writes on either end. </summary>
+        void Shutdown();
+
+    private:
+        friend class LocalSocketListener;
+        explicit LocalSocket(intptr_t handle);
+
+        intptr_t _handle;
+    };
+
+    /// <summary> Cross-platform listening Unix domain socket. </summary>
+    class LocalSocketListener {
+    public:
+        /// <summary> Binds and listens on a path, replacing a stale socket file that no server listens on. </summary>
+        /// <returns>
+        ///     The listener. It throws std::runtime_error on failures, including when a server listens on the path
+        ///     or the path is taken by a file that is not a socket.
+        /// </returns>
+        static std::unique_ptr<LocalSocketListener> Listen(const std::string& path);
+
+        /// <summary> Closes the socket and removes its path. </summary>
+        ~LocalSocketListener();
+
+        /// <summary> Non-copyable. </summary>
+        LocalSocketListener(const LocalSocketListener&) = delete;
+        LocalSocketListener& operator=(const LocalSocketListener&) = delete;
+
+        /// <summary> Accepts a connection. </summary>
+        /// <param name="timeout"> Max time to wait for a connection. </param>
+        /// <returns> The connected socket, or nullptr if none came in time. </returns>
+        std::unique_ptr<LocalSocket> Accept(std::chrono::milliseconds timeout);
+
+    private:
+        LocalSocketListener(intptr_t handle, std::string path);
+
+        intptr_t _handle;
+        std::string _path;
+    };
+}
+}
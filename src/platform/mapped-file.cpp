@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/mapped-file.h>
+#include <platform/platform.h>
+
+#ifdef SUPPORT_POSIX
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#else
+
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#include <windows.h>
+#pragma pop_macro("NOMINMAX")
+
+#endif
+
+#include <stdexcept>
+
+namespace napa {
+namespace filesystem {
+
+MappedFile::MappedFile(const Path& path) : _data(nullptr), _size(0) {
+#ifdef SUPPORT_POSIX
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Can't open for mapping " + path.String());
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Can't stat for mapping " + path.String());
+    }
+
+    _size = static_cast<size_t>(st.st_size);
+    if (_size > 0) {
+        auto address = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Can't map " + path.String());
+        }
+        _data = static_cast<const char*>(address);
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+#else
+    _mappingHandle = nullptr;
+    _fileHandle = ::CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Can't open for mapping " + path.String());
+    }
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(_fileHandle, &size)) {
+        ::CloseHandle(_fileHandle);
+        throw std::runtime_error("Can't stat for mapping " + path.String());
+    }
+
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size > 0) {
+        _mappingHandle = ::CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mappingHandle == nullptr) {
+            ::CloseHandle(_fileHandle);
+            throw std::runtime_error("Can't map " + path.String());
+        }
+
+        _data = static_cast<const char*>(::MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (_data == nullptr) {
+            ::CloseHandle(_mappingHandle);
+            ::CloseHandle(_fileHandle);
+            throw std::runtime_error("Can't map " + path.String());
+        }
+    }
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef SUPPORT_POSIX
+    if (_data != nullptr) {
+        ::munmap(const_cast<char*>(_data), _size);
+    }
+#else
+    if (_data != nullptr) {
+        ::UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle != nullptr) {
+        ::CloseHandle(_mappingHandle);
+    }
+    ::CloseHandle(_fileHandle);
+#endif
+}
+
+}
+}
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <platform/filesystem.h>
+
+#include <cstddef>
+
+namespace napa {
+namespace filesystem {
+
+    /// <summary> Cross-platform read-only memory mapping of a whole file. </summary>
+    class MappedFile {
+    public:
+        /// <summary> Maps a file into memory. It throws std::runtime_error if the file can't be mapped. </summary>
+        explicit MappedFile(const Path& path);
+
+        ~MappedFile();
+
+        /// <summary> Non-copyable and non-movable, mapped memory is handed out by address. </summary>
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// <summary> Start of the mapped content. Null for an empty file. </summary>
+        const char* Data() const {
+            return _data;
+        }
+
+        /// <summary> Size of the mapped content in bytes. </summary>
+        size_t Size() const {
+            return _size;
+        }
+
+    private:
+        const char* _data;
+        size_t _size;
+
+#ifndef SUPPORT_POSIX
+        void* _fileHandle;
+        void* _mappingHandle;
+#endif
+    };
+}
+}
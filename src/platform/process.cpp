@@ -9,6 +9,7 @@
 #include <unistd.h>
 #include <limits.h>
 #include <sys/syscall.h>
+#include <time.h>
 
 #else
 
@@ -163,6 +164,27 @@ int32_t Gettid() {
 #endif
 }
 
+std::chrono::nanoseconds GetThreadCpuTime() {
+#ifdef SUPPORT_POSIX
+    struct timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#else
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    // FILETIME counts 100-nanosecond intervals.
+    auto toTicks = [](const FILETIME& time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return std::chrono::nanoseconds((toTicks(kernelTime) + toTicks(userTime)) * 100);
+#endif
+}
+
 int32_t Isatty(int32_t fd) {
 #ifdef SUPPORT_POSIX
     return static_cast<int32_t>(isatty(fd));
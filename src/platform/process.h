@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -30,6 +31,9 @@ namespace platform {
     /// <summary> Return tid. </summary>
     int32_t Gettid();
 
+    /// <summary> Return CPU time consumed by the calling thread. </summary>
+    std::chrono::nanoseconds GetThreadCpuTime();
+
     /// <summary> Return nonzero value if a descriptor is associated with a character device. </summary>
     /// <param name="fd"> File descriptor. </param>
     int32_t Isatty(int32_t fd);
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/shared-memory.h>
+#include <platform/platform.h>
+
+#ifdef SUPPORT_POSIX
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#else
+
+#pragma push_macro("NOMINMAX")
+#define NOMINMAX
+#include <windows.h>
+#pragma pop_macro("NOMINMAX")
+
+#endif
+
+#include <stdexcept>
+
+namespace napa {
+namespace platform {
+
+namespace {
+
+#ifdef SUPPORT_POSIX
+    std::string GetSystemName(const std::string& name) {
+        return "/" + name;
+    }
+#else
+    std::string GetSystemName(const std::string& name) {
+        return "Local\\" + name;
+    }
+#endif
+
+}   // End of anonymous namespace.
+
+SharedMemory::SharedMemory(std::string name, char* data, size_t size, void* handle) :
+    _name(std::move(name)), _data(data), _size(size), _handle(handle) {
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name, size_t size) {
+    auto systemName = GetSystemName(name);
+#ifdef SUPPORT_POSIX
+    int fd = ::shm_open(systemName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            return nullptr;
+        }
+        throw std::runtime_error("Can't create shared memory " + systemName);
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        ::shm_unlink(systemName.c_str());
+        throw std::runtime_error("Can't resize shared memory " + systemName);
+    }
+
+    auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        ::shm_unlink(systemName.c_str());
+        throw std::runtime_error("Can't map shared memory " + systemName);
+    }
+    return std::unique_ptr<SharedMemory>(new SharedMemory(systemName, static_cast<char*>(address), size, nullptr));
+#else
+    auto handle = ::CreateFileMappingA(
+        INVALID_HANDLE_VALUE,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+        static_cast<DWORD>(size & 0xFFFFFFFF),
+        systemName.c_str());
+    if (handle == nullptr) {
+        throw std::runtime_error("Can't create shared memory " + systemName);
+    }
+    if (::GetLastError() == ERROR_ALREADY_EXISTS) {
+        ::CloseHandle(handle);
+        return nullptr;
+    }
+
+    auto address = ::MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (address == nullptr) {
+        ::CloseHandle(handle);
+        throw std::runtime_error("Can't map shared memory " + systemName);
+    }
+    return std::unique_ptr<SharedMemory>(new SharedMemory(systemName, static_cast<char*>(address), size, handle));
+#endif
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string& name) {
+    auto systemName = GetSystemName(name);
+#ifdef SUPPORT_POSIX
+    int fd = ::shm_open(systemName.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return nullptr;
+        }
+        throw std::runtime_error("Can't open shared memory " + systemName);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Can't stat shared memory " + systemName);
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Can't map shared memory " + systemName);
+    }
+    return std::unique_ptr<SharedMemory>(new SharedMemory(systemName, static_cast<char*>(address), size, nullptr));
+#else
+    auto handle = ::OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName.c_str());
+    if (handle == nullptr) {
+        if (::GetLastError() == ERROR_FILE_NOT_FOUND) {
+            return nullptr;
+        }
+        throw std::runtime_error("Can't open shared memory " + systemName);
+    }
+
+    auto address = ::MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (address == nullptr) {
+        ::CloseHandle(handle);
+        throw std::runtime_error("Can't map shared memory " + systemName);
+    }
+
+    MEMORY_BASIC_INFORMATION info;
+    ::VirtualQuery(address, &info, sizeof(info));
+    return std::unique_ptr<SharedMemory>(
+        new SharedMemory(systemName, static_cast<char*>(address), static_cast<size_t>(info.RegionSize), handle));
+#endif
+}
+
+void SharedMemory::Unlink() {
+#ifdef SUPPORT_POSIX
+    ::shm_unlink(_name.c_str());
+#endif
+}
+
+SharedMemory::~SharedMemory() {
+#ifdef SUPPORT_POSIX
+    ::munmap(_data, _size);
+#else
+    ::UnmapViewOfFile(_data);
+    ::CloseHandle(_handle);
+#endif
+}
+
+}
+}
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> Cross-platform named shared memory, which can be mapped by multiple processes. </summary>
+    class SharedMemory {
+    public:
+        /// <summary> Creates and maps a zero-filled named segment. </summary>
+        /// <param name="name"> Name of the segment, without platform specific prefix. </param>
+        /// <param name="size"> Size of the segment in bytes. </param>
+        /// <returns> The segment, or nullptr if a segment with the name already exists.
+        /// It throws std::runtime_error on other failures. </returns>
+        static std::unique_ptr<SharedMemory> Create(const std::string& name, size_t size);
+
+        /// <summary> Opens and maps an existing named segment. </summary>
+        /// <returns> The segment, or nullptr if it doesn't exist. It throws std::runtime_error on other failures. </returns>
+        static std::unique_ptr<SharedMemory> Open(const std::string& name);
+
+        ~SharedMemory();
+
+        /// <summary> Non-copyable. </summary>
+        SharedMemory(const SharedMemory&) = delete;
+        SharedMemory& operator=(const SharedMemory&) = delete;
+
+        /// <summary> Start of the mapped segment. </summary>
+        char* Data() const {
+            return _data;
+        }
+
+        /// <summary> Size of the mapped segment in bytes. </summary>
+        size_t Size() const {
+            return _size;
+        }
+
+        /// <summary> Removes the name, so it can't be opened again. Existing mappings stay valid. </summary>
+        /// <remarks> No-op on Windows, where the segment goes away with its last handle. </remarks>
+        void Unlink();
+
+    private:
+        SharedMemory(std::string name, char* data, size_t size, void* handle);
+
+        std::string _name;
+        char* _data;
+        size_t _size;
+        void* _handle;
+    };
+}
+}
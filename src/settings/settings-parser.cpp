@@ -46,6 +46,12 @@ bool settings::Parse(const std::vector<std::string>& args, ZoneSettings& setting
     args::ValueFlag<uint32_t> maxSemiSpaceSize(parser, "maxSemiSpaceSize", "max semi space size in MB", { "maxSemiSpaceSize" });
     args::ValueFlag<uint32_t> maxExecutableSize(parser, "maxExecutableSize", "max executable size in MB", { "maxExecutableSize" });
     args::ValueFlag<uint32_t> maxStackSize(parser, "maxStackSize", "max isolate stack size in bytes", { "maxStackSize" });
+    args::ValueFlag<std::string> bundle(parser, "bundle", "module bundle path", { "bundle" });
+    args::ValueFlag<uint32_t> idleSpinMicroseconds(parser, "idleSpinMicroseconds", "max idle spin in microseconds", { "idleSpinMicroseconds" });
+    args::ValueFlag<uint32_t> processes(parser, "processes", "number of helper processes", { "processes" });
+    args::ValueFlag<std::string> remote(parser, "remote", "remote zone server socket path", { "remote" });
+    args::ValueFlag<uint32_t> connections(parser, "connections", "number of remote zone connections", { "connections" });
+    args::ValueFlag<uint32_t> resultCacheBytes(parser, "resultCacheBytes", "max bytes of cached results", { "resultCacheBytes" });
 
     try {
         parser.ParseArgs(args);
@@ -77,5 +83,30 @@ bool settings::Parse(const std::vector<std::string>& args, ZoneSettings& setting
         settings.maxStackSize = maxStackSize.Get();
     }
 
+    if (bundle) {
+        settings.bundle = bundle.Get();
+    }
+
+    if (idleSpinMicroseconds) {
+        settings.idleSpinMicroseconds = idleSpinMicroseconds.Get();
+    }
+
+    if (processes) {
+        settings.processes = processes.Get();
+    }
+
+    if (remote) {
+        settings.remote = remote.Get();
+    }
+
+    if (connections) {
+        NAPA_ASSERT(connections.Get() > 0, "The number of connections must be greater than 0");
+        settings.connections = connections.Get();
+    }
+
+    if (resultCacheBytes) {
+        settings.resultCacheBytes = resultCacheBytes.Get();
+    }
+
     return true;
 }
\ No newline at end of file
@@ -40,6 +40,34 @@ namespace settings {
 
         /// <summary> The maximum size that the isolate stack is allowed to grow in bytes. </summary>
         uint32_t maxStackSize = 500 * 1024;
+
+        /// <summary> Path of a prebuilt module bundle to resolve and load modules from. Empty if not used. </summary>
+        std::string bundle;
+
+        /// <summary>
+        /// Max microseconds an idle worker spins before parking on its task event, 0 to park right away.
+        /// The actual spin is tuned from recent task arrival gaps of the worker.
+        /// </summary>
+        uint32_t idleSpinMicroseconds = 0u;
+
+        /// <summary>
+        /// The number of helper processes to run zone workers in, each with 'workers' workers.
+        /// 0 runs workers in the current process.
+        /// </summary>
+        uint32_t processes = 0u;
+
+        /// <summary>
+        /// Socket path of a remote zone server to forward calls to, which makes the zone a proxy. Empty if not used.
+        /// </summary>
+        std::string remote;
+
+        /// <summary> The number of connections to a remote zone server, each carrying many calls at a time. </summary>
+        uint32_t connections = 1u;
+
+        /// <summary>
+        /// Max bytes of results cached for calls with a cache time to live, 0 to disable the result cache.
+        /// </summary>
+        uint32_t resultCacheBytes = 16 * 1024 * 1024;
     };
 }
 }
\ No newline at end of file
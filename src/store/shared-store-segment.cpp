@@ -0,0 +1,493 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "shared-store-segment.h"
+
+#include <platform/child-process.h>
+#include <platform/process.h>
+#include <platform/shared-memory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace napa;
+using namespace napa::store;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared store requires lock-free 64-bit atomics to work across processes.");
+
+namespace {
+
+    const uint64_t SEGMENT_MAGIC = 0x534d485341504e41ULL;   // "ANPASHMS" in little-endian.
+    const uint32_t SEGMENT_VERSION = 2;
+
+    /// <summary> Top bit of a record word, which marks the key as deleted. </summary>
+    const uint64_t DELETED_BIT = 1ULL << 63;
+
+    /// <summary> How long Open waits for the creator to finish initializing the segment. </summary>
+    const auto INITIALIZE_TIMEOUT = std::chrono::seconds(1);
+
+    struct RecordHeader {
+        /// <summary> Milliseconds since epoch of system clock, 0 for never expire. </summary>
+        uint64_t expiresAt;
+        uint32_t keyLength;
+
+        /// <summary> Number of chars of the payload. </summary>
+        uint32_t payloadLength;
+
+        /// <summary> 1 if the payload is kept as Latin-1, 0 if UTF-16. </summary>
+        uint8_t oneByte;
+    };
+
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint64_t NowInMilliseconds() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    /// <summary> FNV-1a hash of key, never 0 since 0 marks a slot being published. </summary>
+    uint64_t HashKey(const char* key, size_t length) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<uint8_t>(key[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash == 0 ? 1 : hash;
+    }
+
+    std::string GetSegmentName(const std::string& id) {
+        auto valid = !id.empty() && id.size() <= 200 && std::all_of(id.begin(), id.end(), [](char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+        });
+        if (!valid) {
+            throw std::runtime_error("Shared store id \"" + id + "\" must be 1 to 200 characters of [A-Za-z0-9._-]");
+        }
+        return "napa-store-" + id;
+    }
+
+}   // End of anonymous namespace.
+
+struct SharedStoreSegment::Header {
+    /// <summary> Written last by the creator, so openers know the segment is initialized. </summary>
+    std::atomic<uint64_t> magic;
+    uint32_t layoutVersion;
+    uint32_t ttl;
+
+    /// <summary> Process that created the segment and removes its name when it's done with it. </summary>
+    int32_t creatorProcessId;
+    uint64_t slotCount;
+    uint64_t maxEntries;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+
+    /// <summary> Bytes of the data area in use. </summary>
+    std::atomic<uint64_t> dataTail;
+
+    /// <summary> Number of keys which are not deleted, including expired keys not yet purged. </summary>
+    std::atomic<uint64_t> size;
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> expirations;
+
+    /// <summary> Set once any key is written with a time to live, so Size only scans for expired keys when needed. </summary>
+    std::atomic<uint32_t> hasExpiry;
+};
+
+struct SharedStoreSegment::Slot {
+    /// <summary> Hash of the key, 0 until the slot is published. </summary>
+    std::atomic<uint64_t> keyHash;
+
+    /// <summary> Offset of the current record with DELETED_BIT, 0 if the slot is empty. </summary>
+    std::atomic<uint64_t> record;
+};
+
+std::unique_ptr<SharedStoreSegment> SharedStoreSegment::Create(const std::string& id, size_t maxEntries, size_t maxBytes, uint32_t ttl) {
+    if (maxEntries == 0 || maxBytes == 0) {
+        throw std::runtime_error("Shared store requires non-zero maxEntries and maxBytes");
+    }
+
+    // Keep load factor of the index at most 0.5, so probes stay short.
+    uint64_t slotCount = 16;
+    while (slotCount < maxEntries * 2) {
+        slotCount <<= 1;
+    }
+
+    auto name = GetSegmentName(id);
+    auto dataOffset = AlignUp(sizeof(Header), 64) + AlignUp(slotCount * sizeof(Slot), 64);
+    auto memory = platform::SharedMemory::Create(name, dataOffset + maxBytes);
+    if (memory == nullptr) {
+        // A creator that crashed leaves its segment behind, which is replaced instead of failing forever.
+        // Two processes replacing the same stale segment at once may both succeed, the first one is orphaned.
+        auto existing = platform::SharedMemory::Open(name);
+        if (existing != nullptr && !IsStale(*existing)) {
+            return nullptr;
+        }
+        if (existing != nullptr) {
+            existing->Unlink();
+        }
+        memory = platform::SharedMemory::Create(name, dataOffset + maxBytes);
+        if (memory == nullptr) {
+            return nullptr;
+        }
+    }
+
+    // Shared memory is zero-filled, so slots are empty and counters are 0.
+    auto header = new (memory->Data()) Header();
+    header->layoutVersion = SEGMENT_VERSION;
+    header->ttl = ttl;
+    header->creatorProcessId = platform::Getpid();
+    header->slotCount = slotCount;
+    header->maxEntries = maxEntries;
+    header->dataOffset = dataOffset;
+    header->dataSize = maxBytes;
+    header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<SharedStoreSegment>(new SharedStoreSegment(std::move(memory)));
+}
+
+std::unique_ptr<SharedStoreSegment> SharedStoreSegment::Open(const std::string& id) {
+    auto memory = platform::SharedMemory::Open(GetSegmentName(id));
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    if (memory->Size() < sizeof(Header)) {
+        throw std::runtime_error("Shared store \"" + id + "\" is malformed");
+    }
+
+    if (!WaitForInitialized(*memory)) {
+        throw std::runtime_error("Shared store \"" + id + "\" is not initialized");
+    }
+
+    auto header = reinterpret_cast<Header*>(memory->Data());
+
+    if (header->layoutVersion != SEGMENT_VERSION
+        || header->dataOffset < sizeof(Header) + header->slotCount * sizeof(Slot)
+        || header->dataOffset + header->dataSize > memory->Size()) {
+        throw std::runtime_error("Shared store \"" + id + "\" is malformed");
+    }
+    return std::unique_ptr<SharedStoreSegment>(new SharedStoreSegment(std::move(memory)));
+}
+
+bool SharedStoreSegment::WaitForInitialized(const platform::SharedMemory& memory) {
+    auto header = reinterpret_cast<Header*>(memory.Data());
+    auto deadline = std::chrono::steady_clock::now() + INITIALIZE_TIMEOUT;
+    while (header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+bool SharedStoreSegment::IsStale(const platform::SharedMemory& memory) {
+    if (memory.Size() < sizeof(Header) || !WaitForInitialized(memory)) {
+        return true;
+    }
+
+    // Segments of other layouts are left alone, as their creator can't be told.
+    auto header = reinterpret_cast<const Header*>(memory.Data());
+    return header->layoutVersion == SEGMENT_VERSION && !platform::IsProcessRunning(header->creatorProcessId);
+}
+
+SharedStoreSegment::SharedStoreSegment(std::unique_ptr<platform::SharedMemory> memory) :
+    _memory(std::move(memory)),
+    _header(reinterpret_cast<Header*>(_memory->Data())),
+    _slots(reinterpret_cast<Slot*>(_memory->Data() + AlignUp(sizeof(Header), 64))) {
+}
+
+SharedStoreSegment::~SharedStoreSegment() = default;
+
+uint64_t SharedStoreSegment::Get(const std::string& key, Payload* payload) {
+    return Lookup(key, payload, true);
+}
+
+uint64_t SharedStoreSegment::GetVersion(const std::string& key) {
+    return Lookup(key, nullptr, false);
+}
+
+uint64_t SharedStoreSegment::Lookup(const std::string& key, Payload* payload, bool countStatistics) {
+    auto slot = FindSlot(key, false);
+    if (slot != nullptr) {
+        auto now = NowInMilliseconds();
+        auto recordWord = slot->record.load(std::memory_order_acquire);
+        auto version = GetLiveVersion(recordWord, now);
+        if (version != 0) {
+            if (payload != nullptr) {
+                *payload = ReadPayload(version);
+            }
+            if (countStatistics) {
+                _header->hits.fetch_add(1, std::memory_order_relaxed);
+            }
+            return version;
+        }
+
+        // Purge an expired key, only the thread that marks it deleted updates the counters.
+        if ((recordWord & DELETED_BIT) == 0
+            && slot->record.compare_exchange_strong(recordWord, recordWord | DELETED_BIT, std::memory_order_acq_rel)) {
+            _header->size.fetch_sub(1, std::memory_order_relaxed);
+            _header->expirations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (countStatistics) {
+        _header->misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+uint64_t SharedStoreSegment::Set(const std::string& key, const Payload& payload, uint32_t ttl, const uint64_t* expectedVersion) {
+    auto keyHash = HashKey(key.data(), key.size());
+    uint64_t newRecord = 0;
+
+    auto reserveEntry = [this]() {
+        if (_header->size.fetch_add(1, std::memory_order_relaxed) >= _header->maxEntries) {
+            _header->size.fetch_sub(1, std::memory_order_relaxed);
+            throw std::runtime_error("Shared store is full of entries");
+        }
+    };
+    auto releaseEntry = [this]() {
+        _header->size.fetch_sub(1, std::memory_order_relaxed);
+    };
+    auto appendRecord = [&]() {
+        if (newRecord == 0) {
+            newRecord = AppendRecord(key, payload, ttl);
+        }
+    };
+
+    while (true) {
+        auto slot = FindSlot(key, true);
+        auto recordWord = slot->record.load(std::memory_order_acquire);
+
+        if (recordWord == 0) {
+            // An empty slot at the end of the probe sequence, the key doesn't exist.
+            if (expectedVersion != nullptr && *expectedVersion != 0) {
+                return 0;
+            }
+            reserveEntry();
+            try {
+                appendRecord();
+            } catch (...) {
+                releaseEntry();
+                throw;
+            }
+            if (slot->record.compare_exchange_strong(recordWord, newRecord, std::memory_order_acq_rel)) {
+                slot->keyHash.store(keyHash, std::memory_order_release);
+                return newRecord;
+            }
+
+            // Another writer took the slot, probe again.
+            releaseEntry();
+            continue;
+        }
+
+        auto now = NowInMilliseconds();
+        while (true) {
+            auto counted = (recordWord & DELETED_BIT) == 0;
+            auto version = GetLiveVersion(recordWord, now);
+            if (expectedVersion != nullptr && *expectedVersion != version) {
+                return 0;
+            }
+
+            if (!counted) {
+                reserveEntry();
+            }
+            try {
+                appendRecord();
+            } catch (...) {
+                if (!counted) {
+                    releaseEntry();
+                }
+                throw;
+            }
+
+            if (slot->record.compare_exchange_weak(recordWord, newRecord, std::memory_order_acq_rel)) {
+                if (counted && version == 0) {
+                    _header->expirations.fetch_add(1, std::memory_order_relaxed);
+                }
+                return newRecord;
+            }
+            if (!counted) {
+                releaseEntry();
+            }
+        }
+    }
+}
+
+bool SharedStoreSegment::Delete(const std::string& key) {
+    auto slot = FindSlot(key, false);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    auto now = NowInMilliseconds();
+    auto recordWord = slot->record.load(std::memory_order_acquire);
+    while ((recordWord & DELETED_BIT) == 0) {
+        if (slot->record.compare_exchange_weak(recordWord, recordWord | DELETED_BIT, std::memory_order_acq_rel)) {
+            _header->size.fetch_sub(1, std::memory_order_relaxed);
+            if (GetLiveVersion(recordWord, now) == 0) {
+                _header->expirations.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t SharedStoreSegment::Size() {
+    if (_header->hasExpiry.load(std::memory_order_relaxed) != 0) {
+        auto now = NowInMilliseconds();
+        for (uint64_t i = 0; i < _header->slotCount; ++i) {
+            auto& slot = _slots[i];
+            auto recordWord = slot.record.load(std::memory_order_acquire);
+            if (recordWord != 0 && (recordWord & DELETED_BIT) == 0 && GetLiveVersion(recordWord, now) == 0
+                && slot.record.compare_exchange_strong(recordWord, recordWord | DELETED_BIT, std::memory_order_acq_rel)) {
+                _header->size.fetch_sub(1, std::memory_order_relaxed);
+                _header->expirations.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    return static_cast<size_t>(_header->size.load(std::memory_order_relaxed));
+}
+
+void SharedStoreSegment::ForEach(const std::function<void(const std::string&, const Payload&, uint32_t, uint64_t)>& callback) {
+    auto now = NowInMilliseconds();
+    std::vector<uint64_t> versions;
+    for (uint64_t i = 0; i < _header->slotCount; ++i) {
+        auto version = GetLiveVersion(_slots[i].record.load(std::memory_order_acquire), now);
+        if (version != 0) {
+            versions.push_back(version);
+        }
+    }
+    std::sort(versions.begin(), versions.end());
+
+    for (auto version : versions) {
+        auto record = reinterpret_cast<const RecordHeader*>(_memory->Data() + version);
+        auto key = _memory->Data() + version + sizeof(RecordHeader);
+
+        uint32_t ttl = 0;
+        if (record->expiresAt != 0) {
+            ttl = static_cast<uint32_t>(std::max<uint64_t>(record->expiresAt - std::min(record->expiresAt, now), 1));
+        }
+        callback(std::string(key, record->keyLength), ReadPayload(version), ttl, version);
+    }
+}
+
+size_t SharedStoreSegment::GetMaxEntries() const {
+    return static_cast<size_t>(_header->maxEntries);
+}
+
+size_t SharedStoreSegment::GetMaxBytes() const {
+    return static_cast<size_t>(_header->dataSize);
+}
+
+uint32_t SharedStoreSegment::GetTtl() const {
+    return _header->ttl;
+}
+
+SharedStoreSegment::Statistics SharedStoreSegment::GetStatistics() const {
+    return Statistics {
+        _header->hits.load(std::memory_order_relaxed),
+        _header->misses.load(std::memory_order_relaxed),
+        _header->expirations.load(std::memory_order_relaxed),
+        static_cast<size_t>(_header->dataTail.load(std::memory_order_relaxed))
+    };
+}
+
+void SharedStoreSegment::Unlink() {
+    _memory->Unlink();
+}
+
+SharedStoreSegment::Slot* SharedStoreSegment::FindSlot(const std::string& key, bool claim) {
+    auto keyHash = HashKey(key.data(), key.size());
+    auto mask = _header->slotCount - 1;
+
+    for (uint64_t i = 0; i <= mask; ++i) {
+        auto& slot = _slots[(keyHash + i) & mask];
+        auto recordWord = slot.record.load(std::memory_order_acquire);
+        if (recordWord == 0) {
+            // Slots are never emptied, so the key is not in the table.
+            return claim ? &slot : nullptr;
+        }
+
+        auto slotHash = slot.keyHash.load(std::memory_order_acquire);
+        if (slotHash != 0 && slotHash != keyHash) {
+            continue;
+        }
+
+        // The record keeps the key even after deletion. It also covers a slot whose hash is not published yet.
+        auto offset = recordWord & ~DELETED_BIT;
+        auto record = reinterpret_cast<const RecordHeader*>(_memory->Data() + offset);
+        if (record->keyLength == key.size()
+            && std::memcmp(_memory->Data() + offset + sizeof(RecordHeader), key.data(), key.size()) == 0) {
+            return &slot;
+        }
+    }
+
+    if (claim) {
+        throw std::runtime_error("Shared store index is full");
+    }
+    return nullptr;
+}
+
+uint64_t SharedStoreSegment::GetLiveVersion(uint64_t recordWord, uint64_t now) const {
+    if (recordWord == 0 || (recordWord & DELETED_BIT) != 0) {
+        return 0;
+    }
+    auto record = reinterpret_cast<const RecordHeader*>(_memory->Data() + recordWord);
+    if (record->expiresAt != 0 && record->expiresAt <= now) {
+        return 0;
+    }
+    return recordWord;
+}
+
+Payload SharedStoreSegment::ReadPayload(uint64_t offset) const {
+    auto record = reinterpret_cast<const RecordHeader*>(_memory->Data() + offset);
+    auto chars = _memory->Data() + offset + sizeof(RecordHeader) + AlignUp(record->keyLength, 2);
+    if (record->oneByte != 0) {
+        return Payload::FromLatin1(std::string(chars, record->payloadLength));
+    }
+    return Payload(std::u16string(reinterpret_cast<const char16_t*>(chars), record->payloadLength));
+}
+
+uint64_t SharedStoreSegment::AppendRecord(const std::string& key, const Payload& payload, uint32_t ttl) {
+    auto size = AlignUp(sizeof(RecordHeader) + AlignUp(key.size(), 2) + payload.GetByteSize(), 8);
+    // Space is only claimed if it fits, so a failed append doesn't take up what smaller records could use.
+    auto tail = _header->dataTail.load(std::memory_order_relaxed);
+    do {
+        if (size > _header->dataSize - tail) {
+            throw std::runtime_error("Shared store is full of bytes");
+        }
+    } while (!_header->dataTail.compare_exchange_weak(tail, tail + size, std::memory_order_relaxed));
+
+    auto offset = _header->dataOffset + tail;
+    auto data = _memory->Data() + offset;
+    auto record = reinterpret_cast<RecordHeader*>(data);
+    record->expiresAt = ttl == 0 ? 0 : NowInMilliseconds() + ttl;
+    record->keyLength = static_cast<uint32_t>(key.size());
+    record->payloadLength = static_cast<uint32_t>(payload.Length());
+    record->oneByte = payload.IsOneByte() ? 1 : 0;
+    std::memcpy(data + sizeof(RecordHeader), key.data(), key.size());
+
+    auto chars = data + sizeof(RecordHeader) + AlignUp(key.size(), 2);
+    if (payload.IsOneByte()) {
+        std::memcpy(chars, payload.GetOneByte().data(), payload.GetByteSize());
+    } else {
+        std::memcpy(chars, payload.GetTwoByte().data(), payload.GetByteSize());
+    }
+
+    if (ttl != 0) {
+        _header->hasExpiry.store(1, std::memory_order_relaxed);
+    }
+    return offset;
+}
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store-payload.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace napa {
+namespace platform {
+    class SharedMemory;
+}
+
+namespace store {
+
+    /// <summary>
+    /// Key/payload storage in a named shared memory segment, which can be opened by multiple processes.
+    /// The index is an open addressing hash table whose slots are claimed and updated by atomic compare-and-swap,
+    /// records are immutable and appended to a data area, thus reads and writes never take a lock.
+    /// </summary>
+    /// <remarks>
+    /// Layout, offsets are from the start of the segment:
+    ///     Header:  magic, layout version, creator process id, slot count, data offset/size, default TTL and atomic counters.
+    ///     Slots:   slotCount x { atomic uint64 keyHash, atomic uint64 record }.
+    ///     Data:    records of { uint64 expiresAt, uint32 keyLength, uint32 payloadLength, uint8 oneByte, key, payload }.
+    ///              The payload is Latin-1 if oneByte is set, otherwise UTF-16 aligned to 2 bytes.
+    /// A slot's record word is the record offset, with the top bit set when the key is deleted.
+    /// As records are never reused, the record offset of a live key serves as its version.
+    /// Space of overwritten or deleted records is not reclaimed, so the segment suits data that is written
+    /// once and read many times. A write fails when the data area or the index is full.
+    /// </remarks>
+    class SharedStoreSegment {
+    public:
+        /// <summary> Counters kept in the segment, shared by all processes. </summary>
+        struct Statistics {
+            uint64_t hits;
+            uint64_t misses;
+            uint64_t expirations;
+
+            /// <summary> Bytes of the data area in use. </summary>
+            size_t bytes;
+        };
+
+        /// <summary> Creates a segment. </summary>
+        /// <param name="id"> Store id, which is part of the segment name. </param>
+        /// <param name="maxEntries"> Max number of keys. </param>
+        /// <param name="maxBytes"> Size of the data area in bytes. </param>
+        /// <param name="ttl"> Default time to live in milliseconds that is shared with processes opening the segment. </param>
+        /// <returns>
+        ///     The segment, or nullptr if it already exists. It throws std::runtime_error on other failures.
+        ///     A segment whose creator is no longer running, or never finished initializing it, is replaced.
+        /// </returns>
+        static std::unique_ptr<SharedStoreSegment> Create(const std::string& id, size_t maxEntries, size_t maxBytes, uint32_t ttl);
+
+        /// <summary> Opens a segment created by this or another process. </summary>
+        /// <returns> The segment, or nullptr if it doesn't exist. It throws std::runtime_error if the segment is malformed. </returns>
+        static std::unique_ptr<SharedStoreSegment> Open(const std::string& id);
+
+        ~SharedStoreSegment();
+
+        /// <summary> Non-copyable. </summary>
+        SharedStoreSegment(const SharedStoreSegment&) = delete;
+        SharedStoreSegment& operator=(const SharedStoreSegment&) = delete;
+
+        /// <summary> Gets payload of a key, counting a hit or miss. </summary>
+        /// <returns> Version of the key, or 0 if the key is not found. </returns>
+        uint64_t Get(const std::string& key, Payload* payload);
+
+        /// <summary> Gets version of a key without reading its payload or counting a hit or miss. </summary>
+        /// <returns> Version of the key, or 0 if the key is not found. </returns>
+        uint64_t GetVersion(const std::string& key);
+
+        /// <summary> Sets payload of a key. </summary>
+        /// <param name="ttl"> Time to live in milliseconds, 0 for never expire. </param>
+        /// <param name="expectedVersion"> If not null, only set when current version of the key matches. 0 means the key doesn't exist. </param>
+        /// <returns> New version of the key, or 0 if expectedVersion doesn't match. It throws std::runtime_error if the segment is full. </returns>
+        uint64_t Set(const std::string& key, const Payload& payload, uint32_t ttl, const uint64_t* expectedVersion = nullptr);
+
+        /// <summary> Deletes a key. </summary>
+        /// <returns> True if the key existed. </returns>
+        bool Delete(const std::string& key);
+
+        /// <summary> Number of keys. </summary>
+        size_t Size();
+
+        /// <summary> Calls a function with each key, payload, remaining time to live and version, in order of version. </summary>
+        void ForEach(const std::function<void(const std::string&, const Payload&, uint32_t, uint64_t)>& callback);
+
+        /// <summary> Max number of keys. </summary>
+        size_t GetMaxEntries() const;
+
+        /// <summary> Size of data area in bytes. </summary>
+        size_t GetMaxBytes() const;
+
+        /// <summary> Default time to live of the store in milliseconds. </summary>
+        uint32_t GetTtl() const;
+
+        /// <summary> Gets counters of the segment. </summary>
+        Statistics GetStatistics() const;
+
+        /// <summary> Removes the segment name, so it can't be opened again. Processes which opened it keep their mapping. </summary>
+        void Unlink();
+
+    private:
+        struct Header;
+        struct Slot;
+
+        explicit SharedStoreSegment(std::unique_ptr<platform::SharedMemory> memory);
+
+        /// <summary> Waits for the creator to finish initializing a segment. </summary>
+        /// <returns> False if the segment is still not initialized after a timeout. </returns>
+        static bool WaitForInitialized(const platform::SharedMemory& memory);
+
+        /// <summary> Returns true if a segment was left behind by a creator that is no longer running. </summary>
+        static bool IsStale(const platform::SharedMemory& memory);
+
+        /// <summary> Looks up a key, purging it if expired. </summary>
+        uint64_t Lookup(const std::string& key, Payload* payload, bool countStatistics);
+
+        /// <summary> Finds the slot of a key, claiming an empty slot if 'claim' is true. </summary>
+        Slot* FindSlot(const std::string& key, bool claim);
+
+        /// <summary> Gets version of a record word, 0 if the key is deleted or expired. </summary>
+        uint64_t GetLiveVersion(uint64_t recordWord, uint64_t now) const;
+
+        /// <summary> Reads the payload of a record. </summary>
+        Payload ReadPayload(uint64_t offset) const;
+
+        /// <summary> Appends a record to the data area. </summary>
+        uint64_t AppendRecord(const std::string& key, const Payload& payload, uint32_t ttl);
+
+        std::unique_ptr<platform::SharedMemory> _memory;
+        Header* _header;
+        Slot* _slots;
+    };
+}
+}
@@ -0,0 +1,276 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "store.h"
+#include "shared-store-segment.h"
+#include "store-payload.h"
+#include "store-snapshot.h"
+#include "store-watchers.h"
+
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace napa::store;
+
+namespace {
+
+    /// <summary> Default number of keys of a shared store. </summary>
+    const size_t DEFAULT_SHARED_MAX_ENTRIES = 64 * 1024;
+
+    /// <summary> Default size of the data area of a shared store. </summary>
+    const size_t DEFAULT_SHARED_MAX_BYTES = 64 * 1024 * 1024;
+
+} // namespace
+
+/// <summary> Store backed by a SharedStoreSegment, so values are shared by all processes opening the store. </summary>
+/// <remarks> Watchers are notified of changes made in this process only. Expirations are not notified. </remarks>
+class SharedStoreImpl: public Store {
+public:
+    /// <summary> Constructor. </summary>
+    /// <param name="owner"> True if this process created the segment, and removes it when the store is destroyed. </param>
+    SharedStoreImpl(const char* id, std::unique_ptr<SharedStoreSegment> segment, bool owner)
+        : _id(id), _segment(std::move(segment)), _owner(owner) {
+        _options.maxEntries = _segment->GetMaxEntries();
+        _options.maxBytes = _segment->GetMaxBytes();
+        _options.ttl = _segment->GetTtl();
+    }
+
+    ~SharedStoreImpl() override {
+        if (_owner) {
+            _segment->Unlink();
+        }
+    }
+
+    const char* GetId() const override {
+        return _id.c_str();
+    }
+
+    void Set(const char* key, std::shared_ptr<ValueType> value) override {
+        Set(key, std::move(value), _options.ttl);
+    }
+
+    void Set(const char* key, std::shared_ptr<ValueType> value, uint32_t ttl) override {
+        EnsureProcessIndependent(*value);
+        _watchers.Notify(key, _segment->Set(key, value->payload, ttl));
+    }
+
+    std::shared_ptr<ValueType> Get(const char* key) const override {
+        Payload payload;
+        if (_segment->Get(key, &payload) == 0) {
+            return nullptr;
+        }
+        return MakeValue(std::move(payload));
+    }
+
+    bool Has(const char* key) const override {
+        return _segment->GetVersion(key) != 0;
+    }
+
+    void Delete(const char* key) override {
+        if (_segment->Delete(key)) {
+            _watchers.Notify(key, 0);
+        }
+    }
+
+    size_t Size() const override {
+        return _segment->Size();
+    }
+
+    std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const override {
+        std::vector<std::shared_ptr<ValueType>> values;
+        values.reserve(keys.size());
+        for (const auto& key : keys) {
+            values.push_back(Get(key.c_str()));
+        }
+        return values;
+    }
+
+    void SetMany(std::vector<KeyValueType> values) override {
+        for (const auto& keyValue : values) {
+            EnsureProcessIndependent(*keyValue.second);
+        }
+        for (const auto& keyValue : values) {
+            _watchers.Notify(keyValue.first, _segment->Set(keyValue.first, keyValue.second->payload, _options.ttl));
+        }
+    }
+
+    uint64_t GetVersion(const char* key) const override {
+        return _segment->GetVersion(key);
+    }
+
+    uint64_t CompareAndSet(const char* key, std::shared_ptr<ValueType> value, uint64_t expectedVersion) override {
+        EnsureProcessIndependent(*value);
+        auto version = _segment->Set(key, value->payload, _options.ttl, &expectedVersion);
+        if (version != 0) {
+            _watchers.Notify(key, version);
+        }
+        return version;
+    }
+
+    std::shared_ptr<ValueType> GetOrSet(const char* key, std::shared_ptr<ValueType> value) override {
+        EnsureProcessIndependent(*value);
+        while (true) {
+            Payload payload;
+            if (_segment->Get(key, &payload) != 0) {
+                return MakeValue(std::move(payload));
+            }
+
+            uint64_t absent = 0;
+            auto version = _segment->Set(key, value->payload, _options.ttl, &absent);
+            if (version != 0) {
+                _watchers.Notify(key, version);
+                return value;
+            }
+        }
+    }
+
+    bool Increment(const char* key, double delta, double& result) override {
+        while (true) {
+            Payload payload;
+            double current = 0;
+            auto version = _segment->GetVersion(key);
+            if (version != 0) {
+                if (_segment->Get(key, &payload) != version) {
+                    continue;
+                }
+                if (!payload::ParseNumber(payload, current)) {
+                    return false;
+                }
+            }
+
+            result = current + delta;
+            if (!std::isfinite(result)) {
+                return false;
+            }
+            auto newVersion = _segment->Set(key, payload::FormatNumber(result), _options.ttl, &version);
+            if (newVersion != 0) {
+                _watchers.Notify(key, newVersion);
+                return true;
+            }
+        }
+    }
+
+    size_t Save(const char* path) const override {
+        std::vector<SnapshotEntry> snapshotEntries;
+        _segment->ForEach([&](const std::string& key, const Payload& payload, uint32_t ttl, uint64_t) {
+            snapshotEntries.push_back(SnapshotEntry { key, payload, ttl });
+        });
+
+        snapshot::Write(path, snapshotEntries);
+        return snapshotEntries.size();
+    }
+
+    size_t Load(const char* path) override {
+        auto snapshotEntries = snapshot::Read(path);
+        for (const auto& entry : snapshotEntries) {
+            _watchers.Notify(entry.key, _segment->Set(entry.key, entry.payload, entry.ttl));
+        }
+        return snapshotEntries.size();
+    }
+
+    uint64_t Watch(const char* key, bool isPrefix, WatchCallback callback) override {
+        return _watchers.Add(key, isPrefix, std::move(callback));
+    }
+
+    void Unwatch(uint64_t watchId) override {
+        _watchers.Remove(watchId);
+    }
+
+    const StoreOptions& GetOptions() const override {
+        return _options;
+    }
+
+    StoreStatistics GetStatistics() const override {
+        auto segmentStatistics = _segment->GetStatistics();
+
+        StoreStatistics statistics;
+        statistics.hits = segmentStatistics.hits;
+        statistics.misses = segmentStatistics.misses;
+        statistics.expirations = segmentStatistics.expirations;
+        statistics.bytes = segmentStatistics.bytes;
+        statistics.rawBytes = segmentStatistics.bytes;
+        return statistics;
+    }
+
+private:
+    /// <summary> Native objects in transport context live in this process only, thus can't be shared. </summary>
+    static void EnsureProcessIndependent(const ValueType& value) {
+        if (value.transportContext.GetSharedCount() > 0) {
+            throw std::runtime_error("Values holding native objects can't be set to a shared store");
+        }
+    }
+
+    static std::shared_ptr<ValueType> MakeValue(Payload payload) {
+        return std::make_shared<ValueType>(ValueType { std::move(payload), napa::transport::TransportContext() });
+    }
+
+    /// <summary> ID. Case sensitive. </summary>
+    std::string _id;
+
+    /// <summary> Shared memory segment. </summary>
+    std::unique_ptr<SharedStoreSegment> _segment;
+
+    /// <summary> Whether this process created the segment. </summary>
+    bool _owner;
+
+    /// <summary> Options read from the segment. </summary>
+    StoreOptions _options;
+
+    /// <summary> Watchers of changes made in this process. </summary>
+    StoreWatchers _watchers;
+};
+
+namespace napa {
+namespace store {
+
+    namespace {
+        std::unordered_map<std::string, std::weak_ptr<Store>> _sharedStoreRegistry;
+        std::mutex _sharedRegistryAccess;
+    } // namespace
+
+    std::shared_ptr<Store> CreateSharedStore(const char* id, const StoreOptions& options) {
+        std::lock_guard<std::mutex> lock(_sharedRegistryAccess);
+
+        auto it = _sharedStoreRegistry.find(id);
+        if (it != _sharedStoreRegistry.end() && !it->second.expired()) {
+            return nullptr;
+        }
+
+        auto segment = SharedStoreSegment::Create(
+            id,
+            options.maxEntries != 0 ? options.maxEntries : DEFAULT_SHARED_MAX_ENTRIES,
+            options.maxBytes != 0 ? options.maxBytes : DEFAULT_SHARED_MAX_BYTES,
+            options.ttl);
+        if (segment == nullptr) {
+            return nullptr;
+        }
+
+        auto store = std::make_shared<SharedStoreImpl>(id, std::move(segment), true);
+        _sharedStoreRegistry[id] = store;
+        return store;
+    }
+
+    std::shared_ptr<Store> GetSharedStore(const char* id) {
+        std::lock_guard<std::mutex> lock(_sharedRegistryAccess);
+
+        auto it = _sharedStoreRegistry.find(id);
+        if (it != _sharedStoreRegistry.end()) {
+            auto store = it->second.lock();
+            if (store != nullptr) {
+                return store;
+            }
+        }
+
+        auto segment = SharedStoreSegment::Open(id);
+        if (segment == nullptr) {
+            return nullptr;
+        }
+
+        auto store = std::make_shared<SharedStoreImpl>(id, std::move(segment), false);
+        _sharedStoreRegistry[id] = store;
+        return store;
+    }
+} // namespace store
+} // namespace napa
@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "store-compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace napa;
+using namespace napa::store;
+
+namespace {
+
+    /// <summary> Shortest match worth encoding, as a match costs at least 3 bytes. </summary>
+    const size_t MIN_MATCH = 4;
+
+    /// <summary> Farthest match, limited by the 2 bytes of offset. </summary>
+    const size_t MAX_OFFSET = 65535;
+
+    /// <summary> Length that doesn't fit a 4-bit field of the token and is continued in following bytes. </summary>
+    const size_t EXTENDED_LENGTH = 15;
+
+    const uint32_t HASH_BITS = 12;
+    const uint32_t NO_POSITION = UINT32_MAX;
+
+    uint32_t Hash(const char* data) {
+        uint32_t sequence;
+        memcpy(&sequence, data, sizeof(sequence));
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    void WriteExtendedLength(std::string& output, size_t length) {
+        if (length < EXTENDED_LENGTH) {
+            return;
+        }
+        length -= EXTENDED_LENGTH;
+        while (length >= 255) {
+            output.push_back(static_cast<char>(255));
+            length -= 255;
+        }
+        output.push_back(static_cast<char>(length));
+    }
+
+    bool ReadExtendedLength(const uint8_t*& input, const uint8_t* end, size_t& length) {
+        if (length < EXTENDED_LENGTH) {
+            return true;
+        }
+        uint8_t byte;
+        do {
+            if (input == end) {
+                return false;
+            }
+            byte = *input++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    /// <summary> Write literals, followed by a match unless it's the last sequence. </summary>
+    void WriteSequence(std::string& output, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        auto token = static_cast<uint8_t>(std::min(literalLength, EXTENDED_LENGTH) << 4);
+        if (matchLength > 0) {
+            token |= static_cast<uint8_t>(std::min(matchLength - MIN_MATCH, EXTENDED_LENGTH));
+        }
+        output.push_back(static_cast<char>(token));
+        WriteExtendedLength(output, literalLength);
+        output.append(literals, literalLength);
+
+        if (matchLength > 0) {
+            output.push_back(static_cast<char>(offset & 0xff));
+            output.push_back(static_cast<char>((offset >> 8) & 0xff));
+            WriteExtendedLength(output, matchLength - MIN_MATCH);
+        }
+    }
+
+}   // End of anonymous namespace.
+
+std::string compression::Compress(const char* data, size_t size) {
+    std::string output;
+    output.reserve(size / 2 + 16);
+
+    // Last position of each hashed 4-byte sequence.
+    std::vector<uint32_t> positions(1u << HASH_BITS, NO_POSITION);
+
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + MIN_MATCH <= size) {
+        auto& candidate = positions[Hash(data + position)];
+        auto previous = candidate;
+        candidate = static_cast<uint32_t>(position);
+
+        if (previous != NO_POSITION
+            && position - previous <= MAX_OFFSET
+            && memcmp(data + previous, data + position, MIN_MATCH) == 0) {
+            auto length = MIN_MATCH;
+            while (position + length < size && data[previous + length] == data[position + length]) {
+                ++length;
+            }
+            WriteSequence(output, data + anchor, position - anchor, position - previous, length);
+            position += length;
+            anchor = position;
+        } else {
+            ++position;
+        }
+    }
+
+    WriteSequence(output, data + anchor, size - anchor, 0, 0);
+    return output;
+}
+
+bool compression::Decompress(const std::string& compressed, char* output, size_t outputSize) {
+    auto input = reinterpret_cast<const uint8_t*>(compressed.data());
+    auto end = input + compressed.size();
+    size_t written = 0;
+
+    while (input < end) {
+        auto token = *input++;
+
+        size_t literalLength = token >> 4;
+        if (!ReadExtendedLength(input, end, literalLength)
+            || literalLength > static_cast<size_t>(end - input)
+            || literalLength > outputSize - written) {
+            return false;
+        }
+        memcpy(output + written, input, literalLength);
+        input += literalLength;
+        written += literalLength;
+
+        // The last sequence has no match.
+        if (input == end) {
+            break;
+        }
+
+        if (end - input < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(input[0]) | (static_cast<size_t>(input[1]) << 8);
+        input += 2;
+
+        size_t matchLength = token & 0x0f;
+        if (!ReadExtendedLength(input, end, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > written || matchLength > outputSize - written) {
+            return false;
+        }
+
+        // Copy byte by byte since the match may overlap bytes it writes.
+        auto source = output + written - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            output[written + i] = source[i];
+        }
+        written += matchLength;
+    }
+    return written == outputSize;
+}
+
+bool compression::Compress(const Payload& payload, CompressedPayload& compressed) {
+    auto data = payload.IsOneByte()
+        ? payload.GetOneByte().data()
+        : reinterpret_cast<const char*>(payload.GetTwoByte().data());
+    auto size = payload.GetByteSize();
+
+    auto result = Compress(data, size);
+    if (result.size() >= size) {
+        return false;
+    }
+
+    compressed.data = std::move(result);
+    compressed.oneByte = payload.IsOneByte();
+    compressed.rawBytes = size;
+    return true;
+}
+
+Payload compression::Decompress(const CompressedPayload& compressed) {
+    if (compressed.oneByte) {
+        std::string latin1(compressed.rawBytes, '\0');
+        if (!Decompress(compressed.data, &latin1[0], latin1.size())) {
+            throw std::runtime_error("Malformed compressed payload");
+        }
+        return Payload::FromLatin1(std::move(latin1));
+    }
+
+    std::u16string utf16(compressed.rawBytes / sizeof(char16_t), u'\0');
+    if (!Decompress(compressed.data, reinterpret_cast<char*>(&utf16[0]), compressed.rawBytes)) {
+        throw std::runtime_error("Malformed compressed payload");
+    }
+    return Payload(std::move(utf16));
+}
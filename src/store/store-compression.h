@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store-payload.h"
+
+#include <cstddef>
+#include <string>
+
+namespace napa {
+namespace store {
+namespace compression {
+
+    /// <summary> A payload compressed by Compress. </summary>
+    struct CompressedPayload {
+        /// <summary> Compressed chars of the payload. </summary>
+        std::string data;
+
+        /// <summary> True if the payload was kept as Latin-1. </summary>
+        bool oneByte = true;
+
+        /// <summary> Size of the payload in bytes before compression. </summary>
+        size_t rawBytes = 0;
+    };
+
+    /// <summary>
+    ///     Compress bytes with a LZ77 codec, whose sequences of literals and matches are laid out like LZ4's.
+    ///     It doesn't follow the end of block rules of LZ4, so the output is only meant for Decompress.
+    /// </summary>
+    /// <returns> Compressed bytes, which is larger than the input if it has no repetition. </returns>
+    std::string Compress(const char* data, size_t size);
+
+    /// <summary> Decompress bytes returned by Compress. </summary>
+    /// <param name="output"> Buffer of exactly the size of the original bytes. </param>
+    /// <returns> False if the compressed bytes are malformed or don't fill the output. </returns>
+    bool Decompress(const std::string& compressed, char* output, size_t outputSize);
+
+    /// <summary> Compress a payload. </summary>
+    /// <returns> False if compressing doesn't make the payload smaller, in which case compressed is not changed. </returns>
+    bool Compress(const Payload& payload, CompressedPayload& compressed);
+
+    /// <summary> Decompress a payload compressed by Compress. It throws std::runtime_error if malformed. </summary>
+    Payload Decompress(const CompressedPayload& compressed);
+}
+}
+}
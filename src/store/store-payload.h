@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace napa {
+namespace store {
+
+    /// <summary>
+    ///     A marshalled JS value, kept as Latin-1 when all its chars fit in one byte, as JSON of mostly ASCII data
+    ///     does, which takes half the memory of UTF-16.
+    /// </summary>
+    class Payload {
+    public:
+        /// <summary> Constructs an empty payload. </summary>
+        Payload() = default;
+
+        /// <summary> Constructs a payload from UTF-16, which is compacted to Latin-1 if possible. </summary>
+        Payload(std::u16string utf16) {
+            for (auto c : utf16) {
+                if (c > 0xFF) {
+                    _twoByte = std::move(utf16);
+                    return;
+                }
+            }
+            _oneByte.assign(utf16.begin(), utf16.end());
+        }
+
+        /// <summary> Constructs a payload from Latin-1 chars. </summary>
+        static Payload FromLatin1(std::string latin1) {
+            Payload payload;
+            payload._oneByte = std::move(latin1);
+            return payload;
+        }
+
+        /// <summary> Returns true if the payload is kept as Latin-1. </summary>
+        bool IsOneByte() const {
+            return _twoByte.empty();
+        }
+
+        /// <summary> Gets the Latin-1 chars, valid if IsOneByte() is true. </summary>
+        const std::string& GetOneByte() const {
+            return _oneByte;
+        }
+
+        /// <summary> Gets the UTF-16 chars, valid if IsOneByte() is false. </summary>
+        const std::u16string& GetTwoByte() const {
+            return _twoByte;
+        }
+
+        /// <summary> Gets the number of chars. </summary>
+        size_t Length() const {
+            return IsOneByte() ? _oneByte.size() : _twoByte.size();
+        }
+
+        /// <summary> Gets the number of bytes the chars take. </summary>
+        size_t GetByteSize() const {
+            return IsOneByte() ? _oneByte.size() : _twoByte.size() * sizeof(char16_t);
+        }
+
+        /// <summary> Converts the payload to UTF-16. </summary>
+        std::u16string ToUtf16() const {
+            if (!IsOneByte()) {
+                return _twoByte;
+            }
+            return std::u16string(
+                reinterpret_cast<const unsigned char*>(_oneByte.data()),
+                reinterpret_cast<const unsigned char*>(_oneByte.data()) + _oneByte.size());
+        }
+
+        bool operator==(const Payload& other) const {
+            return _oneByte == other._oneByte && _twoByte == other._twoByte;
+        }
+
+    private:
+        /// <summary> Only one of them has chars. </summary>
+        std::string _oneByte;
+        std::u16string _twoByte;
+    };
+
+namespace payload {
+
+    /// <summary> Parse one-byte text which is a marshalled JS number. </summary>
+    /// <returns> False if the text is not a JSON number. </returns>
+    inline bool ParseNumber(const std::string& text, double& number) {
+        // JSON numbers never start with whitespace, 'I', 'N' or '+', which strtod also accepts.
+        if (text.empty() || !(text[0] == '-' || (text[0] >= '0' && text[0] <= '9'))) {
+            return false;
+        }
+        char* end = nullptr;
+        number = std::strtod(text.c_str(), &end);
+        return end == text.c_str() + text.size();
+    }
+
+    /// <summary> Parse a payload which is a marshalled JS number. </summary>
+    /// <returns> False if the payload is not a JSON number. </returns>
+    inline bool ParseNumber(const std::u16string& payload, double& number) {
+        std::string text;
+        text.reserve(payload.size());
+        for (auto c : payload) {
+            if (c > 0x7F) {
+                return false;
+            }
+            text.push_back(static_cast<char>(c));
+        }
+        return ParseNumber(text, number);
+    }
+
+    /// <summary> Parse a payload which is a marshalled JS number. </summary>
+    /// <returns> False if the payload is not a JSON number. </returns>
+    inline bool ParseNumber(const Payload& payload, double& number) {
+        return payload.IsOneByte() && ParseNumber(payload.GetOneByte(), number);
+    }
+
+    /// <summary> Format a finite number into a payload that unmarshalls to the same JS number. </summary>
+    inline std::u16string FormatNumber(double number) {
+        char buffer[32];
+        if (number == std::floor(number) && std::fabs(number) < 9007199254740992.0) {
+            snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(number));
+        } else {
+            snprintf(buffer, sizeof(buffer), "%.17g", number);
+        }
+        return std::u16string(buffer, buffer + strlen(buffer));
+    }
+
+}
+}
+}
@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "store-snapshot.h"
+
+#include <platform/filesystem.h>
+#include <platform/mapped-file.h>
+#include <platform/process.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace napa;
+using namespace napa::store;
+
+namespace {
+
+    const char SNAPSHOT_MAGIC[8] = { 'N', 'A', 'P', 'A', 'S', 'N', 'A', 'P' };
+    const uint32_t SNAPSHOT_VERSION = 1;
+
+    const size_t HEADER_SIZE = 16;
+    const size_t ENTRY_HEADER_SIZE = 16;
+
+    uint32_t ReadUint32(const char* data) {
+        auto bytes = reinterpret_cast<const uint8_t*>(data);
+        return static_cast<uint32_t>(bytes[0])
+            | (static_cast<uint32_t>(bytes[1]) << 8)
+            | (static_cast<uint32_t>(bytes[2]) << 16)
+            | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    void WriteUint8(std::string& buffer, uint8_t value) {
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    void WriteUint32(std::string& buffer, uint32_t value) {
+        buffer.push_back(static_cast<char>(value & 0xff));
+        buffer.push_back(static_cast<char>((value >> 8) & 0xff));
+        buffer.push_back(static_cast<char>((value >> 16) & 0xff));
+        buffer.push_back(static_cast<char>((value >> 24) & 0xff));
+    }
+
+    /// <summary>
+    /// Returns a temporary path next to the snapshot that no other writer uses,
+    /// so concurrent saves to the same snapshot, from this process or another, don't write the same file.
+    /// </summary>
+    std::string GetTemporaryPath(const std::string& path) {
+        static std::atomic<uint32_t> counter(0);
+        return path + "." + std::to_string(platform::Getpid())
+            + "-" + std::to_string(platform::Gettid())
+            + "-" + std::to_string(counter++) + ".tmp";
+    }
+
+}   // End of anonymous namespace.
+
+void snapshot::Write(const std::string& path, const std::vector<SnapshotEntry>& entries) {
+    std::string content(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    WriteUint32(content, SNAPSHOT_VERSION);
+    WriteUint32(content, static_cast<uint32_t>(entries.size()));
+
+    for (const auto& entry : entries) {
+        WriteUint32(content, static_cast<uint32_t>(entry.key.size()));
+        WriteUint32(content, static_cast<uint32_t>(entry.payload.Length()));
+        WriteUint32(content, entry.ttl);
+        WriteUint8(content, entry.payload.IsOneByte() ? 1 : 0);
+        content.append(3, '\0');
+        content.append(entry.key);
+        if (entry.payload.IsOneByte()) {
+            content.append(entry.payload.GetOneByte());
+        } else {
+            for (auto c : entry.payload.GetTwoByte()) {
+                content.push_back(static_cast<char>(c & 0xff));
+                content.push_back(static_cast<char>((c >> 8) & 0xff));
+            }
+        }
+    }
+
+    // Write to a temporary file first, so readers never see a partially written snapshot.
+    auto temporaryPath = GetTemporaryPath(path);
+    {
+        std::ofstream ofs(temporaryPath, std::ios::binary | std::ios::trunc);
+        ofs << content;
+        if (!ofs) {
+            ofs.close();
+            std::remove(temporaryPath.c_str());
+            throw std::runtime_error("Can't write store snapshot " + temporaryPath);
+        }
+    }
+
+    // Replacing keeps the old snapshot in place until the new one is complete, so there is always a snapshot to load.
+    // Concurrent saves each replace it atomically, and the last one wins.
+    if (!filesystem::ReplaceFile(filesystem::Path(temporaryPath), filesystem::Path(path))) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Can't rename store snapshot " + temporaryPath + " to " + path);
+    }
+}
+
+std::vector<SnapshotEntry> snapshot::Read(const std::string& path) {
+    filesystem::MappedFile file((filesystem::Path(path)));
+    auto data = file.Data();
+    auto size = file.Size();
+
+    if (size < HEADER_SIZE || std::string(data, sizeof(SNAPSHOT_MAGIC)) != std::string(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC))) {
+        throw std::runtime_error("\"" + path + "\" is not a store snapshot");
+    }
+
+    auto version = ReadUint32(data + 8);
+    if (version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("\"" + path + "\" has unsupported snapshot version " + std::to_string(version));
+    }
+
+    auto count = ReadUint32(data + 12);
+    std::vector<SnapshotEntry> entries;
+    entries.reserve(count);
+
+    size_t offset = HEADER_SIZE;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (size - offset < ENTRY_HEADER_SIZE) {
+            throw std::runtime_error("\"" + path + "\" is truncated");
+        }
+        size_t keyLength = ReadUint32(data + offset);
+        size_t payloadLength = ReadUint32(data + offset + 4);
+        auto ttl = ReadUint32(data + offset + 8);
+        auto oneByte = data[offset + 12] != 0;
+        offset += ENTRY_HEADER_SIZE;
+
+        size_t charSize = oneByte ? 1 : 2;
+        if (size - offset < keyLength || (size - offset - keyLength) / charSize < payloadLength) {
+            throw std::runtime_error("\"" + path + "\" is truncated");
+        }
+
+        SnapshotEntry entry { std::string(data + offset, keyLength), Payload(), ttl };
+        offset += keyLength;
+
+        if (oneByte) {
+            entry.payload = Payload::FromLatin1(std::string(data + offset, payloadLength));
+        } else {
+            std::u16string chars(payloadLength, u'\0');
+            auto bytes = reinterpret_cast<const uint8_t*>(data + offset);
+            for (size_t c = 0; c < payloadLength; ++c) {
+                chars[c] = static_cast<char16_t>(bytes[2 * c] | (bytes[2 * c + 1] << 8));
+            }
+            entry.payload = Payload(std::move(chars));
+        }
+        offset += payloadLength * charSize;
+
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
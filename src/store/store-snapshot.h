@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store-payload.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace store {
+
+    /// <summary> A key with its marshalled value, as saved in a snapshot file. </summary>
+    struct SnapshotEntry {
+        std::string key;
+
+        /// <summary> Marshalled JS value. </summary>
+        Payload payload;
+
+        /// <summary> Remaining time to live in milliseconds, 0 for never expire. </summary>
+        uint32_t ttl;
+    };
+
+    /// <summary>
+    /// Reads and writes store snapshot files.
+    /// Layout, all integers are little-endian:
+    ///     Header:  char magic[8] = "NAPASNAP", uint32 version, uint32 entryCount.
+    ///     Entries: entryCount x { uint32 keyLength, uint32 payloadLength, uint32 ttl, uint8 oneByte, uint8 reserved[3],
+    ///              char key[keyLength], payload }.
+    ///              The payload is payloadLength Latin-1 chars if oneByte is set, otherwise payloadLength UTF-16 chars.
+    /// Entries are written from least to most recently used, so loading them in order restores recency.
+    /// </summary>
+    namespace snapshot {
+
+        /// <summary> Writes entries to a temporary file then renames it to path. It throws std::runtime_error on failure. </summary>
+        void Write(const std::string& path, const std::vector<SnapshotEntry>& entries);
+
+        /// <summary> Maps a snapshot file and reads its entries. It throws std::runtime_error on failure. </summary>
+        std::vector<SnapshotEntry> Read(const std::string& path);
+    }
+}
+}
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "store-watchers.h"
+
+#include <algorithm>
+
+using namespace napa::store;
+
+namespace {
+    std::atomic<uint64_t> _lastWatchId(0);
+} // namespace
+
+uint64_t StoreWatchers::Add(const char* key, bool isPrefix, Store::WatchCallback callback) {
+    auto id = ++_lastWatchId;
+
+    std::lock_guard<std::mutex> lock(_access);
+    _watchers.push_back(Watcher { id, key, isPrefix, std::move(callback) });
+    _count = _watchers.size();
+    return id;
+}
+
+void StoreWatchers::Remove(uint64_t watchId) {
+    std::lock_guard<std::mutex> lock(_access);
+    _watchers.erase(
+        std::remove_if(_watchers.begin(), _watchers.end(), [watchId](const Watcher& watcher) {
+            return watcher.id == watchId;
+        }),
+        _watchers.end());
+    _count = _watchers.size();
+}
+
+bool StoreWatchers::HasWatchers() const {
+    return _count > 0;
+}
+
+void StoreWatchers::Notify(const std::string& key, uint64_t version) const {
+    if (_count == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_access);
+    for (const auto& watcher : _watchers) {
+        auto matched = watcher.isPrefix
+            ? key.compare(0, watcher.key.size(), watcher.key) == 0
+            : key == watcher.key;
+        if (matched) {
+            watcher.callback(key, version);
+        }
+    }
+}
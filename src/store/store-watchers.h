@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace store {
+
+    /// <summary> Watchers of a store, which are notified when watched keys change. </summary>
+    class StoreWatchers {
+    public:
+        /// <summary> Add a watcher. </summary>
+        /// <param name="key"> Key, or key prefix if isPrefix is true. </param>
+        /// <returns> Watch id, unique in the process. </returns>
+        uint64_t Add(const char* key, bool isPrefix, Store::WatchCallback callback);
+
+        /// <summary> Remove a watcher. No-op if not found. </summary>
+        void Remove(uint64_t watchId);
+
+        /// <summary> Returns true if there is any watcher. It doesn't take the lock. </summary>
+        bool HasWatchers() const;
+
+        /// <summary> Notify watchers of a key change. It returns immediately when there is no watcher. </summary>
+        /// <param name="version"> New version of the key, 0 if the key is removed. </param>
+        void Notify(const std::string& key, uint64_t version) const;
+
+    private:
+        struct Watcher {
+            uint64_t id;
+            std::string key;
+            bool isPrefix;
+            Store::WatchCallback callback;
+        };
+
+        mutable std::mutex _access;
+        std::vector<Watcher> _watchers;
+
+        /// <summary> Number of watchers, read without lock on every change. </summary>
+        std::atomic<size_t> _count { 0 };
+    };
+}
+}
@@ -2,19 +2,66 @@
 // Licensed under the MIT license.
 
 #include "store.h"
+#include "store-compression.h"
+#include "store-payload.h"
+#include "store-snapshot.h"
+#include "store-watchers.h"
 
+#include <napa/assert.h>
+#include <napa/log.h>
 #include <napa/memory.h>
+#include <platform/filesystem.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <list>
+#include <map>
 #include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace napa::store;
 
 class StoreImpl: public Store {
 public:
     /// <summary> Constructor. </summary>
-    explicit StoreImpl(const char* id)
-        : _id(id) {
+    explicit StoreImpl(const char* id, const StoreOptions& options = StoreOptions())
+        : _id(id), _options(options) {
+
+        if (!_options.snapshotPath.empty()) {
+            if (napa::filesystem::IsRegularFile(napa::filesystem::Path(_options.snapshotPath))) {
+                try {
+                    Load(_options.snapshotPath.c_str());
+                } catch (const std::exception& ex) {
+                    LOG_ERROR("Store", "Failed to load snapshot of store '%s': %s", _id.c_str(), ex.what());
+                }
+            }
+
+            if (_options.snapshotInterval > 0) {
+                _snapshotThread = std::thread(&StoreImpl::SnapshotLoop, this);
+            }
+        }
+    }
+
+    /// <summary> Destructor. It saves a final snapshot if the store has a snapshot path. </summary>
+    ~StoreImpl() override {
+        if (_snapshotThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(_snapshotAccess);
+                _snapshotStopped = true;
+            }
+            _snapshotCondition.notify_one();
+            _snapshotThread.join();
+        }
+
+        if (!_options.snapshotPath.empty()) {
+            SaveSnapshot();
+        }
     }
 
     /// <summary> Get ID of this store. </summary>
@@ -27,53 +74,526 @@ public:
     /// <param name="value"> A shared pointer of ValueType,
     /// which is composed by a pair of payload and transport context. </returns>
     void Set(const char* key, std::shared_ptr<Store::ValueType> value) override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        auto it = _valueMap.find(key);
-        if (it != _valueMap.end()) {
-            it->second = std::move(value);
-        } else {
-            _valueMap.emplace(std::string(key), std::move(value));
-        }
+        Set(key, std::move(value), _options.ttl);
+    }
+
+    /// <summary> Set value with a key, which expires after a time to live. </summary>
+    void Set(const char* key, std::shared_ptr<Store::ValueType> value, uint32_t ttl) override {
+        auto stored = Prepare(std::move(value));
+
+        StoreLock lock(*this);
+        auto now = Clock::now();
+        PurgeExpired(now);
+
+        SetEntry(key, std::move(stored), ttl, now);
+        EvictOverLimits();
     }
 
     /// <summary> Get value by a key. </summary>
     /// <param name="key"> Case-sensitive key to get. </param>
     /// <returns> A ValueType shared pointer, empty if not found. </returns>
     std::shared_ptr<ValueType> Get(const char* key) const override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        auto it = _valueMap.find(key);
-        if (it != _valueMap.end()) {
-            return it->second;
+        StoredValue stored;
+        {
+            StoreLock lock(*this);
+            PurgeExpired(Clock::now());
+
+            auto it = _valueMap.find(key);
+            if (it == _valueMap.end()) {
+                _statistics.misses++;
+                return nullptr;
+            }
+            _statistics.hits++;
+            Touch(it->second);
+            stored = it->second->stored;
         }
-        return nullptr;
+
+        // Decompress without the lock, so a cold read of a large value doesn't hold up other store users.
+        return GetValue(stored);
     }
 
     /// <summary> Check if this store has a key. </summary>
     /// <param name="key"> Case-sensitive key. </param>
     /// <returns> True if the key exists in store. </returns>
     bool Has(const char* key) const override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
+        StoreLock lock(*this);
+        PurgeExpired(Clock::now());
         return _valueMap.find(key) != _valueMap.end();
     }
 
     /// <summary> Delete a key. No-op if key is not found in store. </summary>
     void Delete(const char* key) override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        _valueMap.erase(key);
+        StoreLock lock(*this);
+        auto it = _valueMap.find(key);
+        if (it != _valueMap.end()) {
+            Remove(it);
+        }
     }
 
     /// <summary> Return size of the store. </summary>
     size_t Size() const override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
+        StoreLock lock(*this);
+        PurgeExpired(Clock::now());
         return _valueMap.size();
     }
 
+    /// <summary> Get values of multiple keys under one lock acquisition. </summary>
+    std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const override {
+        std::vector<StoredValue> stored(keys.size());
+        {
+            StoreLock lock(*this);
+            PurgeExpired(Clock::now());
+
+            for (size_t i = 0; i < keys.size(); ++i) {
+                auto it = _valueMap.find(keys[i]);
+                if (it != _valueMap.end()) {
+                    _statistics.hits++;
+                    Touch(it->second);
+                    stored[i] = it->second->stored;
+                } else {
+                    _statistics.misses++;
+                }
+            }
+        }
+
+        std::vector<std::shared_ptr<ValueType>> values;
+        values.reserve(keys.size());
+        for (const auto& value : stored) {
+            values.push_back(value.IsEmpty() ? nullptr : GetValue(value));
+        }
+        return values;
+    }
+
+    /// <summary> Set multiple keys under one lock acquisition. </summary>
+    void SetMany(std::vector<KeyValueType> values) override {
+        std::vector<StoredValue> stored;
+        stored.reserve(values.size());
+        for (auto& keyValue : values) {
+            stored.push_back(Prepare(std::move(keyValue.second)));
+        }
+
+        StoreLock lock(*this);
+        auto now = Clock::now();
+        PurgeExpired(now);
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            SetEntry(values[i].first, std::move(stored[i]), _options.ttl, now);
+        }
+        EvictOverLimits();
+    }
+
+    /// <summary> Get version of a key, 0 if not found. </summary>
+    uint64_t GetVersion(const char* key) const override {
+        StoreLock lock(*this);
+        PurgeExpired(Clock::now());
+
+        auto it = _valueMap.find(key);
+        return it != _valueMap.end() ? it->second->version : 0;
+    }
+
+    /// <summary> Set value with a key only if its current version matches. </summary>
+    uint64_t CompareAndSet(const char* key, std::shared_ptr<ValueType> value, uint64_t expectedVersion) override {
+        auto stored = Prepare(std::move(value));
+
+        StoreLock lock(*this);
+        auto now = Clock::now();
+        PurgeExpired(now);
+
+        auto it = _valueMap.find(key);
+        auto version = it != _valueMap.end() ? it->second->version : 0;
+        if (version != expectedVersion) {
+            return 0;
+        }
+
+        version = SetEntry(key, std::move(stored), _options.ttl, now);
+        EvictOverLimits();
+        return version;
+    }
+
+    /// <summary> Get value of a key, or set it if the key doesn't exist. </summary>
+    std::shared_ptr<ValueType> GetOrSet(const char* key, std::shared_ptr<ValueType> value) override {
+        auto stored = Prepare(value);
+
+        StoredValue existing;
+        {
+            StoreLock lock(*this);
+            auto now = Clock::now();
+            PurgeExpired(now);
+
+            auto it = _valueMap.find(key);
+            if (it == _valueMap.end()) {
+                _statistics.misses++;
+                SetEntry(key, std::move(stored), _options.ttl, now);
+                EvictOverLimits();
+                return value;
+            }
+            _statistics.hits++;
+            Touch(it->second);
+            existing = it->second->stored;
+        }
+        return GetValue(existing);
+    }
+
+    /// <summary> Atomically add a number to a numeric value. </summary>
+    bool Increment(const char* key, double delta, double& result) override {
+        StoreLock lock(*this);
+        auto now = Clock::now();
+        PurgeExpired(now);
+
+        double current = 0;
+        auto it = _valueMap.find(key);
+        if (it != _valueMap.end() && !payload::ParseNumber(GetValue(it->second->stored)->payload, current)) {
+            return false;
+        }
+
+        result = current + delta;
+        if (!std::isfinite(result)) {
+            return false;
+        }
+
+        // Keep the TTL of an existing key by rewriting its value in place.
+        auto stored = Prepare(std::make_shared<ValueType>(
+            ValueType { payload::FormatNumber(result), napa::transport::TransportContext() }));
+        if (it != _valueMap.end()) {
+            auto& entry = *it->second;
+            UncountBytes(entry.stored);
+            entry.stored = std::move(stored);
+            entry.version = ++_lastVersion;
+            CountBytes(entry.stored);
+            Touch(it->second);
+            QueueNotification(entry.key, entry.version);
+        } else {
+            SetEntry(key, std::move(stored), _options.ttl, now);
+        }
+        EvictOverLimits();
+        return true;
+    }
+
+    /// <summary> Save keys with their remaining time to live to a snapshot file. </summary>
+    size_t Save(const char* path) const override {
+        // Only references to values are taken under the lock. Decompressing and converting them for the
+        // snapshot happens afterwards, so saving a large store doesn't block other store users.
+        struct SavedEntry {
+            std::string key;
+            StoredValue stored;
+            uint32_t ttl;
+        };
+
+        std::vector<SavedEntry> savedEntries;
+        {
+            StoreLock lock(*this);
+            auto now = Clock::now();
+            PurgeExpired(now);
+
+            savedEntries.reserve(_entries.size());
+            for (auto it = _entries.rbegin(); it != _entries.rend(); ++it) {
+                if (it->stored.value != nullptr && it->stored.value->transportContext.GetSharedCount() > 0) {
+                    continue;
+                }
+
+                uint32_t ttl = 0;
+                if (it->hasExpiry) {
+                    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(it->expiry->first - now).count();
+                    ttl = static_cast<uint32_t>(std::max<decltype(remaining)>(remaining, 1));
+                }
+                savedEntries.push_back(SavedEntry { it->key, it->stored, ttl });
+            }
+        }
+
+        std::vector<SnapshotEntry> snapshotEntries;
+        snapshotEntries.reserve(savedEntries.size());
+        for (auto& entry : savedEntries) {
+            snapshotEntries.push_back(SnapshotEntry { std::move(entry.key), GetValue(entry.stored)->payload, entry.ttl });
+        }
+
+        snapshot::Write(path, snapshotEntries);
+        return snapshotEntries.size();
+    }
+
+    /// <summary> Load keys from a snapshot file, overriding existing keys. </summary>
+    size_t Load(const char* path) override {
+        auto snapshotEntries = snapshot::Read(path);
+
+        std::vector<StoredValue> stored;
+        stored.reserve(snapshotEntries.size());
+        for (auto& entry : snapshotEntries) {
+            stored.push_back(Prepare(std::make_shared<ValueType>(
+                ValueType { std::move(entry.payload), napa::transport::TransportContext() })));
+        }
+
+        StoreLock lock(*this);
+        auto now = Clock::now();
+        PurgeExpired(now);
+
+        for (size_t i = 0; i < snapshotEntries.size(); ++i) {
+            SetEntry(snapshotEntries[i].key, std::move(stored[i]), snapshotEntries[i].ttl, now);
+        }
+        EvictOverLimits();
+        return snapshotEntries.size();
+    }
+
+    uint64_t Watch(const char* key, bool isPrefix, WatchCallback callback) override {
+        return _watchers.Add(key, isPrefix, std::move(callback));
+    }
+
+    void Unwatch(uint64_t watchId) override {
+        _watchers.Remove(watchId);
+    }
+
+    /// <summary> Get options of the store. </summary>
+    const StoreOptions& GetOptions() const override {
+        return _options;
+    }
+
+    /// <summary> Get a snapshot of counters of the store. </summary>
+    StoreStatistics GetStatistics() const override {
+        StoreLock lock(*this);
+        PurgeExpired(Clock::now());
+        return _statistics;
+    }
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    /// <summary> Holds the store lock, and notifies watchers of the changes made under it once it's released. </summary>
+    class StoreLock {
+    public:
+        explicit StoreLock(const StoreImpl& store) : _store(store), _lock(store._storeAccess) {}
+
+        ~StoreLock() {
+            if (_store._notifications.empty()) {
+                return;
+            }
+
+            std::vector<std::pair<std::string, uint64_t>> notifications;
+            notifications.swap(_store._notifications);
+            _lock.unlock();
+
+            for (const auto& notification : notifications) {
+                _store._watchers.Notify(notification.first, notification.second);
+            }
+        }
+
+    private:
+        const StoreImpl& _store;
+        std::unique_lock<std::mutex> _lock;
+    };
+
+    /// <summary> Keys ordered by expiration time. </summary>
+    using ExpiryMap = std::multimap<Clock::time_point, std::string>;
+
+    /// <summary> A value as kept by the store, with its payload compressed if it's over compressThreshold. </summary>
+    /// <remarks> It's cheap to copy, so readers copy it under the lock and decompress after releasing it. </remarks>
+    struct StoredValue {
+        /// <summary> The value, or nullptr if its payload is compressed. </summary>
+        std::shared_ptr<Store::ValueType> value;
+
+        /// <summary> Compressed payload of the value if value is nullptr. </summary>
+        std::shared_ptr<const compression::CompressedPayload> compressed;
+
+        /// <summary> Payload size in bytes as kept. </summary>
+        size_t bytes;
+
+        /// <summary> Payload size in bytes before compression. </summary>
+        size_t rawBytes;
+
+        /// <summary> True if it holds neither a value nor a compressed payload. </summary>
+        bool IsEmpty() const {
+            return value == nullptr && compressed == nullptr;
+        }
+    };
+
+    /// <summary> A key with its value. </summary>
+    struct Entry {
+        std::string key;
+        StoredValue stored;
+
+        /// <summary> Version assigned on last update. </summary>
+        uint64_t version;
+
+        /// <summary> True if the key has a time to live, then expiry points to its position in _expiries. </summary>
+        bool hasExpiry;
+        ExpiryMap::iterator expiry;
+    };
+
+    /// <summary> Entries from most to least recently used. </summary>
+    using EntryList = std::list<Entry>;
+
+    using ValueMap = std::unordered_map<std::string, EntryList::iterator>;
+
+    /// <summary> Compress a value to keep if its payload is over compressThreshold. It doesn't need the lock. </summary>
+    StoredValue Prepare(std::shared_ptr<Store::ValueType> value) const {
+        StoredValue stored { std::move(value), nullptr, 0, 0 };
+        stored.rawBytes = stored.value->payload.GetByteSize();
+        stored.bytes = stored.rawBytes;
+
+        // Native objects in transport context are kept alive by the value, thus it can't be dropped.
+        compression::CompressedPayload compressed;
+        if (_options.compressThreshold > 0
+            && stored.rawBytes >= _options.compressThreshold
+            && stored.value->transportContext.GetSharedCount() == 0
+            && compression::Compress(stored.value->payload, compressed)) {
+            stored.value = nullptr;
+            stored.bytes = compressed.data.size();
+            stored.compressed = std::make_shared<const compression::CompressedPayload>(std::move(compressed));
+        }
+        return stored;
+    }
+
+    /// <summary> Get value of a stored value, decompressing its payload if it's compressed. It doesn't need the lock. </summary>
+    static std::shared_ptr<Store::ValueType> GetValue(const StoredValue& stored) {
+        if (stored.value != nullptr) {
+            return stored.value;
+        }
+        return std::make_shared<Store::ValueType>(Store::ValueType {
+            compression::Decompress(*stored.compressed), napa::transport::TransportContext() });
+    }
+
+    void CountBytes(const StoredValue& stored) const {
+        _statistics.bytes += stored.bytes;
+        _statistics.rawBytes += stored.rawBytes;
+        if (stored.value == nullptr) {
+            _statistics.compressedBytes += stored.bytes;
+        }
+    }
+
+    void UncountBytes(const StoredValue& stored) const {
+        _statistics.bytes -= stored.bytes;
+        _statistics.rawBytes -= stored.rawBytes;
+        if (stored.value == nullptr) {
+            _statistics.compressedBytes -= stored.bytes;
+        }
+    }
+
+    /// <summary> Save snapshot to the path in options, logging instead of throwing on failure. </summary>
+    void SaveSnapshot() const {
+        try {
+            Save(_options.snapshotPath.c_str());
+        } catch (const std::exception& ex) {
+            LOG_ERROR("Store", "Failed to save snapshot of store '%s': %s", _id.c_str(), ex.what());
+        }
+    }
+
+    /// <summary> Background thread to save snapshot periodically until the store is destroyed. </summary>
+    void SnapshotLoop() {
+        std::unique_lock<std::mutex> lock(_snapshotAccess);
+        while (!_snapshotCondition.wait_for(
+            lock,
+            std::chrono::milliseconds(_options.snapshotInterval),
+            [this]() { return _snapshotStopped; })) {
+            lock.unlock();
+            SaveSnapshot();
+            lock.lock();
+        }
+    }
+
+    /// <summary> Insert or update an entry as most recently used. Caller holds the lock and evicts afterwards. </summary>
+    /// <returns> New version of the entry. </returns>
+    uint64_t SetEntry(const std::string& key, StoredValue stored, uint32_t ttl, Clock::time_point now) {
+        auto version = ++_lastVersion;
+        auto it = _valueMap.find(key);
+        if (it != _valueMap.end()) {
+            auto& entry = *it->second;
+            UncountBytes(entry.stored);
+            entry.stored = std::move(stored);
+            entry.version = version;
+            ClearExpiry(entry);
+            Touch(it->second);
+        } else {
+            _entries.emplace_front(Entry { key, std::move(stored), version, false, ExpiryMap::iterator() });
+            _valueMap.emplace(key, _entries.begin());
+        }
+        CountBytes(_entries.front().stored);
+
+        if (ttl > 0) {
+            auto& entry = _entries.front();
+            entry.expiry = _expiries.emplace(now + std::chrono::milliseconds(ttl), entry.key);
+            entry.hasExpiry = true;
+        }
+        QueueNotification(key, version);
+        return version;
+    }
+
+    /// <summary> Queue a change to notify watchers of once the lock is released. Caller holds the lock. </summary>
+    void QueueNotification(const std::string& key, uint64_t version) const {
+        if (_watchers.HasWatchers()) {
+            _notifications.emplace_back(key, version);
+        }
+    }
+
+    /// <summary> Mark an entry as most recently used. </summary>
+    void Touch(EntryList::iterator entry) const {
+        _entries.splice(_entries.begin(), _entries, entry);
+    }
+
+    void ClearExpiry(Entry& entry) const {
+        if (entry.hasExpiry) {
+            _expiries.erase(entry.expiry);
+            entry.hasExpiry = false;
+        }
+    }
+
+    void Remove(ValueMap::iterator it) const {
+        auto entry = it->second;
+        QueueNotification(entry->key, 0);
+        UncountBytes(entry->stored);
+        ClearExpiry(*entry);
+        _valueMap.erase(it);
+        _entries.erase(entry);
+    }
+
+    /// <summary> Remove keys whose time to live has passed. </summary>
+    void PurgeExpired(Clock::time_point now) const {
+        while (!_expiries.empty() && _expiries.begin()->first <= now) {
+            auto it = _valueMap.find(_expiries.begin()->second);
+            NAPA_ASSERT(it != _valueMap.end(), "Expiring key must exist in store");
+            Remove(it);
+            _statistics.expirations++;
+        }
+    }
+
+    /// <summary> Evict least recently used keys until limits are met. The most recent key is always kept. </summary>
+    void EvictOverLimits() {
+        while (_entries.size() > 1
+            && ((_options.maxEntries > 0 && _entries.size() > _options.maxEntries)
+                || (_options.maxBytes > 0 && _statistics.bytes > _options.maxBytes))) {
+            Remove(_valueMap.find(_entries.back().key));
+            _statistics.evictions++;
+        }
+    }
+
     /// <summary> ID. Case sensitive. </summary>
     std::string _id;
 
-    /// <summary> Key to value map. </summary>
-    std::unordered_map<std::string, std::shared_ptr<Store::ValueType>> _valueMap;
+    /// <summary> Options. </summary>
+    StoreOptions _options;
+
+    /// <summary> Key to entry map. Lookups update recency and purge expired keys, hence mutable. </summary>
+    mutable ValueMap _valueMap;
+
+    /// <summary> Entries in recency order. </summary>
+    mutable EntryList _entries;
+
+    /// <summary> Keys with time to live. </summary>
+    mutable ExpiryMap _expiries;
+
+    /// <summary> Counters. </summary>
+    mutable StoreStatistics _statistics;
+
+    /// <summary> Last version assigned to an entry. </summary>
+    uint64_t _lastVersion = 0;
+
+    /// <summary> Watchers, notified after the store lock is released. </summary>
+    StoreWatchers _watchers;
+
+    /// <summary> Changes made under the store lock, to notify watchers of once it's released. </summary>
+    mutable std::vector<std::pair<std::string, uint64_t>> _notifications;
+
+    /// <summary> Periodic snapshot thread and its stop signal. </summary>
+    std::thread _snapshotThread;
+    std::mutex _snapshotAccess;
+    std::condition_variable _snapshotCondition;
+    bool _snapshotStopped = false;
 
     /// <summary> Mutex to value map access. (use std::shared_mutex when it's public) </summary>
     mutable std::mutex _storeAccess;
@@ -88,21 +608,29 @@ namespace store {
     } // namespace
 
     std::shared_ptr<Store> CreateStore(const char* id) {
+        return CreateStore(id, StoreOptions());
+    }
+
+    std::shared_ptr<Store> CreateStore(const char* id, const StoreOptions& options) {
         std::lock_guard<std::mutex> lockWrite(_registryAccess);
         
         std::shared_ptr<Store> store;
         auto it = _storeRegistry.find(id);
         if (it == _storeRegistry.end()) {
-            store = std::make_shared<StoreImpl>(id);
+            store = std::make_shared<StoreImpl>(id, options);
             _storeRegistry.insert(std::make_pair(std::string(id), store));
         }
         return store;
     }
 
     std::shared_ptr<Store> GetOrCreateStore(const char* id) {
+        return GetOrCreateStore(id, StoreOptions());
+    }
+
+    std::shared_ptr<Store> GetOrCreateStore(const char* id, const StoreOptions& options) {
         auto store = GetStore(id);
         if (store == nullptr) {
-            store = CreateStore(id);
+            store = CreateStore(id, options);
             if (store == nullptr) {
                 // Already created just now. Lookup again.
                 store = GetStore(id);
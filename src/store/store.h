@@ -3,15 +3,67 @@
 
 #pragma once
 
+#include "store-payload.h"
+
 #include <napa/exports.h>
 #include <napa/transport/transport-context.h>
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace napa {
 namespace store {
 
+    /// <summary> Optional limits and persistence of a store. 0 means unlimited. </summary>
+    struct StoreOptions {
+        /// <summary> Maximum number of keys. Least recently used keys are evicted beyond it. </summary>
+        size_t maxEntries = 0;
+
+        /// <summary> Maximum total size of payloads in bytes. Least recently used keys are evicted beyond it. </summary>
+        size_t maxBytes = 0;
+
+        /// <summary> Default time to live of a key in milliseconds, used when Set is called without TTL. </summary>
+        uint32_t ttl = 0;
+
+        /// <summary> Snapshot file, loaded when the store is created and saved when it's destroyed. Empty for none. </summary>
+        std::string snapshotPath;
+
+        /// <summary> Interval in milliseconds to save snapshot in background, 0 for no periodic snapshot. </summary>
+        uint32_t snapshotInterval = 0;
+
+        /// <summary> Payload size in bytes from which values are kept compressed, 0 for no compression.
+        /// Values holding native objects in their transport context are never compressed. </summary>
+        size_t compressThreshold = 0;
+    };
+
+    /// <summary> Counters of a store. </summary>
+    struct StoreStatistics {
+        /// <summary> Number of Get calls that found the key. </summary>
+        uint64_t hits = 0;
+
+        /// <summary> Number of Get calls that didn't find the key. </summary>
+        uint64_t misses = 0;
+
+        /// <summary> Number of keys evicted because of maxEntries or maxBytes. </summary>
+        uint64_t evictions = 0;
+
+        /// <summary> Number of keys removed because their TTL expired. </summary>
+        uint64_t expirations = 0;
+
+        /// <summary> Current total size of payloads in bytes, as they are kept after compression. </summary>
+        size_t bytes = 0;
+
+        /// <summary> Current total size of payloads in bytes before compression. </summary>
+        size_t rawBytes = 0;
+
+        /// <summary> Current size of compressed payloads in bytes, included in bytes. </summary>
+        size_t compressedBytes = 0;
+    };
+
     /// <summary> Class for memory store, which stores transportable JS objects across isolates. </summary>
     /// <remarks> Store is intended to be used by StoreWrap. 
     /// We expose Store in napa.dll instead of napa-binding for sharing memory between Napa and Node.JS. </remarks>
@@ -20,12 +72,18 @@ namespace store {
         /// Meta-data that is necessary to marshall/unmarshall JS values.
         struct ValueType {
             /// <summary> JSON string from marshalled JS value. </summary>
-            std::u16string payload;
+            Payload payload;
 
             /// <summary> TransportContext that is needed to unmarshall the JS value. </summary>
             napa::transport::TransportContext transportContext;
         };
 
+        /// <summary> A key with its value, used by batched operations. </summary>
+        using KeyValueType = std::pair<std::string, std::shared_ptr<ValueType>>;
+
+        /// <summary> Callback of a change to a watched key, with the new version of the key, or 0 if the key is removed. </summary>
+        using WatchCallback = std::function<void(const std::string& key, uint64_t version)>;
+
         /// <summary> Get ID of this store. </summary>
         virtual const char* GetId() const = 0;
 
@@ -35,6 +93,12 @@ namespace store {
         /// which is composed by a pair of payload and transport context. </returns>
         virtual void Set(const char* key, std::shared_ptr<ValueType> value) = 0;
 
+        /// <summary> Set value with a key, which expires after a time to live. </summary>
+        /// <param name="key"> Case-sensitive key to set. </param>
+        /// <param name="value"> A shared pointer of ValueType. </param>
+        /// <param name="ttl"> Time to live in milliseconds, 0 for never expire. </param>
+        virtual void Set(const char* key, std::shared_ptr<ValueType> value, uint32_t ttl) = 0;
+
         /// <summary> Get value by a key. </summary>
         /// <param name="key"> Case-sensitive key to get. </param>
         /// <returns> A ValueType shared pointer, empty if not found. </returns>
@@ -48,9 +112,74 @@ namespace store {
         /// <summary> Delete a key. No-op if key is not found in store. </summary>
         virtual void Delete(const char* key) = 0;
 
+        /// <summary> Get values of multiple keys under one lock acquisition. </summary>
+        /// <param name="keys"> Case-sensitive keys to get. </param>
+        /// <returns> Values in the order of keys, with empty pointers for keys not found. </returns>
+        virtual std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const = 0;
+
+        /// <summary> Set multiple keys under one lock acquisition. </summary>
+        /// <param name="values"> Keys with values to set, in order. </param>
+        virtual void SetMany(std::vector<KeyValueType> values) = 0;
+
+        /// <summary> Get version of a key. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <returns> A number which changes on every update of the key, 0 if the key is not found. </returns>
+        /// <remarks> Versions are unique within a store, so a key that is deleted and set again gets a new version. </remarks>
+        virtual uint64_t GetVersion(const char* key) const = 0;
+
+        /// <summary> Set value with a key only if its current version matches. </summary>
+        /// <param name="key"> Case-sensitive key to set. </param>
+        /// <param name="value"> A shared pointer of ValueType. </param>
+        /// <param name="expectedVersion"> Version returned by GetVersion, 0 to set only if the key doesn't exist. </param>
+        /// <returns> New version of the key if set, otherwise 0. </returns>
+        virtual uint64_t CompareAndSet(const char* key, std::shared_ptr<ValueType> value, uint64_t expectedVersion) = 0;
+
+        /// <summary> Get value of a key, or set it with the given value if the key doesn't exist. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <param name="value"> A shared pointer of ValueType to set if the key is not found. </param>
+        /// <returns> The existing value, or value if it's set by this call. </returns>
+        virtual std::shared_ptr<ValueType> GetOrSet(const char* key, std::shared_ptr<ValueType> value) = 0;
+
+        /// <summary> Atomically add a number to a numeric value. A key not found is treated as 0. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <param name="delta"> Number to add. </param>
+        /// <param name="result"> Value after increment. </param>
+        /// <returns> False if the existing value is not a number, in which case the store is not changed. </returns>
+        virtual bool Increment(const char* key, double delta, double& result) = 0;
+
         /// <summary> Return size of the store. </summary>
         virtual size_t Size() const = 0;
 
+        /// <summary> Save keys with their remaining time to live to a snapshot file. </summary>
+        /// <param name="path"> Snapshot file path, which is replaced atomically. </param>
+        /// <returns> Number of keys saved. It throws std::runtime_error if the file can't be written. </returns>
+        /// <remarks> Values holding native objects in their transport context (e.g. transportables,
+        /// SharedArrayBuffer) are process specific, thus are not saved. </remarks>
+        virtual size_t Save(const char* path) const = 0;
+
+        /// <summary> Load keys from a snapshot file, overriding existing keys. </summary>
+        /// <param name="path"> Snapshot file path. </param>
+        /// <returns> Number of keys loaded. It throws std::runtime_error if the file can't be read or is malformed. </returns>
+        virtual size_t Load(const char* path) = 0;
+
+        /// <summary> Watch changes to a key, or to all keys with a prefix. </summary>
+        /// <param name="key"> Key, or key prefix if isPrefix is true. </param>
+        /// <param name="callback"> Called for each set, delete, expiration and eviction of a matching key. </param>
+        /// <returns> Watch id to unwatch. </returns>
+        /// <remarks> The callback runs on the thread changing the key, after the store lock is released, so it may
+        /// read the store. Watchers are locked while it runs, thus it must return quickly, and must not change the
+        /// store or watch and unwatch, which would notify or lock watchers again. </remarks>
+        virtual uint64_t Watch(const char* key, bool isPrefix, WatchCallback callback) = 0;
+
+        /// <summary> Stop watching. No-op if the watch id is not found. </summary>
+        virtual void Unwatch(uint64_t watchId) = 0;
+
+        /// <summary> Get options of the store. </summary>
+        virtual const StoreOptions& GetOptions() const = 0;
+
+        /// <summary> Get a snapshot of counters of the store. </summary>
+        virtual StoreStatistics GetStatistics() const = 0;
+
         /// <summary> Destructor. </summary>
         virtual ~Store() = default;
     };
@@ -60,16 +189,43 @@ namespace store {
     /// <returns> Newly created store, or nullptr if store associated with id already exists. </summary>
     NAPA_API std::shared_ptr<Store> CreateStore(const char* id);
 
+    /// <summary> Create a store by id, with options. </summary>
+    /// <param name="id"> Case-sensitive id. </summary>
+    /// <param name="options"> Limits of entries, bytes and time to live, and snapshot settings. </summary>
+    /// <returns> Newly created store, or nullptr if store associated with id already exists. </summary>
+    NAPA_API std::shared_ptr<Store> CreateStore(const char* id, const StoreOptions& options);
+
     /// <summary> Get or create a store by id. </summary>
     /// <param name="id"> Case-sensitive id. </summary>
     /// <returns> Existing or newly created store. Should never be nullptr. </summary>
     NAPA_API std::shared_ptr<Store> GetOrCreateStore(const char* id);
 
+    /// <summary> Get or create a store by id, with options. </summary>
+    /// <param name="id"> Case-sensitive id. </summary>
+    /// <param name="options"> Options to create the store with. Ignored if the store exists. </summary>
+    /// <returns> Existing or newly created store. Should never be nullptr. </summary>
+    NAPA_API std::shared_ptr<Store> GetOrCreateStore(const char* id, const StoreOptions& options);
+
     /// <summary> Get a store by id. </summary>
     /// <param name="id"> Case-sensitive id. </summary>
     /// <returns> Existing store or nullptr if not found. </summary>
     NAPA_API std::shared_ptr<Store> GetStore(const char* id);
 
+    /// <summary> Create a store in named shared memory, which can be opened by other processes via GetSharedStore. </summary>
+    /// <param name="id"> Case-sensitive id of characters [A-Za-z0-9._-]. </summary>
+    /// <param name="options"> maxEntries and maxBytes size the shared memory, with defaults if 0. ttl is the default time to live.
+    /// Snapshot and compression options are not applied to shared stores. </summary>
+    /// <returns> Newly created store, or nullptr if a shared store with the id already exists.
+    /// It throws std::runtime_error if the shared memory can't be created. </summary>
+    /// <remarks> The shared memory is removed when the creating store is destroyed, processes which opened it keep their mapping.
+    /// Memory of overwritten or deleted values is not reclaimed, and only values without native objects can be set. </remarks>
+    NAPA_API std::shared_ptr<Store> CreateSharedStore(const char* id, const StoreOptions& options);
+
+    /// <summary> Get a shared store created by this or another process. </summary>
+    /// <param name="id"> Case-sensitive id. </summary>
+    /// <returns> The store, or nullptr if not found. It throws std::runtime_error if the shared memory is malformed. </summary>
+    NAPA_API std::shared_ptr<Store> GetSharedStore(const char* id);
+
     /// <summary> Get store count currently in use. </summary>
     NAPA_API size_t GetStoreCount();
 }
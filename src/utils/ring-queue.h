@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace napa {
+namespace utils {
+
+    /// <summary>
+    ///     A FIFO queue on a circular buffer, with the std::queue operations used by task queues.
+    ///     Unlike std::queue over std::deque, its storage is kept when drained, so a queue in steady state doesn't allocate.
+    /// </summary>
+    template <typename T>
+    class RingQueue {
+    public:
+        bool empty() const {
+            return _size == 0;
+        }
+
+        size_t size() const {
+            return _size;
+        }
+
+        T& front() {
+            return _items[_head];
+        }
+
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            if (_size == _items.size()) {
+                Grow();
+            }
+            _items[(_head + _size) % _items.size()] = T(std::forward<Args>(args)...);
+            ++_size;
+        }
+
+        void push(T item) {
+            emplace(std::move(item));
+        }
+
+        /// <summary> Remove the front item, releasing what it holds. </summary>
+        void pop() {
+            _items[_head] = T();
+            _head = (_head + 1) % _items.size();
+            --_size;
+        }
+
+    private:
+        void Grow() {
+            std::vector<T> items(_items.empty() ? INITIAL_CAPACITY : _items.size() * 2);
+            for (size_t i = 0; i < _size; ++i) {
+                items[i] = std::move(_items[(_head + i) % _items.size()]);
+            }
+            _items.swap(items);
+            _head = 0;
+        }
+
+        static constexpr size_t INITIAL_CAPACITY = 16;
+
+        std::vector<T> _items;
+        size_t _head = 0;
+        size_t _size = 0;
+    };
+}
+}
@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace napa {
+namespace utils {
+
+    template <typename Signature, size_t Capacity = 48>
+    class SmallFunction;
+
+    /// <summary>
+    ///     A move-only callable wrapper like std::function, which stores callables of up to 'Capacity' bytes inline,
+    ///     so wrapping a lambda capturing a few pointers doesn't allocate. Larger callables are stored on heap.
+    /// </summary>
+    template <typename R, typename... Args, size_t Capacity>
+    class SmallFunction<R(Args...), Capacity> {
+    public:
+        SmallFunction() = default;
+
+        SmallFunction(std::nullptr_t) {}
+
+        template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, SmallFunction>::value>>
+        SmallFunction(F&& function) {
+            using Functor = std::decay_t<F>;
+            Construct<Functor>(std::forward<F>(function), std::integral_constant<bool, IsInline<Functor>()>());
+        }
+
+        SmallFunction(SmallFunction&& other) noexcept {
+            MoveFrom(other);
+        }
+
+        SmallFunction& operator=(SmallFunction&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        SmallFunction(const SmallFunction&) = delete;
+        SmallFunction& operator=(const SmallFunction&) = delete;
+
+        ~SmallFunction() {
+            Reset();
+        }
+
+        R operator()(Args... args) {
+            return _ops->invoke(&_storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const {
+            return _ops != nullptr;
+        }
+
+        /// <summary> Whether a callable type is stored inline. </summary>
+        template <typename Functor>
+        static constexpr bool IsInline() {
+            return sizeof(Functor) <= Capacity
+                && alignof(Functor) <= alignof(std::max_align_t)
+                && std::is_nothrow_move_constructible<Functor>::value;
+        }
+
+    private:
+        /// <summary> Operations of the stored callable type. </summary>
+        struct Ops {
+            R (*invoke)(void* storage, Args&&... args);
+            void (*move)(void* to, void* from);
+            void (*destroy)(void* storage);
+        };
+
+        template <typename Functor>
+        struct InlineOps {
+            static R Invoke(void* storage, Args&&... args) {
+                return (*static_cast<Functor*>(storage))(std::forward<Args>(args)...);
+            }
+
+            static void Move(void* to, void* from) {
+                new (to) Functor(std::move(*static_cast<Functor*>(from)));
+                static_cast<Functor*>(from)->~Functor();
+            }
+
+            static void Destroy(void* storage) {
+                static_cast<Functor*>(storage)->~Functor();
+            }
+
+            static constexpr Ops ops = { Invoke, Move, Destroy };
+        };
+
+        template <typename Functor>
+        struct HeapOps {
+            static Functor*& Get(void* storage) {
+                return *static_cast<Functor**>(storage);
+            }
+
+            static R Invoke(void* storage, Args&&... args) {
+                return (*Get(storage))(std::forward<Args>(args)...);
+            }
+
+            static void Move(void* to, void* from) {
+                new (to) Functor*(Get(from));
+            }
+
+            static void Destroy(void* storage) {
+                delete Get(storage);
+            }
+
+            static constexpr Ops ops = { Invoke, Move, Destroy };
+        };
+
+        template <typename Functor, typename F>
+        void Construct(F&& function, std::true_type /* inline */) {
+            new (&_storage) Functor(std::forward<F>(function));
+            _ops = &InlineOps<Functor>::ops;
+        }
+
+        template <typename Functor, typename F>
+        void Construct(F&& function, std::false_type /* inline */) {
+            new (&_storage) Functor*(new Functor(std::forward<F>(function)));
+            _ops = &HeapOps<Functor>::ops;
+        }
+
+        void MoveFrom(SmallFunction& other) {
+            if (other._ops != nullptr) {
+                other._ops->move(&_storage, &other._storage);
+                _ops = other._ops;
+                other._ops = nullptr;
+            }
+        }
+
+        void Reset() {
+            if (_ops != nullptr) {
+                _ops->destroy(&_storage);
+                _ops = nullptr;
+            }
+        }
+
+        typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type _storage;
+        const Ops* _ops = nullptr;
+    };
+
+    template <typename R, typename... Args, size_t Capacity>
+    template <typename Functor>
+    constexpr typename SmallFunction<R(Args...), Capacity>::Ops SmallFunction<R(Args...), Capacity>::InlineOps<Functor>::ops;
+
+    template <typename R, typename... Args, size_t Capacity>
+    template <typename Functor>
+    constexpr typename SmallFunction<R(Args...), Capacity>::Ops SmallFunction<R(Args...), Capacity>::HeapOps<Functor>::ops;
+}
+}
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -138,6 +139,70 @@ namespace string {
     inline bool CaseInsensitiveEquals(const std::string& left, const std::string& right) {
         return CaseInsensitiveCompare(left, right) == 0;
     }
+
+    /// <summary> Whether a string only contains 7-bit ASCII chars, thus is the same in UTF-8 and Latin-1. </summary>
+    inline bool IsAscii(const std::string& str) {
+        return std::all_of(str.begin(), str.end(), [](char c) {
+            return (static_cast<unsigned char>(c) & 0x80) == 0;
+        });
+    }
+
+    /// <summary> Convert a UTF-8 string to UTF-16. Malformed sequences are replaced by U+FFFD. </summary>
+    inline std::u16string Utf8ToUtf16(const std::string& str) {
+        const char16_t replacement = 0xFFFD;
+
+        std::u16string result;
+        result.reserve(str.size());
+
+        size_t i = 0;
+        while (i < str.size()) {
+            auto lead = static_cast<unsigned char>(str[i++]);
+            if (lead < 0x80) {
+                result.push_back(lead);
+                continue;
+            }
+
+            size_t trailing = 0;
+            uint32_t codePoint = 0;
+            uint32_t minCodePoint = 0;
+            if ((lead & 0xE0) == 0xC0) {
+                trailing = 1;
+                codePoint = lead & 0x1F;
+                minCodePoint = 0x80;
+            } else if ((lead & 0xF0) == 0xE0) {
+                trailing = 2;
+                codePoint = lead & 0x0F;
+                minCodePoint = 0x800;
+            } else if ((lead & 0xF8) == 0xF0) {
+                trailing = 3;
+                codePoint = lead & 0x07;
+                minCodePoint = 0x10000;
+            } else {
+                result.push_back(replacement);
+                continue;
+            }
+
+            size_t consumed = 0;
+            while (consumed < trailing && i < str.size() && (static_cast<unsigned char>(str[i]) & 0xC0) == 0x80) {
+                codePoint = (codePoint << 6) | (static_cast<unsigned char>(str[i++]) & 0x3F);
+                ++consumed;
+            }
+
+            if (consumed < trailing
+                || codePoint < minCodePoint
+                || codePoint > 0x10FFFF
+                || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+                result.push_back(replacement);
+            } else if (codePoint >= 0x10000) {
+                codePoint -= 0x10000;
+                result.push_back(static_cast<char16_t>(0xD800 + (codePoint >> 10)));
+                result.push_back(static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF)));
+            } else {
+                result.push_back(static_cast<char16_t>(codePoint));
+            }
+        }
+        return result;
+    }
 }
 }
 }
\ No newline at end of file
@@ -7,31 +7,88 @@
 #endif
 
 #include "call-context.h"
+#include "object-pool.h"
 
+#include <napa/assert.h>
 #include <napa/log.h>
 #include <napa/v8-helpers.h>
+#include <platform/process.h>
+#include <utils/string.h>
 
 #include <stdint.h>
 
 using namespace napa::zone;
 
-CallContext::CallContext(const napa::FunctionSpec& spec, napa::ExecuteCallback callback) : 
+CallArguments::CallArguments(const napa::FunctionSpec& spec) :
     _module(NAPA_STRING_REF_TO_STD_STRING(spec.module)),
-    _function(NAPA_STRING_REF_TO_STD_STRING(spec.function)),
-    _callback(callback),
-    _finished(false) {
+    _function(NAPA_STRING_REF_TO_STD_STRING(spec.function)) {
 
-    // Audit start time.
-    _startTime = std::chrono::high_resolution_clock::now();
-    
     _arguments.reserve(spec.arguments.size());
+    _isAscii.reserve(spec.arguments.size());
+    bool needsUtf16 = false;
     for (auto& arg : spec.arguments) {
         _arguments.emplace_back(NAPA_STRING_REF_TO_STD_STRING(arg));
+        _isAscii.push_back(utils::string::IsAscii(_arguments.back()));
+        needsUtf16 |= !_isAscii.back() && _arguments.back().size() >= v8_helpers::MIN_EXTERNAL_STRING_LENGTH;
+    }
+
+    if (needsUtf16) {
+        _utf16Arguments.reset(new std::u16string[_arguments.size()]);
+        _utf16Converted.reset(new std::once_flag[_arguments.size()]);
     }
-    _options = spec.options;
+}
+
+const std::string& CallArguments::GetModule() const {
+    return _module;
+}
+
+const std::string& CallArguments::GetFunction() const {
+    return _function;
+}
+
+const std::vector<std::string>& CallArguments::GetArguments() const {
+    return _arguments;
+}
+
+bool CallArguments::IsAsciiArgument(size_t index) const {
+    return _isAscii[index];
+}
+
+const std::u16string& CallArguments::GetUtf16Argument(size_t index) const {
+    NAPA_ASSERT(_utf16Arguments != nullptr, "UTF-16 is only kept for large non-ASCII arguments");
+    std::call_once(_utf16Converted[index], [this, index]() {
+        _utf16Arguments[index] = utils::string::Utf8ToUtf16(_arguments[index]);
+    });
+    return _utf16Arguments[index];
+}
+
+CallContext::CallContext(const napa::FunctionSpec& spec, napa::ExecuteCallback callback) :
+    CallContext(
+        MakePooled<CallArguments>(spec),
+        spec.options,
+        std::move(spec.transportContext),
+        std::move(callback)) {
+}
 
-    // Pass ownership of the transport context.
-    _transportContext = std::move(spec.transportContext);
+CallContext::CallContext(
+    std::shared_ptr<const CallArguments> arguments,
+    const napa::CallOptions& options,
+    std::unique_ptr<napa::transport::TransportContext> transportContext,
+    napa::ExecuteCallback callback) :
+    _arguments(std::move(arguments)),
+    _options(options),
+    _transportContext(std::move(transportContext)),
+    _callback(std::move(callback)),
+    _finished(false),
+    _executeStartTime(0),
+    _executingThread(std::thread::id()),
+    _executeStartCpuTime(0),
+    _executeStartHeapSize(0),
+    _cpuTime(0),
+    _heapGrowth(0) {
+
+    // Audit start time.
+    _startTime = std::chrono::high_resolution_clock::now();
 }
 
 bool CallContext::Resolve(std::string marshalledResult) {
@@ -40,13 +97,15 @@ bool CallContext::Resolve(std::string marshalledResult) {
         return false;
     }
 
-    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" is resolved successfully.", _module.c_str(), _function.c_str());
+    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" is resolved successfully.", _arguments->GetModule().c_str(), _arguments->GetFunction().c_str());
 
+    auto accounting = CreateAccounting(marshalledResult.size());
     _callback({ 
         NAPA_RESULT_SUCCESS, 
         "", 
         std::move(marshalledResult),
-        std::move(_transportContext) 
+        std::move(_transportContext),
+        std::move(accounting)
     });
     return true;
 }
@@ -57,9 +116,9 @@ bool CallContext::Reject(napa::ResultCode code, std::string reason) {
         return false;
     }
 
-    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" was rejected: %s.", _module.c_str(), _function.c_str(), reason.c_str());
+    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" was rejected: %s.", _arguments->GetModule().c_str(), _arguments->GetFunction().c_str(), reason.c_str());
 
-    _callback({ code, reason, "", std::move(_transportContext) });
+    _callback({ code, reason, "", std::move(_transportContext), CreateAccounting(0) });
     return true;
 }
 
@@ -68,14 +127,18 @@ bool CallContext::IsFinished() const {
 }
 
 const std::string& CallContext::GetModule() const {
-    return _module;
+    return _arguments->GetModule();
 }
 
 const std::string& CallContext::GetFunction() const {
-    return _function;
+    return _arguments->GetFunction();
 }
 
 const std::vector<std::string>& CallContext::GetArguments() const {
+    return _arguments->GetArguments();
+}
+
+const std::shared_ptr<const CallArguments>& CallContext::GetCallArguments() const {
     return _arguments;
 }
 
@@ -89,4 +152,71 @@ const napa::CallOptions& CallContext::GetOptions() const {
 
 std::chrono::nanoseconds CallContext::GetElapse() const {
     return std::chrono::high_resolution_clock::now() - _startTime;
+}
+
+void CallContext::BeginExecute() {
+    if (_options.accounting == 0) {
+        return;
+    }
+
+    v8::HeapStatistics heapStatistics;
+    v8::Isolate::GetCurrent()->GetHeapStatistics(&heapStatistics);
+
+    _executingThread = std::this_thread::get_id();
+    _executeStartCpuTime = platform::GetThreadCpuTime();
+    _executeStartHeapSize = heapStatistics.used_heap_size();
+    _executeStartTime = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+}
+
+void CallContext::EndExecute() {
+    if (_options.accounting == 0) {
+        return;
+    }
+
+    SampleExecution();
+    _executingThread = std::thread::id();
+}
+
+void CallContext::SampleExecution() {
+    if (_executingThread != std::this_thread::get_id()) {
+        return;
+    }
+
+    v8::HeapStatistics heapStatistics;
+    v8::Isolate::GetCurrent()->GetHeapStatistics(&heapStatistics);
+
+    // A garbage collection during the call may shrink the heap below where it started.
+    _cpuTime = (platform::GetThreadCpuTime() - _executeStartCpuTime).count();
+    _heapGrowth = heapStatistics.used_heap_size() > _executeStartHeapSize
+        ? heapStatistics.used_heap_size() - _executeStartHeapSize
+        : 0;
+}
+
+std::shared_ptr<const napa::CallAccounting> CallContext::CreateAccounting(size_t resultBytes) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    // A call that no worker started has nothing to measure.
+    auto executeStartTicks = _executeStartTime.load();
+    if (_options.accounting == 0 || executeStartTicks == 0) {
+        return nullptr;
+    }
+    auto executeStartTime = Clock::time_point(Clock::duration(executeStartTicks));
+
+    // A call finishing synchronously is still running on this thread, so it's sampled up to now.
+    // A timeout rejecting it on the timer thread can't sample it, then it gets the latest sample of the worker.
+    SampleExecution();
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    auto accounting = std::make_shared<napa::CallAccounting>();
+    accounting->queue_wait_us = duration_cast<microseconds>(executeStartTime - _startTime).count();
+    accounting->execution_us = duration_cast<microseconds>(Clock::now() - executeStartTime).count();
+    accounting->cpu_us = duration_cast<microseconds>(std::chrono::nanoseconds(_cpuTime.load())).count();
+    accounting->heap_bytes = _heapGrowth;
+    for (const auto& argument : _arguments->GetArguments()) {
+        accounting->argument_bytes += argument.size();
+    }
+    accounting->result_bytes = resultBytes;
+    return accounting;
 }
\ No newline at end of file
@@ -9,11 +9,54 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace napa {
 namespace zone {
 
+    /// <summary>
+    ///     Module, function and marshalled arguments of a call, copied once from FunctionSpec.
+    ///     It's immutable, thus a broadcast shares one instance with all workers.
+    /// </summary>
+    class CallArguments {
+    public:
+        /// <summary> Copy module, function and arguments from external FunctionSpec. </summary>
+        explicit CallArguments(const napa::FunctionSpec& spec);
+
+        /// <summary> Get module name to load function. </summary>
+        const std::string& GetModule() const;
+
+        /// <summary> Get function name to execute. </summary>
+        const std::string& GetFunction() const;
+
+        /// <summary> Get marshalled arguments in UTF-8. </summary>
+        const std::vector<std::string>& GetArguments() const;
+
+        /// <summary> Whether an argument only has ASCII chars, thus can be used as a Latin-1 string as is. </summary>
+        bool IsAsciiArgument(size_t index) const;
+
+        /// <summary> Get UTF-16 of an argument, converted on first call and shared by later calls. </summary>
+        /// <remarks> Only for non-ASCII arguments of at least v8_helpers::MIN_EXTERNAL_STRING_LENGTH chars,
+        /// which are passed to V8 as external strings. Shorter ones are copied into V8 heap. </remarks>
+        const std::u16string& GetUtf16Argument(size_t index) const;
+
+    private:
+        std::string _module;
+        std::string _function;
+        std::vector<std::string> _arguments;
+        std::vector<bool> _isAscii;
+
+        /// <summary>
+        ///     UTF-16 of large non-ASCII arguments, converted lazily as workers may convert concurrently.
+        ///     Only allocated if there is such an argument, so most calls don't pay for it.
+        /// </summary>
+        mutable std::unique_ptr<std::u16string[]> _utf16Arguments;
+        mutable std::unique_ptr<std::once_flag[]> _utf16Converted;
+    };
+
     /// <summary> Context of calling a JavaScript function. </summary>
     class CallContext {
 
@@ -21,6 +64,17 @@ namespace zone {
         /// <summary> Construct spec from external FunctionSpec. </summary>
         explicit CallContext(const napa::FunctionSpec& spec, napa::ExecuteCallback callback);
 
+        /// <summary> Construct spec with arguments shared with other calls. </summary>
+        /// <param name="arguments"> Immutable module, function and arguments. </param>
+        /// <param name="options"> Execute options. </param>
+        /// <param name="transportContext"> Transport context, which may be null. </param>
+        /// <param name="callback"> Callback when the call completes. </param>
+        CallContext(
+            std::shared_ptr<const CallArguments> arguments,
+            const napa::CallOptions& options,
+            std::unique_ptr<napa::transport::TransportContext> transportContext,
+            napa::ExecuteCallback callback);
+
         /// <summary> Resolve current spec. </summary>
         /// <param name="result"> marshalled return value. </param>
         /// <returns> True if operation is successful, otherwise if task is already finished before. </returns>
@@ -45,6 +99,9 @@ namespace zone {
         /// <summary> Get marshalled arguments. </summary>
         const std::vector<std::string>& GetArguments() const;
 
+        /// <summary> Get module, function and arguments, which may be shared with other calls. </summary>
+        const std::shared_ptr<const CallArguments>& GetCallArguments() const;
+
         /// <summary> Get transport context. </summary>
         napa::transport::TransportContext& GetTransportContext();
 
@@ -54,15 +111,21 @@ namespace zone {
         /// <summary> Get elapse since task start in nano-second. </summary>
         std::chrono::nanoseconds GetElapse() const;
 
+        /// <summary> Marks that the calling worker starts running the call, to measure it if the options ask to. </summary>
+        void BeginExecute();
+
+        /// <summary> Marks that the calling worker returned from running the call, which may still be pending. </summary>
+        void EndExecute();
+
     private:
-        /// <summary> Module name. </summary>
-        std::string _module;
+        /// <summary> Creates the accounting of the call finishing now, or null if it's not measured. </summary>
+        std::shared_ptr<const napa::CallAccounting> CreateAccounting(size_t resultBytes);
 
-        /// <summary> Function name. </summary>
-        std::string _function;
+        /// <summary> Updates CPU time and heap growth, if the call is running on the calling thread. </summary>
+        void SampleExecution();
 
-        /// <summary> Arguments. </summary>
-        std::vector<std::string> _arguments;
+        /// <summary> Module, function and arguments. </summary>
+        std::shared_ptr<const CallArguments> _arguments;
 
         /// <summary> Execute options. </summary>
         napa::CallOptions _options;
@@ -78,6 +141,23 @@ namespace zone {
 
         /// <summary> Call start time. </summary>
         std::chrono::high_resolution_clock::time_point _startTime;
+
+        /// <summary>
+        ///     When a worker started running the call, in ticks since the clock's epoch, 0 if it didn't or the call is not
+        ///     measured. It's atomic like the other fields a timeout reads on the timer thread while the worker writes them.
+        /// </summary>
+        std::atomic<std::chrono::high_resolution_clock::rep> _executeStartTime;
+
+        /// <summary> The thread running the call synchronously, if the call is measured. </summary>
+        std::atomic<std::thread::id> _executingThread;
+
+        /// <summary> Thread CPU time and heap size when the worker started running the call, only used by the worker. </summary>
+        std::chrono::nanoseconds _executeStartCpuTime;
+        size_t _executeStartHeapSize;
+
+        /// <summary> Thread CPU time in nanoseconds and heap growth while running the call, as of the latest sample. </summary>
+        std::atomic<std::chrono::nanoseconds::rep> _cpuTime;
+        std::atomic<size_t> _heapGrowth;
     };
 }
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "call-key.h"
+
+#include <cstring>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    const uint64_t HASH_OFFSET = 14695981039346656037ull;
+    const uint64_t HASH_PRIME = 1099511628211ull;
+
+    uint64_t Mix(uint64_t hash, uint64_t value) {
+        return (hash ^ value) * HASH_PRIME;
+    }
+
+    uint64_t HashBytes(uint64_t hash, const char* data, size_t size) {
+        hash = Mix(hash, size);
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = Mix(hash, word);
+        }
+        for (; i < size; ++i) {
+            hash = Mix(hash, static_cast<unsigned char>(data[i]));
+        }
+        return hash;
+    }
+
+    bool Equals(const std::string& value, const StringRef& ref) {
+        return value.size() == ref.size && (ref.size == 0 || std::memcmp(value.data(), ref.data, ref.size) == 0);
+    }
+
+} // namespace
+
+CallKey::CallKey(const FunctionSpec& spec) :
+    hash(Hash(spec)),
+    module(NAPA_STRING_REF_TO_STD_STRING(spec.module)),
+    function(NAPA_STRING_REF_TO_STD_STRING(spec.function)),
+    bytes(spec.module.size + spec.function.size) {
+
+    arguments.reserve(spec.arguments.size());
+    for (const auto& argument : spec.arguments) {
+        arguments.emplace_back(NAPA_STRING_REF_TO_STD_STRING(argument));
+        bytes += argument.size;
+    }
+}
+
+uint64_t CallKey::Hash(const FunctionSpec& spec) {
+    auto hash = HashBytes(HASH_OFFSET, spec.module.data, spec.module.size);
+    hash = HashBytes(hash, spec.function.data, spec.function.size);
+    for (const auto& argument : spec.arguments) {
+        hash = HashBytes(hash, argument.data, argument.size);
+    }
+    return Mix(hash, spec.arguments.size());
+}
+
+bool CallKey::Matches(const FunctionSpec& spec) const {
+    if (!Equals(module, spec.module) || !Equals(function, spec.function) || arguments.size() != spec.arguments.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        if (!Equals(arguments[i], spec.arguments[i])) {
+            return false;
+        }
+    }
+    return true;
+}
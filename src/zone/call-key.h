@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     Identifies a call by module, function and marshalled arguments, to find identical calls.
+    ///     It holds a copy of them, so it outlives the function spec it's made from.
+    /// </summary>
+    struct CallKey {
+        explicit CallKey(const FunctionSpec& spec);
+
+        /// <summary> Hash of module, function and arguments, each prefixed by its length, mixing 8 bytes per step. </summary>
+        static uint64_t Hash(const FunctionSpec& spec);
+
+        /// <summary> Returns true if the spec has the same module, function and arguments, to tell apart calls with the same hash. </summary>
+        bool Matches(const FunctionSpec& spec) const;
+
+        uint64_t hash;
+        std::string module;
+        std::string function;
+        std::vector<std::string> arguments;
+
+        /// <summary> Bytes of module, function and arguments. </summary>
+        size_t bytes;
+    };
+}
+}
@@ -36,11 +36,13 @@ void CallTask::Execute() {
 
     // Execute the function.
     v8::TryCatch tryCatch(isolate);
+    _context->BeginExecute();
     auto res = v8::Local<v8::Function>::Cast(executeFunction)->Call(
         isolate->GetCurrentContext(),
         context->Global(),
         1,
         argv);
+    _context->EndExecute();
 
     // Terminating an isolate may occur from a different thread, i.e. from timeout service.
     // If the function call already finished successfully when the isolate is terminated it may lead
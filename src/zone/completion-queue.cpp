@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "completion-queue.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace napa;
+using namespace napa::zone;
+
+ExecuteCallback CompletionQueue::MakeCallback(std::shared_ptr<CompletionQueue> queue, void* tag) {
+    // Result is moved into the completion as is, its strings are handed to the reaper without copy.
+    return [queue = std::move(queue), tag](Result result) {
+        queue->Push(std::unique_ptr<Completion>(new Completion { tag, std::move(result) }));
+    };
+}
+
+void CompletionQueue::Push(std::unique_ptr<Completion> completion) {
+    std::lock_guard<std::mutex> lock(_access);
+    if (_closed) {
+        return;
+    }
+    _completions.push_back(std::move(completion));
+
+    // Only wake up the reaper thread when it's blocked in wait.
+    if (_waiters > 0) {
+        _available.notify_one();
+    }
+}
+
+size_t CompletionQueue::Pop(std::unique_ptr<Completion>* completions, size_t max, const uint32_t* timeout) {
+    std::unique_lock<std::mutex> lock(_access);
+    if (timeout != nullptr && _completions.empty()) {
+        auto hasCompletion = [this]() { return !_completions.empty() || _closed; };
+        _waiters++;
+        if (*timeout == 0) {
+            _available.wait(lock, hasCompletion);
+        } else {
+            _available.wait_for(lock, std::chrono::milliseconds(*timeout), hasCompletion);
+        }
+        _waiters--;
+    }
+
+    auto count = std::min(max, _completions.size());
+    for (size_t i = 0; i < count; ++i) {
+        completions[i] = std::move(_completions.front());
+        _completions.pop_front();
+    }
+    return count;
+}
+
+void CompletionQueue::Close() {
+    std::deque<std::unique_ptr<Completion>> discarded;
+    {
+        std::lock_guard<std::mutex> lock(_access);
+        _closed = true;
+        discarded.swap(_completions);
+    }
+    _available.notify_all();
+}
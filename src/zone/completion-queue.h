@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A completed execution, which owns the result until it's released. </summary>
+    struct Completion {
+        void* tag;
+        Result result;
+    };
+
+    /// <summary>
+    ///     Collects results of executions to be reaped in batches. Each execution in flight holds the queue, so it
+    ///     stays alive until the last one completes. Completions of executions that complete after the queue is
+    ///     closed are discarded.
+    /// </summary>
+    /// <remarks> This class is thread-safe. </remarks>
+    class CompletionQueue {
+    public:
+        /// <summary> Returns the callback of an execution, which holds the queue and pushes the result. </summary>
+        /// <param name="queue"> The queue to push the completion to. </param>
+        /// <param name="tag"> An opaque pointer that is returned with the completion. </param>
+        static ExecuteCallback MakeCallback(std::shared_ptr<CompletionQueue> queue, void* tag);
+
+        /// <summary> Adds a completion, or discards it if the queue is closed. </summary>
+        void Push(std::unique_ptr<Completion> completion);
+
+        /// <summary> Moves up to 'max' completions out under one lock acquisition, in order of completion. </summary>
+        /// <param name="completions"> An array of at least 'max' completions to receive them. </param>
+        /// <param name="timeout"> Milliseconds to wait for the first completion, nullptr for no wait, 0 for infinite. </param>
+        /// <returns> The number of completions moved out. </returns>
+        size_t Pop(std::unique_ptr<Completion>* completions, size_t max, const uint32_t* timeout);
+
+        /// <summary> Discards completions not yet reaped and all completions pushed from now on. </summary>
+        void Close();
+
+    private:
+        std::mutex _access;
+        std::condition_variable _available;
+        std::deque<std::unique_ptr<Completion>> _completions;
+        size_t _waiters = 0;
+        bool _closed = false;
+    };
+}
+}
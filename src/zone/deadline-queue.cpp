@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "deadline-queue.h"
+
+#include <napa/log.h>
+
+using namespace napa::zone;
+
+DeadlineQueue::~DeadlineQueue() {
+    {
+        std::lock_guard<std::mutex> lock(_access);
+        _stopped = true;
+    }
+    _changed.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void DeadlineQueue::Add(std::chrono::milliseconds delay, Callback callback) {
+    auto deadline = Clock::now() + delay;
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(_access);
+        if (!_thread.joinable()) {
+            _thread = std::thread(&DeadlineQueue::Run, this);
+        }
+        earliest = _entries.empty() || deadline < _entries.top().deadline;
+        _entries.push(Entry { deadline, std::move(callback) });
+    }
+
+    // The thread only needs to wake up early for a deadline before the one it waits for.
+    if (earliest) {
+        _changed.notify_one();
+    }
+}
+
+size_t DeadlineQueue::GetPendingCount() {
+    std::lock_guard<std::mutex> lock(_access);
+    return _entries.size();
+}
+
+void DeadlineQueue::Run() {
+    std::unique_lock<std::mutex> lock(_access);
+    while (!_stopped) {
+        if (_entries.empty()) {
+            _changed.wait(lock);
+            continue;
+        }
+
+        auto deadline = _entries.top().deadline;
+        if (deadline > Clock::now()) {
+            _changed.wait_until(lock, deadline);
+            continue;
+        }
+
+        // The priority queue only exposes a const top, so the callback is copied out before popping.
+        auto callback = _entries.top().callback;
+        _entries.pop();
+
+        lock.unlock();
+        try {
+            callback();
+        } catch (const std::exception& ex) {
+            LOG_ERROR("DeadlineQueue", "Deadline callback threw an exception. %s", ex.what());
+        }
+
+        // The callback and what it captured are released before relocking, as releasing them may add callbacks.
+        callback = nullptr;
+        lock.lock();
+    }
+}
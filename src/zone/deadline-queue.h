@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     Runs callbacks at their deadlines on a thread of its own, started by the first callback added.
+    ///     Unlike Timer, it takes no slot per callback, so any number of callbacks can be pending.
+    /// </summary>
+    /// <remarks>
+    ///     This class is thread-safe. Callbacks run without the queue locked, so they may add callbacks,
+    ///     and those still pending when the queue is destroyed are dropped without running.
+    /// </remarks>
+    class DeadlineQueue {
+    public:
+        typedef std::chrono::steady_clock Clock;
+        typedef std::function<void(void)> Callback;
+
+        /// <summary> Constructor. </summary>
+        DeadlineQueue() = default;
+
+        /// <summary> Destructor. It waits for a running callback to return. </summary>
+        ~DeadlineQueue();
+
+        /// <summary> Non-copyable. </summary>
+        DeadlineQueue(const DeadlineQueue&) = delete;
+        DeadlineQueue& operator=(const DeadlineQueue&) = delete;
+
+        /// <summary> Runs a callback once the delay has passed. </summary>
+        void Add(std::chrono::milliseconds delay, Callback callback);
+
+        /// <summary> Number of callbacks that haven't run yet. </summary>
+        size_t GetPendingCount();
+
+    private:
+        struct Entry {
+            Clock::time_point deadline;
+            Callback callback;
+        };
+
+        struct Later {
+            bool operator()(const Entry& first, const Entry& second) const {
+                return first.deadline > second.deadline;
+            }
+        };
+
+        void Run();
+
+        std::mutex _access;
+        std::condition_variable _changed;
+        std::priority_queue<Entry, std::vector<Entry>, Later> _entries;
+        bool _stopped = false;
+        std::thread _thread;
+    };
+}
+}
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "flow-queue.h"
+
+#include <algorithm>
+
+using namespace napa;
+using namespace napa::zone;
+
+FlowQueue::FlowQueue(size_t maxIdleFlows) : _maxIdleFlows(maxIdleFlows) {
+}
+
+void FlowQueue::Push(std::shared_ptr<Task> task, FlowId flow, uint32_t weight) {
+    std::lock_guard<std::mutex> lock(_access);
+
+    auto it = _flows.find(flow);
+    if (it == _flows.end()) {
+        FlowStatistics statistics = {};
+        statistics.flow_id = flow;
+        it = _flows.emplace(flow, Flow { statistics, {}, 0, _idleFlows.end() }).first;
+    }
+
+    auto& entry = it->second;
+    entry.statistics.weight = std::max(weight, 1u);
+    entry.statistics.queued++;
+    if (entry.tasks.empty()) {
+        if (entry.idle != _idleFlows.end()) {
+            _idleFlows.erase(entry.idle);
+            entry.idle = _idleFlows.end();
+        }
+        _activeFlows.push_back(&entry);
+    }
+    entry.tasks.push(QueuedTask { std::move(task), Clock::now() });
+}
+
+std::shared_ptr<Task> FlowQueue::Pop() {
+    std::lock_guard<std::mutex> lock(_access);
+
+    if (_activeFlows.empty()) {
+        return nullptr;
+    }
+
+    auto flow = _activeFlows.front();
+    if (flow->deficit == 0) {
+        flow->deficit = flow->statistics.weight;
+    }
+
+    auto queued = std::move(flow->tasks.front());
+    flow->tasks.pop();
+    flow->deficit--;
+
+    auto wait = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - queued.queueTime).count());
+    flow->statistics.queued--;
+    flow->statistics.dispatched++;
+    flow->statistics.total_wait_us += wait;
+    flow->statistics.max_wait_us = std::max(flow->statistics.max_wait_us, wait);
+
+    // A drained flow starts a fresh turn when it queues again, a flow out of turn goes behind the others.
+    if (flow->tasks.empty()) {
+        flow->deficit = 0;
+        _activeFlows.pop_front();
+
+        flow->idle = _idleFlows.insert(_idleFlows.end(), flow->statistics.flow_id);
+        if (_idleFlows.size() > _maxIdleFlows) {
+            _flows.erase(_idleFlows.front());
+            _idleFlows.pop_front();
+        }
+    } else if (flow->deficit == 0) {
+        _activeFlows.pop_front();
+        _activeFlows.push_back(flow);
+    }
+
+    return std::move(queued.task);
+}
+
+bool FlowQueue::IsEmpty() const {
+    std::lock_guard<std::mutex> lock(_access);
+    return _activeFlows.empty();
+}
+
+std::vector<FlowStatistics> FlowQueue::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(_access);
+
+    std::vector<FlowStatistics> statistics;
+    statistics.reserve(_flows.size());
+    for (const auto& flow : _flows) {
+        statistics.push_back(flow.second.statistics);
+    }
+    return statistics;
+}
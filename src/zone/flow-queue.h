@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "task.h"
+
+#include <napa/types.h>
+
+#include <chrono>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Identifies a flow of tasks, such as the calls of one tenant. </summary>
+    using FlowId = uint32_t;
+
+    /// <summary>
+    ///     Tasks waiting for a worker, queued per flow and taken by deficit round-robin: each busy flow in turn
+    ///     hands out as many tasks as its weight, so a flow flooding the queue doesn't delay the others.
+    /// </summary>
+    /// <remarks> This class is thread-safe. </remarks>
+    class FlowQueue {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// <summary> Default number of drained flows whose counters are kept. </summary>
+        static const size_t DEFAULT_MAX_IDLE_FLOWS = 1024;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="maxIdleFlows"> Number of drained flows whose counters are kept, least recently drained
+        /// ones are dropped beyond it, so arbitrary flow ids don't grow the queue without bound. </param>
+        explicit FlowQueue(size_t maxIdleFlows = DEFAULT_MAX_IDLE_FLOWS);
+
+        /// <summary> Queues a task at the back of its flow. </summary>
+        /// <param name="task"> The task. </param>
+        /// <param name="flow"> The flow of the task. </param>
+        /// <param name="weight"> The weight of the flow, 0 is taken as 1. </param>
+        void Push(std::shared_ptr<Task> task, FlowId flow, uint32_t weight);
+
+        /// <summary> Takes the next task by deficit round-robin across flows. </summary>
+        /// <returns> The task, or nullptr if no task is queued. </returns>
+        std::shared_ptr<Task> Pop();
+
+        /// <summary> Returns true if no task is queued. </summary>
+        bool IsEmpty() const;
+
+        /// <summary> Gets counters of flows with queued tasks and of the most recently drained ones, ordered by flow id. </summary>
+        std::vector<FlowStatistics> GetStatistics() const;
+
+    private:
+        struct QueuedTask {
+            std::shared_ptr<Task> task;
+            Clock::time_point queueTime;
+        };
+
+        struct Flow {
+            FlowStatistics statistics;
+            std::queue<QueuedTask> tasks;
+
+            /// <summary> Tasks the flow may still hand out in its current turn. </summary>
+            uint32_t deficit;
+
+            /// <summary> Position in _idleFlows while the flow has no queued task. </summary>
+            std::list<FlowId>::iterator idle;
+        };
+
+        /// <summary> Flows are kept after their tasks drain, so their counters survive, up to _maxIdleFlows of them. </summary>
+        std::map<FlowId, Flow> _flows;
+
+        /// <summary> Drained flows from least to most recently drained. </summary>
+        std::list<FlowId> _idleFlows;
+        size_t _maxIdleFlows;
+
+        /// <summary> Flows with queued tasks, the front one taking its turn. </summary>
+        std::deque<Flow*> _activeFlows;
+
+        mutable std::mutex _access;
+    };
+}
+}
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "forwarded-call.h"
+
+#include <store/store.h>
+
+#include <cstring>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Module name and store of anonymous functions, see lib/transport/function-transporter.ts. </summary>
+    const std::string ANONYMOUS_FUNCTION_MODULE = "__function";
+    const char* const FUNCTION_STORE_ID = "__napajs_marshalled_functions";
+
+    FunctionSpec ToFunctionSpec(const ProcessRequest& request) {
+        FunctionSpec spec;
+        spec.module = STD_STRING_TO_NAPA_STRING_REF(request.module);
+        spec.function = STD_STRING_TO_NAPA_STRING_REF(request.function);
+        spec.arguments.reserve(request.arguments.size());
+        for (const auto& argument : request.arguments) {
+            spec.arguments.emplace_back(STD_STRING_TO_NAPA_STRING_REF(argument));
+        }
+        spec.options.timeout = request.timeout;
+        spec.options.hedge_after_ms = request.hedgeAfterMs;
+        spec.options.cache_ttl_ms = request.cacheTtlMs;
+        spec.options.single_flight = request.singleFlight;
+        spec.options.flow_id = request.flowId;
+        spec.options.flow_weight = request.flowWeight;
+        spec.options.accounting = request.accounting;
+        spec.transportContext = std::make_unique<transport::TransportContext>();
+        return spec;
+    }
+
+    /// <summary> Saves the definition of an anonymous function sent with a request into the function store of this process. </summary>
+    void SaveFunctionDefinition(const ProcessRequest& request) {
+        if (request.functionDefinition.empty()) {
+            return;
+        }
+
+        auto store = store::GetOrCreateStore(FUNCTION_STORE_ID);
+        if (store->Get(request.function.c_str()) != nullptr) {
+            return;
+        }
+
+        std::u16string utf16(request.functionDefinition.size() / sizeof(char16_t), u'\0');
+        std::memcpy(&utf16[0], request.functionDefinition.data(), utf16.size() * sizeof(char16_t));
+
+        auto definition = std::make_shared<store::Store::ValueType>();
+        definition->payload = std::move(utf16);
+        store->Set(request.function.c_str(), std::move(definition));
+    }
+
+} // namespace
+
+Result napa::zone::MakeResult(ResultCode code, std::string errorMessage) {
+    Result result;
+    result.code = code;
+    result.errorMessage = std::move(errorMessage);
+    result.transportContext = std::make_unique<transport::TransportContext>();
+    return result;
+}
+
+bool napa::zone::HasSharedObjects(const std::unique_ptr<transport::TransportContext>& transportContext) {
+    return transportContext != nullptr && transportContext->GetSharedCount() > 0;
+}
+
+ProcessRequest napa::zone::ToProcessRequest(ProcessRequest::Type type, uint64_t callId, const FunctionSpec& spec) {
+    ProcessRequest request;
+    request.type = type;
+    request.callId = callId;
+    request.timeout = spec.options.timeout;
+    request.hedgeAfterMs = spec.options.hedge_after_ms;
+    request.cacheTtlMs = spec.options.cache_ttl_ms;
+    request.singleFlight = spec.options.single_flight;
+    request.flowId = spec.options.flow_id;
+    request.flowWeight = spec.options.flow_weight;
+    request.accounting = spec.options.accounting;
+    request.module = NAPA_STRING_REF_TO_STD_STRING(spec.module);
+    request.function = NAPA_STRING_REF_TO_STD_STRING(spec.function);
+    request.arguments.reserve(spec.arguments.size());
+    for (const auto& argument : spec.arguments) {
+        request.arguments.emplace_back(NAPA_STRING_REF_TO_STD_STRING(argument));
+    }
+
+    if (request.module == ANONYMOUS_FUNCTION_MODULE) {
+        auto store = store::GetStore(FUNCTION_STORE_ID);
+        auto definition = store != nullptr ? store->Get(request.function.c_str()) : nullptr;
+        if (definition != nullptr) {
+            auto utf16 = definition->payload.ToUtf16();
+            request.functionDefinition.assign(reinterpret_cast<const char*>(utf16.data()), utf16.size() * sizeof(char16_t));
+        }
+    }
+    return request;
+}
+
+void PendingCalls::Add(uint64_t callId, ExecuteCallback callback) {
+    std::lock_guard<std::mutex> lock(_access);
+    _calls.emplace(callId, std::move(callback));
+    _count = _calls.size();
+}
+
+ExecuteCallback PendingCalls::Take(uint64_t callId) {
+    std::lock_guard<std::mutex> lock(_access);
+    auto iter = _calls.find(callId);
+    if (iter == _calls.end()) {
+        return nullptr;
+    }
+    auto callback = std::move(iter->second);
+    _calls.erase(iter);
+    _count = _calls.size();
+    return callback;
+}
+
+bool PendingCalls::Resolve(const std::string& message) {
+    ProcessResponse response;
+    if (!ProcessResponse::Parse(message, response)) {
+        return false;
+    }
+
+    // Responses of calls that failed already, or of replayed broadcasts, match no callback.
+    auto callback = Take(response.callId);
+    if (callback) {
+        auto result = MakeResult(response.code, std::move(response.errorMessage));
+        result.returnValue = std::move(response.returnValue);
+        result.accounting = std::move(response.accounting);
+        callback(std::move(result));
+    }
+    return true;
+}
+
+void PendingCalls::FailAll(ResultCode code, const std::string& errorMessage) {
+    std::unordered_map<uint64_t, ExecuteCallback> calls;
+    {
+        std::lock_guard<std::mutex> lock(_access);
+        calls.swap(_calls);
+        _count = 0;
+    }
+
+    for (auto& call : calls) {
+        call.second(MakeResult(code, errorMessage));
+    }
+}
+
+size_t PendingCalls::GetCount() const {
+    return _count;
+}
+
+bool napa::zone::DispatchRequest(
+    Zone& zone,
+    const std::string& message,
+    size_t maxResponseSize,
+    std::function<void(std::string)> send) {
+
+    // The request owns the strings that the function spec refers to until the call completes.
+    auto request = std::make_shared<ProcessRequest>();
+    if (!ProcessRequest::Parse(message, *request)) {
+        return false;
+    }
+
+    SaveFunctionDefinition(*request);
+
+    auto spec = ToFunctionSpec(*request);
+    auto respond = [request, maxResponseSize, send = std::move(send)](Result result) {
+        ProcessResponse response;
+        response.callId = request->callId;
+        response.code = result.code;
+        response.errorMessage = std::move(result.errorMessage);
+        response.returnValue = std::move(result.returnValue);
+        response.accounting = std::move(result.accounting);
+
+        if (response.code == NAPA_RESULT_SUCCESS && HasSharedObjects(result.transportContext)) {
+            response.code = NAPA_RESULT_EXECUTE_FUNC_ERROR;
+            response.errorMessage = "Results of a call from another process must not refer to shared objects";
+            response.returnValue.clear();
+        }
+
+        auto responseMessage = response.Serialize();
+        if (responseMessage.size() > maxResponseSize) {
+            response.code = NAPA_RESULT_EXECUTE_FUNC_ERROR;
+            response.errorMessage = "Result of " + std::to_string(responseMessage.size()) + " bytes is too large to send to another process";
+            response.returnValue.clear();
+            responseMessage = response.Serialize();
+        }
+
+        send(std::move(responseMessage));
+    };
+
+    if (request->type == ProcessRequest::Type::Broadcast) {
+        zone.Broadcast(spec, std::move(respond));
+    } else {
+        zone.Execute(spec, std::move(respond));
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "zone.h"
+
+#include <zone/process-message.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Makes a result without return value, with an empty transport context as zones produce. </summary>
+    Result MakeResult(ResultCode code, std::string errorMessage);
+
+    /// <summary> Returns true if a transport context holds objects, which only live in the current process. </summary>
+    bool HasSharedObjects(const std::unique_ptr<transport::TransportContext>& transportContext);
+
+    /// <summary> Makes a request to forward a call to a zone in another process. </summary>
+    /// <remarks> Anonymous functions are saved in a store of this process, so their definitions travel with the request. </remarks>
+    ProcessRequest ToProcessRequest(ProcessRequest::Type type, uint64_t callId, const FunctionSpec& spec);
+
+    /// <summary> Callbacks of calls forwarded to another process, until their responses come back. </summary>
+    class PendingCalls {
+    public:
+
+        /// <summary> Adds the callback of a call. </summary>
+        void Add(uint64_t callId, ExecuteCallback callback);
+
+        /// <summary> Takes the callback of a call out, so whoever gets it calls it exactly once. </summary>
+        /// <returns> The callback, or nullptr if it was taken already. </returns>
+        ExecuteCallback Take(uint64_t callId);
+
+        /// <summary> Calls back the call of a serialized response. </summary>
+        /// <returns> False if the response is malformed. </returns>
+        bool Resolve(const std::string& message);
+
+        /// <summary> Calls back all calls with a failure. </summary>
+        void FailAll(ResultCode code, const std::string& errorMessage);
+
+        /// <summary> Number of calls in flight, without taking the lock. </summary>
+        size_t GetCount() const;
+
+    private:
+        std::mutex _access;
+        std::unordered_map<uint64_t, ExecuteCallback> _calls;
+        std::atomic<size_t> _count { 0 };
+    };
+
+    /// <summary> Runs a forwarded request on a zone of this process. </summary>
+    /// <param name="zone"> The zone to run the call in. </param>
+    /// <param name="message"> Serialized request. </param>
+    /// <param name="maxResponseSize"> Largest serialized response the transport can take, larger results become errors. </param>
+    /// <param name="send"> Called with the serialized response once the call completes, from a worker of the zone. </param>
+    /// <returns> False if the request is malformed, in which case 'send' is not called. </returns>
+    bool DispatchRequest(
+        Zone& zone,
+        const std::string& message,
+        size_t maxResponseSize,
+        std::function<void(std::string)> send);
+}
+}
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "framed-connection.h"
+
+#include <platform/local-socket.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Bytes read from the socket at a time. </summary>
+    const size_t READ_CHUNK_SIZE = 64 * 1024;
+
+} // namespace
+
+struct FramedConnection::State {
+    std::unique_ptr<platform::LocalSocket> socket;
+    MessageCallback onMessage;
+    CloseCallback onClose;
+
+    std::mutex access;
+    std::condition_variable hasMessages;
+    std::vector<std::string> outbound;
+    std::atomic<bool> closed { false };
+
+    /// <summary> Marks the connection closed and wakes up both threads. </summary>
+    /// <returns> True if this call closed it. </returns>
+    bool Close() {
+        {
+            std::lock_guard<std::mutex> lock(access);
+            if (closed.exchange(true)) {
+                return false;
+            }
+        }
+        hasMessages.notify_one();
+        socket->Shutdown();
+        return true;
+    }
+
+    void WriteMessages() {
+        std::vector<std::string> batch;
+        std::string buffer;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(access);
+                hasMessages.wait(lock, [this]() { return closed || !outbound.empty(); });
+                if (closed) {
+                    return;
+                }
+                batch.swap(outbound);
+            }
+
+            // Frame everything queued since the last write into one buffer.
+            buffer.clear();
+            for (const auto& message : batch) {
+                auto length = static_cast<uint32_t>(message.size());
+                buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                buffer.append(message);
+            }
+            batch.clear();
+
+            if (!socket->Write(buffer.data(), buffer.size())) {
+                // The reader sees the connection end and reports the close.
+                socket->Shutdown();
+                return;
+            }
+        }
+    }
+
+    void ReadMessages() {
+        std::string buffer;
+        size_t offset = 0;
+        bool valid = true;
+        while (valid) {
+            // Make room for the next chunk at the end of the buffer.
+            auto size = buffer.size();
+            buffer.resize(size + READ_CHUNK_SIZE);
+            auto read = socket->Read(&buffer[size], READ_CHUNK_SIZE);
+            buffer.resize(size + read);
+            if (read == 0) {
+                break;
+            }
+
+            while (buffer.size() - offset >= sizeof(uint32_t)) {
+                uint32_t length;
+                std::memcpy(&length, buffer.data() + offset, sizeof(length));
+                if (length > MAX_MESSAGE_SIZE) {
+                    valid = false;
+                    break;
+                }
+                if (buffer.size() - offset - sizeof(length) < length) {
+                    break;
+                }
+
+                if (!closed) {
+                    onMessage(buffer.substr(offset + sizeof(length), length));
+                }
+                offset += sizeof(length) + length;
+            }
+
+            buffer.erase(0, offset);
+            offset = 0;
+        }
+
+        if (Close()) {
+            onClose();
+        }
+    }
+};
+
+FramedConnection::FramedConnection(
+    std::unique_ptr<platform::LocalSocket> socket,
+    MessageCallback onMessage,
+    CloseCallback onClose) : _state(std::make_shared<State>()) {
+
+    _state->socket = std::move(socket);
+    _state->onMessage = std::move(onMessage);
+    _state->onClose = std::move(onClose);
+}
+
+void FramedConnection::Start() {
+    // Threads share the state, so they can outlive this object when it's destroyed from one of them.
+    auto state = _state;
+    _reader = std::thread([state]() { state->ReadMessages(); });
+    _writer = std::thread([state]() { state->WriteMessages(); });
+}
+
+FramedConnection::~FramedConnection() {
+    Close();
+
+    for (auto thread : { &_reader, &_writer }) {
+        if (!thread->joinable()) {
+            continue;
+        }
+        if (thread->get_id() == std::this_thread::get_id()) {
+            thread->detach();
+        } else {
+            thread->join();
+        }
+    }
+}
+
+bool FramedConnection::Send(std::string message) {
+    {
+        std::lock_guard<std::mutex> lock(_state->access);
+        if (_state->closed) {
+            return false;
+        }
+        _state->outbound.push_back(std::move(message));
+    }
+    _state->hasMessages.notify_one();
+    return true;
+}
+
+void FramedConnection::Close() {
+    _state->Close();
+}
+
+bool FramedConnection::IsClosed() const {
+    return _state->closed;
+}
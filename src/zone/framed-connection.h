@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace napa {
+namespace platform {
+    class LocalSocket;
+}
+
+namespace zone {
+
+    /// <summary>
+    /// Sends and receives length-prefixed messages over a socket, with a thread to read and a thread to write.
+    /// Messages sent while the writer is busy are written together in one system call.
+    /// </summary>
+    class FramedConnection {
+    public:
+        using MessageCallback = std::function<void(std::string message)>;
+        using CloseCallback = std::function<void()>;
+
+        /// <summary> Largest message accepted from the other end, which closes the connection if exceeded. </summary>
+        static const size_t MAX_MESSAGE_SIZE = 256 * 1024 * 1024;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="socket"> Connected socket. </param>
+        /// <param name="onMessage"> Called on the reader thread with each message in order. </param>
+        /// <param name="onClose"> Called on the reader thread if the other end or an error closed the connection. </param>
+        FramedConnection(std::unique_ptr<platform::LocalSocket> socket, MessageCallback onMessage, CloseCallback onClose);
+
+        /// <summary> Closes the connection and waits for its threads, unless called from one of them. </summary>
+        ~FramedConnection();
+
+        /// <summary> Non-copyable. </summary>
+        FramedConnection(const FramedConnection&) = delete;
+        FramedConnection& operator=(const FramedConnection&) = delete;
+
+        /// <summary> Starts reading and writing messages. </summary>
+        void Start();
+
+        /// <summary> Queues a message to send. </summary>
+        /// <returns> False if the connection is closed. </returns>
+        bool Send(std::string message);
+
+        /// <summary> Closes the connection, dropping messages not sent yet. </summary>
+        void Close();
+
+        /// <summary> Returns true if the connection is closed. </summary>
+        bool IsClosed() const;
+
+        /// <summary> State shared with the threads, defined in the implementation. </summary>
+        struct State;
+
+    private:
+        std::shared_ptr<State> _state;
+        std::thread _reader;
+        std::thread _writer;
+    };
+}
+}
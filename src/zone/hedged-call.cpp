@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "hedged-call.h"
+
+#include <zone/call-task.h>
+#include <zone/object-pool.h>
+#include <zone/task-decorators.h>
+#include <zone/worker-context.h>
+
+#include <napa/log.h>
+
+#include <limits>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Marks that no worker picked up the scheduled run yet. </summary>
+    const WorkerId NO_WORKER = std::numeric_limits<WorkerId>::max();
+
+    WorkerId GetCurrentWorkerId() {
+        return static_cast<WorkerId>(reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+    }
+
+} // namespace
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Runs the scheduled call, recording which worker runs it. </summary>
+    class PrimaryTask : public Task {
+    public:
+        PrimaryTask(std::shared_ptr<HedgedCall> call, std::shared_ptr<Task> callTask) :
+            _call(std::move(call)), _callTask(std::move(callTask)) {}
+
+        void Execute() override {
+            // The duplicate ran first while the scheduled run was queued.
+            if (_call->IsFinished()) {
+                return;
+            }
+
+            _call->_primaryWorker = GetCurrentWorkerId();
+            _callTask->Execute();
+        }
+
+    private:
+        std::shared_ptr<HedgedCall> _call;
+        std::shared_ptr<Task> _callTask;
+    };
+
+    /// <summary> Runs a duplicate of a call that was still pending after its hedge delay. </summary>
+    /// <remarks> It doesn't own the call, which is gone if the scheduled run finished and released it. </remarks>
+    class HedgeTask : public Task {
+    public:
+        explicit HedgeTask(std::weak_ptr<HedgedCall> call) : _call(std::move(call)) {}
+
+        void Execute() override {
+            auto call = _call.lock();
+            if (call == nullptr || call->IsFinished()) {
+                return;
+            }
+
+            // The worker of the scheduled run is free, so it's not stalled and a duplicate on it wouldn't help.
+            auto workerId = GetCurrentWorkerId();
+            if (workerId == call->_primaryWorker) {
+                return;
+            }
+
+            NAPA_DEBUG("Zone", "Hedging call to \"%s.%s\" on worker %u.",
+                call->_arguments->GetModule().c_str(), call->_arguments->GetFunction().c_str(), workerId);
+            call->CreateCallTask(std::make_unique<transport::TransportContext>())->Execute();
+        }
+
+    private:
+        std::weak_ptr<HedgedCall> _call;
+    };
+}
+}
+
+HedgedCall::HedgedCall(const FunctionSpec& spec, ExecuteCallback callback) :
+    _arguments(MakePooled<CallArguments>(spec)),
+    _options(spec.options),
+    _callback(std::move(callback)),
+    _finished(false),
+    _primaryWorker(NO_WORKER),
+    _hedgeAfter(spec.options.hedge_after_ms) {
+}
+
+void HedgedCall::Start(
+    std::shared_ptr<Scheduler> scheduler,
+    DeadlineQueue& hedges,
+    std::unique_ptr<transport::TransportContext> transportContext) {
+    _scheduler = scheduler;
+
+    auto task = std::make_shared<PrimaryTask>(shared_from_this(), CreateCallTask(std::move(transportContext)));
+    scheduler->Schedule(std::move(task), _options.flow_id, _options.flow_weight);
+
+    // The delay runs on the zone's deadline queue thread, so no worker is held up by it. The deadline doesn't
+    // own the call, which is released as soon as it finishes.
+    std::weak_ptr<HedgedCall> call = shared_from_this();
+    hedges.Add(_hedgeAfter, [call]() {
+        if (auto pending = call.lock()) {
+            pending->Hedge();
+        }
+    });
+}
+
+bool HedgedCall::IsFinished() const {
+    return _finished;
+}
+
+std::shared_ptr<Task> HedgedCall::CreateCallTask(std::unique_ptr<transport::TransportContext> transportContext) {
+    auto self = shared_from_this();
+    auto context = MakePooled<CallContext>(_arguments, _options, std::move(transportContext), [self](Result result) {
+        self->Finish(std::move(result));
+    });
+
+    if (_options.timeout > 0) {
+        return MakePooled<TimeoutTaskDecorator<CallTask>>(std::chrono::milliseconds(_options.timeout), std::move(context));
+    }
+    return MakePooled<CallTask>(std::move(context));
+}
+
+void HedgedCall::Hedge() {
+    // The zone may be gone along with its scheduler while the call was pending.
+    auto scheduler = _scheduler.lock();
+    if (scheduler == nullptr || IsFinished()) {
+        return;
+    }
+
+    // The scheduler hands the duplicate to an idle worker, or queues it for the first worker to become idle.
+    scheduler->Schedule(std::make_shared<HedgeTask>(shared_from_this()), _options.flow_id, _options.flow_weight);
+}
+
+void HedgedCall::Finish(Result result) {
+    auto expected = false;
+    if (!_finished.compare_exchange_strong(expected, true)) {
+        NAPA_DEBUG("Zone", "Discarded the later result of hedged call to \"%s.%s\".",
+            _arguments->GetModule().c_str(), _arguments->GetFunction().c_str());
+        return;
+    }
+    _callback(std::move(result));
+}
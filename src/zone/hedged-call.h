@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "call-context.h"
+#include "deadline-queue.h"
+#include "scheduler.h"
+#include "task.h"
+#include "worker.h"
+
+#include <napa/types.h>
+
+#include <atomic>
+#include <memory>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     An execute call that may run twice: once as scheduled, and once more on another worker if it's still
+    ///     pending after 'hedgeAfterMs'. Each run has its own call context, and the first to finish completes the call.
+    /// </summary>
+    /// <remarks>
+    ///     Only idempotent functions should be hedged. A duplicate gets an empty transport context, so calls with
+    ///     shared objects in their arguments are not hedged.
+    /// </remarks>
+    class HedgedCall : public std::enable_shared_from_this<HedgedCall> {
+    public:
+        /// <summary> Constructor. </summary>
+        /// <param name="spec"> The function spec. </param>
+        /// <param name="callback"> Callback called once with the first result. </param>
+        HedgedCall(const napa::FunctionSpec& spec, napa::ExecuteCallback callback);
+
+        /// <summary> Schedules the call, and queues the deadline that schedules a duplicate once the hedge delay passed. </summary>
+        /// <param name="scheduler"> The scheduler of the zone. A duplicate isn't scheduled once it's gone. </param>
+        /// <param name="hedges"> The zone's queue of hedge deadlines. </param>
+        /// <param name="transportContext"> The transport context of the spec, taken by the scheduled run. </param>
+        void Start(
+            std::shared_ptr<Scheduler> scheduler,
+            DeadlineQueue& hedges,
+            std::unique_ptr<napa::transport::TransportContext> transportContext);
+
+        /// <summary> Returns true if either run finished the call, so a run that didn't start is cancelled. </summary>
+        bool IsFinished() const;
+
+    private:
+        friend class HedgeTask;
+        friend class PrimaryTask;
+
+        /// <summary> Creates a call task for one run. </summary>
+        std::shared_ptr<Task> CreateCallTask(std::unique_ptr<napa::transport::TransportContext> transportContext);
+
+        /// <summary> Schedules the duplicate if the call is still pending. Called on the deadline queue thread. </summary>
+        void Hedge();
+
+        /// <summary> Calls back with the first result, discarding the later one. </summary>
+        void Finish(napa::Result result);
+
+        std::shared_ptr<const CallArguments> _arguments;
+        napa::CallOptions _options;
+        napa::ExecuteCallback _callback;
+        std::atomic<bool> _finished;
+
+        /// <summary> The scheduler the call runs on, not kept alive by a pending hedge. </summary>
+        std::weak_ptr<Scheduler> _scheduler;
+
+        /// <summary> The worker that picked up the scheduled run, which a duplicate must not run on. </summary>
+        std::atomic<WorkerId> _primaryWorker;
+
+        /// <summary> The hedge delay. </summary>
+        std::chrono::milliseconds _hedgeAfter;
+    };
+}
+}
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Hints the CPU that the calling thread is in a spin wait loop. </summary>
+    inline void CpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+        __yield();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    /// <summary>
+    /// Decides how long an idle worker spins before parking on its task event.
+    /// Parking costs a futex wait and wake on each task arrival, which dominates latency when tasks arrive
+    /// in quick succession, while spinning burns a core for nothing when they arrive sparsely.
+    /// The strategy keeps a moving average of recent idle periods and spins only when the next task is
+    /// expected within the max spin: first with a CPU pause for half of the budget, then yielding the rest.
+    /// </summary>
+    /// <remarks> Not thread safe. Each worker owns one instance and uses it from its own thread only. </remarks>
+    class IdleStrategy {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="maxSpin"> Max time to spin, 0 to always park right away. </param>
+        explicit IdleStrategy(std::chrono::microseconds maxSpin)
+            : _maxSpin(maxSpin),
+              _averageIdle(std::chrono::duration_cast<std::chrono::nanoseconds>(maxSpin) / 2) {
+        }
+
+        /// <summary> Returns true if the worker may spin at all. </summary>
+        bool IsEnabled() const {
+            return _maxSpin.count() > 0;
+        }
+
+        /// <summary> Gets how long the next idle period should spin before parking. </summary>
+        std::chrono::nanoseconds GetSpinBudget() const {
+            if (_averageIdle >= _maxSpin) {
+                // Tasks come slower than we are willing to spin for.
+                return std::chrono::nanoseconds(0);
+            }
+
+            // Leave headroom over the average, as gaps vary around it.
+            return std::min<std::chrono::nanoseconds>(_averageIdle * 2, _maxSpin);
+        }
+
+        /// <summary> Spins until 'ready' returns true or the spin budget runs out. </summary>
+        /// <returns> True if 'ready' returned true, false if the caller should park. </returns>
+        template <typename Predicate>
+        bool Spin(Predicate ready) const {
+            auto budget = GetSpinBudget();
+            if (budget.count() == 0) {
+                return ready();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            auto pauseUntil = start + budget / 2;
+            auto yieldUntil = start + budget;
+
+            while (!ready()) {
+                auto now = std::chrono::steady_clock::now();
+                if (now >= yieldUntil) {
+                    return false;
+                }
+
+                if (now < pauseUntil) {
+                    for (uint32_t i = 0; i < PAUSES_PER_CHECK; ++i) {
+                        CpuRelax();
+                    }
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            return true;
+        }
+
+        /// <summary> Records how long the worker stayed idle before the last task came, either spinning or parked. </summary>
+        void RecordIdle(std::chrono::nanoseconds idle) {
+            // Inverse weight of a new sample in the moving average.
+            const int64_t averageWeight = 8;
+
+            // Samples are capped to this many times the max spin.
+            const int64_t idleSampleCap = 4;
+
+            // Cap samples so one long quiet period doesn't keep spinning disabled long after traffic resumes.
+            auto capped = std::min<std::chrono::nanoseconds>(idle, _maxSpin * idleSampleCap);
+            _averageIdle += (capped - _averageIdle) / averageWeight;
+        }
+
+    private:
+
+        /// <summary> Number of CPU pauses between checks of the clock and the predicate. </summary>
+        static constexpr uint32_t PAUSES_PER_CHECK = 16;
+
+        /// <summary> Max time to spin. </summary>
+        std::chrono::nanoseconds _maxSpin;
+
+        /// <summary> Moving average of idle periods. </summary>
+        std::chrono::nanoseconds _averageIdle;
+    };
+}
+}
@@ -8,8 +8,13 @@
 #include <platform/filesystem.h>
 #include <utils/string.h>
 #include <zone/eval-task.h>
+#include <zone/forwarded-call.h>
 #include <zone/call-task.h>
 #include <zone/call-context.h>
+#include <zone/hedged-call.h>
+#include <zone/object-pool.h>
+#include <zone/result-cache.h>
+#include <zone/single-flight.h>
 #include <zone/task-decorators.h>
 #include <zone/worker-context.h>
 
@@ -37,13 +42,25 @@ std::shared_ptr<NapaZone> NapaZone::Create(const settings::ZoneSettings& setting
         return nullptr;
     }
 
+    // Open the module bundle upfront, so a bad bundle fails zone creation instead of worker setup.
+    std::shared_ptr<const module::ModuleBundle> bundle;
+    if (!settings.bundle.empty()) {
+        try {
+            bundle = module::ModuleBundle::Open(settings.bundle);
+        } catch (const std::exception& ex) {
+            LOG_ERROR("Zone", "Failed to create zone '%s': %s", settings.id.c_str(), ex.what());
+            return nullptr;
+        }
+    }
+
     // An helper class to enable make_shared of NapaZone
     struct MakeSharedEnabler : public NapaZone {
-        MakeSharedEnabler(const settings::ZoneSettings& settings) : NapaZone(settings) {}
+        MakeSharedEnabler(const settings::ZoneSettings& settings, std::shared_ptr<const module::ModuleBundle> bundle) :
+            NapaZone(settings, std::move(bundle)) {}
     };
 
     // Fail to create Napa zone is not expected, will always trigger crash.
-    auto zone = std::make_shared<MakeSharedEnabler>(settings);
+    auto zone = std::make_shared<MakeSharedEnabler>(settings, std::move(bundle));
     _zones[settings.id] = zone;
 
     NAPA_DEBUG("Zone", "Napa zone \"%s\" created.", settings.id.c_str());
@@ -72,8 +89,9 @@ std::shared_ptr<NapaZone> NapaZone::Get(const std::string& id) {
     return zone;
 }
 
-NapaZone::NapaZone(const settings::ZoneSettings& settings) : 
-    _settings(settings) {
+NapaZone::NapaZone(const settings::ZoneSettings& settings, std::shared_ptr<const module::ModuleBundle> bundle) : 
+    _settings(settings), _bundle(std::move(bundle)), _resultCache(std::make_shared<ResultCache>(settings.resultCacheBytes)),
+    _singleFlight(std::make_shared<SingleFlight>()) {
 
     // Create the zone's scheduler.
     _scheduler = std::make_unique<Scheduler>(_settings, [this](WorkerId id) {
@@ -87,7 +105,7 @@ NapaZone::NapaZone(const settings::ZoneSettings& settings) :
         WorkerContext::Set(WorkerContextItem::WORKER_ID, reinterpret_cast<void*>(static_cast<uintptr_t>(id)));
 
         // Load module loader and built-in modules of require, console and etc.
-        CREATE_MODULE_LOADER();
+        CREATE_MODULE_LOADER(_bundle);
     });
 
     // Bootstrap after zone is created.
@@ -123,15 +141,19 @@ void NapaZone::Broadcast(const FunctionSpec& spec, BroadcastCallback callback) {
         }
     };
 
+    // Arguments are copied once and shared by all workers, so broadcast cost doesn't grow with worker count.
+    auto arguments = std::make_shared<const CallArguments>(spec);
+
     for (WorkerId id = 0; id < _settings.workers; id++) {
         std::shared_ptr<Task> task;
+        auto context = MakePooled<CallContext>(arguments, spec.options, std::move(spec.transportContext), callOnce);
 
         if (spec.options.timeout > 0) {
-            task = std::make_shared<TimeoutTaskDecorator<CallTask>>(
+            task = MakePooled<TimeoutTaskDecorator<CallTask>>(
                 std::chrono::milliseconds(spec.options.timeout),
-                std::make_shared<CallContext>(spec, callOnce));
+                std::move(context));
         } else {
-            task = std::make_shared<CallTask>(std::make_shared<CallContext>(spec, callOnce));
+            task = MakePooled<CallTask>(std::move(context));
         }
 
         _scheduler->ScheduleOnWorker(id, std::move(task));
@@ -141,18 +163,56 @@ void NapaZone::Broadcast(const FunctionSpec& spec, BroadcastCallback callback) {
 }
 
 void NapaZone::Execute(const FunctionSpec& spec, ExecuteCallback callback) {
+    auto hasSharedObjects = HasSharedObjects(spec.transportContext);
+
+    // A cached result is returned right away without scheduling a task.
+    auto cacheable = spec.options.cache_ttl_ms > 0 && _resultCache->IsEnabled() && !hasSharedObjects;
+    if (cacheable) {
+        Result result;
+        if (_resultCache->Get(spec, result)) {
+            NAPA_DEBUG("Zone", "Execute function \"%s.%s\" on zone \"%s\" from result cache", spec.module.data, spec.function.data, _settings.id.c_str());
+            callback(std::move(result));
+            return;
+        }
+    }
+
+    // An identical call in flight completes this call too, otherwise this call completes the ones joining it.
+    if (spec.options.single_flight != 0 && !hasSharedObjects && _singleFlight->Join(spec, callback)) {
+        return;
+    }
+
+    // The result is cached before the flight completes, so calls arriving afterwards hit the cache.
+    if (cacheable) {
+        auto key = std::make_shared<const CallKey>(spec);
+        callback = [cache = _resultCache, key = std::move(key), ttl = spec.options.cache_ttl_ms, callback = std::move(callback)](Result result) {
+            cache->Set(key, result, ttl);
+            callback(std::move(result));
+        };
+    }
+
+    // A hedged call queues a deadline, which schedules a duplicate if the call is still pending when it passes.
+    if (spec.options.hedge_after_ms > 0 && _settings.workers > 1 && !hasSharedObjects) {
+        auto call = std::make_shared<HedgedCall>(spec, std::move(callback));
+        call->Start(_scheduler, _hedges, std::move(spec.transportContext));
+
+        NAPA_DEBUG("Zone", "Execute function \"%s.%s\" on zone \"%s\" with hedging", spec.module.data, spec.function.data, _settings.id.c_str());
+        return;
+    }
+
     std::shared_ptr<Task> task;
 
+    // Call context and task are pooled, as they are allocated and freed on every call.
+    auto context = MakePooled<CallContext>(spec, std::move(callback));
     if (spec.options.timeout > 0) {
-        task = std::make_shared<TimeoutTaskDecorator<CallTask>>(
+        task = MakePooled<TimeoutTaskDecorator<CallTask>>(
             std::chrono::milliseconds(spec.options.timeout),
-            std::make_shared<CallContext>(spec, std::move(callback)));
+            std::move(context));
     } else {
-        task = std::make_shared<CallTask>(std::make_shared<CallContext>(spec, std::move(callback)));
+        task = MakePooled<CallTask>(std::move(context));
     }
     
     NAPA_DEBUG("Zone", "Execute function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
-    _scheduler->Schedule(std::move(task));
+    _scheduler->Schedule(std::move(task), spec.options.flow_id, spec.options.flow_weight);
 }
 
 const settings::ZoneSettings& NapaZone::GetSettings() const {
@@ -162,3 +222,11 @@ const settings::ZoneSettings& NapaZone::GetSettings() const {
 std::shared_ptr<Scheduler> NapaZone::GetScheduler() {
     return _scheduler;
 }
+
+CacheStatistics NapaZone::GetCacheStatistics() const {
+    return _resultCache->GetStatistics();
+}
+
+std::vector<FlowStatistics> NapaZone::GetFlowStatistics() const {
+    return _scheduler->GetFlowStatistics();
+}
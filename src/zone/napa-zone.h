@@ -5,6 +5,10 @@
 
 #include "zone.h"
 
+#include "module/loader/module-bundle.h"
+#include "zone/deadline-queue.h"
+#include "zone/result-cache.h"
+#include "zone/single-flight.h"
 #include "zone/scheduler.h"
 #include "settings/settings.h"
 
@@ -42,12 +46,28 @@ namespace zone {
         /// <remark> Asynchronous works keep the reference on scheduler, so they can finish up safely. </remarks>
         std::shared_ptr<zone::Scheduler> GetScheduler();
 
+        /// <summary> Retrieves counters of the result cache. </summary>
+        CacheStatistics GetCacheStatistics() const;
+
+        /// <summary> Retrieves counters of the scheduler's flows. </summary>
+        std::vector<FlowStatistics> GetFlowStatistics() const;
+
     private:
-        explicit NapaZone(const settings::ZoneSettings& settings);
+        NapaZone(const settings::ZoneSettings& settings, std::shared_ptr<const module::ModuleBundle> bundle);
 
         settings::ZoneSettings _settings;
+        std::shared_ptr<const module::ModuleBundle> _bundle;
         std::shared_ptr<zone::Scheduler> _scheduler;
 
+        /// <summary> Shared with callbacks of pending calls, which cache their results. </summary>
+        std::shared_ptr<ResultCache> _resultCache;
+
+        /// <summary> Identical calls in flight, shared with their callbacks. </summary>
+        std::shared_ptr<SingleFlight> _singleFlight;
+
+        /// <summary> Deadlines of hedged calls. Destroyed first, so no hedge is scheduled while the zone goes away. </summary>
+        DeadlineQueue _hedges;
+
         static std::mutex _mutex;
         static std::unordered_map<std::string, std::weak_ptr<NapaZone>> _zones;
     };
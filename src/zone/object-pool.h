@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Counters of all block pools. </summary>
+    struct BlockPoolStatistics {
+        /// <summary> Number of blocks allocated from the heap. </summary>
+        std::atomic<size_t> heapAllocations { 0 };
+    };
+
+    /// <summary> Get counters of all block pools in the process. </summary>
+    inline BlockPoolStatistics& GetBlockPoolStatistics() {
+        static BlockPoolStatistics statistics;
+        return statistics;
+    }
+
+    /// <summary>
+    ///     A process wide pool of fixed size blocks, which are reused instead of returned to the heap.
+    ///     Each thread allocates from and frees to its own free list without locking. Blocks move between threads
+    ///     through a shared list in batches, e.g. call contexts created on the caller's thread and released on a worker.
+    /// </summary>
+    template <size_t BlockSize, size_t Alignment>
+    class BlockPool {
+    public:
+        static_assert(Alignment <= alignof(std::max_align_t), "Over-aligned blocks are not supported");
+
+        /// <summary> Max number of free blocks kept in the shared list. Blocks freed beyond it go back to the heap. </summary>
+        static constexpr size_t MAX_FREE_BLOCKS = 4096;
+
+        /// <summary> Max number of free blocks a thread keeps before handing a batch to the shared list. </summary>
+        static constexpr size_t MAX_THREAD_BLOCKS = 64;
+
+        /// <summary> Number of blocks moved between a thread and the shared list at once. </summary>
+        static constexpr size_t BATCH_BLOCKS = 32;
+
+        /// <summary> Get the pool of this block size. It's never destroyed, as blocks may be freed during static destruction. </summary>
+        static BlockPool& Instance() {
+            static auto pool = new BlockPool();
+            return *pool;
+        }
+
+        void* Allocate() {
+            FreeList single;
+            auto local = ThreadList();
+            if (local == nullptr) {
+                // The thread is exiting, take a block from the shared list directly.
+                Refill(single, 1);
+                local = &single;
+            }
+            else if (local->head == nullptr) {
+                Refill(*local, BATCH_BLOCKS);
+            }
+
+            if (local->head != nullptr) {
+                return local->Pop();
+            }
+            GetBlockPoolStatistics().heapAllocations.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(BLOCK_SIZE);
+        }
+
+        void Deallocate(void* pointer) {
+            auto block = static_cast<FreeBlock*>(pointer);
+            auto local = ThreadList();
+            if (local == nullptr) {
+                // The thread is exiting, give the block to the shared list directly.
+                FreeList single;
+                single.Push(block);
+                Flush(single, 1);
+                return;
+            }
+
+            local->Push(block);
+            if (local->count > MAX_THREAD_BLOCKS) {
+                Flush(*local, BATCH_BLOCKS);
+            }
+        }
+
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct FreeList {
+            FreeBlock* head = nullptr;
+            size_t count = 0;
+
+            void Push(FreeBlock* block) {
+                block->next = head;
+                head = block;
+                ++count;
+            }
+
+            FreeBlock* Pop() {
+                auto block = head;
+                head = block->next;
+                --count;
+                return block;
+            }
+        };
+
+        /// <summary> Free list of a thread, handed to the shared list when the thread exits. </summary>
+        struct ThreadFreeList : FreeList {
+            explicit ThreadFreeList(bool& exited) : exited(exited) {}
+
+            ~ThreadFreeList() {
+                Instance().Flush(*this, this->count);
+                exited = true;
+            }
+
+            bool& exited;
+        };
+
+        static constexpr size_t BLOCK_SIZE = BlockSize > sizeof(FreeBlock) ? BlockSize : sizeof(FreeBlock);
+
+        BlockPool() = default;
+
+        /// <summary> Get the free list of the calling thread, or nullptr once it's destroyed at thread exit. </summary>
+        static FreeList* ThreadList() {
+            // The flag has no destructor, so it can still be read while other thread local or static objects
+            // are destroyed after the list, and free their blocks.
+            static thread_local bool exited = false;
+            static thread_local ThreadFreeList list(exited);
+            return exited ? nullptr : &list;
+        }
+
+        /// <summary> Move up to count blocks from the shared list to a thread list. </summary>
+        void Refill(FreeList& local, size_t count) {
+            std::lock_guard<std::mutex> lock(_lock);
+            for (size_t i = 0; i < count && _shared.head != nullptr; ++i) {
+                local.Push(_shared.Pop());
+            }
+        }
+
+        /// <summary> Move blocks from a thread list to the shared list, freeing those that don't fit. </summary>
+        void Flush(FreeList& local, size_t count) {
+            FreeList overflow;
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                for (size_t i = 0; i < count && local.head != nullptr; ++i) {
+                    auto block = local.Pop();
+                    if (_shared.count < MAX_FREE_BLOCKS) {
+                        _shared.Push(block);
+                    } else {
+                        overflow.Push(block);
+                    }
+                }
+            }
+            while (overflow.head != nullptr) {
+                ::operator delete(overflow.Pop());
+            }
+        }
+
+        std::mutex _lock;
+        FreeList _shared;
+    };
+
+    /// <summary> Standard allocator that allocates single objects from the BlockPool of their size. </summary>
+    template <typename T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+
+        using Pool = BlockPool<sizeof(T), alignof(T)>;
+
+        PoolAllocator() = default;
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>&) {}
+
+        T* allocate(size_t count) {
+            if (count == 1) {
+                return static_cast<T*>(Pool::Instance().Allocate());
+            }
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+
+        void deallocate(T* pointer, size_t count) {
+            if (count == 1) {
+                Pool::Instance().Deallocate(pointer);
+            } else {
+                ::operator delete(pointer);
+            }
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U>&) const {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const PoolAllocator<U>&) const {
+            return false;
+        }
+    };
+
+    /// <summary> Like std::make_shared, with the object and its reference count allocated from a BlockPool. </summary>
+    template <typename T, typename... Args>
+    std::shared_ptr<T> MakePooled(Args&&... args) {
+        return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+    }
+}
+}
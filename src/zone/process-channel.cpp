@@ -0,0 +1,355 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "process-channel.h"
+
+#include <platform/platform.h>
+#include <platform/process.h>
+#include <platform/shared-memory.h>
+
+#include <napa/assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef SUPPORT_POSIX
+#include <cerrno>
+#include <pthread.h>
+#include <time.h>
+#endif
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    const uint32_t CHANNEL_MAGIC = 0x4e415043; // "NAPC"
+    const uint32_t CHANNEL_LAYOUT_VERSION = 1;
+
+    const size_t MAX_ZONE_ID_LENGTH = 256;
+    const size_t MAX_SETTINGS_LENGTH = 4096;
+    const size_t MIN_RING_CAPACITY = 4096;
+
+    /// <summary> Records are aligned, so there is always room for a length word before the end of a ring. </summary>
+    const size_t RECORD_ALIGNMENT = 8;
+
+    /// <summary> Length word of a record that tells the reader to continue from the start of the ring. </summary>
+    const uint32_t WRAP_MARKER = 0xFFFFFFFF;
+
+    const size_t CACHE_LINE_SIZE = 64;
+
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    size_t RoundUpToPowerOf2(size_t value) {
+        size_t result = MIN_RING_CAPACITY;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    size_t GetRecordSize(size_t messageSize) {
+        return AlignUp(sizeof(uint32_t) + messageSize, RECORD_ALIGNMENT);
+    }
+
+} // namespace
+
+struct ProcessChannel::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    int32_t creatorProcessId;
+    std::atomic<uint32_t> ready;
+    std::atomic<uint32_t> closed;
+    char zoneId[MAX_ZONE_ID_LENGTH];
+    char settings[MAX_SETTINGS_LENGTH];
+};
+
+struct ProcessChannel::Ring {
+    /// <summary> Read position, only advanced by the reader. Positions grow forever and are masked by capacity. </summary>
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+
+    /// <summary> Write position, only advanced by the writer. </summary>
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+
+    /// <summary> Number of threads sleeping on the condition variable, either for data or for space. </summary>
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> waiters;
+
+#ifdef SUPPORT_POSIX
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+#endif
+};
+
+namespace {
+
+    const size_t HEADER_SIZE = AlignUp(sizeof(ProcessChannel::Header), CACHE_LINE_SIZE);
+    const size_t RING_SIZE = AlignUp(sizeof(ProcessChannel::Ring), CACHE_LINE_SIZE);
+
+    size_t GetSegmentSize(size_t capacity) {
+        return HEADER_SIZE + 2 * RING_SIZE + 2 * capacity;
+    }
+
+#ifdef SUPPORT_POSIX
+    void InitializeRing(ProcessChannel::Ring* ring) {
+        pthread_mutexattr_t mutexAttributes;
+        pthread_mutexattr_init(&mutexAttributes);
+        pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+#ifdef OS_LINUX
+        // A helper may be killed at any point, the survivor takes the lock over.
+        pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+#endif
+        pthread_mutex_init(&ring->mutex, &mutexAttributes);
+        pthread_mutexattr_destroy(&mutexAttributes);
+
+        pthread_condattr_t conditionAttributes;
+        pthread_condattr_init(&conditionAttributes);
+        pthread_condattr_setpshared(&conditionAttributes, PTHREAD_PROCESS_SHARED);
+        pthread_cond_init(&ring->condition, &conditionAttributes);
+        pthread_condattr_destroy(&conditionAttributes);
+    }
+
+    void LockRing(ProcessChannel::Ring* ring) {
+        auto result = pthread_mutex_lock(&ring->mutex);
+#ifdef OS_LINUX
+        if (result == EOWNERDEAD) {
+            // State guarded by the mutex is just the sleep itself, so it's consistent as is.
+            pthread_mutex_consistent(&ring->mutex);
+        }
+#else
+        (void)result;
+#endif
+    }
+#endif
+
+} // namespace
+
+ProcessChannel::ProcessChannel(std::unique_ptr<platform::SharedMemory> memory, bool creator)
+    : _memory(std::move(memory)) {
+    auto data = _memory->Data();
+    _header = reinterpret_cast<Header*>(data);
+
+    auto requests = reinterpret_cast<Ring*>(data + HEADER_SIZE);
+    auto responses = reinterpret_cast<Ring*>(data + HEADER_SIZE + RING_SIZE);
+    auto requestData = data + HEADER_SIZE + 2 * RING_SIZE;
+    auto responseData = requestData + _header->capacity;
+
+    _outbound = creator ? requests : responses;
+    _outboundData = creator ? requestData : responseData;
+    _inbound = creator ? responses : requests;
+    _inboundData = creator ? responseData : requestData;
+}
+
+ProcessChannel::~ProcessChannel() = default;
+
+std::unique_ptr<ProcessChannel> ProcessChannel::Create(
+    const std::string& name,
+    size_t capacity,
+    const std::string& zoneId,
+    const std::string& settings) {
+    if (zoneId.size() >= MAX_ZONE_ID_LENGTH || settings.size() >= MAX_SETTINGS_LENGTH) {
+        throw std::runtime_error("Zone id or settings are too long for a process channel");
+    }
+
+    capacity = RoundUpToPowerOf2(capacity);
+    auto memory = platform::SharedMemory::Create(name, GetSegmentSize(capacity));
+    if (memory == nullptr) {
+        throw std::runtime_error("Process channel " + name + " already exists");
+    }
+
+    // The segment is zero-filled, so positions, counters and flags start at 0.
+    auto header = reinterpret_cast<Header*>(memory->Data());
+    header->version = CHANNEL_LAYOUT_VERSION;
+    header->capacity = capacity;
+    header->creatorProcessId = platform::Getpid();
+    std::memcpy(header->zoneId, zoneId.c_str(), zoneId.size() + 1);
+    std::memcpy(header->settings, settings.c_str(), settings.size() + 1);
+
+#ifdef SUPPORT_POSIX
+    InitializeRing(reinterpret_cast<Ring*>(memory->Data() + HEADER_SIZE));
+    InitializeRing(reinterpret_cast<Ring*>(memory->Data() + HEADER_SIZE + RING_SIZE));
+#endif
+
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = CHANNEL_MAGIC;
+
+    return std::unique_ptr<ProcessChannel>(new ProcessChannel(std::move(memory), true));
+}
+
+std::unique_ptr<ProcessChannel> ProcessChannel::Open(const std::string& name) {
+    auto memory = platform::SharedMemory::Open(name);
+    if (memory == nullptr) {
+        return nullptr;
+    }
+
+    auto header = reinterpret_cast<Header*>(memory->Data());
+    if (memory->Size() < HEADER_SIZE
+        || header->magic != CHANNEL_MAGIC
+        || header->version != CHANNEL_LAYOUT_VERSION
+        || memory->Size() < GetSegmentSize(header->capacity)) {
+        throw std::runtime_error("Process channel " + name + " is malformed");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return std::unique_ptr<ProcessChannel>(new ProcessChannel(std::move(memory), false));
+}
+
+std::string ProcessChannel::GetZoneId() const {
+    return std::string(_header->zoneId);
+}
+
+std::string ProcessChannel::GetSettings() const {
+    return std::string(_header->settings);
+}
+
+int32_t ProcessChannel::GetCreatorProcessId() const {
+    return _header->creatorProcessId;
+}
+
+size_t ProcessChannel::GetMaxMessageSize() const {
+    // A record never takes more than half of a ring, so it fits even if it has to skip the ring's end.
+    return static_cast<size_t>(_header->capacity) / 2 - RECORD_ALIGNMENT;
+}
+
+bool ProcessChannel::Send(const std::string& message, std::chrono::milliseconds timeout) {
+    NAPA_ASSERT(message.size() <= GetMaxMessageSize(), "Message of %zu bytes is too large for the process channel", message.size());
+
+    std::lock_guard<std::mutex> lock(_sendAccess);
+
+    auto capacity = _header->capacity;
+    auto recordSize = GetRecordSize(message.size());
+
+    auto tail = _outbound->tail.load(std::memory_order_relaxed);
+    auto offset = tail & (capacity - 1);
+    auto contiguous = capacity - offset;
+    auto required = recordSize <= contiguous ? recordSize : contiguous + recordSize;
+
+    auto hasSpace = [this, tail, capacity, required]() {
+        return capacity - (tail - _outbound->head.load(std::memory_order_acquire)) >= required;
+    };
+    if (!Wait(_outbound, std::chrono::steady_clock::now() + timeout, hasSpace)) {
+        return false;
+    }
+
+    if (recordSize > contiguous) {
+        uint32_t marker = WRAP_MARKER;
+        std::memcpy(_outboundData + offset, &marker, sizeof(marker));
+        tail += contiguous;
+        offset = 0;
+    }
+
+    auto length = static_cast<uint32_t>(message.size());
+    std::memcpy(_outboundData + offset, &length, sizeof(length));
+    std::memcpy(_outboundData + offset + sizeof(length), message.data(), message.size());
+
+    _outbound->tail.store(tail + recordSize);
+    Notify(_outbound);
+    return true;
+}
+
+bool ProcessChannel::Receive(std::string& message, std::chrono::milliseconds timeout) {
+    auto hasMessage = [this]() {
+        return _inbound->tail.load(std::memory_order_acquire) != _inbound->head.load(std::memory_order_relaxed);
+    };
+    if (!Wait(_inbound, std::chrono::steady_clock::now() + timeout, hasMessage)) {
+        return false;
+    }
+
+    auto capacity = _header->capacity;
+    auto head = _inbound->head.load(std::memory_order_relaxed);
+    auto offset = head & (capacity - 1);
+
+    uint32_t length;
+    std::memcpy(&length, _inboundData + offset, sizeof(length));
+    if (length == WRAP_MARKER) {
+        // The writer publishes the record after the marker together with the marker.
+        head += capacity - offset;
+        offset = 0;
+        std::memcpy(&length, _inboundData, sizeof(length));
+    }
+
+    message.assign(_inboundData + offset + sizeof(length), length);
+
+    _inbound->head.store(head + GetRecordSize(length));
+    Notify(_inbound);
+    return true;
+}
+
+void ProcessChannel::SetReady() {
+    _header->ready = 1;
+}
+
+bool ProcessChannel::IsReady() const {
+    return _header->ready != 0;
+}
+
+void ProcessChannel::Close() {
+    _header->closed = 1;
+
+    Notify(_outbound);
+    Notify(_inbound);
+}
+
+bool ProcessChannel::IsClosed() const {
+    return _header->closed != 0;
+}
+
+void ProcessChannel::Unlink() {
+    _memory->Unlink();
+}
+
+void ProcessChannel::Notify(Ring* ring) {
+    if (ring->waiters.load() == 0) {
+        return;
+    }
+
+#ifdef SUPPORT_POSIX
+    LockRing(ring);
+    pthread_cond_broadcast(&ring->condition);
+    pthread_mutex_unlock(&ring->mutex);
+#endif
+}
+
+template <typename Predicate>
+bool ProcessChannel::Wait(Ring* ring, std::chrono::steady_clock::time_point deadline, Predicate ready) {
+    while (!ready()) {
+        if (IsClosed()) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+
+#ifdef SUPPORT_POSIX
+        // Condition variables of the ring take an absolute system clock time.
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+        timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        auto nanoseconds = static_cast<int64_t>(until.tv_nsec) + remaining.count() % 1000000000;
+        until.tv_sec += static_cast<time_t>(remaining.count() / 1000000000 + nanoseconds / 1000000000);
+        until.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+
+        LockRing(ring);
+        ring->waiters++;
+
+        // The other side changes positions before it reads 'waiters', so checking again after
+        // counting ourselves in guarantees it either wakes us up or we see the change.
+        if (!ready() && !IsClosed()) {
+            pthread_cond_timedwait(&ring->condition, &ring->mutex, &until);
+        }
+
+        ring->waiters--;
+        pthread_mutex_unlock(&ring->mutex);
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+    }
+    return true;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace napa {
+namespace platform {
+    class SharedMemory;
+}
+
+namespace zone {
+
+    /// <summary>
+    /// A pair of message rings in a named shared memory segment, connecting a process zone with one helper process.
+    /// The creator (the zone) sends requests and receives responses, the opener (the helper) does the opposite.
+    /// </summary>
+    /// <remarks>
+    /// Each ring has a single reader and is written under a lock per process, so any thread can send.
+    /// Readers and writers only touch the process-shared condition variable of a ring when the other side
+    /// sleeps on it, thus messages flow without system calls while both sides are busy.
+    /// On platforms without process-shared condition variables, waiting falls back to polling.
+    /// </remarks>
+    class ProcessChannel {
+    public:
+        /// <summary> Creates a channel. </summary>
+        /// <param name="name"> Name of the shared memory segment. </param>
+        /// <param name="capacity"> Bytes of each ring, rounded up to a power of 2. </param>
+        /// <param name="zoneId"> Id of the zone, read by the helper. </param>
+        /// <param name="settings"> Zone settings for the helper to create its zone with. </param>
+        /// <returns> The zone end of the channel. It throws std::runtime_error on failures. </returns>
+        static std::unique_ptr<ProcessChannel> Create(
+            const std::string& name,
+            size_t capacity,
+            const std::string& zoneId,
+            const std::string& settings);
+
+        /// <summary> Opens a channel created by a process zone. </summary>
+        /// <returns> The helper end of the channel, or nullptr if it doesn't exist. It throws std::runtime_error if malformed. </returns>
+        static std::unique_ptr<ProcessChannel> Open(const std::string& name);
+
+        ~ProcessChannel();
+
+        /// <summary> Non-copyable. </summary>
+        ProcessChannel(const ProcessChannel&) = delete;
+        ProcessChannel& operator=(const ProcessChannel&) = delete;
+
+        /// <summary> Id of the zone. </summary>
+        std::string GetZoneId() const;
+
+        /// <summary> Zone settings for the helper. </summary>
+        std::string GetSettings() const;
+
+        /// <summary> Process id of the zone end. </summary>
+        int32_t GetCreatorProcessId() const;
+
+        /// <summary> Size of the largest message that can be sent. </summary>
+        size_t GetMaxMessageSize() const;
+
+        /// <summary> Sends a message, waiting for space if the ring is full. </summary>
+        /// <param name="message"> Message, which must not be larger than GetMaxMessageSize(). </param>
+        /// <param name="timeout"> Max time to wait for space. </param>
+        /// <returns> False if it timed out or the channel is closed. </returns>
+        bool Send(const std::string& message, std::chrono::milliseconds timeout);
+
+        /// <summary> Receives a message. Only one thread of a process may receive. </summary>
+        /// <param name="timeout"> Max time to wait for a message. </param>
+        /// <returns> False if it timed out or the channel is closed. </returns>
+        bool Receive(std::string& message, std::chrono::milliseconds timeout);
+
+        /// <summary> Marks the helper ready to serve. </summary>
+        void SetReady();
+
+        /// <summary> Returns true once the helper is ready to serve. </summary>
+        bool IsReady() const;
+
+        /// <summary> Closes the channel, waking up both ends. </summary>
+        void Close();
+
+        /// <summary> Returns true if either end closed the channel. </summary>
+        bool IsClosed() const;
+
+        /// <summary> Removes the segment name, so it can't be opened again. </summary>
+        void Unlink();
+
+        /// <summary> Layout of the segment, defined in the implementation. </summary>
+        struct Header;
+        struct Ring;
+
+    private:
+        ProcessChannel(std::unique_ptr<platform::SharedMemory> memory, bool creator);
+
+        /// <summary> Wakes up waiters of a ring if any. </summary>
+        void Notify(Ring* ring);
+
+        /// <summary> Waits on a ring until 'ready' returns true, the deadline passes or the channel is closed. </summary>
+        template <typename Predicate>
+        bool Wait(Ring* ring, std::chrono::steady_clock::time_point deadline, Predicate ready);
+
+        std::unique_ptr<platform::SharedMemory> _memory;
+        Header* _header;
+
+        /// <summary> Ring this end writes to. </summary>
+        Ring* _outbound;
+        char* _outboundData;
+
+        /// <summary> Ring this end reads from. </summary>
+        Ring* _inbound;
+        char* _inboundData;
+
+        /// <summary> Serializes writers of this process. </summary>
+        std::mutex _sendAccess;
+    };
+}
+}
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "process-message.h"
+
+#include <cstring>
+
+using namespace napa::zone;
+
+namespace {
+
+    // Both ends of a channel run on the same machine, so integers are written in native byte order.
+
+    template <typename T>
+    void WriteValue(std::string& buffer, T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void WriteString(std::string& buffer, const std::string& value) {
+        WriteValue(buffer, static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    /// <summary> Reads values in order, remembering if any read went past the end. </summary>
+    class Reader {
+    public:
+        explicit Reader(const std::string& buffer) : _buffer(buffer), _offset(0), _valid(true) {}
+
+        template <typename T>
+        T ReadValue() {
+            T value{};
+            if (!Ensure(sizeof(T))) {
+                return value;
+            }
+            std::memcpy(&value, _buffer.data() + _offset, sizeof(T));
+            _offset += sizeof(T);
+            return value;
+        }
+
+        std::string ReadString() {
+            auto length = ReadValue<uint32_t>();
+            if (!Ensure(length)) {
+                return std::string();
+            }
+            std::string value(_buffer.data() + _offset, length);
+            _offset += length;
+            return value;
+        }
+
+        /// <summary> True if all reads so far succeeded. </summary>
+        bool IsValid() const {
+            return _valid;
+        }
+
+        /// <summary> True if all reads succeeded and the whole buffer was consumed. </summary>
+        bool IsComplete() const {
+            return _valid && _offset == _buffer.size();
+        }
+
+    private:
+        bool Ensure(size_t size) {
+            if (!_valid || _buffer.size() - _offset < size) {
+                _valid = false;
+            }
+            return _valid;
+        }
+
+        const std::string& _buffer;
+        size_t _offset;
+        bool _valid;
+    };
+
+} // namespace
+
+std::string ProcessRequest::Serialize() const {
+    size_t size = 52 + module.size() + function.size() + functionDefinition.size();
+    for (const auto& argument : arguments) {
+        size += 4 + argument.size();
+    }
+
+    std::string buffer;
+    buffer.reserve(size);
+    WriteValue(buffer, static_cast<uint32_t>(type));
+    WriteValue(buffer, callId);
+    WriteValue(buffer, timeout);
+    WriteValue(buffer, hedgeAfterMs);
+    WriteValue(buffer, cacheTtlMs);
+    WriteValue(buffer, singleFlight);
+    WriteValue(buffer, flowId);
+    WriteValue(buffer, flowWeight);
+    WriteValue(buffer, accounting);
+    WriteString(buffer, module);
+    WriteString(buffer, function);
+    WriteValue(buffer, static_cast<uint32_t>(arguments.size()));
+    for (const auto& argument : arguments) {
+        WriteString(buffer, argument);
+    }
+    WriteString(buffer, functionDefinition);
+    return buffer;
+}
+
+bool ProcessRequest::Parse(const std::string& message, ProcessRequest& request) {
+    Reader reader(message);
+
+    auto type = reader.ReadValue<uint32_t>();
+    if (type > static_cast<uint32_t>(Type::Broadcast)) {
+        return false;
+    }
+    request.type = static_cast<Type>(type);
+    request.callId = reader.ReadValue<uint64_t>();
+    request.timeout = reader.ReadValue<uint32_t>();
+    request.hedgeAfterMs = reader.ReadValue<uint32_t>();
+    request.cacheTtlMs = reader.ReadValue<uint32_t>();
+    request.singleFlight = reader.ReadValue<uint32_t>();
+    request.flowId = reader.ReadValue<uint32_t>();
+    request.flowWeight = reader.ReadValue<uint32_t>();
+    request.accounting = reader.ReadValue<uint32_t>();
+    request.module = reader.ReadString();
+    request.function = reader.ReadString();
+
+    auto count = reader.ReadValue<uint32_t>();
+    request.arguments.clear();
+    for (uint32_t i = 0; i < count && reader.IsValid(); ++i) {
+        request.arguments.push_back(reader.ReadString());
+    }
+    request.functionDefinition = reader.ReadString();
+    return reader.IsComplete() && request.arguments.size() == count;
+}
+
+std::string ProcessResponse::Serialize() const {
+    std::string buffer;
+    buffer.reserve(21 + sizeof(CallAccounting) + errorMessage.size() + returnValue.size());
+    WriteValue(buffer, callId);
+    WriteValue(buffer, static_cast<uint32_t>(code));
+    WriteString(buffer, errorMessage);
+    WriteString(buffer, returnValue);
+    WriteValue(buffer, static_cast<uint8_t>(accounting != nullptr));
+    if (accounting != nullptr) {
+        WriteValue(buffer, *accounting);
+    }
+    return buffer;
+}
+
+bool ProcessResponse::Parse(const std::string& message, ProcessResponse& response) {
+    Reader reader(message);
+
+    response.callId = reader.ReadValue<uint64_t>();
+    response.code = static_cast<ResultCode>(reader.ReadValue<uint32_t>());
+    response.errorMessage = reader.ReadString();
+    response.returnValue = reader.ReadString();
+    response.accounting = nullptr;
+    if (reader.ReadValue<uint8_t>() != 0) {
+        response.accounting = std::make_shared<const CallAccounting>(reader.ReadValue<CallAccounting>());
+    }
+    return reader.IsComplete();
+}
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A call sent from a process zone to one of its helper processes. </summary>
+    struct ProcessRequest {
+        enum class Type : uint32_t {
+            Execute = 0,
+            Broadcast = 1
+        };
+
+        Type type = Type::Execute;
+
+        /// <summary> Id to match the response, unique in the helper process. </summary>
+        uint64_t callId = 0;
+
+        /// <summary> Timeout in milliseconds, 0 for no timeout. </summary>
+        uint32_t timeout = 0;
+
+        /// <summary> Milliseconds after which the call is duplicated on another worker, 0 for no hedging. </summary>
+        uint32_t hedgeAfterMs = 0;
+
+        /// <summary> Milliseconds to cache the result for, 0 for no caching. </summary>
+        uint32_t cacheTtlMs = 0;
+
+        /// <summary> Non-zero to coalesce the call with an identical call in flight. </summary>
+        uint32_t singleFlight = 0;
+
+        /// <summary> The flow the call is queued in while all workers are busy, and the flow's weight. </summary>
+        uint32_t flowId = 0;
+        uint32_t flowWeight = 0;
+
+        /// <summary> Non-zero to measure the resources the call uses. </summary>
+        uint32_t accounting = 0;
+
+        std::string module;
+        std::string function;
+
+        /// <summary> Marshalled arguments. </summary>
+        std::vector<std::string> arguments;
+
+        /// <summary>
+        /// Marshalled definition of an anonymous function, as UTF-16 bytes, since the helper doesn't share
+        /// the function store of the zone process. Empty for functions of modules.
+        /// </summary>
+        std::string functionDefinition;
+
+        /// <summary> Writes the request into bytes for a process channel. </summary>
+        std::string Serialize() const;
+
+        /// <summary> Reads a request written by Serialize. </summary>
+        /// <returns> False if the message is malformed. </returns>
+        static bool Parse(const std::string& message, ProcessRequest& request);
+    };
+
+    /// <summary> Result of a call, sent back from a helper process. </summary>
+    struct ProcessResponse {
+        uint64_t callId = 0;
+        ResultCode code = NAPA_RESULT_SUCCESS;
+        std::string errorMessage;
+        std::string returnValue;
+
+        /// <summary> Resources used by the call if it was measured, otherwise null. </summary>
+        std::shared_ptr<const CallAccounting> accounting;
+
+        /// <summary> Writes the response into bytes for a process channel. </summary>
+        std::string Serialize() const;
+
+        /// <summary> Reads a response written by Serialize. </summary>
+        /// <returns> False if the message is malformed. </returns>
+        static bool Parse(const std::string& message, ProcessResponse& response);
+    };
+}
+}
@@ -0,0 +1,567 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "process-zone.h"
+
+#include <platform/child-process.h>
+#include <platform/process.h>
+#include <settings/settings-parser.h>
+#include <zone/forwarded-call.h>
+#include <zone/napa-zone.h>
+#include <zone/process-channel.h>
+#include <zone/process-message.h>
+
+#include <napa/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+
+// Static members initialization
+std::mutex ProcessZone::_mutex;
+std::unordered_map<std::string, std::weak_ptr<ProcessZone>> ProcessZone::_zones;
+
+namespace {
+
+    /// <summary> Bytes of each ring of a channel, which bounds the size of marshalled arguments and results. </summary>
+    const size_t CHANNEL_CAPACITY = 8 * 1024 * 1024;
+
+    /// <summary> How often blocked senders and readers check whether the other end is still alive. </summary>
+    const std::chrono::milliseconds POLL_INTERVAL(100);
+
+    /// <summary> Max time for a helper to create its zone. </summary>
+    const std::chrono::seconds HELPER_START_TIMEOUT(60);
+
+    /// <summary> Min time between starts of a helper, so one that keeps dying doesn't spin its reader. </summary>
+    const std::chrono::seconds HELPER_RESTART_INTERVAL(1);
+
+    /// <summary> Max bytes of broadcasts kept to replay on restarted helpers. Broadcasts beyond it fail. </summary>
+    const size_t MAX_BROADCAST_LOG_BYTES = 64 * 1024 * 1024;
+
+    std::mutex _hostCommandAccess;
+    std::vector<std::string> _hostCommand;
+
+    /// <summary> Makes channel names unique in this process. </summary>
+    std::atomic<uint64_t> _channelCount(0);
+
+} // namespace
+
+class ProcessZone::ProcessZoneImpl : public std::enable_shared_from_this<ProcessZoneImpl> {
+public:
+    ProcessZoneImpl(const settings::ZoneSettings& settings, const std::string& settingsString);
+
+    /// <summary> Starts helper processes with their readers and writers. </summary>
+    /// <returns> False if any helper failed to start. </returns>
+    bool Start();
+
+    /// <summary> Stops readers and writers, and fails calls in flight. Child process destructors kill helpers afterwards. </summary>
+    void Stop();
+
+    const std::string& GetId() const;
+    void Broadcast(const FunctionSpec& spec, BroadcastCallback callback);
+    void Execute(const FunctionSpec& spec, ExecuteCallback callback);
+
+private:
+    /// <summary> A request waiting to be written to the channel it was queued for. </summary>
+    struct OutboundRequest {
+        std::string message;
+        uint64_t callId;
+
+        /// <summary> Channel of the helper when the request was queued, the call fails if it's closed. </summary>
+        std::shared_ptr<ProcessChannel> channel;
+    };
+
+    /// <summary> A helper process with its channel, calls in flight and requests not yet sent. </summary>
+    struct Helper {
+
+        /// <summary> Guards the process and channel. </summary>
+        std::mutex access;
+
+        std::unique_ptr<platform::ChildProcess> process;
+        std::shared_ptr<ProcessChannel> channel;
+        PendingCalls pending;
+
+        std::mutex outboundAccess;
+        std::condition_variable hasOutbound;
+        std::deque<OutboundRequest> outbound;
+
+        std::thread reader;
+        std::thread writer;
+
+        std::shared_ptr<ProcessChannel> GetChannel() {
+            std::lock_guard<std::mutex> lock(access);
+            return channel;
+        }
+    };
+
+    /// <summary> Starts the process of a helper, replaying broadcasts, and waits until it's ready. </summary>
+    bool StartHelper(Helper& helper);
+
+    /// <summary> Reads responses of a helper, restarting it when it dies. Runs on a thread per helper. </summary>
+    void ReadResponses(Helper& helper);
+
+    /// <summary> Writes queued requests of a helper, waiting while its ring is full. Runs on a thread per helper. </summary>
+    void WriteRequests(Helper& helper);
+
+    /// <summary> Queues a request to a helper, calling back with a failure if it can't be sent. </summary>
+    void SendRequest(Helper& helper, std::string message, uint64_t callId);
+
+    /// <summary> Calls back a call with a failure, unless it already completed. </summary>
+    void FailRequest(Helper& helper, uint64_t callId, std::string errorMessage);
+
+    settings::ZoneSettings _settings;
+    std::string _settingsString;
+    std::vector<std::unique_ptr<Helper>> _helpers;
+
+    /// <summary> Serializes broadcasts with replaying them on restarted helpers. </summary>
+    std::mutex _broadcastAccess;
+    std::vector<std::string> _broadcasts;
+    size_t _broadcastBytes;
+
+    std::atomic<uint64_t> _nextCallId;
+    std::atomic<bool> _stopping;
+};
+
+std::shared_ptr<ProcessZone> ProcessZone::Create(const settings::ZoneSettings& settings, const std::string& settingsString) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _zones.find(settings.id);
+    if (iter != _zones.end() && !iter->second.expired()) {
+        NAPA_DEBUG("Zone", "Failed to create zone '%s': a zone with this name already exists.", settings.id.c_str());
+        return nullptr;
+    }
+
+    // An helper class to enable make_shared of ProcessZone
+    struct MakeSharedEnabler : public ProcessZone {
+        MakeSharedEnabler(const settings::ZoneSettings& settings, const std::string& settingsString) :
+            ProcessZone(settings, settingsString) {}
+    };
+
+    // Failed zones are not handed out, the destructor stops helpers that did start.
+    auto zone = std::make_shared<MakeSharedEnabler>(settings, settingsString);
+    if (!zone->_impl->Start()) {
+        LOG_ERROR("Zone", "Failed to create zone '%s': helper processes failed to start.", settings.id.c_str());
+        return nullptr;
+    }
+    _zones[settings.id] = zone;
+
+    NAPA_DEBUG("Zone", "Process zone \"%s\" created with %u processes.", settings.id.c_str(), settings.processes);
+
+    return zone;
+}
+
+std::shared_ptr<ProcessZone> ProcessZone::Get(const std::string& id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _zones.find(id);
+    if (iter == _zones.end()) {
+        return nullptr;
+    }
+
+    auto zone = iter->second.lock();
+    if (zone == nullptr) {
+        // Use this chance to clean up the map
+        _zones.erase(iter);
+    }
+    return zone;
+}
+
+void ProcessZone::SetHostCommand(std::vector<std::string> command) {
+    std::lock_guard<std::mutex> lock(_hostCommandAccess);
+    _hostCommand = std::move(command);
+}
+
+ProcessZone::ProcessZone(const settings::ZoneSettings& settings, const std::string& settingsString) :
+    _impl(std::make_shared<ProcessZoneImpl>(settings, settingsString)) {}
+
+ProcessZone::~ProcessZone() {
+    // The implementation is released by the last reader or writer if this runs on one of their threads.
+    _impl->Stop();
+}
+
+const std::string& ProcessZone::GetId() const {
+    return _impl->GetId();
+}
+
+void ProcessZone::Broadcast(const FunctionSpec& spec, BroadcastCallback callback) {
+    _impl->Broadcast(spec, std::move(callback));
+}
+
+void ProcessZone::Execute(const FunctionSpec& spec, ExecuteCallback callback) {
+    _impl->Execute(spec, std::move(callback));
+}
+
+ProcessZone::ProcessZoneImpl::ProcessZoneImpl(const settings::ZoneSettings& settings, const std::string& settingsString) :
+    _settings(settings), _settingsString(settingsString), _broadcastBytes(0), _nextCallId(1), _stopping(false) {}
+
+bool ProcessZone::ProcessZoneImpl::Start() {
+    // Helpers start in parallel, as each of them bootstraps a zone of its own.
+    _helpers.reserve(_settings.processes);
+    for (uint32_t i = 0; i < _settings.processes; ++i) {
+        _helpers.emplace_back(std::make_unique<Helper>());
+    }
+
+    std::vector<std::thread> starters;
+    for (auto& helper : _helpers) {
+        starters.emplace_back([this, &helper]() {
+            StartHelper(*helper);
+        });
+    }
+    for (auto& starter : starters) {
+        starter.join();
+    }
+
+    for (auto& helper : _helpers) {
+        if (helper->channel == nullptr) {
+            return false;
+        }
+    }
+
+    // Each reader and writer holds the implementation, which may outlive the zone.
+    for (auto& helper : _helpers) {
+        helper->reader = std::thread([self = shared_from_this(), helper = helper.get()]() {
+            self->ReadResponses(*helper);
+        });
+        helper->writer = std::thread([self = shared_from_this(), helper = helper.get()]() {
+            self->WriteRequests(*helper);
+        });
+    }
+    return true;
+}
+
+void ProcessZone::ProcessZoneImpl::Stop() {
+    _stopping = true;
+
+    for (auto& helper : _helpers) {
+        auto channel = helper->GetChannel();
+        if (channel != nullptr) {
+            channel->Close();
+        }
+
+        // Notify under the lock, so a writer about to wait doesn't miss it.
+        std::lock_guard<std::mutex> lock(helper->outboundAccess);
+        helper->hasOutbound.notify_one();
+    }
+
+    for (auto& helper : _helpers) {
+        for (auto thread : { &helper->reader, &helper->writer }) {
+            if (!thread->joinable()) {
+                continue;
+            }
+
+            // The last reference to the zone may be dropped by a callback on a reader or writer thread,
+            // which then returns to its loop and stops after releasing the implementation.
+            if (thread->get_id() == std::this_thread::get_id()) {
+                thread->detach();
+            } else {
+                thread->join();
+            }
+        }
+    }
+
+    for (auto& helper : _helpers) {
+        helper->pending.FailAll(NAPA_RESULT_INTERNAL_ERROR, "Process zone '" + _settings.id + "' was released");
+    }
+}
+
+const std::string& ProcessZone::ProcessZoneImpl::GetId() const {
+    return _settings.id;
+}
+
+void ProcessZone::ProcessZoneImpl::Broadcast(const FunctionSpec& spec, BroadcastCallback callback) {
+    if (HasSharedObjects(spec.transportContext)) {
+        callback(MakeResult(NAPA_RESULT_BROADCAST_SCRIPT_ERROR,
+            "Arguments of a call to process zone '" + _settings.id + "' must not refer to shared objects"));
+        return;
+    }
+
+    // Makes sure the callback is only called once, after all helpers finished running the broadcast.
+    // The first failure of any helper is reported over successes.
+    struct BroadcastState {
+        std::mutex access;
+        size_t remaining;
+        Result result;
+        BroadcastCallback callback;
+    };
+    auto state = std::make_shared<BroadcastState>();
+    state->remaining = _helpers.size();
+    state->result.code = NAPA_RESULT_SUCCESS;
+    state->callback = std::move(callback);
+
+    auto callOnce = [state](Result result) {
+        std::unique_lock<std::mutex> lock(state->access);
+        if (state->result.code == NAPA_RESULT_SUCCESS) {
+            state->result = std::move(result);
+        }
+        if (--state->remaining == 0) {
+            lock.unlock();
+            state->callback(std::move(state->result));
+        }
+    };
+
+    // Broadcasts are recorded and queued under one lock, so a restarted helper replays each of them
+    // exactly once and in order, before it gets any other call. Queuing doesn't wait for a helper.
+    std::unique_lock<std::mutex> lock(_broadcastAccess);
+
+    // Replay messages have call id 0, which matches no call, so their responses are dropped.
+    auto replay = ToProcessRequest(ProcessRequest::Type::Broadcast, 0, spec).Serialize();
+    auto callIds = _nextCallId.fetch_add(_helpers.size());
+    std::vector<std::string> messages;
+    messages.reserve(_helpers.size());
+    auto maxSize = replay.size();
+    for (size_t i = 0; i < _helpers.size(); ++i) {
+        messages.push_back(ToProcessRequest(ProcessRequest::Type::Broadcast, callIds + i, spec).Serialize());
+        maxSize = std::max(maxSize, messages.back().size());
+    }
+
+    // A broadcast is only recorded if every helper can take it, as replaying a message larger than
+    // a channel allows would fail the restart of a helper.
+    std::string errorMessage;
+    if (maxSize > _helpers[0]->GetChannel()->GetMaxMessageSize()) {
+        errorMessage = "Arguments of " + std::to_string(maxSize) + " bytes are too large for process zone '" + _settings.id + "'";
+    } else if (replay.size() > MAX_BROADCAST_LOG_BYTES - _broadcastBytes) {
+        errorMessage = "Broadcasts to process zone '" + _settings.id + "' exceed "
+            + std::to_string(MAX_BROADCAST_LOG_BYTES) + " bytes kept to restore restarted helpers";
+    }
+    if (!errorMessage.empty()) {
+        lock.unlock();
+        state->callback(MakeResult(NAPA_RESULT_BROADCAST_SCRIPT_ERROR, std::move(errorMessage)));
+        return;
+    }
+    _broadcastBytes += replay.size();
+    _broadcasts.push_back(std::move(replay));
+
+    for (size_t i = 0; i < _helpers.size(); ++i) {
+        _helpers[i]->pending.Add(callIds + i, callOnce);
+        SendRequest(*_helpers[i], std::move(messages[i]), callIds + i);
+    }
+
+    NAPA_DEBUG("Zone", "Broadcast function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
+}
+
+void ProcessZone::ProcessZoneImpl::Execute(const FunctionSpec& spec, ExecuteCallback callback) {
+    if (HasSharedObjects(spec.transportContext)) {
+        callback(MakeResult(NAPA_RESULT_EXECUTE_FUNC_ERROR,
+            "Arguments of a call to process zone '" + _settings.id + "' must not refer to shared objects"));
+        return;
+    }
+
+    auto callId = _nextCallId++;
+    auto message = ToProcessRequest(ProcessRequest::Type::Execute, callId, spec).Serialize();
+
+    // Pick the helper with the fewest calls in flight, starting from a rotating one to spread ties.
+    auto count = _helpers.size();
+    auto target = _helpers[callId % count].get();
+    for (size_t i = 1; i < count; ++i) {
+        auto helper = _helpers[(callId + i) % count].get();
+        if (helper->pending.GetCount() < target->pending.GetCount()) {
+            target = helper;
+        }
+    }
+
+    target->pending.Add(callId, std::move(callback));
+    SendRequest(*target, std::move(message), callId);
+
+    NAPA_DEBUG("Zone", "Execute function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
+}
+
+void ProcessZone::ProcessZoneImpl::SendRequest(Helper& helper, std::string message, uint64_t callId) {
+    auto channel = helper.GetChannel();
+    if (message.size() > channel->GetMaxMessageSize()) {
+        FailRequest(helper, callId,
+            "Arguments of " + std::to_string(message.size()) + " bytes are too large for process zone '" + _settings.id + "'");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(helper.outboundAccess);
+        helper.outbound.push_back(OutboundRequest { std::move(message), callId, std::move(channel) });
+    }
+    helper.hasOutbound.notify_one();
+}
+
+void ProcessZone::ProcessZoneImpl::FailRequest(Helper& helper, uint64_t callId, std::string errorMessage) {
+    auto callback = helper.pending.Take(callId);
+    if (callback) {
+        callback(MakeResult(NAPA_RESULT_INTERNAL_ERROR, std::move(errorMessage)));
+    }
+}
+
+void ProcessZone::ProcessZoneImpl::WriteRequests(Helper& helper) {
+    while (true) {
+        OutboundRequest request;
+        {
+            std::unique_lock<std::mutex> lock(helper.outboundAccess);
+            helper.hasOutbound.wait(lock, [this, &helper]() { return _stopping || !helper.outbound.empty(); });
+            if (_stopping) {
+                // Stop fails the calls left in the queue.
+                return;
+            }
+            request = std::move(helper.outbound.front());
+            helper.outbound.pop_front();
+        }
+
+        // The reader closes the channel when the helper dies, which stops waiting for space.
+        // A restarted helper has a new channel, and gets broadcasts queued for the old one by replay.
+        while (!request.channel->Send(request.message, POLL_INTERVAL)) {
+            if (request.channel->IsClosed() || _stopping) {
+                FailRequest(helper, request.callId, "Helper process of zone '" + _settings.id + "' exited");
+                break;
+            }
+        }
+    }
+}
+
+bool ProcessZone::ProcessZoneImpl::StartHelper(Helper& helper) {
+    std::vector<std::string> command;
+    {
+        std::lock_guard<std::mutex> lock(_hostCommandAccess);
+        command = _hostCommand;
+    }
+    if (command.empty()) {
+        LOG_ERROR("Zone", "Failed to start helper process of zone '%s': no host command was set.", _settings.id.c_str());
+        return false;
+    }
+
+    auto name = "napa-zone-" + std::to_string(platform::Getpid()) + "-" + std::to_string(_channelCount++);
+    command.push_back(name);
+
+    std::shared_ptr<ProcessChannel> channel;
+    std::unique_ptr<platform::ChildProcess> process;
+    try {
+        channel = ProcessChannel::Create(name, CHANNEL_CAPACITY, _settings.id, _settingsString);
+        process = platform::ChildProcess::Spawn(command);
+    } catch (const std::exception& ex) {
+        LOG_ERROR("Zone", "Failed to start helper process of zone '%s': %s", _settings.id.c_str(), ex.what());
+        if (channel != nullptr) {
+            channel->Unlink();
+        }
+        return false;
+    }
+
+    // The helper opens the channel before it creates its zone and reports ready.
+    auto deadline = std::chrono::steady_clock::now() + HELPER_START_TIMEOUT;
+    while (!channel->IsReady()) {
+        if (!process->IsRunning() || std::chrono::steady_clock::now() >= deadline || _stopping) {
+            LOG_ERROR("Zone", "Helper process %d of zone '%s' failed to start.", process->GetId(), _settings.id.c_str());
+            channel->Unlink();
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    channel->Unlink();
+
+    std::lock_guard<std::mutex> broadcastLock(_broadcastAccess);
+
+    // Replay broadcasts before the helper becomes visible to calls. Their responses match no call and are dropped.
+    for (const auto& message : _broadcasts) {
+        while (!channel->Send(message, POLL_INTERVAL)) {
+            if (!process->IsRunning() || _stopping) {
+                LOG_ERROR("Zone", "Helper process %d of zone '%s' exited during start.", process->GetId(), _settings.id.c_str());
+                return false;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(helper.access);
+    helper.channel = std::move(channel);
+    helper.process = std::move(process);
+
+    NAPA_DEBUG("Zone", "Helper process %d of zone '%s' started.", helper.process->GetId(), _settings.id.c_str());
+    return true;
+}
+
+void ProcessZone::ProcessZoneImpl::ReadResponses(Helper& helper) {
+    auto lastStart = std::chrono::steady_clock::now();
+
+    std::string message;
+    while (!_stopping) {
+        auto channel = helper.GetChannel();
+        if (channel->Receive(message, POLL_INTERVAL)) {
+            if (!helper.pending.Resolve(message)) {
+                LOG_ERROR("Zone", "Malformed response from helper process of zone '%s'.", _settings.id.c_str());
+            }
+            continue;
+        }
+
+        // Only this thread replaces the process, so it's read without the lock.
+        if (_stopping || (!channel->IsClosed() && helper.process->IsRunning())) {
+            continue;
+        }
+
+        LOG_ERROR("Zone", "Helper process %d of zone '%s' exited, restarting it.", helper.process->GetId(), _settings.id.c_str());
+        channel->Close();
+
+        helper.pending.FailAll(NAPA_RESULT_INTERNAL_ERROR, "Helper process of zone '" + _settings.id + "' exited");
+
+        while (!_stopping) {
+            auto elapsed = std::chrono::steady_clock::now() - lastStart;
+            if (elapsed < HELPER_RESTART_INTERVAL) {
+                std::this_thread::sleep_for(HELPER_RESTART_INTERVAL - elapsed);
+            }
+            lastStart = std::chrono::steady_clock::now();
+
+            if (StartHelper(helper)) {
+                break;
+            }
+        }
+    }
+}
+
+ResultCode ProcessZone::Serve(const std::string& channelName) {
+    std::shared_ptr<ProcessChannel> channel;
+    try {
+        channel = ProcessChannel::Open(channelName);
+    } catch (const std::exception& ex) {
+        LOG_ERROR("Zone", "Failed to open process channel '%s': %s", channelName.c_str(), ex.what());
+        return NAPA_RESULT_ZONE_INIT_ERROR;
+    }
+    if (channel == nullptr) {
+        LOG_ERROR("Zone", "Process channel '%s' doesn't exist.", channelName.c_str());
+        return NAPA_RESULT_ZONE_INIT_ERROR;
+    }
+
+    settings::ZoneSettings settings;
+    if (!settings::ParseFromString(channel->GetSettings(), settings)) {
+        return NAPA_RESULT_SETTINGS_PARSER_ERROR;
+    }
+    settings.id = channel->GetZoneId();
+    settings.processes = 0;
+
+    auto zone = NapaZone::Create(settings);
+    if (zone == nullptr) {
+        return NAPA_RESULT_ZONE_INIT_ERROR;
+    }
+    channel->SetReady();
+
+    auto creatorId = channel->GetCreatorProcessId();
+    std::string message;
+    while (!channel->IsClosed() && platform::IsProcessRunning(creatorId)) {
+        if (!channel->Receive(message, POLL_INTERVAL)) {
+            continue;
+        }
+
+        auto sendResponse = [channel, creatorId](std::string response) {
+            while (!channel->Send(response, POLL_INTERVAL)) {
+                if (channel->IsClosed() || !platform::IsProcessRunning(creatorId)) {
+                    return;
+                }
+            }
+        };
+
+        if (!DispatchRequest(*zone, message, channel->GetMaxMessageSize(), std::move(sendResponse))) {
+            LOG_ERROR("Zone", "Malformed request to helper process of zone '%s'.", settings.id.c_str());
+        }
+    }
+
+    NAPA_DEBUG("Zone", "Helper process of zone '%s' stopped serving.", settings.id.c_str());
+    channel->Close();
+    return NAPA_RESULT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "zone.h"
+
+#include "settings/settings.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    /// A zone whose workers run in helper processes, so a fatal error or OOM in one of its isolates
+    /// doesn't take down the host process and other zones, and process-wide locks are not shared between helpers.
+    /// Calls are carried to helpers over shared memory channels with their marshalled arguments.
+    /// </summary>
+    /// <remarks>
+    /// Each helper runs a Napa zone with the workers of the zone settings. Execute goes to the least loaded helper,
+    /// Broadcast goes to all of them and is replayed on a helper that is restarted after it died.
+    /// Calls are queued to a writer thread per helper, so callers don't wait while a helper's ring is full.
+    /// Calls in flight on a dead helper fail, and arguments or results referring to shared objects in their
+    /// transport context are rejected, as those are only valid in the process that created them.
+    /// </remarks>
+    class ProcessZone : public Zone {
+    public:
+
+        /// <summary> Creates a new zone and starts its helper processes. </summary>
+        /// <param name="settings"> Zone settings, where 'processes' is the number of helpers. </param>
+        /// <param name="settingsString"> Settings as passed in by the user, which helpers create their zones with. </param>
+        /// <returns> The zone, or nullptr if the id is taken or helpers failed to start. </returns>
+        static std::shared_ptr<ProcessZone> Create(const settings::ZoneSettings& settings, const std::string& settingsString);
+
+        /// <summary> Retrieves an existing zone by id. </summary>
+        static std::shared_ptr<ProcessZone> Get(const std::string& id);
+
+        /// <summary> Sets the command that starts a helper process, to which the channel name is appended. </summary>
+        static void SetHostCommand(std::vector<std::string> command);
+
+        /// <summary> Serves a process zone in a helper process, until the zone closes the channel or its process exits. </summary>
+        /// <param name="channelName"> Name of the channel, as passed in to the host command. </param>
+        static ResultCode Serve(const std::string& channelName);
+
+        /// <summary> Stops and kills helper processes. </summary>
+        virtual ~ProcessZone();
+
+        /// <see cref="Zone::GetId" />
+        virtual const std::string& GetId() const override;
+
+        /// <see cref="Zone::Broadcast" />
+        virtual void Broadcast(const FunctionSpec& spec, BroadcastCallback callback) override;
+
+        /// <see cref="Zone::Execute" />
+        virtual void Execute(const FunctionSpec& spec, ExecuteCallback callback) override;
+
+    private:
+        ProcessZone(const settings::ZoneSettings& settings, const std::string& settingsString);
+
+        /// <summary>
+        /// Helpers and their reader and writer threads. The threads hold it, so it outlives the zone when the last
+        /// reference to the zone is dropped by a callback on one of them.
+        /// </summary>
+        class ProcessZoneImpl;
+        std::shared_ptr<ProcessZoneImpl> _impl;
+
+        static std::mutex _mutex;
+        static std::unordered_map<std::string, std::weak_ptr<ProcessZone>> _zones;
+    };
+}
+}
@@ -0,0 +1,316 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "remote-zone.h"
+
+#include <platform/local-socket.h>
+#include <zone/forwarded-call.h>
+#include <zone/framed-connection.h>
+
+#include <napa/log.h>
+
+#include <chrono>
+
+using namespace napa;
+using namespace napa::zone;
+
+// Static members initialization
+std::mutex RemoteZone::_mutex;
+std::unordered_map<std::string, std::weak_ptr<RemoteZone>> RemoteZone::_zones;
+std::mutex RemoteZoneServer::_serversAccess;
+std::unordered_map<std::string, std::unique_ptr<RemoteZoneServer>> RemoteZoneServer::_servers;
+
+namespace {
+
+    /// <summary> How often the server checks whether it's stopping while waiting for connections. </summary>
+    const std::chrono::milliseconds ACCEPT_POLL_INTERVAL(100);
+
+} // namespace
+
+struct RemoteZone::Connection {
+
+    /// <summary> Guards the link and its calls. </summary>
+    std::mutex access;
+
+    std::unique_ptr<FramedConnection> link;
+
+    /// <summary> Calls in flight on the link, replaced with the link so closing an old link can't fail new calls. </summary>
+    std::shared_ptr<PendingCalls> pending = std::make_shared<PendingCalls>();
+
+    size_t GetLoad() {
+        std::lock_guard<std::mutex> lock(access);
+        return pending->GetCount();
+    }
+};
+
+std::shared_ptr<RemoteZone> RemoteZone::Create(const settings::ZoneSettings& settings) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _zones.find(settings.id);
+    if (iter != _zones.end() && !iter->second.expired()) {
+        NAPA_DEBUG("Zone", "Failed to create zone '%s': a zone with this name already exists.", settings.id.c_str());
+        return nullptr;
+    }
+
+    // An helper class to enable make_shared of RemoteZone
+    struct MakeSharedEnabler : public RemoteZone {
+        explicit MakeSharedEnabler(const settings::ZoneSettings& settings) : RemoteZone(settings) {}
+    };
+
+    // Connect the pool upfront, so an unreachable server fails zone creation.
+    auto zone = std::make_shared<MakeSharedEnabler>(settings);
+    for (auto& connection : zone->_connections) {
+        std::lock_guard<std::mutex> connectionLock(connection->access);
+        if (!zone->Connect(*connection)) {
+            return nullptr;
+        }
+    }
+    _zones[settings.id] = zone;
+
+    NAPA_DEBUG("Zone", "Remote zone \"%s\" connected to \"%s\".", settings.id.c_str(), settings.remote.c_str());
+
+    return zone;
+}
+
+std::shared_ptr<RemoteZone> RemoteZone::Get(const std::string& id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _zones.find(id);
+    if (iter == _zones.end()) {
+        return nullptr;
+    }
+
+    auto zone = iter->second.lock();
+    if (zone == nullptr) {
+        // Use this chance to clean up the map
+        _zones.erase(iter);
+    }
+    return zone;
+}
+
+RemoteZone::RemoteZone(const settings::ZoneSettings& settings) : _settings(settings), _nextCallId(1) {
+    auto count = std::max<uint32_t>(_settings.connections, 1u);
+    for (uint32_t i = 0; i < count; ++i) {
+        _connections.emplace_back(std::make_unique<Connection>());
+    }
+}
+
+RemoteZone::~RemoteZone() {
+    for (auto& connection : _connections) {
+        std::unique_ptr<FramedConnection> link;
+        std::shared_ptr<PendingCalls> pending;
+        {
+            std::lock_guard<std::mutex> lock(connection->access);
+            link = std::move(connection->link);
+            pending = connection->pending;
+        }
+
+        // Closing from this end doesn't report the close, so calls in flight are failed here.
+        link.reset();
+        pending->FailAll(NAPA_RESULT_INTERNAL_ERROR, "Remote zone '" + _settings.id + "' was released");
+    }
+}
+
+const std::string& RemoteZone::GetId() const {
+    return _settings.id;
+}
+
+void RemoteZone::Broadcast(const FunctionSpec& spec, BroadcastCallback callback) {
+    // The server broadcasts to the workers of its zone and responds once.
+    Forward(ProcessRequest::Type::Broadcast, spec, std::move(callback));
+
+    NAPA_DEBUG("Zone", "Broadcast function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
+}
+
+void RemoteZone::Execute(const FunctionSpec& spec, ExecuteCallback callback) {
+    Forward(ProcessRequest::Type::Execute, spec, std::move(callback));
+
+    NAPA_DEBUG("Zone", "Execute function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
+}
+
+void RemoteZone::Forward(ProcessRequest::Type type, const FunctionSpec& spec, ExecuteCallback callback) {
+    if (HasSharedObjects(spec.transportContext)) {
+        callback(MakeResult(NAPA_RESULT_EXECUTE_FUNC_ERROR,
+            "Arguments of a call to remote zone '" + _settings.id + "' must not refer to shared objects"));
+        return;
+    }
+
+    auto callId = _nextCallId++;
+    auto message = ToProcessRequest(type, callId, spec).Serialize();
+    if (message.size() > FramedConnection::MAX_MESSAGE_SIZE) {
+        callback(MakeResult(NAPA_RESULT_EXECUTE_FUNC_ERROR,
+            "Arguments of " + std::to_string(message.size()) + " bytes are too large for remote zone '" + _settings.id + "'"));
+        return;
+    }
+
+    // Pick the connection with the fewest calls in flight, starting from a rotating one to spread ties.
+    auto count = _connections.size();
+    auto target = _connections[callId % count].get();
+    auto targetLoad = target->GetLoad();
+    for (size_t i = 1; i < count && targetLoad > 0; ++i) {
+        auto connection = _connections[(callId + i) % count].get();
+        auto load = connection->GetLoad();
+        if (load < targetLoad) {
+            target = connection;
+            targetLoad = load;
+        }
+    }
+
+    // A broken link is destroyed outside the lock, as its reader may be failing its calls.
+    std::unique_ptr<FramedConnection> retired;
+    std::shared_ptr<PendingCalls> pending;
+    bool sent = false;
+    {
+        std::lock_guard<std::mutex> lock(target->access);
+        if (target->link == nullptr || target->link->IsClosed()) {
+            retired = std::move(target->link);
+            Connect(*target);
+        }
+
+        if (target->link != nullptr) {
+            pending = target->pending;
+            pending->Add(callId, std::move(callback));
+            sent = target->link->Send(std::move(message));
+        }
+    }
+
+    if (pending == nullptr) {
+        callback(MakeResult(NAPA_RESULT_INTERNAL_ERROR,
+            "Can't connect to remote zone '" + _settings.id + "' at " + _settings.remote));
+        return;
+    }
+
+    if (!sent) {
+        auto failed = pending->Take(callId);
+        if (failed) {
+            failed(MakeResult(NAPA_RESULT_INTERNAL_ERROR, "Connection to remote zone '" + _settings.id + "' was closed"));
+        }
+    }
+}
+
+bool RemoteZone::Connect(Connection& connection) {
+    std::unique_ptr<platform::LocalSocket> socket;
+    try {
+        socket = platform::LocalSocket::Connect(_settings.remote);
+    } catch (const std::exception& ex) {
+        LOG_ERROR("Zone", "Failed to connect remote zone '%s': %s", _settings.id.c_str(), ex.what());
+        return false;
+    }
+
+    // Callbacks don't refer to the zone, as a link may report after the zone is gone.
+    auto pending = std::make_shared<PendingCalls>();
+    auto id = _settings.id;
+    connection.link = std::make_unique<FramedConnection>(
+        std::move(socket),
+        [pending, id](std::string message) {
+            if (!pending->Resolve(message)) {
+                LOG_ERROR("Zone", "Malformed response from remote zone '%s'.", id.c_str());
+            }
+        },
+        [pending, id]() {
+            pending->FailAll(NAPA_RESULT_INTERNAL_ERROR, "Connection to remote zone '" + id + "' was closed");
+        });
+    connection.pending = std::move(pending);
+    connection.link->Start();
+    return true;
+}
+
+RemoteZoneServer::RemoteZoneServer(std::shared_ptr<Zone> zone, const std::string& address) :
+    _zone(std::move(zone)),
+    _listener(platform::LocalSocketListener::Listen(address)),
+    _stopping(false),
+    _nextSessionId(0) {
+    _acceptor = std::thread([this]() {
+        AcceptConnections();
+    });
+}
+
+RemoteZoneServer::~RemoteZoneServer() {
+    _stopping = true;
+    _acceptor.join();
+
+    // Sessions are closed outside the lock, as their readers may be removing themselves.
+    std::unordered_map<uint64_t, std::shared_ptr<FramedConnection>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(_access);
+        sessions.swap(_sessions);
+    }
+}
+
+bool RemoteZoneServer::Listen(std::shared_ptr<Zone> zone, const std::string& address) {
+    std::lock_guard<std::mutex> lock(_serversAccess);
+    if (_servers.find(address) != _servers.end()) {
+        NAPA_DEBUG("Zone", "Failed to listen on '%s': it's served already.", address.c_str());
+        return false;
+    }
+
+    try {
+        _servers.emplace(address, std::make_unique<RemoteZoneServer>(std::move(zone), address));
+    } catch (const std::exception& ex) {
+        LOG_ERROR("Zone", "Failed to listen on '%s': %s", address.c_str(), ex.what());
+        return false;
+    }
+    return true;
+}
+
+bool RemoteZoneServer::Unlisten(const std::string& address) {
+    std::unique_ptr<RemoteZoneServer> server;
+    {
+        std::lock_guard<std::mutex> lock(_serversAccess);
+        auto iter = _servers.find(address);
+        if (iter == _servers.end()) {
+            return false;
+        }
+        server = std::move(iter->second);
+        _servers.erase(iter);
+    }
+    return true;
+}
+
+void RemoteZoneServer::AcceptConnections() {
+    while (!_stopping) {
+        auto socket = _listener->Accept(ACCEPT_POLL_INTERVAL);
+        if (socket == nullptr) {
+            continue;
+        }
+
+        // Responses are sent from zone workers, which must not keep a closed session alive.
+        auto zone = _zone;
+        auto self = std::make_shared<std::weak_ptr<FramedConnection>>();
+
+        std::lock_guard<std::mutex> lock(_access);
+        auto sessionId = _nextSessionId++;
+        auto session = std::make_shared<FramedConnection>(
+            std::move(socket),
+            [zone, self](std::string message) {
+                auto send = [self](std::string response) {
+                    auto session = self->lock();
+                    if (session != nullptr) {
+                        session->Send(std::move(response));
+                    }
+                };
+
+                if (!DispatchRequest(*zone, message, FramedConnection::MAX_MESSAGE_SIZE, std::move(send))) {
+                    LOG_ERROR("Zone", "Malformed request to zone '%s' from a remote zone.", zone->GetId().c_str());
+                    auto session = self->lock();
+                    if (session != nullptr) {
+                        session->Close();
+                    }
+                }
+            },
+            [this, sessionId]() {
+                // Declared before the lock, so the session is destroyed after it's released.
+                std::shared_ptr<FramedConnection> session;
+                std::lock_guard<std::mutex> lock(_access);
+                auto iter = _sessions.find(sessionId);
+                if (iter != _sessions.end()) {
+                    session = std::move(iter->second);
+                    _sessions.erase(iter);
+                }
+            });
+
+        *self = session;
+        _sessions.emplace(sessionId, session);
+        session->Start();
+    }
+}
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "zone.h"
+
+#include "settings/settings.h"
+#include "zone/process-message.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace platform {
+    class LocalSocketListener;
+}
+
+namespace zone {
+
+    class FramedConnection;
+
+    /// <summary>
+    /// A zone in another process, reached through a remote zone server over Unix domain sockets.
+    /// Calls are forwarded with their marshalled arguments over a pool of connections, each carrying many calls
+    /// at a time that are matched to responses by id, and writing calls queued together in one system call.
+    /// </summary>
+    /// <remarks>
+    /// A call goes to the connection with the fewest calls in flight. A connection that breaks fails its calls in
+    /// flight and is reconnected by the next call that picks it. Arguments and results referring to shared objects
+    /// in their transport context are rejected, as those are only valid in the process that created them.
+    /// </remarks>
+    class RemoteZone : public Zone {
+    public:
+
+        /// <summary> Creates a zone and connects to the server at 'remote' of the settings. </summary>
+        /// <returns> The zone, or nullptr if the id is taken or the server can't be reached. </returns>
+        static std::shared_ptr<RemoteZone> Create(const settings::ZoneSettings& settings);
+
+        /// <summary> Retrieves an existing zone by id. </summary>
+        static std::shared_ptr<RemoteZone> Get(const std::string& id);
+
+        /// <summary> Closes connections, failing calls in flight. </summary>
+        virtual ~RemoteZone();
+
+        /// <see cref="Zone::GetId" />
+        virtual const std::string& GetId() const override;
+
+        /// <see cref="Zone::Broadcast" />
+        virtual void Broadcast(const FunctionSpec& spec, BroadcastCallback callback) override;
+
+        /// <see cref="Zone::Execute" />
+        virtual void Execute(const FunctionSpec& spec, ExecuteCallback callback) override;
+
+        /// <summary> A pooled connection with its calls in flight, defined in the implementation. </summary>
+        struct Connection;
+
+    private:
+        explicit RemoteZone(const settings::ZoneSettings& settings);
+
+        /// <summary> Forwards a call through the least loaded connection. </summary>
+        void Forward(ProcessRequest::Type type, const FunctionSpec& spec, ExecuteCallback callback);
+
+        /// <summary> Connects a connection of the pool if it's not connected. </summary>
+        /// <returns> False if the server can't be reached. </returns>
+        bool Connect(Connection& connection);
+
+        settings::ZoneSettings _settings;
+        std::vector<std::unique_ptr<Connection>> _connections;
+        std::atomic<uint64_t> _nextCallId;
+
+        static std::mutex _mutex;
+        static std::unordered_map<std::string, std::weak_ptr<RemoteZone>> _zones;
+    };
+
+    /// <summary> Serves a zone of this process to remote zones connecting to a Unix domain socket. </summary>
+    class RemoteZoneServer {
+    public:
+
+        /// <summary> Starts serving a zone on a socket path. </summary>
+        /// <remarks> It throws std::runtime_error if the path can't be listened on. </remarks>
+        RemoteZoneServer(std::shared_ptr<Zone> zone, const std::string& address);
+
+        /// <summary> Stops accepting connections and closes connected ones. Calls in flight are not answered. </summary>
+        ~RemoteZoneServer();
+
+        /// <summary> Non-copyable. </summary>
+        RemoteZoneServer(const RemoteZoneServer&) = delete;
+        RemoteZoneServer& operator=(const RemoteZoneServer&) = delete;
+
+        /// <summary> Starts a server kept until Unlisten is called with the address, which holds the zone alive. </summary>
+        /// <returns> False if the address is served already or can't be listened on. </returns>
+        static bool Listen(std::shared_ptr<Zone> zone, const std::string& address);
+
+        /// <summary> Stops a server started by Listen. </summary>
+        /// <returns> False if no server was started on the address. </returns>
+        static bool Unlisten(const std::string& address);
+
+    private:
+        void AcceptConnections();
+
+        std::shared_ptr<Zone> _zone;
+        std::unique_ptr<platform::LocalSocketListener> _listener;
+        std::thread _acceptor;
+        std::atomic<bool> _stopping;
+
+        /// <summary> Connected clients by a sequence number. </summary>
+        std::mutex _access;
+        std::unordered_map<uint64_t, std::shared_ptr<FramedConnection>> _sessions;
+        uint64_t _nextSessionId;
+
+        static std::mutex _serversAccess;
+        static std::unordered_map<std::string, std::unique_ptr<RemoteZoneServer>> _servers;
+    };
+}
+}
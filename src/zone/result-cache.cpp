@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "result-cache.h"
+
+#include <iterator>
+
+using namespace napa;
+using namespace napa::zone;
+
+ResultCache::ResultCache(size_t maxBytes) : _maxBytes(maxBytes), _statistics() {
+}
+
+bool ResultCache::IsEnabled() const {
+    return _maxBytes > 0;
+}
+
+bool ResultCache::Get(const FunctionSpec& spec, Result& result) {
+    auto hash = CallKey::Hash(spec);
+
+    std::lock_guard<std::mutex> lock(_access);
+    PurgeExpired(Clock::now());
+
+    auto it = _entryMap.find(hash);
+    if (it == _entryMap.end() || !it->second->key->Matches(spec)) {
+        _statistics.misses++;
+        return false;
+    }
+
+    _statistics.hits++;
+    _entries.splice(_entries.begin(), _entries, it->second);
+
+    result.code = NAPA_RESULT_SUCCESS;
+    result.errorMessage.clear();
+    result.returnValue = it->second->returnValue;
+    result.transportContext = std::make_unique<transport::TransportContext>();
+    return true;
+}
+
+void ResultCache::Set(std::shared_ptr<const CallKey> key, const Result& result, uint32_t ttl) {
+    if (!IsEnabled() || ttl == 0 || result.code != NAPA_RESULT_SUCCESS) {
+        return;
+    }
+    if (result.transportContext != nullptr && result.transportContext->GetSharedCount() > 0) {
+        return;
+    }
+
+    // A result that can't fit would only evict everything else.
+    auto bytes = key->bytes + result.returnValue.size();
+    if (bytes > _maxBytes) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_access);
+    auto now = Clock::now();
+    PurgeExpired(now);
+
+    auto it = _entryMap.find(key->hash);
+    if (it != _entryMap.end()) {
+        Remove(it->second);
+    }
+
+    auto expiry = _expiries.emplace(now + std::chrono::milliseconds(ttl), key->hash);
+    _entries.emplace_front(Entry { std::move(key), result.returnValue, bytes, expiry });
+    _entryMap.emplace(expiry->second, _entries.begin());
+    _statistics.bytes += bytes;
+
+    while (_statistics.bytes > _maxBytes) {
+        Remove(std::prev(_entries.end()));
+        _statistics.evictions++;
+    }
+}
+
+CacheStatistics ResultCache::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(_access);
+    return _statistics;
+}
+
+void ResultCache::Remove(EntryList::iterator entry) {
+    _statistics.bytes -= entry->bytes;
+    _expiries.erase(entry->expiry);
+    _entryMap.erase(entry->key->hash);
+    _entries.erase(entry);
+}
+
+void ResultCache::PurgeExpired(Clock::time_point now) {
+    while (!_expiries.empty() && _expiries.begin()->first <= now) {
+        Remove(_entryMap.at(_expiries.begin()->second));
+        _statistics.expirations++;
+    }
+}
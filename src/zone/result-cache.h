@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "call-key.h"
+
+#include <napa/types.h>
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     Caches marshalled results of calls to deterministic functions, keyed by module, function and marshalled
+    ///     arguments. Results expire after the time to live of the call that cached them, and least recently used
+    ///     results are evicted to keep the cache within its size.
+    /// </summary>
+    /// <remarks>
+    ///     Only successful results without shared objects are cached, as a cached result is returned with an empty
+    ///     transport context. This class is thread-safe.
+    /// </remarks>
+    class ResultCache {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="maxBytes"> Max bytes of keys and results to keep, 0 to disable the cache. </param>
+        explicit ResultCache(size_t maxBytes);
+
+        /// <summary> Returns true if the cache keeps results. </summary>
+        bool IsEnabled() const;
+
+        /// <summary> Gets the cached result of a call. </summary>
+        /// <param name="spec"> The function spec of the call. </param>
+        /// <param name="result"> Receives the cached result on a hit. </param>
+        /// <returns> True on a hit. </returns>
+        bool Get(const FunctionSpec& spec, Result& result);
+
+        /// <summary> Caches the result of a call, if it's successful and carries no shared objects. </summary>
+        /// <param name="key"> The key of the call, made before it was scheduled. </param>
+        /// <param name="result"> The result of the call. </param>
+        /// <param name="ttl"> Milliseconds to keep the result for. </param>
+        void Set(std::shared_ptr<const CallKey> key, const Result& result, uint32_t ttl);
+
+        /// <summary> Gets counters of the cache. </summary>
+        CacheStatistics GetStatistics() const;
+
+    private:
+        using ExpiryMap = std::multimap<Clock::time_point, uint64_t>;
+
+        struct Entry {
+            std::shared_ptr<const CallKey> key;
+            std::string returnValue;
+            size_t bytes;
+            ExpiryMap::iterator expiry;
+        };
+
+        /// <summary> Entries from most to least recently used. </summary>
+        using EntryList = std::list<Entry>;
+
+        void Remove(EntryList::iterator entry);
+
+        /// <summary> Remove results whose time to live has passed. </summary>
+        void PurgeExpired(Clock::time_point now);
+
+        size_t _maxBytes;
+
+        EntryList _entries;
+        std::unordered_map<uint64_t, EntryList::iterator> _entryMap;
+        ExpiryMap _expiries;
+
+        CacheStatistics _statistics;
+
+        mutable std::mutex _access;
+    };
+}
+}
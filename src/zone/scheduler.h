@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "flow-queue.h"
 #include "schedule-phase.h"
 #include "simple-thread-pool.h"
 #include "task.h"
@@ -13,9 +14,9 @@
 #include <napa/log.h>
 
 #include <atomic>
+#include <chrono>
 #include <list>
 #include <memory>
-#include <queue>
 #include <thread>
 #include <vector>
 
@@ -37,7 +38,9 @@ namespace zone {
 
         /// <summary> Schedules the task on a single worker. </summary>
         /// <param name="task"> Task to schedule. </param>
-        void Schedule(std::shared_ptr<Task> task);
+        /// <param name="flow"> The flow the task waits in while all workers are busy. </param>
+        /// <param name="weight"> The share of workers the flow gets relative to other busy flows. </param>
+        void Schedule(std::shared_ptr<Task> task, FlowId flow = 0, uint32_t weight = 1);
 
         /// <summary> Schedules the task on a specific worker. </summary>
         /// <param name="workerId"> The id of the worker. </param>
@@ -46,11 +49,27 @@ namespace zone {
         /// <remarks>
         /// By design, it enqueues a task immediately,
         /// so the task will have higher priority than ones called by Schedule().
+        /// When called from the thread of the target worker, the task is put on the worker's local queue directly.
         /// </remarks>
         void ScheduleOnWorker(WorkerId workerId,
                               std::shared_ptr<Task> task,
                               SchedulePhase phase = SchedulePhase::DefaultPhase);
 
+        /// <summary> Schedules the task on the calling worker, to run after a delay. </summary>
+        /// <param name="workerId"> The id of the worker, which must be the worker of the calling thread. </param>
+        /// <param name="task"> Task to schedule. </param>
+        /// <param name="delay"> Delay after which the task runs. </param>
+        /// <returns> Id of the timer, to cancel it with CancelOnWorker. </returns>
+        /// <remarks> Timers are kept by the worker itself, so arming and firing them doesn't involve other threads. </remarks>
+        Worker::TimerId ScheduleOnWorkerAfter(WorkerId workerId,
+                                              std::shared_ptr<Task> task,
+                                              std::chrono::milliseconds delay);
+
+        /// <summary> Cancels a delayed task armed by ScheduleOnWorkerAfter, if it didn't run yet. </summary>
+        /// <param name="workerId"> The id of the worker, which must be the worker of the calling thread. </param>
+        /// <param name="timerId"> Id returned by ScheduleOnWorkerAfter. </param>
+        void CancelOnWorker(WorkerId workerId, Worker::TimerId timerId);
+
         /// <summary> Schedules the task on all workers. </summary>
         /// <param name="task"> Task to schedule. </param>
         /// <remarks>
@@ -59,16 +78,25 @@ namespace zone {
         /// </remarks>
         void ScheduleOnAllWorkers(std::shared_ptr<Task> task);
 
+        /// <summary> Returns the number of idle workers, which may change right after it's read. </summary>
+        uint32_t GetIdleWorkerCount() const;
+
+        /// <summary> Gets queue depth and wait time counters of flows with queued tasks and of recently drained ones. </summary>
+        std::vector<FlowStatistics> GetFlowStatistics() const;
+
     private:
 
         /// <summary> The logic invoked when a worker is idle. </summary>
         void IdleWorkerNotificationCallback(WorkerId workerId);
 
+        /// <summary> The logic invoked when an idle worker wakes up by itself to run its timers. </summary>
+        void BusyWorkerNotificationCallback(WorkerId workerId);
+
         /// <summary> The workers that are used for running the tasks. </summary>
         std::vector<WorkerType> _workers;
 
-        /// <summary> New tasks that weren't assigned to a specific worker. </summary>
-        std::queue<std::shared_ptr<Task>> _nonScheduledTasks;
+        /// <summary> New tasks that weren't assigned to a specific worker, queued by flow. </summary>
+        FlowQueue _nonScheduledTasks;
 
         /// <summary> List of idle workers, used when assigning non scheduled tasks. </summary>
         std::list<WorkerId> _idleWorkers;
@@ -76,6 +104,9 @@ namespace zone {
         /// <summary> Flags to indicate that a worker is in the idle list. </summary>
         std::vector<std::list<WorkerId>::iterator> _idleWorkersFlags;
 
+        /// <summary> Size of the idle list, updated by the synchronizer, to read from other threads. </summary>
+        std::atomic<uint32_t> _idleWorkerCount;
+
         /// <summary> Uses a single thread to synchronize task queuing and posting. </summary>
         std::unique_ptr<SimpleThreadPool> _synchronizer;
 
@@ -91,6 +122,7 @@ namespace zone {
     template <typename WorkerType>
     SchedulerImpl<WorkerType>::SchedulerImpl(const settings::ZoneSettings& settings, std::function<void(WorkerId)> workerSetupCallback) :
         _idleWorkersFlags(settings.workers, _idleWorkers.end()),
+        _idleWorkerCount(0),
         _synchronizer(std::make_unique<SimpleThreadPool>(1)),
         _shouldStop(false),
         _beingScheduled(0) {
@@ -100,6 +132,8 @@ namespace zone {
         for (WorkerId i = 0; i < settings.workers; i++) {
             _workers.emplace_back(i, settings, workerSetupCallback, [this](WorkerId workerId) {
                 IdleWorkerNotificationCallback(workerId);
+            }, [this](WorkerId workerId) {
+                BusyWorkerNotificationCallback(workerId);
             });
             _workers[i].Start();
         }
@@ -110,7 +144,7 @@ namespace zone {
         NAPA_DEBUG("Scheduler", "Shutting down: Start draining unscheduled tasks...");
 
         // Wait for all tasks to be scheduled.
-        while (_beingScheduled > 0 || !_nonScheduledTasks.empty()) {
+        while (_beingScheduled > 0 || !_nonScheduledTasks.IsEmpty()) {
             std::this_thread::yield();
         }
 
@@ -127,23 +161,25 @@ namespace zone {
     }
 
     template <typename WorkerType>
-    void SchedulerImpl<WorkerType>::Schedule(std::shared_ptr<Task> task) {
+    void SchedulerImpl<WorkerType>::Schedule(std::shared_ptr<Task> task, FlowId flow, uint32_t weight) {
         NAPA_ASSERT(task, "task is null");
         _beingScheduled++;
-        _synchronizer->Execute([this, task]() {
+        _synchronizer->Execute([this, task, flow, weight]() {
             if (_idleWorkers.empty()) {
-                NAPA_DEBUG("Scheduler", "All workers are busy, putting task to non-scheduled queue.");
+                NAPA_DEBUG("Scheduler", "All workers are busy, putting task to non-scheduled queue of flow %u.", flow);
 
                 // If there is no idle worker, put the task into the non-scheduled queue.
-                _nonScheduledTasks.emplace(std::move(task));
+                _nonScheduledTasks.Push(std::move(task), flow, weight);
             } else {
                 // Pop the worker id from the idle workers list.
                 auto workerId = _idleWorkers.front();
                 _idleWorkers.pop_front();
                 _idleWorkersFlags[workerId] = _idleWorkers.end();
+                _idleWorkerCount = static_cast<uint32_t>(_idleWorkers.size());
 
-                // Schedule task on worker
-                _workers[workerId].Schedule(std::move(task));
+                // The queue is empty while workers are idle, so the task passes straight through it to be counted.
+                _nonScheduledTasks.Push(std::move(task), flow, weight);
+                _workers[workerId].Schedule(_nonScheduledTasks.Pop());
 
                 NAPA_DEBUG("Scheduler", "Scheduled task on worker %u.", workerId);
             }
@@ -157,11 +193,20 @@ namespace zone {
             WorkerId workerId, std::shared_ptr<Task> task, SchedulePhase phase) {
         NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
 
+        // A worker scheduling on itself is busy by definition, so there is no idle list book-keeping to do.
+        if (_workers[workerId].IsCurrentThread()) {
+            _workers[workerId].ScheduleLocal(std::move(task), phase);
+
+            NAPA_DEBUG("Scheduler", "Worker %u scheduled task on itself.", workerId);
+            return;
+        }
+
         _synchronizer->Execute([workerId, this, task, phase]() {
             // If the worker is idle, change it's status.
             if (_idleWorkersFlags[workerId] != _idleWorkers.end()) {
                 _idleWorkers.erase(_idleWorkersFlags[workerId]);
                 _idleWorkersFlags[workerId] = _idleWorkers.end();
+                _idleWorkerCount = static_cast<uint32_t>(_idleWorkers.size());
             }
 
             // Schedule task on worker
@@ -171,6 +216,24 @@ namespace zone {
         });
     }
 
+    template <typename WorkerType>
+    Worker::TimerId SchedulerImpl<WorkerType>::ScheduleOnWorkerAfter(
+            WorkerId workerId, std::shared_ptr<Task> task, std::chrono::milliseconds delay) {
+        NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
+        NAPA_ASSERT(task, "task is null");
+        NAPA_ASSERT(_workers[workerId].IsCurrentThread(), "delayed tasks can only be scheduled from the worker itself");
+
+        return _workers[workerId].ScheduleLocalAfter(std::move(task), delay);
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::CancelOnWorker(WorkerId workerId, Worker::TimerId timerId) {
+        NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
+        NAPA_ASSERT(_workers[workerId].IsCurrentThread(), "delayed tasks can only be cancelled from the worker itself");
+
+        _workers[workerId].CancelLocalTimer(timerId);
+    }
+
     template <typename WorkerType>
     void SchedulerImpl<WorkerType>::ScheduleOnAllWorkers(std::shared_ptr<Task> task) {
         NAPA_ASSERT(task, "task is null");
@@ -181,6 +244,7 @@ namespace zone {
             for (auto& flag : _idleWorkersFlags) {
                 flag = _idleWorkers.end();
             }
+            _idleWorkerCount = 0;
 
             // Schedule the task on all workers.
             for (auto& worker : _workers) {
@@ -190,6 +254,16 @@ namespace zone {
         });
     }
 
+    template <typename WorkerType>
+    uint32_t SchedulerImpl<WorkerType>::GetIdleWorkerCount() const {
+        return _idleWorkerCount;
+    }
+
+    template <typename WorkerType>
+    std::vector<FlowStatistics> SchedulerImpl<WorkerType>::GetFlowStatistics() const {
+        return _nonScheduledTasks.GetStatistics();
+    }
+
     template <typename WorkerType>
     void SchedulerImpl<WorkerType>::IdleWorkerNotificationCallback(WorkerId workerId) {
         NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
@@ -199,10 +273,9 @@ namespace zone {
         }
 
         _synchronizer->Execute([this, workerId]() {
-            if (!_nonScheduledTasks.empty()) {
+            auto task = _nonScheduledTasks.Pop();
+            if (task != nullptr) {
                 // If there is a non scheduled task, schedule it on the idle worker.
-                auto task = _nonScheduledTasks.front();
-                _nonScheduledTasks.pop();
                 _workers[workerId].Schedule(std::move(task));
 
                 NAPA_DEBUG("Scheduler", "Worker %u fetched a task from non-scheduled queue", workerId);
@@ -211,11 +284,32 @@ namespace zone {
                 if (_idleWorkersFlags[workerId] == _idleWorkers.end()) {
                     auto iter = _idleWorkers.emplace(_idleWorkers.end(), workerId);
                     _idleWorkersFlags[workerId] = iter;
+                    _idleWorkerCount = static_cast<uint32_t>(_idleWorkers.size());
 
                     NAPA_DEBUG("Scheduler", "Worker %u becomes idle", workerId);
                 }
             }
         });
     }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::BusyWorkerNotificationCallback(WorkerId workerId) {
+        NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
+
+        if (_shouldStop) {
+            return;
+        }
+
+        _synchronizer->Execute([this, workerId]() {
+            // The worker runs its timers now, take it off the idle list until it notifies idle again.
+            if (_idleWorkersFlags[workerId] != _idleWorkers.end()) {
+                _idleWorkers.erase(_idleWorkersFlags[workerId]);
+                _idleWorkersFlags[workerId] = _idleWorkers.end();
+                _idleWorkerCount = static_cast<uint32_t>(_idleWorkers.size());
+
+                NAPA_DEBUG("Scheduler", "Worker %u woke up for its timers", workerId);
+            }
+        });
+    }
 }
 }
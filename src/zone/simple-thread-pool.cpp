@@ -8,7 +8,7 @@ using namespace napa::zone;
 SimpleThreadPool::Worker::Worker(SimpleThreadPool& pool) : _pool(pool) {}
 
 void SimpleThreadPool::Worker::operator()() {
-    std::function<void()> task;
+    utils::SmallFunction<void()> task;
 
     while (true) {
         {
@@ -3,10 +3,12 @@
 
 #pragma once
 
+#include <utils/ring-queue.h>
+#include <utils/small-function.h>
+
 #include <condition_variable>
 #include <functional>
 #include <mutex>
-#include <queue>
 #include <stdint.h>
 #include <thread>
 #include <utility>
@@ -51,7 +53,8 @@ namespace zone {
         };
 
         std::vector<std::thread> _workers;
-        std::queue<std::function<void()>> _taskQueue;
+        /// <summary> Queued functions, stored inline so scheduling a small lambda doesn't allocate. </summary>
+        utils::RingQueue<utils::SmallFunction<void()>> _taskQueue;
 
         /// <summary> Critical section and event for task queue. </summary>
         std::mutex _queueLock;
@@ -68,7 +71,7 @@ namespace zone {
 
         {
             std::unique_lock<std::mutex> lock(_queueLock);
-            _taskQueue.emplace(task);
+            _taskQueue.emplace(std::move(task));
         }
 
         _queueCondition.notify_one();
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "single-flight.h"
+
+#include <napa/log.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+bool SingleFlight::Join(const FunctionSpec& spec, ExecuteCallback& callback) {
+    auto hash = CallKey::Hash(spec);
+
+    std::lock_guard<std::mutex> lock(_access);
+    auto it = _flights.find(hash);
+    if (it != _flights.end()) {
+        // A different call with the same hash runs on its own, and can't start a flight meanwhile.
+        if (!it->second->key.Matches(spec)) {
+            return false;
+        }
+        it->second->waiters.emplace_back(std::move(callback));
+        _joinCount++;
+
+        NAPA_DEBUG("Zone", "Call to \"%s.%s\" joined an identical call in flight.", spec.module.data, spec.function.data);
+        return true;
+    }
+
+    auto flight = std::make_shared<Flight>(Flight { CallKey(spec), {} });
+    _flights.emplace(hash, flight);
+
+    callback = [self = shared_from_this(), flight = std::move(flight), callback = std::move(callback)](Result result) mutable {
+        self->Complete(flight, callback, std::move(result));
+    };
+    return false;
+}
+
+uint64_t SingleFlight::GetJoinCount() const {
+    std::lock_guard<std::mutex> lock(_access);
+    return _joinCount;
+}
+
+void SingleFlight::Complete(const std::shared_ptr<Flight>& flight, ExecuteCallback& callback, Result result) {
+    std::vector<ExecuteCallback> waiters;
+    {
+        std::lock_guard<std::mutex> lock(_access);
+        _flights.erase(flight->key.hash);
+        waiters.swap(flight->waiters);
+    }
+
+    for (auto& waiter : waiters) {
+        Result copy;
+        copy.code = result.code;
+        copy.errorMessage = result.errorMessage;
+        copy.returnValue = result.returnValue;
+        copy.transportContext = result.transportContext != nullptr
+            ? result.transportContext->Clone()
+            : std::make_unique<transport::TransportContext>();
+        copy.accounting = result.accounting;
+        waiter(std::move(copy));
+    }
+    callback(std::move(result));
+}
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "call-key.h"
+
+#include <napa/types.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     Coalesces identical calls in flight, so that one execution completes all of them. Calls are identical
+    ///     when they have the same module, function and marshalled arguments, while their options may differ:
+    ///     calls joining a flight get the result of its first call, including its errors and timeouts.
+    /// </summary>
+    /// <remarks> This class is thread-safe. </remarks>
+    class SingleFlight : public std::enable_shared_from_this<SingleFlight> {
+    public:
+        /// <summary> Joins an identical call in flight, or starts a flight for the call. </summary>
+        /// <param name="spec"> The function spec of the call. </param>
+        /// <param name="callback">
+        ///     The callback of the call. It's taken over on joining, otherwise it's replaced by the callback that
+        ///     completes the flight, which must be passed to the execution of the call.
+        /// </param>
+        /// <returns> True if the call joined a flight, so it must not be executed. </returns>
+        bool Join(const FunctionSpec& spec, ExecuteCallback& callback);
+
+        /// <summary> Returns the number of calls that joined a flight instead of executing. </summary>
+        uint64_t GetJoinCount() const;
+
+    private:
+        struct Flight {
+            CallKey key;
+            std::vector<ExecuteCallback> waiters;
+        };
+
+        /// <summary> Ends a flight, calling back its waiters with copies of the result and then its first call. </summary>
+        void Complete(const std::shared_ptr<Flight>& flight, ExecuteCallback& callback, Result result);
+
+        std::unordered_map<uint64_t, std::shared_ptr<Flight>> _flights;
+        uint64_t _joinCount = 0;
+        mutable std::mutex _access;
+    };
+}
+}
@@ -7,6 +7,8 @@
 #include <platform/process.h>
 #include <platform/thread-local.h>
 #include <array>
+#include <functional>
+#include <vector>
 
 using namespace napa;
 using namespace napa::zone;
@@ -15,11 +17,15 @@ namespace {
     tls::ThreadLocal<std::array<
         void*,
         static_cast<size_t>(WorkerContextItem::END_OF_WORKER_CONTEXT_ITEM)>> items;
+
+    tls::ThreadLocal<std::vector<std::function<void()>>> exitCallbacks;
 }
 
 void WorkerContext::Init() {
     items.Install();
     items->fill(nullptr);
+
+    exitCallbacks.Install();
 }
 
 void* WorkerContext::Get(WorkerContextItem item) {
@@ -30,4 +36,22 @@ void* WorkerContext::Get(WorkerContextItem item) {
 void WorkerContext::Set(WorkerContextItem item, void* data) {
     NAPA_ASSERT(item < WorkerContextItem::END_OF_WORKER_CONTEXT_ITEM, "Invalid WorkerContextItem");
     (*items)[static_cast<size_t>(item)] = data;
-}
\ No newline at end of file
+}
+
+void WorkerContext::AddExitCallback(std::function<void()> callback) {
+    NAPA_ASSERT(exitCallbacks.operator->() != nullptr, "Worker context is not initialized");
+    exitCallbacks->push_back(std::move(callback));
+}
+
+void WorkerContext::RunExitCallbacks() {
+    // Threads that never initialized worker context have nothing to run.
+    if (exitCallbacks.operator->() == nullptr) {
+        return;
+    }
+
+    std::vector<std::function<void()>> callbacks;
+    callbacks.swap(*exitCallbacks);
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
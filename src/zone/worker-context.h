@@ -6,6 +6,8 @@
 #include <napa/exports.h>
 
 #include <array>
+#include <cstdint>
+#include <functional>
 
 namespace napa {
 namespace zone {
@@ -50,6 +52,13 @@ namespace zone {
         /// <param name="item"> Pre-defined data id for Napa specific data. </param>
         /// <param name="data"> Pointer to stored data. </param>
         static void Set(WorkerContextItem item, void* data);
+
+        /// <summary> Register a callback to run on this worker thread when it stops, while its isolate is still alive. </summary>
+        /// <param name="callback"> Callback to release resources bound to the isolate of the worker. </param>
+        static void AddExitCallback(std::function<void()> callback);
+
+        /// <summary> Run and clear the exit callbacks of this thread. Called by the worker once it stops serving tasks. </summary>
+        static void RunExitCallbacks();
     };
 
     #define INIT_WORKER_CONTEXT napa::zone::WorkerContext::Init
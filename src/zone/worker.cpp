@@ -2,16 +2,24 @@
 // Licensed under the MIT license.
 
 #include "worker.h"
+#include "idle-strategy.h"
+#include "worker-context.h"
 
 #include <napa/log.h>
+#include <utils/ring-queue.h>
 
 #include <v8.h>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdlib>
+#include <map>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <v8-extensions/v8-extensions-macros.h>
 #if !(V8_VERSION_CHECK_FOR_ARRAY_BUFFER_ALLOCATOR)
@@ -25,6 +33,9 @@ using namespace napa::zone;
 static v8::Isolate* CreateIsolate(const settings::ZoneSettings& settings);
 static void ConfigureIsolate(v8::Isolate* isolate, const settings::ZoneSettings& settings);
 
+/// <summary> Key of a local timer. Timers with the same deadline fire in arming order. </summary>
+using LocalTimerKey = std::pair<std::chrono::steady_clock::time_point, Worker::TimerId>;
+
 struct Worker::Impl {
 
     /// <summary> The worker id. </summary>
@@ -34,17 +45,44 @@ struct Worker::Impl {
     std::thread workerThread;
 
     /// <summary> Queue for tasks scheduled on this worker. </summary>
-    std::queue<std::shared_ptr<Task>> tasks;
+    utils::RingQueue<std::shared_ptr<Task>> tasks;
+
+    /// <summary> Queue for immediate tasks scheduled on this worker. </summary>
+    utils::RingQueue<std::shared_ptr<Task>> immediateTasks;
+
+    /// <summary> Number of tasks in the two queues above, readable without taking the queue lock. </summary>
+    std::atomic<size_t> sharedTaskCount;
+
+    /// <summary> Queue for tasks the worker scheduled on itself. Only accessed by the worker thread. </summary>
+    utils::RingQueue<std::shared_ptr<Task>> localTasks;
+
+    /// <summary> Queue for immediate tasks the worker scheduled on itself. Only accessed by the worker thread. </summary>
+    utils::RingQueue<std::shared_ptr<Task>> localImmediateTasks;
+
+    /// <summary> Delayed tasks the worker scheduled on itself, closest to expire first. Only accessed by the worker thread. </summary>
+    std::map<LocalTimerKey, std::shared_ptr<Task>> localTimers;
+
+    /// <summary> Deadline of each armed timer by id, to find it when it's cancelled. Only accessed by the worker thread. </summary>
+    std::unordered_map<TimerId, std::chrono::steady_clock::time_point> localTimerDeadlines;
+
+    /// <summary> Number of timers armed so far, used as timer id and to order timers with the same deadline. </summary>
+    TimerId localTimerSequence;
+
+    /// <summary> Id of the thread that executes the tasks, set once the thread starts. </summary>
+    std::atomic<std::thread::id> threadId;
 
-    /// <summary> Queue for tasks scheduled on this worker. </summary>
-    std::queue<std::shared_ptr<Task>> immediateTasks;
-    
     /// <summary> Condition variable to indicate if there are more tasks to consume. </summary>
     std::condition_variable hasTaskEvent;
 
     /// <summary> Lock for task queue and immediate task queue. </summary>
     std::mutex queueLock;
 
+    /// <summary> Whether the worker thread waits on hasTaskEvent. Guarded by queueLock. </summary>
+    bool parked;
+
+    /// <summary> Decides how long the worker spins before parking. Only accessed by the worker thread. </summary>
+    IdleStrategy idleStrategy;
+
     /// <summary> V8 isolate associated with this worker. </summary>
     v8::Isolate* isolate;
 
@@ -54,19 +92,32 @@ struct Worker::Impl {
     /// <summary> A callback function that is called when worker becomes idle. </summary>
     std::function<void(WorkerId)> idleNotificationCallback;
 
+    /// <summary> A callback function that is called when an idle worker wakes up to run its own timers. </summary>
+    std::function<void(WorkerId)> busyNotificationCallback;
+
     /// <summary> The zone settings for the current worker. </summary>
     settings::ZoneSettings settings;
+
+    explicit Impl(const settings::ZoneSettings& settings)
+        : idleStrategy(std::chrono::microseconds(settings.idleSpinMicroseconds)) {
+    }
 };
 
 Worker::Worker(WorkerId id,
                const settings::ZoneSettings& settings,
                std::function<void(WorkerId)> setupCallback,
-               std::function<void(WorkerId)> idleNotificationCallback)
-    : _impl(std::make_unique<Worker::Impl>()) {
+               std::function<void(WorkerId)> idleNotificationCallback,
+               std::function<void(WorkerId)> busyNotificationCallback)
+    : _impl(std::make_unique<Worker::Impl>(settings)) {
 
     _impl->id = id;
+    _impl->sharedTaskCount = 0;
+    _impl->localTimerSequence = 0;
+    _impl->parked = false;
+    _impl->threadId = std::thread::id();
     _impl->setupCallback = std::move(setupCallback);
     _impl->idleNotificationCallback = std::move(idleNotificationCallback);
+    _impl->busyNotificationCallback = std::move(busyNotificationCallback);
     _impl->settings = settings;
 }
 
@@ -96,7 +147,52 @@ void Worker::Schedule(std::shared_ptr<Task> task, SchedulePhase phase) {
     NAPA_DEBUG("Worker", "(id=%u) Task queued.", _impl->id);
 }
 
+void Worker::ScheduleLocal(std::shared_ptr<Task> task, SchedulePhase phase) {
+    NAPA_ASSERT(task != nullptr, "Task should not be null");
+    NAPA_ASSERT(IsCurrentThread(), "ScheduleLocal must be called from the worker thread");
+
+    if (phase == SchedulePhase::ImmediatePhase) {
+        _impl->localImmediateTasks.emplace(std::move(task));
+    }
+    else {
+        _impl->localTasks.emplace(std::move(task));
+    }
+    NAPA_DEBUG("Worker", "(id=%u) Task queued locally.", _impl->id);
+}
+
+Worker::TimerId Worker::ScheduleLocalAfter(std::shared_ptr<Task> task, std::chrono::milliseconds delay) {
+    NAPA_ASSERT(task != nullptr, "Task should not be null");
+    NAPA_ASSERT(IsCurrentThread(), "ScheduleLocalAfter must be called from the worker thread");
+
+    auto timerId = ++_impl->localTimerSequence;
+    auto deadline = std::chrono::steady_clock::now() + delay;
+    _impl->localTimers.emplace(LocalTimerKey(deadline, timerId), std::move(task));
+    _impl->localTimerDeadlines.emplace(timerId, deadline);
+
+    NAPA_DEBUG("Worker", "(id=%u) Task armed on local timer in %lld ms.", _impl->id, static_cast<long long>(delay.count()));
+    return timerId;
+}
+
+void Worker::CancelLocalTimer(TimerId timerId) {
+    NAPA_ASSERT(IsCurrentThread(), "CancelLocalTimer must be called from the worker thread");
+
+    // The timer may have fired already, in which case there is nothing to cancel.
+    auto it = _impl->localTimerDeadlines.find(timerId);
+    if (it == _impl->localTimerDeadlines.end()) {
+        return;
+    }
+
+    _impl->localTimers.erase(LocalTimerKey(it->second, timerId));
+    _impl->localTimerDeadlines.erase(it);
+    NAPA_DEBUG("Worker", "(id=%u) Local timer cancelled.", _impl->id);
+}
+
+bool Worker::IsCurrentThread() const {
+    return _impl->threadId.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
 void Worker::Enqueue(std::shared_ptr<Task> task, SchedulePhase phase) {
+    bool parked;
     {
         std::unique_lock<std::mutex> lock(_impl->queueLock);
         if (phase == SchedulePhase::ImmediatePhase && task != nullptr) {
@@ -105,12 +201,50 @@ void Worker::Enqueue(std::shared_ptr<Task> task, SchedulePhase phase) {
         else {
             _impl->tasks.emplace(std::move(task));
         }
+        _impl->sharedTaskCount++;
+        parked = _impl->parked;
+    }
+
+    // A spinning worker picks the task up by itself, without the cost of a wake up.
+    if (parked) {
+        _impl->hasTaskEvent.notify_one();
+    }
+}
+
+void Worker::FireExpiredTimers() {
+    if (_impl->localTimers.empty()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    while (!_impl->localTimers.empty() && _impl->localTimers.begin()->first.first <= now) {
+        // Expired timers run as normal local tasks, in expiration order.
+        auto it = _impl->localTimers.begin();
+        _impl->localTasks.emplace(std::move(it->second));
+        _impl->localTimerDeadlines.erase(it->first.second);
+        _impl->localTimers.erase(it);
+    }
+}
+
+std::shared_ptr<Task> Worker::DequeueLocal() {
+    std::shared_ptr<Task> task;
+
+    // Local tasks only come from this thread, so they can be consumed without the queue lock
+    // as long as no shared task would have been picked before them.
+    if (!_impl->localImmediateTasks.empty()) {
+        task = std::move(_impl->localImmediateTasks.front());
+        _impl->localImmediateTasks.pop();
     }
-    _impl->hasTaskEvent.notify_one();
+    else if (!_impl->localTasks.empty() && _impl->sharedTaskCount.load(std::memory_order_acquire) == 0) {
+        task = std::move(_impl->localTasks.front());
+        _impl->localTasks.pop();
+    }
+    return task;
 }
 
 void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
-    
+    _impl->threadId = std::this_thread::get_id();
+
     _impl->isolate = CreateIsolate(settings);
 
     // If any user of v8 library uses a locker on any isolate, all isolates must be locked before use.
@@ -135,36 +269,83 @@ void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
     NAPA_DEBUG("Worker", "(id=%u) Setup completed.", _impl->id);
 
     while (true) {
-        std::shared_ptr<Task> task;
+        FireExpiredTimers();
+
+        std::shared_ptr<Task> task = DequeueLocal();
 
-        {
-            // Logically one merged task queue is the concatenation of immediate queue and
-            // the normal queue. The logically merged queue is treated as empty only when both queues
-            // are empty. And when not empty, immediate tasks will be handled prior to normal tasks.
-            // Inside each single queue (immediate or normal), tasks are first in first out.
+        if (task == nullptr) {
+            // Logically one merged task queue is the concatenation of immediate queues and
+            // the normal queues. The logically merged queue is treated as empty only when all queues
+            // are empty. And when not empty, immediate tasks will be handled prior to normal tasks,
+            // and local tasks prior to shared tasks of the same phase.
+            // Inside each single queue, tasks are first in first out.
             std::unique_lock<std::mutex> lock(_impl->queueLock);
-            if (_impl->tasks.empty() && _impl->immediateTasks.empty()) {
+            if (_impl->tasks.empty() && _impl->immediateTasks.empty() && _impl->localTasks.empty()) {
                 _impl->idleNotificationCallback(_impl->id);
 
-                // Wait until new tasks come.
-                _impl->hasTaskEvent.wait(
-                    lock, 
-                    [this]() { return !(_impl->tasks.empty() && _impl->immediateTasks.empty()); });
+                std::chrono::steady_clock::time_point idleStart;
+                if (_impl->idleStrategy.IsEnabled()) {
+                    idleStart = std::chrono::steady_clock::now();
+
+                    // Spin without the lock so producers don't contend with us, watching the shared task count.
+                    lock.unlock();
+                    _impl->idleStrategy.Spin([this]() {
+                        return _impl->sharedTaskCount.load(std::memory_order_acquire) > 0;
+                    });
+                    lock.lock();
+                }
+
+                // Wait until new tasks come, or until the next local timer expires.
+                auto hasSharedTask = [this]() { return !(_impl->tasks.empty() && _impl->immediateTasks.empty()); };
+                bool hasTask = true;
+                _impl->parked = true;
+                if (_impl->localTimers.empty()) {
+                    _impl->hasTaskEvent.wait(lock, hasSharedTask);
+                }
+                else {
+                    hasTask = _impl->hasTaskEvent.wait_until(lock, _impl->localTimers.begin()->first.first, hasSharedTask);
+                }
+                _impl->parked = false;
+
+                if (_impl->idleStrategy.IsEnabled()) {
+                    _impl->idleStrategy.RecordIdle(std::chrono::steady_clock::now() - idleStart);
+                }
+
+                if (!hasTask) {
+                    // Timer expired before any task came. The worker is still in the idle list,
+                    // so leave it before running the timers to not be handed tasks while busy.
+                    lock.unlock();
+                    _impl->busyNotificationCallback(_impl->id);
+                    continue;
+                }
             }
 
-            if (_impl->immediateTasks.empty()) {
-                task = _impl->tasks.front();
-                _impl->tasks.pop();
+            if (!_impl->immediateTasks.empty()) {
+                task = std::move(_impl->immediateTasks.front());
+                _impl->immediateTasks.pop();
+                _impl->sharedTaskCount--;
+            }
+            else if (!_impl->localTasks.empty()) {
+                task = std::move(_impl->localTasks.front());
+                _impl->localTasks.pop();
             }
             else {
-                task = _impl->immediateTasks.front();
-                _impl->immediateTasks.pop();
+                task = std::move(_impl->tasks.front());
+                _impl->tasks.pop();
+                _impl->sharedTaskCount--;
             }
         }
 
         // A null task means that the worker needs to shutdown.
         if (task == nullptr) {
             NAPA_DEBUG("Worker", "(id=%u) Finish serving tasks.", _impl->id);
+
+            // Timers that didn't fire yet never will, release them while their isolate is still alive.
+            _impl->localTimers.clear();
+            _impl->localTimerDeadlines.clear();
+
+            // Let modules release what they bound to the isolate, like store watches.
+            WorkerContext::RunExitCallbacks();
             break;
         }
 
@@ -7,6 +7,7 @@
 #include "schedule-phase.h"
 #include "settings/settings.h"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -21,15 +22,20 @@ namespace zone {
     class Worker {
     public:
 
+        /// <summary> Identifies a timer armed by ScheduleLocalAfter. </summary>
+        using TimerId = uint64_t;
+
         /// <summary> Constructor. </summary>
         /// <param name="id"> The task id. </param>
         /// <param name="settings"> A settings object. </param>
         /// <param name="setupCallback"> Callback to setup the isolate after worker created its isolate. </param>
         /// <param name="idleNotificationCallback"> Triggers when the worker becomes idle. </param>
+        /// <param name="busyNotificationCallback"> Triggers when an idle worker wakes up to run expired timers. </param>
         Worker(WorkerId id,
                const settings::ZoneSettings &settings,
                std::function<void(WorkerId)> setupCallback,
-               std::function<void(WorkerId)> idleNotificationCallback);
+               std::function<void(WorkerId)> idleNotificationCallback,
+               std::function<void(WorkerId)> busyNotificationCallback);
 
         /// <summary> Destructor. </summary>
         /// <note> This will block until all pending tasks are completed. </note>
@@ -51,6 +57,33 @@ namespace zone {
         /// <note> Same task instance may run on multiple workers, hence the use of shared_ptr. </node>
         void Schedule(std::shared_ptr<Task> task, SchedulePhase phase=SchedulePhase::DefaultPhase);
 
+        /// <summary> Schedules a task on this worker from the worker's own thread. </summary>
+        /// <param name="task"> Task to schedule. </param>
+        /// <param name="phase"> Which phase of the task, like Immediate or Normal. </param>
+        /// <remarks>
+        /// The task goes to a run queue only touched by the worker thread, so no lock or signal is needed.
+        /// Must only be called when IsCurrentThread() is true.
+        /// </remarks>
+        void ScheduleLocal(std::shared_ptr<Task> task, SchedulePhase phase=SchedulePhase::DefaultPhase);
+
+        /// <summary> Schedules a task on this worker from the worker's own thread, to run after a delay. </summary>
+        /// <param name="task"> Task to schedule. </param>
+        /// <param name="delay"> Delay after which the task becomes runnable. </param>
+        /// <returns> Id of the timer, to cancel it with CancelLocalTimer. </returns>
+        /// <remarks>
+        /// The task is kept in a timer heap owned by the worker, which waits on it with the task queues.
+        /// Must only be called when IsCurrentThread() is true.
+        /// </remarks>
+        TimerId ScheduleLocalAfter(std::shared_ptr<Task> task, std::chrono::milliseconds delay);
+
+        /// <summary> Removes a timer armed by ScheduleLocalAfter, releasing its task. No-op if it already fired. </summary>
+        /// <param name="timerId"> Id returned by ScheduleLocalAfter. </param>
+        /// <remarks> Must only be called when IsCurrentThread() is true. </remarks>
+        void CancelLocalTimer(TimerId timerId);
+
+        /// <summary> Returns true if the calling thread is the thread of this worker. </summary>
+        bool IsCurrentThread() const;
+
     private:
 
         /// <summary> The worker thread logic. </summary>
@@ -58,6 +91,12 @@ namespace zone {
 
         /// <summary> Enqueue a task. </summary>
         void Enqueue(std::shared_ptr<Task> task, SchedulePhase phase);
+
+        /// <summary> Move expired local timers to the local task queue. Called from the worker thread. </summary>
+        void FireExpiredTimers();
+
+        /// <summary> Dequeue a local task if one can run before any shared task. Called from the worker thread. </summary>
+        std::shared_ptr<Task> DequeueLocal();
         
         struct Impl;
         std::unique_ptr<Impl> _impl;
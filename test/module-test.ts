@@ -46,6 +46,18 @@ describe('napajs/module', function () {
             });
         });
 
+        it('json module loaded by multiple workers', () => {
+            let jsonZone = napa.zone.create('module-tests-json-zone', { workers: 2 });
+            return jsonZone.broadcast(() => {
+                var assert = require("assert");
+                var jsonModule = require('./module/test.json');
+
+                assert.notEqual(jsonModule, undefined);
+                assert.equal(jsonModule.prop1, "val1");
+                assert.equal(jsonModule.prop2, "val2");
+            });
+        });
+
         it('napa module', () => {
             return napaZone.execute(() => {
                 var assert = require("assert");
@@ -90,6 +102,63 @@ describe('napajs/module', function () {
                 }
             });
         });
+
+        it('module created by node after a failed require', async () => {
+            let fs = require('fs');
+            let modulePath = path.resolve(__dirname, `module/created-later-${process.pid}.js`);
+            let requireIt = (file: string) => {
+                try {
+                    return require(file).value;
+                } catch (e) {
+                    return null;
+                }
+            };
+
+            try {
+                assert.strictEqual((await napaZone.execute(requireIt, [modulePath])).value, null);
+
+                // Node's fs doesn't invalidate the cache, so the failed lookup sticks until it's invalidated.
+                fs.writeFileSync(modulePath, 'module.exports.value = 1;');
+                assert.strictEqual((await napaZone.execute(requireIt, [modulePath])).value, null);
+
+                napa.module.invalidateCache(modulePath);
+                assert.strictEqual((await napaZone.execute(requireIt, [modulePath])).value, 1);
+            } finally {
+                fs.unlinkSync(modulePath);
+            }
+        });
+    });
+
+    describe('bundle', function () {
+        it('zone reads bundled sources instead of files', async () => {
+            let fs = require('fs');
+            let modulePath = path.resolve(__dirname, `module/bundled-${process.pid}.js`);
+            let bundlePath = path.resolve(__dirname, `module/bundled-${process.pid}.bundle`);
+
+            try {
+                fs.writeFileSync(modulePath, 'module.exports.value = "bundled";');
+                napa.module.writeBundle(bundlePath, [{ name: `./bundled-${process.pid}`, from: path.dirname(modulePath) }]);
+
+                // The bundle keeps the source it was written with.
+                fs.writeFileSync(modulePath, 'module.exports.value = "changed";');
+                let bundleZone = napa.zone.create(`module-tests-bundle-zone-${process.pid}`, { workers: 1, bundle: bundlePath });
+                let result = await bundleZone.execute((dir: string, name: string) => {
+                    return require(require('path').join(dir, name)).value;
+                }, [path.dirname(modulePath), `bundled-${process.pid}`]);
+                assert.strictEqual(result.value, 'bundled');
+            } finally {
+                fs.unlinkSync(modulePath);
+                if (fs.existsSync(bundlePath)) {
+                    fs.unlinkSync(bundlePath);
+                }
+            }
+        });
+
+        it('unresolved require fails the bundle', () => {
+            assert.throws(() => {
+                napa.module.writeBundle(path.resolve(__dirname, `module/missing-${process.pid}.bundle`), ['./no-such-module']);
+            });
+        });
     });
 
     describe('resolve', function () {
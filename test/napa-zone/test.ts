@@ -206,6 +206,21 @@ export function storeDelete(storeId: string, key: string) {
     store.delete(key);
 }
 
+export function storeIncrement(storeId: string, key: string, delta: number) {
+    let store = napa.store.get(storeId);
+    return store.increment(key, delta);
+}
+
+export function sharedStoreVerifyGet(storeId: string, key: string, expectedValue: any) {
+    let store = napa.store.getShared(storeId);
+    assert.deepEqual(store.get(key), expectedValue);
+}
+
+export function sharedStoreSet(storeId: string, key: string, value: any) {
+    let store = napa.store.getShared(storeId);
+    store.set(key, value);
+}
+
 export function storeVerifyNotExist(storeId: string, key: string) {
     let store = napa.store.get(storeId);
     assert(!store.has(key));
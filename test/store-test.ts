@@ -166,4 +166,152 @@ describe('napajs/store', function () {
         // delete 'a', 'b', 'c', 'd'
         assert.equal(store1.size, 6);
     });
+
+    it('maxEntries: evict least recently used', () => {
+        let lru = napa.store.create('store-lru', { maxEntries: 2 });
+        lru.set('a', 1);
+        lru.set('b', 2);
+        assert.equal(lru.get('a'), 1);
+        lru.set('c', 3);
+        assert.equal(lru.size, 2);
+        assert(lru.has('a'));
+        assert(!lru.has('b'));
+        assert(lru.has('c'));
+        assert.equal(lru.get('b'), undefined);
+
+        let statistics = lru.statistics;
+        assert.equal(statistics.hits, 1);
+        assert.equal(statistics.misses, 1);
+        assert.equal(statistics.evictions, 1);
+    });
+
+    it('ttl: expire keys', async () => {
+        let ttlStore = napa.store.create('store-ttl', { ttl: 50 });
+        ttlStore.set('a', 1);
+        ttlStore.set('b', 2, 0);
+        assert(ttlStore.has('a'));
+        await new Promise(resolve => setTimeout(resolve, 100));
+        assert(!ttlStore.has('a'));
+        assert.equal(ttlStore.get('b'), 2);
+        assert.equal(ttlStore.statistics.expirations, 1);
+    });
+
+    it('compressThreshold: compress large values', async () => {
+        let compressed = napa.store.create('store-compress', { compressThreshold: 1024 });
+        let large = { items: new Array(200).fill({ name: 'item', tags: ['a', 'b', '中文'] }) };
+        compressed.set('large', large);
+        compressed.set('small', { name: 'item' });
+        assert.deepEqual(compressed.get('large'), large);
+        await napaZone.execute('./napa-zone/test', "storeVerifyGet", ['store-compress', 'large', large]);
+        assert.deepEqual(compressed.get('small'), { name: 'item' });
+
+        let statistics = compressed.statistics;
+        assert(statistics.compressedBytes > 0);
+        assert(statistics.compressedBytes < statistics.bytes);
+        assert(statistics.bytes < statistics.rawBytes);
+    });
+
+        it('getMany/setMany', () => {
+        let batch = napa.store.create('store-batch');
+        batch.setMany({ a: 1, b: 'hello', c: { x: [1, 2] } });
+        assert.equal(batch.size, 3);
+        assert.deepEqual(batch.getMany(['a', 'not-exist', 'c', 'b']), [1, undefined, { x: [1, 2] }, 'hello']);
+    });
+
+    it('version/compareAndSet', () => {
+        let cas = napa.store.create('store-cas');
+        assert.equal(cas.version('a'), 0);
+        assert(cas.compareAndSet('a', 1, 0));
+        assert(!cas.compareAndSet('a', 2, 0));
+
+        let version = cas.version('a');
+        assert(version > 0);
+        cas.set('a', 3);
+        assert(!cas.compareAndSet('a', 4, version));
+        assert.equal(cas.get('a'), 3);
+        assert(cas.compareAndSet('a', 5, cas.version('a')));
+        assert.equal(cas.get('a'), 5);
+    });
+
+    it('increment in node and napa', async () => {
+        let counter = napa.store.create('store-counter');
+        assert.equal(counter.increment('n'), 1);
+        assert.equal(counter.increment('n', 2.5), 3.5);
+        await Promise.all([
+            napaZone.execute('./napa-zone/test', "storeIncrement", ['store-counter', 'n', 2]),
+            napaZone.execute('./napa-zone/test', "storeIncrement", ['store-counter', 'n', 2])
+        ]);
+        assert.equal(counter.get('n'), 7.5);
+
+        counter.set('s', 'not a number');
+        assert.throws(() => { counter.increment('s'); });
+    });
+
+    it('getOrCompute', () => {
+        let computeStore = napa.store.create('store-compute');
+        let calls = 0;
+        let compute = () => { ++calls; return { value: 1 }; };
+        assert.deepEqual(computeStore.getOrCompute('a', compute), { value: 1 });
+        assert.deepEqual(computeStore.getOrCompute('a', compute), { value: 1 });
+        assert.equal(calls, 1);
+
+        let statistics = computeStore.statistics;
+        assert.equal(statistics.misses, 1);
+        assert.equal(statistics.hits, 1);
+    });
+
+    it('save/load', () => {
+        let snapshotPath = path.resolve(__dirname, 'store-test.snapshot');
+        let saved = napa.store.create('store-save');
+        saved.set('a', 1);
+        saved.set('b', { x: 'unicode 中文' }, 60000);
+        saved.set('c', napa.memory.crtAllocator);
+        assert.equal(saved.save(snapshotPath), 2);
+
+        let loaded = napa.store.create('store-load');
+        assert.equal(loaded.load(snapshotPath), 2);
+        assert.equal(loaded.get('a'), 1);
+        assert.deepEqual(loaded.get('b'), { x: 'unicode 中文' });
+        assert(!loaded.has('c'));
+        assert.throws(() => { loaded.load(path.resolve(__dirname, 'not-exist.snapshot')); });
+    });
+
+    it('watch/unwatch', async () => {
+        let watched = napa.store.create('store-watch');
+        let keyChanges: [string, number][] = [];
+        let prefixChanges: [string, number][] = [];
+        let keyWatch = watched.watch('a', (key, version) => { keyChanges.push([key, version]); });
+        watched.watch({ prefix: 'user.' }, (key, version) => { prefixChanges.push([key, version]); });
+
+        watched.set('a', 1);
+        let version = watched.version('a');
+        watched.set('b', 1);
+        await napaZone.execute('./napa-zone/test', "storeSet", ['store-watch', 'user.1', 1]);
+        watched.delete('user.1');
+        await new Promise(resolve => setTimeout(resolve, 50));
+        assert.deepEqual(keyChanges, [['a', version]]);
+        assert.deepEqual(prefixChanges.map(change => change[0]), ['user.1', 'user.1']);
+        assert.equal(prefixChanges[1][1], 0);
+
+        watched.unwatch(keyWatch);
+        watched.set('a', 2);
+        await new Promise(resolve => setTimeout(resolve, 50));
+        assert.equal(keyChanges.length, 1);
+    });
+
+    it('shared store: set in node, get in napa', async () => {
+        let sharedId = 'store-test-shared-' + process.pid;
+        let shared = napa.store.createShared(sharedId, { maxEntries: 16, maxBytes: 4096 });
+        assert.throws(() => { napa.store.createShared(sharedId); });
+        assert.equal(napa.store.getShared(sharedId).id, sharedId);
+
+        shared.set('a', { x: 1 });
+        assert.equal(shared.increment('n'), 1);
+        assert.throws(() => { shared.set('allocator', napa.memory.crtAllocator); });
+
+        await napaZone.execute('./napa-zone/test', "sharedStoreVerifyGet", [sharedId, 'a', { x: 1 }]);
+        await napaZone.execute('./napa-zone/test', "sharedStoreSet", [sharedId, 'b', 2]);
+        assert.equal(shared.get('b'), 2);
+        assert.equal(shared.size, 3);
+    });
 });
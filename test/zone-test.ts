@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 import * as assert from "assert";
+import * as os from "os";
 import * as path from "path";
 import * as napa from "../lib/index";
 
@@ -35,6 +36,65 @@ describe('napajs/zone', function () {
             assert.equal(result.value.id, "new-zone");
         }).timeout(0);
 
+        it('@node: idle spin', async () => {
+            let zone = napa.zone.create('napa-zone-idle-spin', { workers: 2, idleSpinMicroseconds: 50 });
+            for (let i = 0; i < 100; ++i) {
+                let result = await zone.execute((n: number) => n + 1, [i]);
+                assert.strictEqual(result.value, i + 1);
+            }
+        });
+
+        it('@node: workers in helper processes', async () => {
+            let zone = napa.zone.create('napa-zone-processes', { workers: 1, processes: 2 });
+            await zone.broadcast('var processZoneState = 1;');
+
+            let pids: { [pid: number]: boolean } = {};
+            for (let i = 0; i < 20; ++i) {
+                let result = await zone.execute((n: number) => [n + (<any>global).processZoneState, process.pid], [i]);
+                assert.strictEqual(result.value[0], i + 1);
+                pids[result.value[1]] = true;
+            }
+            assert(!(process.pid in pids));
+        });
+
+        it('@node: helper processes restart after an oversized broadcast', async () => {
+            let zone = napa.zone.create('napa-zone-processes-oversized', { workers: 1, processes: 1 });
+            await zone.broadcast('var processZoneState = 1;');
+
+            // Larger than a channel takes, so it's rejected and not replayed on restart.
+            await shouldFail(() => zone.broadcast(`var processZoneLarge = "${'x'.repeat(5 * 1024 * 1024)}";`));
+
+            await shouldFail(() => zone.execute(() => { process.exit(1); }));
+
+            // The helper is restarted within a second, replaying the broadcasts that succeeded.
+            let result: napa.zone.Result = null;
+            for (let i = 0; i < 50 && result == null; ++i) {
+                await new Promise((resolve) => setTimeout(resolve, 100));
+                result = await zone.execute(() => [(<any>global).processZoneState, typeof (<any>global).processZoneLarge])
+                    .catch(() => null);
+            }
+            assert.deepEqual(result.value, [1, 'undefined']);
+        }).timeout(10000);
+
+        it('@node: remote zone', async () => {
+            let address = path.join(os.tmpdir(), `napa-zone-remote-${process.pid}.sock`);
+            let served = napa.zone.create('napa-zone-served', { workers: 2 });
+            served.listen(address);
+
+            let zone = napa.zone.create('napa-zone-remote', { remote: address, connections: 2 });
+            await zone.broadcast('var remoteZoneState = 1;');
+
+            let results = await Promise.all([0, 1, 2, 3, 4, 5, 6, 7].map((i: number) => {
+                return zone.execute((n: number) => n + (<any>global).remoteZoneState, [i]);
+            }));
+            results.forEach((result: napa.zone.Result, i: number) => {
+                assert.strictEqual(result.value, i + 1);
+            });
+
+            assert(napa.zone.unlisten(address));
+            await shouldFail(() => zone.execute(() => 0));
+        });
+
         it('@node: zone id already exists', () => {
             assert.throws(() => { napa.zone.create('napa-zone1'); });
         });
@@ -171,6 +231,19 @@ describe('napajs/zone', function () {
             }, ['hello world']);
         });
 
+        it('@node: -> napa zone with large arguments', () => {
+            let ascii = 'a'.repeat(64 * 1024);
+            let unicode = '中文'.repeat(32 * 1024);
+            return napaZone1.broadcast((ascii: string, unicode: string, asciiLength: number, unicodeLength: number) => {
+                if (ascii.length !== asciiLength || ascii[asciiLength - 1] !== 'a') {
+                    throw new Error('Unexpected ascii argument');
+                }
+                if (unicode.length !== unicodeLength || unicode.substr(0, 2) !== '中文') {
+                    throw new Error('Unexpected unicode argument');
+                }
+            }, [ascii, unicode, ascii.length, unicode.length]);
+        });
+
         it('@napa: -> napa zone with anonymous function', () => {
             return napaZone1.execute('./napa-zone/test', "broadcastTestFunction", ['napa-zone2']);
         });
@@ -587,6 +660,157 @@ describe('napajs/zone', function () {
                 });
         });
 
+        it('@node: -> napa zone with hedging', async () => {
+            let zone = napa.zone.create('napa-zone-hedge', { workers: 2 });
+            let store = napa.store.getOrCreate('napa-zone-hedge');
+
+            // The first run stalls until the test has its result, so only the duplicate started on the other worker can win.
+            try {
+                let result = await zone.execute(() => {
+                    let store = require('../lib/index').store.getOrCreate('napa-zone-hedge');
+                    if (store.get('started')) {
+                        return 'hedge';
+                    }
+                    store.set('started', true);
+                    let begin = Date.now();
+                    while (!store.get('done') && Date.now() - begin < 60000) {}
+                    return 'primary';
+                }, [], { hedgeAfterMs: 20 });
+
+                assert.strictEqual(result.value, 'hedge');
+            } finally {
+                store.set('done', true);
+            }
+        });
+
+        it('@node: -> napa zone with result cache', async () => {
+            let zone = napa.zone.create('napa-zone-cache', { workers: 2 });
+            let count = () => {
+                let store = require('../lib/index').store.getOrCreate('napa-zone-cache');
+                let runs = (store.get('runs') || 0) + 1;
+                store.set('runs', runs);
+                return runs;
+            };
+
+            let first = await zone.execute(count, [1], { cacheTtlMs: 60000 });
+            let second = await zone.execute(count, [1], { cacheTtlMs: 60000 });
+            let other = await zone.execute(count, [2], { cacheTtlMs: 60000 });
+            let uncached = await zone.execute(count, [1]);
+
+            assert.strictEqual(first.value, 1);
+            assert.strictEqual(second.value, 1);
+            assert.strictEqual(other.value, 2);
+            assert.strictEqual(uncached.value, 3);
+
+            let stats = zone.cacheStatistics;
+            assert.strictEqual(stats.hits, 1);
+            assert.strictEqual(stats.misses, 2);
+            assert(stats.bytes > 0);
+        });
+
+        it('@node: -> napa zone with single flight', async () => {
+            let zone = napa.zone.create('napa-zone-single-flight', { workers: 2 });
+            let count = (key: string) => {
+                let store = require('../lib/index').store.getOrCreate('napa-zone-single-flight');
+                let runs = (store.get(key) || 0) + 1;
+                store.set(key, runs);
+                let begin = Date.now();
+                while (Date.now() - begin < 200) {}
+                return runs;
+            };
+
+            let results = await Promise.all([
+                zone.execute(count, ['a'], { singleFlight: true }),
+                zone.execute(count, ['a'], { singleFlight: true }),
+                zone.execute(count, ['a'], { singleFlight: true }),
+                zone.execute(count, ['b'], { singleFlight: true })
+            ]);
+
+            assert.deepEqual(results.map((result: napa.zone.Result) => result.value), [1, 1, 1, 1]);
+        });
+
+        it('@node: -> napa zone with fork-join', async () => {
+            let zone = napa.zone.create('napa-zone-fork-join', { workers: 1 });
+
+            // The only worker is busy running the outer call, so the nested call runs inline on it.
+            let result = await zone.execute(() => {
+                let napa = require('../lib/index');
+                let counter = { count: 0 };
+                return napa.zone.current.execute((c: any) => {
+                    c.count++;
+                    return () => c.count;
+                }, [counter], { forkJoin: true }).then((result: any) => {
+                    return [counter.count, result.value()];
+                });
+            });
+
+            assert.deepEqual(result.value, [1, 1]);
+        });
+
+        it('@node: -> napa zone with fork-join and other options', async () => {
+            let zone = napa.zone.create('napa-zone-fork-join-options', { workers: 1 });
+
+            // A timeout keeps the nested call scheduled rather than inline, so it runs on a copy of its arguments
+            // once the outer call releases the only worker.
+            let result = await zone.execute(() => {
+                let napa = require('../lib/index');
+                let counter = { count: 0 };
+                napa.zone.current.execute((c: any) => {
+                    c.count++;
+                }, [counter], { forkJoin: true, timeout: 10000 });
+                return counter.count;
+            });
+
+            assert.equal(result.value, 0);
+        });
+
+        it('@node: -> napa zone with flows', async () => {
+            let zone = napa.zone.create('napa-zone-flows', { workers: 1 });
+            let sequence = (waitMs: number) => {
+                let store = require('../lib/index').store.getOrCreate('napa-zone-flows');
+                let begin = Date.now();
+                while (Date.now() - begin < waitMs) {}
+                let next = (store.get('next') || 0) + 1;
+                store.set('next', next);
+                return next;
+            };
+
+            // The first call keeps the only worker busy while flow 1 floods the queue ahead of flow 2.
+            let results = await Promise.all([
+                zone.execute(sequence, [200]),
+                zone.execute(sequence, [0], { flowId: 1 }),
+                zone.execute(sequence, [0], { flowId: 1 }),
+                zone.execute(sequence, [0], { flowId: 1 }),
+                zone.execute(sequence, [0], { flowId: 2 })
+            ]);
+
+            assert.deepEqual(results.map((result: any) => result.value), [1, 2, 4, 5, 3]);
+
+            let flows = zone.flowStatistics;
+            assert.deepEqual(flows.map((flow) => [flow.flowId, flow.queued, flow.dispatched]), [[0, 0, 1], [1, 0, 3], [2, 0, 1]]);
+            assert(flows[2].maxWaitUs > 0);
+        });
+
+        it('@node: -> napa zone with accounting', async () => {
+            let zone = napa.zone.create('napa-zone-accounting', { workers: 1 });
+            let spin = (ms: number) => {
+                let begin = Date.now();
+                while (Date.now() - begin < ms) {}
+                return 'done';
+            };
+
+            let measured = await zone.execute(spin, [20], { accounting: true });
+            let accounting = measured.accounting;
+            assert(accounting.executionUs >= 20000);
+            assert(accounting.cpuUs > 0);
+            assert(accounting.cpuUs <= accounting.executionUs * 2);
+            assert.strictEqual(accounting.argumentBytes, '20'.length);
+            assert.strictEqual(accounting.resultBytes, '"done"'.length);
+
+            let unmeasured = await zone.execute(spin, [0]);
+            assert.strictEqual(unmeasured.accounting, undefined);
+        });
+
         it.skip('@node: -> napa zone with timeout and succeed', () => {
             return napaZone1.execute('./napa-zone/test', 'waitMS', [1], {timeout: 100});
         });
@@ -619,4 +843,52 @@ describe('napajs/zone', function () {
         it.skip('@napa: -> napa zone with timed out in multiple hops', () => {
         });
     });
-});
\ No newline at end of file
+
+    describe('pipeline', () => {
+        it('@node: chain of zones', async () => {
+            let pipeline = napa.pipeline([
+                { zone: napaZone1, function: (x: number) => x + 1 },
+                { zone: napaZone2, function: (x: number) => x * 2 },
+                { zone: napaZone1, function: (x: number) => `result: ${x}` }
+            ]);
+            assert.strictEqual(pipeline.stageCount, 3);
+
+            let result = await pipeline.execute([1]);
+            assert.strictEqual(result.value, 'result: 4');
+        });
+
+        it('@node: stage by module and function name', async () => {
+            let pipeline = napa.pipeline([
+                { zone: napaZone1, function: (x: string) => x },
+                { zone: napaZone2, module: './napa-zone/test', function: 'bar' }
+            ]);
+
+            let result = await pipeline.execute(['hello world']);
+            assert.strictEqual(result.value, 'hello world');
+        });
+
+        it('@node: transportable values pass through stages', async () => {
+            let pipeline = napa.pipeline([
+                { zone: napaZone1, function: () => (<any>global).napa.memory.crtAllocator },
+                { zone: napaZone2, function: (allocator: napa.memory.Allocator) => allocator }
+            ]);
+
+            let result = await pipeline.execute();
+            assert.deepEqual(result.value.handle, napa.memory.crtAllocator.handle);
+        });
+
+        it('@node: failure of a stage rejects', () => {
+            let pipeline = napa.pipeline([
+                { zone: napaZone1, function: () => { throw new Error('stage failure'); } },
+                { zone: napaZone2, function: (x: any) => x }
+            ]);
+            return shouldFail(() => pipeline.execute());
+        });
+
+        it('@node: zone does not exist', () => {
+            assert.throws(() => {
+                napa.pipeline([{ zone: <Zone>{ id: 'zone-does-not-exist' }, function: 'foo' }]);
+            });
+        });
+    });
+});
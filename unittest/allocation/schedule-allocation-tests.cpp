@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// These tests replace the global operator new to count heap allocations,
+// so they are built into their own executable, napa-allocation-unittest.
+
+#include <catch/catch.hpp>
+
+#include <zone/object-pool.h>
+#include <zone/simple-thread-pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Number of global operator new calls. </summary>
+    std::atomic<size_t> _newCount(0);
+
+    /// <summary> Stand-ins of a call context and call task, sized alike. </summary>
+    struct FakeCallContext {
+        std::chrono::high_resolution_clock::time_point start;
+        std::atomic<bool> finished { false };
+        char state[120];
+    };
+
+    struct FakeCallTask {
+        explicit FakeCallTask(std::shared_ptr<FakeCallContext> context) : context(std::move(context)) {}
+        std::shared_ptr<FakeCallContext> context;
+    };
+
+}   // End of anonymous namespace.
+
+void* operator new(std::size_t size) {
+    _newCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto pointer = std::malloc(size != 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+// Covers the pooled call objects and the scheduler queues only. Argument copies, transport contexts and
+// callbacks created by NapaZone::Execute and ZoneWrap need a V8 isolate and are not part of this count.
+TEST_CASE("pooled call objects and thread pool queue don't allocate once warmed up", "[object-pool]") {
+    const size_t WARMUP = 1000;
+    const size_t REPEAT = 100000;
+
+    SimpleThreadPool pool(1);
+    std::atomic<size_t> completed(0);
+
+    auto execute = [&]() {
+        auto task = MakePooled<FakeCallTask>(MakePooled<FakeCallContext>());
+        pool.Execute([task, &completed]() {
+            task->context->finished = true;
+            completed++;
+        });
+    };
+
+    for (size_t i = 0; i < WARMUP; ++i) {
+        execute();
+    }
+    while (completed != WARMUP) {
+        std::this_thread::yield();
+    }
+
+    auto newCount = _newCount.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < REPEAT; ++i) {
+        execute();
+
+        // Keep the queue short, like a caller awaiting results.
+        while (completed + 64 < WARMUP + i) {
+            std::this_thread::yield();
+        }
+    }
+    while (completed != WARMUP + REPEAT) {
+        std::this_thread::yield();
+    }
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    auto allocationsPerCall = static_cast<double>(_newCount.load() - newCount) / REPEAT;
+    std::cout << "Allocations per call: " << allocationsPerCall
+        << ", time per call: " << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / REPEAT << "ns"
+        << std::endl;
+    REQUIRE(allocationsPerCall < 0.1);
+}
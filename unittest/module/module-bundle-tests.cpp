@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <module/loader/module-bundle.h>
+#include <module/loader/module-resolver.h>
+#include <platform/filesystem.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+
+    const std::string BUNDLE_PATH = (filesystem::CurrentDirectory() / "module-bundle-test.bundle").String();
+
+    void WriteTestBundle() {
+        ModuleBundleWriter writer;
+        writer.AddModule(ModuleInfo{ModuleType::JAVASCRIPT, "/app/node_modules/a/index.js", "/app/node_modules/a/package.json"},
+                         "module.exports = 'a';");
+        writer.AddModule(ModuleInfo{ModuleType::JSON, "/app/config.json", std::string()}, "{ \"x\": 1 }", "cache");
+        REQUIRE(writer.AddResolution("a", "/app", "/app/node_modules/a/index.js"));
+        REQUIRE(writer.AddResolution("./config", "/app", "/app/config.json"));
+        REQUIRE(!writer.AddResolution("b", "/app", "/app/node_modules/b/index.js"));
+        writer.Write(BUNDLE_PATH);
+    }
+
+}   // End of anonymous namespace.
+
+TEST_CASE("module bundle resolves and reads modules.", "[module-bundle]") {
+    WriteTestBundle();
+
+    auto bundle = ModuleBundle::Open(BUNDLE_PATH);
+    REQUIRE(bundle->GetModuleCount() == 2);
+
+    SECTION("bundles are shared in process") {
+        REQUIRE(ModuleBundle::Open(BUNDLE_PATH) == bundle);
+    }
+
+    SECTION("resolve recorded calls") {
+        ModuleInfo info;
+        REQUIRE(bundle->Resolve("a", "/app", info));
+        REQUIRE(info.type == ModuleType::JAVASCRIPT);
+        REQUIRE(info.fullPath == "/app/node_modules/a/index.js");
+        REQUIRE(info.packageJsonPath == "/app/node_modules/a/package.json");
+
+        REQUIRE(bundle->Resolve("./config", "/app", info));
+        REQUIRE(info.type == ModuleType::JSON);
+
+        REQUIRE(!bundle->Resolve("a", "/other", info));
+        REQUIRE(!bundle->Resolve("b", "/app", info));
+    }
+
+    SECTION("read sources from mapping") {
+        auto module = bundle->Find("/app/node_modules/a/index.js");
+        REQUIRE(module != nullptr);
+        REQUIRE(std::string(module->source, module->sourceLength) == "module.exports = 'a';");
+        REQUIRE(module->isAsciiSource);
+        REQUIRE(module->codeCacheLength == 0);
+
+        module = bundle->Find("/app/config.json");
+        REQUIRE(module != nullptr);
+        REQUIRE(std::string(reinterpret_cast<const char*>(module->codeCache), module->codeCacheLength) == "cache");
+
+        REQUIRE(bundle->Find("/app/missing.js") == nullptr);
+    }
+
+    SECTION("module resolver uses bundle first") {
+        ModuleResolver resolver;
+        resolver.SetBundle(bundle);
+
+        auto info = resolver.Resolve("a", "/app");
+        REQUIRE(info.fullPath == "/app/node_modules/a/index.js");
+    }
+
+    bundle.reset();
+    std::remove(BUNDLE_PATH.c_str());
+}
+
+TEST_CASE("module bundle writer resolves require calls.", "[module-bundle]") {
+    auto modulePath = (filesystem::CurrentDirectory() / "module-bundle-require.js").String();
+    { std::ofstream(modulePath) << "module.exports = 'required';"; }
+    auto fromPath = filesystem::CurrentDirectory().String();
+    auto path = (filesystem::CurrentDirectory() / "module-bundle-require.bundle").String();
+
+    ModuleResolver resolver;
+    ModuleBundleWriter writer;
+    REQUIRE(writer.AddRequire(resolver, "./module-bundle-require", fromPath));
+    REQUIRE(writer.AddRequire(resolver, "./module-bundle-require.js", fromPath));
+    REQUIRE(!writer.AddRequire(resolver, "./module-bundle-missing", fromPath));
+    writer.Write(path);
+
+    {
+        auto bundle = ModuleBundle::Open(path);
+        REQUIRE(bundle->GetModuleCount() == 1);
+
+        ModuleInfo info;
+        REQUIRE(bundle->Resolve("./module-bundle-require", fromPath.c_str(), info));
+        REQUIRE(info.type == ModuleType::JAVASCRIPT);
+        REQUIRE(info.fullPath == modulePath);
+        REQUIRE(bundle->Resolve("./module-bundle-require.js", fromPath.c_str(), info));
+
+        auto module = bundle->Find(modulePath);
+        REQUIRE(module != nullptr);
+        REQUIRE(std::string(module->source, module->sourceLength) == "module.exports = 'required';");
+    }
+
+    std::remove(path.c_str());
+    std::remove(modulePath.c_str());
+}
+
+TEST_CASE("module bundle rejects malformed files.", "[module-bundle]") {
+    auto path = (filesystem::CurrentDirectory() / "module-bundle-bad.bundle").String();
+
+    SECTION("not a bundle") {
+        { std::ofstream(path) << "module.exports = 1;"; }
+        REQUIRE_THROWS(ModuleBundle::Open(path));
+    }
+
+    SECTION("truncated bundle") {
+        WriteTestBundle();
+        std::string content;
+        {
+            std::ifstream ifs(BUNDLE_PATH, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        }
+        { std::ofstream(path, std::ios::binary) << content.substr(0, content.size() - 4); }
+        std::remove(BUNDLE_PATH.c_str());
+
+        REQUIRE_THROWS(ModuleBundle::Open(path));
+    }
+
+    SECTION("missing file") {
+        REQUIRE_THROWS(ModuleBundle::Open(path + ".missing"));
+    }
+
+    std::remove(path.c_str());
+}
@@ -4,31 +4,100 @@
 #include <catch/catch.hpp>
 
 #include <module/loader/module-resolver-cache.h>
+#include <platform/filesystem.h>
+
+#include <cstdio>
+#include <fstream>
 
 using namespace napa;
 using namespace napa::module;
 
-namespace {
-    ModuleResolverCache& GetModuleResolverCache() {
-        static ModuleResolverCache cache;
-        return cache;
-    }
-}
-
 TEST_CASE("module resolver cache works correctly.", "[module-resolver-cache]") {
 
     SECTION("cache not hit") {
         ModuleResolverCache cache;
-        auto result = cache.Lookup("a", "/home/napajs/test/");
-        REQUIRE(result.type == ModuleType::NONE);
+        ModuleInfo result;
+        REQUIRE(!cache.Lookup("a", "/home/napajs/test/", result));
     }
 
     SECTION("cache hit") {
         ModuleResolverCache cache;
         cache.Insert("a", "/home/napajs/test/", ModuleInfo{ModuleType::JAVASCRIPT, "/home/napajs/test/a.js", std::string()});
         
-        auto result = cache.Lookup("a", "/home/napajs/test/");
+        ModuleInfo result;
+        REQUIRE(cache.Lookup("a", "/home/napajs/test/", result));
         REQUIRE(result.type == ModuleType::JAVASCRIPT);
         REQUIRE(result.fullPath == "/home/napajs/test/a.js");
     }
+
+    SECTION("negative cache hit") {
+        ModuleResolverCache cache;
+        cache.Insert("b", "/home/napajs/test/", ModuleInfo{ModuleType::NONE, std::string(), std::string()});
+
+        ModuleInfo result;
+        REQUIRE(cache.Lookup("b", "/home/napajs/test/", result));
+        REQUIRE(result.type == ModuleType::NONE);
+    }
+
+    SECTION("invalidate drops module entries") {
+        ModuleResolverCache cache;
+        cache.Insert("a", "/home/napajs/test/", ModuleInfo{ModuleType::JAVASCRIPT, "/home/napajs/test/a.js", std::string()});
+        cache.Invalidate(filesystem::Path("/home/napajs/test/a.js"));
+
+        ModuleInfo result;
+        REQUIRE(!cache.Lookup("a", "/home/napajs/test/", result));
+    }
+
+    SECTION("insert is skipped if invalidated since the generation") {
+        ModuleResolverCache cache;
+        auto generation = cache.GetGeneration();
+        cache.Invalidate(filesystem::Path("/home/napajs/test/a.js"));
+        cache.Insert("a", "/home/napajs/test/", ModuleInfo{ModuleType::JAVASCRIPT, "/home/napajs/test/a.js", std::string()}, generation);
+
+        ModuleInfo result;
+        REQUIRE(!cache.Lookup("a", "/home/napajs/test/", result));
+
+        cache.Insert("a", "/home/napajs/test/", ModuleInfo{ModuleType::JAVASCRIPT, "/home/napajs/test/a.js", std::string()}, cache.GetGeneration());
+        REQUIRE(cache.Lookup("a", "/home/napajs/test/", result));
+    }
+}
+
+TEST_CASE("module resolver cache memoizes stat results.", "[module-resolver-cache]") {
+    ModuleResolverCache cache;
+
+    auto directory = filesystem::CurrentDirectory() / "module-resolver-cache-test-dir";
+    auto file = directory / "a.js";
+    REQUIRE(!filesystem::Exists(directory));
+
+    REQUIRE(!cache.IsDirectory(directory));
+    REQUIRE(!cache.IsRegularFile(file));
+
+    REQUIRE(filesystem::MakeDirectory(directory));
+    { std::ofstream(file.String()) << "module.exports = 1;"; }
+
+    SECTION("stat results are kept until invalidated") {
+        REQUIRE(!cache.IsDirectory(directory));
+        REQUIRE(!cache.IsRegularFile(file));
+    }
+
+    SECTION("invalidating a path drops it and its parent directories") {
+        cache.Invalidate(file);
+        REQUIRE(cache.IsDirectory(directory));
+        REQUIRE(cache.IsRegularFile(file));
+    }
+
+    SECTION("invalidating a relative path drops the absolute path and its parent directories") {
+        cache.Invalidate(filesystem::Path("module-resolver-cache-test-dir/a.js"));
+        REQUIRE(cache.IsDirectory(directory));
+        REQUIRE(cache.IsRegularFile(file));
+    }
+
+    SECTION("invalidating all") {
+        cache.Invalidate();
+        REQUIRE(cache.IsDirectory(directory));
+        REQUIRE(cache.IsRegularFile(file));
+    }
+
+    std::remove(file.c_str());
+    std::remove(directory.c_str());
 }
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <platform/filesystem.h>
+#include <platform/local-socket.h>
+#include <platform/platform.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef SUPPORT_POSIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace napa;
+
+namespace {
+
+    std::string GetSocketPath(const char* name) {
+        return std::string("unittest-local-socket-") + name + "-"
+            + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count() % 1000000) + ".sock";
+    }
+
+}   // End of anonymous namespace.
+
+TEST_CASE("local socket listener doesn't take a path in use", "[local-socket]") {
+    auto path = GetSocketPath("in-use");
+
+    SECTION("a live server keeps its path") {
+        auto listener = platform::LocalSocketListener::Listen(path);
+        REQUIRE_THROWS(platform::LocalSocketListener::Listen(path));
+
+        // The first server is still reachable.
+        auto socket = platform::LocalSocket::Connect(path);
+        REQUIRE(listener->Accept(std::chrono::milliseconds(1000)) != nullptr);
+    }
+
+    SECTION("a regular file is not removed") {
+        std::ofstream(path) << "content";
+        REQUIRE_THROWS(platform::LocalSocketListener::Listen(path));
+        REQUIRE(filesystem::IsRegularFile(filesystem::Path(path)));
+        std::remove(path.c_str());
+    }
+}
+
+#ifdef SUPPORT_POSIX
+TEST_CASE("local socket listener replaces a stale socket file", "[local-socket]") {
+    auto path = GetSocketPath("stale");
+
+    // A socket bound then closed without removing its file, as a crashed server leaves it.
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    auto handle = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(::bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    ::close(handle);
+
+    auto listener = platform::LocalSocketListener::Listen(path);
+    auto socket = platform::LocalSocket::Connect(path);
+    REQUIRE(listener->Accept(std::chrono::milliseconds(1000)) != nullptr);
+}
+#endif
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <platform/process.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace napa;
+
+TEST_CASE("thread CPU time counts work of the calling thread only", "[process]") {
+    auto start = platform::GetThreadCpuTime();
+
+    // Sleeping takes no CPU time, spinning does.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto slept = platform::GetThreadCpuTime() - start;
+
+    auto spinStart = std::chrono::steady_clock::now();
+    volatile uint64_t spins = 0;
+    while (std::chrono::steady_clock::now() - spinStart < std::chrono::milliseconds(50)) {
+        spins++;
+    }
+    auto spun = platform::GetThreadCpuTime() - start - slept;
+
+    REQUIRE(slept < std::chrono::milliseconds(25));
+    REQUIRE(spun > std::chrono::milliseconds(10));
+}
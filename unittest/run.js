@@ -4,15 +4,20 @@
 var path = require('path');
 var childProcess = require('child_process');
 
+// Allocation tests replace the global operator new, so they are built into an executable of their own.
+var executables = ['napa-unittest', 'napa-allocation-unittest'];
+
 try {
-    childProcess.execFileSync(
-        path.join(__dirname, 'build/test/', process.platform === 'win32'? 'napa-unittest.exe': 'napa-unittest'),
-        [],
-        {
-            cwd: path.join(__dirname, 'build/test'),
-            stdio: 'inherit'
-        }
-    );
+    executables.forEach(function(executable) {
+        childProcess.execFileSync(
+            path.join(__dirname, 'build/test/', process.platform === 'win32'? executable + '.exe': executable),
+            [],
+            {
+                cwd: path.join(__dirname, 'build/test'),
+                stdio: 'inherit'
+            }
+        );
+    });
 }
 catch(err) {
     process.exit(1); // Error
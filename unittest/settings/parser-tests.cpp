@@ -69,3 +69,39 @@ TEST_CASE("Parsing with different value type fails", "[settings-parser]") {
 
     REQUIRE(settings::ParseFromString("--workers five", settings) == false);
 }
+
+TEST_CASE("Parsing idle spin of zone workers", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.idleSpinMicroseconds == 0u);
+
+    REQUIRE(settings::ParseFromString("--workers 4 --idleSpinMicroseconds 50", settings));
+    REQUIRE(settings.workers == 4u);
+    REQUIRE(settings.idleSpinMicroseconds == 50u);
+}
+
+TEST_CASE("Parsing helper processes of zone", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.processes == 0u);
+
+    REQUIRE(settings::ParseFromString("--workers 2 --processes 3", settings));
+    REQUIRE(settings.workers == 2u);
+    REQUIRE(settings.processes == 3u);
+}
+
+TEST_CASE("Parsing remote zone settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.remote.empty());
+    REQUIRE(settings.connections == 1u);
+
+    REQUIRE(settings::ParseFromString("--remote /tmp/napa-zone.sock --connections 4", settings));
+    REQUIRE(settings.remote == "/tmp/napa-zone.sock");
+    REQUIRE(settings.connections == 4u);
+}
+
+TEST_CASE("Parsing result cache size of zone", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.resultCacheBytes == 16u * 1024 * 1024);
+
+    REQUIRE(settings::ParseFromString("--resultCacheBytes 0", settings));
+    REQUIRE(settings.resultCacheBytes == 0u);
+}
@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <platform/shared-memory.h>
+#include <store/shared-store-segment.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::store;
+
+namespace {
+
+    std::string GetTestId(const char* name) {
+        return std::string("unittest-") + name + "-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+}   // End of anonymous namespace.
+
+TEST_CASE("shared store segment sets and gets across mappings.", "[shared-store-segment]") {
+    auto id = GetTestId("basic");
+    auto segment = SharedStoreSegment::Create(id, 16, 4096, 0);
+    REQUIRE(segment != nullptr);
+    REQUIRE(SharedStoreSegment::Create(id, 16, 4096, 0) == nullptr);
+
+    auto version = segment->Set("a", Payload(u"1"), 0);
+    REQUIRE(version != 0);
+    segment->Set("unicode", Payload(u"\"中文\""), 0);
+
+    // A second mapping reads the same bytes.
+    auto other = SharedStoreSegment::Open(id);
+    REQUIRE(other != nullptr);
+    REQUIRE(other->GetMaxEntries() == 16);
+
+    Payload payload;
+    REQUIRE(other->Get("a", &payload) == version);
+    REQUIRE(payload.IsOneByte());
+    REQUIRE(payload.GetOneByte() == "1");
+    REQUIRE(other->Get("unicode", &payload) != 0);
+    REQUIRE(!payload.IsOneByte());
+    REQUIRE(payload.GetTwoByte() == u"\"中文\"");
+    REQUIRE(other->Get("not-exist", &payload) == 0);
+    REQUIRE(other->Size() == 2);
+
+    SECTION("update changes version") {
+        auto newVersion = other->Set("a", Payload(u"2"), 0);
+        REQUIRE(newVersion != version);
+        REQUIRE(segment->Get("a", &payload) == newVersion);
+        REQUIRE(payload == Payload(u"2"));
+        REQUIRE(segment->Size() == 2);
+    }
+
+    SECTION("compare and set") {
+        uint64_t stale = version + 1;
+        REQUIRE(segment->Set("a", Payload(u"3"), 0, &stale) == 0);
+        REQUIRE(segment->Set("a", Payload(u"3"), 0, &version) != 0);
+
+        uint64_t absent = 0;
+        REQUIRE(segment->Set("a", Payload(u"4"), 0, &absent) == 0);
+        REQUIRE(segment->Set("b", Payload(u"4"), 0, &absent) != 0);
+        REQUIRE(segment->Size() == 3);
+    }
+
+    SECTION("delete and set again") {
+        REQUIRE(segment->Delete("a"));
+        REQUIRE(!segment->Delete("a"));
+        REQUIRE(other->GetVersion("a") == 0);
+        REQUIRE(other->Size() == 1);
+
+        auto newVersion = segment->Set("a", Payload(u"5"), 0);
+        REQUIRE(newVersion > version);
+        REQUIRE(other->Size() == 2);
+    }
+
+    SECTION("statistics") {
+        auto statistics = other->GetStatistics();
+        REQUIRE(statistics.hits == 2);
+        REQUIRE(statistics.misses == 1);
+        REQUIRE(statistics.bytes > 0);
+    }
+
+    SECTION("unlinked segment can't be opened") {
+        segment->Unlink();
+        REQUIRE(SharedStoreSegment::Open(id) == nullptr);
+        REQUIRE(other->Get("a", &payload) == version);
+    }
+
+    segment->Unlink();
+}
+
+TEST_CASE("shared store segment expires keys.", "[shared-store-segment]") {
+    auto id = GetTestId("ttl");
+    auto segment = SharedStoreSegment::Create(id, 16, 4096, 0);
+    REQUIRE(segment != nullptr);
+
+    segment->Set("a", Payload(u"1"), 20);
+    segment->Set("b", Payload(u"2"), 0);
+    REQUIRE(segment->GetVersion("a") != 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(segment->GetVersion("a") == 0);
+    REQUIRE(segment->Size() == 1);
+    REQUIRE(segment->GetStatistics().expirations == 1);
+
+    segment->Unlink();
+}
+
+TEST_CASE("shared store segment rejects writes when full.", "[shared-store-segment]") {
+    auto id = GetTestId("full");
+    auto segment = SharedStoreSegment::Create(id, 2, 256, 0);
+    REQUIRE(segment != nullptr);
+
+    segment->Set("a", Payload(u"1"), 0);
+    segment->Set("b", Payload(u"2"), 0);
+    REQUIRE_THROWS(segment->Set("c", Payload(u"3"), 0));
+    REQUIRE(segment->Size() == 2);
+
+    REQUIRE_THROWS(segment->Set("a", Payload(std::u16string(256, u'x')), 0));
+
+    // A record that doesn't fit takes up no space.
+    auto bytes = segment->GetStatistics().bytes;
+    REQUIRE(bytes <= segment->GetMaxBytes());
+    REQUIRE(segment->Set("a", Payload(u"4"), 0) != 0);
+    REQUIRE(segment->GetStatistics().bytes > bytes);
+
+    REQUIRE_THROWS(SharedStoreSegment::Create("invalid/id", 2, 256, 0));
+    segment->Unlink();
+}
+
+TEST_CASE("shared store segment replaces a segment its creator left uninitialized.", "[shared-store-segment]") {
+    auto id = GetTestId("stale");
+
+    // As left behind by a creator that crashed before initializing the segment.
+    auto stale = platform::SharedMemory::Create("napa-store-" + id, 4096);
+    REQUIRE(stale != nullptr);
+
+    auto segment = SharedStoreSegment::Create(id, 16, 4096, 0);
+    REQUIRE(segment != nullptr);
+    REQUIRE(segment->Set("a", Payload(u"1"), 0) != 0);
+
+    // A segment of a running creator is not replaced.
+    REQUIRE(SharedStoreSegment::Create(id, 16, 4096, 0) == nullptr);
+    segment->Unlink();
+}
+
+TEST_CASE("shared store segment handles concurrent writers.", "[shared-store-segment]") {
+    auto id = GetTestId("concurrent");
+    auto segment = SharedStoreSegment::Create(id, 1024, 1024 * 1024, 0);
+    REQUIRE(segment != nullptr);
+
+    const int threadCount = 4;
+    const int keyCount = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&segment]() {
+            for (int i = 0; i < keyCount; ++i) {
+                segment->Set(std::to_string(i), Payload(u"1"), 0);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(segment->Size() == keyCount);
+    size_t visited = 0;
+    segment->ForEach([&visited](const std::string&, const Payload& payload, uint32_t ttl, uint64_t) {
+        REQUIRE(payload == Payload(u"1"));
+        REQUIRE(ttl == 0);
+        ++visited;
+    });
+    REQUIRE(visited == keyCount);
+
+    segment->Unlink();
+}
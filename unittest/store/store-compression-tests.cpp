@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <store/store.h>
+#include <store/store-compression.h>
+
+#include <string>
+
+using namespace napa::store;
+
+namespace {
+    std::string MakeJson(size_t items) {
+        std::string json = "[";
+        for (size_t i = 0; i < items; ++i) {
+            json += "{\"id\":" + std::to_string(i) + ",\"name\":\"item\",\"tags\":[\"a\",\"b\"]},";
+        }
+        json.back() = ']';
+        return json;
+    }
+}
+
+TEST_CASE("compression round trips bytes", "[store-compression]") {
+    for (auto input : { std::string(), std::string("a"), std::string("abcd"), std::string(1000, 'x'), MakeJson(500) }) {
+        auto compressed = compression::Compress(input.data(), input.size());
+
+        std::string output(input.size(), '\0');
+        REQUIRE(compression::Decompress(compressed, &output[0], output.size()));
+        REQUIRE(output == input);
+    }
+}
+
+TEST_CASE("compression shrinks repetitive bytes", "[store-compression]") {
+    auto input = MakeJson(500);
+    auto compressed = compression::Compress(input.data(), input.size());
+
+    REQUIRE(compressed.size() < input.size() / 4);
+}
+
+TEST_CASE("decompression rejects malformed bytes", "[store-compression]") {
+    auto input = MakeJson(10);
+    auto compressed = compression::Compress(input.data(), input.size());
+    std::string output(input.size(), '\0');
+
+    REQUIRE(!compression::Decompress(compressed, &output[0], output.size() - 1));
+    REQUIRE(!compression::Decompress(compressed.substr(0, compressed.size() / 2), &output[0], output.size()));
+    REQUIRE(!compression::Decompress(std::string("\x0f\x00\x00", 3), &output[0], output.size()));
+}
+
+TEST_CASE("compression round trips payloads", "[store-compression]") {
+    auto json = MakeJson(100);
+
+    SECTION("Latin-1") {
+        auto payload = Payload::FromLatin1(json);
+        compression::CompressedPayload compressed;
+        REQUIRE(compression::Compress(payload, compressed));
+        REQUIRE(compressed.rawBytes == json.size());
+        REQUIRE(compression::Decompress(compressed) == payload);
+    }
+
+    SECTION("UTF-16") {
+        Payload payload(std::u16string(json.begin(), json.end()) + u"\"中文\"");
+        compression::CompressedPayload compressed;
+        REQUIRE(compression::Compress(payload, compressed));
+        REQUIRE(compression::Decompress(compressed) == payload);
+    }
+
+    SECTION("incompressible") {
+        compression::CompressedPayload compressed;
+        REQUIRE(!compression::Compress(Payload::FromLatin1("abcdefgh"), compressed));
+    }
+}
+
+TEST_CASE("store keeps large values compressed", "[store-compression]") {
+    StoreOptions options;
+    options.compressThreshold = 1024;
+    auto store = CreateStore("store-compression-tests", options);
+    REQUIRE(store != nullptr);
+
+    auto json = MakeJson(100);
+    store->Set("large", std::make_shared<Store::ValueType>(
+        Store::ValueType { Payload::FromLatin1(json), napa::transport::TransportContext() }));
+    store->Set("small", std::make_shared<Store::ValueType>(
+        Store::ValueType { Payload::FromLatin1("[1,2,3]"), napa::transport::TransportContext() }));
+
+    auto statistics = store->GetStatistics();
+    REQUIRE(statistics.rawBytes == json.size() + 7);
+    REQUIRE(statistics.compressedBytes > 0);
+    REQUIRE(statistics.bytes == statistics.compressedBytes + 7);
+    REQUIRE(statistics.bytes < statistics.rawBytes);
+
+    REQUIRE(store->Get("large")->payload == Payload::FromLatin1(json));
+    REQUIRE(store->Get("small")->payload == Payload::FromLatin1("[1,2,3]"));
+
+    store->Delete("large");
+    statistics = store->GetStatistics();
+    REQUIRE(statistics.rawBytes == 7);
+    REQUIRE(statistics.compressedBytes == 0);
+    REQUIRE(statistics.bytes == 7);
+}
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <store/store-payload.h>
+
+#include <string>
+
+using namespace napa::store;
+
+TEST_CASE("payload keeps Latin-1 chars in one byte", "[store-payload]") {
+    Payload payload(std::u16string(u"{\"a\":\"café\"}"));
+
+    REQUIRE(payload.IsOneByte());
+    REQUIRE(payload.GetOneByte() == "{\"a\":\"caf\xe9\"}");
+    REQUIRE(payload.Length() == 12);
+    REQUIRE(payload.GetByteSize() == 12);
+    REQUIRE(payload.ToUtf16() == u"{\"a\":\"café\"}");
+}
+
+TEST_CASE("payload keeps other chars in UTF-16", "[store-payload]") {
+    Payload payload(std::u16string(u"\"中文\""));
+
+    REQUIRE(!payload.IsOneByte());
+    REQUIRE(payload.GetTwoByte() == u"\"中文\"");
+    REQUIRE(payload.Length() == 4);
+    REQUIRE(payload.GetByteSize() == 8);
+    REQUIRE(payload.ToUtf16() == u"\"中文\"");
+}
+
+TEST_CASE("payload from Latin-1 equals the same payload from UTF-16", "[store-payload]") {
+    REQUIRE(Payload::FromLatin1("[1,2]") == Payload(std::u16string(u"[1,2]")));
+    REQUIRE(!(Payload::FromLatin1("[1,2]") == Payload(std::u16string(u"[1,3]"))));
+    REQUIRE(Payload().IsOneByte());
+    REQUIRE(Payload().Length() == 0);
+}
+
+TEST_CASE("payload parses numbers", "[store-payload]") {
+    double number = 0;
+    REQUIRE(payload::ParseNumber(Payload::FromLatin1("-1.5"), number));
+    REQUIRE(number == -1.5);
+    REQUIRE(payload::ParseNumber(Payload(payload::FormatNumber(42)), number));
+    REQUIRE(number == 42);
+
+    REQUIRE(!payload::ParseNumber(Payload::FromLatin1("\"1\""), number));
+    REQUIRE(!payload::ParseNumber(Payload::FromLatin1(""), number));
+    REQUIRE(!payload::ParseNumber(Payload(std::u16string(u"中")), number));
+}
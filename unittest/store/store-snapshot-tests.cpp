@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <platform/filesystem.h>
+#include <store/store-snapshot.h>
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+using namespace napa;
+using namespace napa::store;
+
+namespace {
+
+    const std::string SNAPSHOT_PATH = (filesystem::CurrentDirectory() / "store-snapshot-test.snapshot").String();
+
+    bool NoTemporaryFiles() {
+        auto prefix = filesystem::Path(SNAPSHOT_PATH).Filename().String() + ".";
+        for (filesystem::PathIterator it(filesystem::CurrentDirectory()); it.Next();) {
+            auto name = it->Filename().String();
+            if (name.compare(0, prefix.size(), prefix) == 0 && it->Extension().String() == ".tmp") {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}   // End of anonymous namespace.
+
+TEST_CASE("store snapshot round trips entries in order.", "[store-snapshot]") {
+    std::vector<SnapshotEntry> entries {
+        { "a", Payload(u"1"), 0 },
+        { "unicode", Payload(u"\"中文\""), 1000 },
+        { "latin1", Payload(u"\"caf\u00e9\""), 0 },
+        { "", Payload(), 0 }
+    };
+    snapshot::Write(SNAPSHOT_PATH, entries);
+    REQUIRE(NoTemporaryFiles());
+
+    auto loaded = snapshot::Read(SNAPSHOT_PATH);
+    REQUIRE(loaded.size() == entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        REQUIRE(loaded[i].key == entries[i].key);
+        REQUIRE(loaded[i].payload == entries[i].payload);
+        REQUIRE(loaded[i].payload.IsOneByte() == entries[i].payload.IsOneByte());
+        REQUIRE(loaded[i].ttl == entries[i].ttl);
+    }
+
+    SECTION("overwrite existing snapshot") {
+        snapshot::Write(SNAPSHOT_PATH, std::vector<SnapshotEntry>());
+        REQUIRE(snapshot::Read(SNAPSHOT_PATH).empty());
+    }
+}
+
+TEST_CASE("store snapshot survives concurrent writes to the same path.", "[store-snapshot]") {
+    const size_t THREADS = 8;
+    const size_t WRITES = 50;
+
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t, &failures]() {
+            std::vector<SnapshotEntry> entries { { "thread", Payload::FromLatin1(std::to_string(t)), 0 } };
+            for (size_t i = 0; i < WRITES; ++i) {
+                try {
+                    snapshot::Write(SNAPSHOT_PATH, entries);
+                } catch (const std::exception&) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(failures == 0);
+    REQUIRE(NoTemporaryFiles());
+
+    auto loaded = snapshot::Read(SNAPSHOT_PATH);
+    REQUIRE(loaded.size() == 1);
+    REQUIRE(loaded[0].key == "thread");
+}
+
+TEST_CASE("store snapshot rejects malformed files.", "[store-snapshot]") {
+    SECTION("not a snapshot") {
+        std::ofstream(SNAPSHOT_PATH, std::ios::binary | std::ios::trunc) << "NAPABNDL and more bytes";
+        REQUIRE_THROWS(snapshot::Read(SNAPSHOT_PATH));
+    }
+
+    SECTION("truncated") {
+        snapshot::Write(SNAPSHOT_PATH, std::vector<SnapshotEntry> { { "key", Payload(u"\"value\""), 0 } });
+        std::string content;
+        {
+            std::ifstream ifs(SNAPSHOT_PATH, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        }
+        std::ofstream(SNAPSHOT_PATH, std::ios::binary | std::ios::trunc) << content.substr(0, content.size() - 3);
+        REQUIRE_THROWS(snapshot::Read(SNAPSHOT_PATH));
+    }
+
+    SECTION("missing") {
+        REQUIRE_THROWS(snapshot::Read(SNAPSHOT_PATH + ".missing"));
+    }
+}
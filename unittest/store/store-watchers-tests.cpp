@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <store/store-watchers.h>
+
+#include <chrono>
+#include <future>
+#include <vector>
+
+using namespace napa::store;
+
+namespace {
+    using Notifications = std::vector<std::pair<std::string, uint64_t>>;
+
+    Store::WatchCallback Record(Notifications& notifications) {
+        return [&notifications](const std::string& key, uint64_t version) {
+            notifications.emplace_back(key, version);
+        };
+    }
+}   // End of anonymous namespace.
+
+TEST_CASE("store watchers match exact keys and prefixes.", "[store-watchers]") {
+    StoreWatchers watchers;
+    Notifications exact;
+    Notifications prefix;
+    watchers.Add("user.1", false, Record(exact));
+    watchers.Add("user.", true, Record(prefix));
+
+    watchers.Notify("user.1", 1);
+    watchers.Notify("user.10", 2);
+    watchers.Notify("group.1", 3);
+    watchers.Notify("user.1", 0);
+
+    REQUIRE((exact == Notifications { { "user.1", 1 }, { "user.1", 0 } }));
+    REQUIRE((prefix == Notifications { { "user.1", 1 }, { "user.10", 2 }, { "user.1", 0 } }));
+}
+
+TEST_CASE("store watchers stop notifying after removal.", "[store-watchers]") {
+    StoreWatchers watchers;
+    Notifications first;
+    Notifications second;
+    auto firstId = watchers.Add("", true, Record(first));
+    auto secondId = watchers.Add("a", false, Record(second));
+    REQUIRE(firstId != secondId);
+
+    watchers.Notify("a", 1);
+    watchers.Remove(firstId);
+    watchers.Notify("a", 2);
+    watchers.Remove(firstId);
+    watchers.Remove(secondId);
+    watchers.Notify("a", 3);
+
+    REQUIRE((first == Notifications { { "a", 1 } }));
+    REQUIRE((second == Notifications { { "a", 1 }, { "a", 2 } }));
+}
+
+TEST_CASE("store watch ids are unique across stores.", "[store-watchers]") {
+    StoreWatchers watchers1;
+    StoreWatchers watchers2;
+    auto id1 = watchers1.Add("a", false, [](const std::string&, uint64_t) {});
+    auto id2 = watchers2.Add("a", false, [](const std::string&, uint64_t) {});
+    REQUIRE(id1 != id2);
+
+    watchers2.Remove(id1);
+    Notifications notifications;
+    watchers2.Add("a", false, Record(notifications));
+    watchers1.Notify("a", 1);
+    REQUIRE(notifications.empty());
+}
+
+TEST_CASE("store notifies watchers after releasing its lock.", "[store-watchers]") {
+    auto store = CreateStore("store-watchers-test-unlocked");
+    REQUIRE(store != nullptr);
+
+    // Another thread can use the store while a watcher is notified. Futures are kept outside of the callback,
+    // so a lock still held fails the test instead of blocking it.
+    std::vector<std::future<bool>> calls;
+    std::vector<bool> usable;
+    store->Watch("a", false, [&store, &calls, &usable](const std::string& key, uint64_t) {
+        calls.push_back(std::async(std::launch::async, [&store, key]() { return store->Has(key.c_str()); }));
+        usable.push_back(calls.back().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    });
+
+    store->Set("a", std::make_shared<Store::ValueType>(Store::ValueType { Payload(u"1"), napa::transport::TransportContext() }));
+    store->Delete("a");
+
+    REQUIRE((usable == std::vector<bool> { true, true }));
+}
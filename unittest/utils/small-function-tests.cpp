@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <utils/small-function.h>
+
+#include <array>
+#include <memory>
+
+using namespace napa;
+
+TEST_CASE("small function stores small callables inline", "[small-function]") {
+    using Function = utils::SmallFunction<int(int), 32>;
+
+    int base = 1;
+    auto addBase = [&base](int x) { return x + base; };
+    REQUIRE(Function::IsInline<decltype(addBase)>());
+
+    Function function(addBase);
+    REQUIRE(function);
+    REQUIRE(function(2) == 3);
+
+    SECTION("move transfers the callable") {
+        Function moved(std::move(function));
+        REQUIRE(!function);
+        REQUIRE(moved(3) == 4);
+
+        Function assigned;
+        assigned = std::move(moved);
+        REQUIRE(!moved);
+        REQUIRE(assigned(4) == 5);
+    }
+}
+
+TEST_CASE("small function stores large callables on heap", "[small-function]") {
+    using Function = utils::SmallFunction<int(), 16>;
+
+    std::array<int, 16> values {};
+    values[15] = 42;
+    auto last = [values]() { return values[15]; };
+    REQUIRE(!Function::IsInline<decltype(last)>());
+
+    Function function(last);
+    Function moved(std::move(function));
+    REQUIRE(moved() == 42);
+}
+
+TEST_CASE("small function destroys its callable", "[small-function]") {
+    auto resource = std::make_shared<int>(1);
+    {
+        utils::SmallFunction<void()> function([resource]() {});
+        REQUIRE(resource.use_count() == 2);
+
+        utils::SmallFunction<void()> moved(std::move(function));
+        REQUIRE(resource.use_count() == 2);
+
+        moved = nullptr;
+        REQUIRE(resource.use_count() == 1);
+    }
+    REQUIRE(resource.use_count() == 1);
+}
@@ -81,4 +81,18 @@ TEST_CASE("utils", "[string]") {
         REQUIRE(utils::string::CaseInsensitiveEquals("abc", "ABc"));
         REQUIRE(!utils::string::CaseInsensitiveEquals("abc", "AB"));
     }
-}
\ No newline at end of file
+
+    SECTION("IsAscii") {
+        REQUIRE(utils::string::IsAscii(""));
+        REQUIRE(utils::string::IsAscii("{\"a\":[1,2]}"));
+        REQUIRE(!utils::string::IsAscii(u8"\"caf\u00e9\""));
+    }
+
+    SECTION("Utf8ToUtf16") {
+        REQUIRE(utils::string::Utf8ToUtf16("abc") == u"abc");
+        REQUIRE(utils::string::Utf8ToUtf16(u8"\u00e9\u4e2d\U0001F600") == u"\u00e9\u4e2d\U0001F600");
+        REQUIRE(utils::string::Utf8ToUtf16("a\xFF" "b") == u"a\uFFFDb");
+        REQUIRE(utils::string::Utf8ToUtf16("a\xE4\xB8") == u"a\uFFFD");
+        REQUIRE(utils::string::Utf8ToUtf16("\xC0\xAF") == u"\uFFFD");
+    }
+}
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace zone {
+namespace test {
+
+    /// <summary> Makes a spec calling a function of "module". It refers to the argument strings, which must outlive it. </summary>
+    inline FunctionSpec GetSpec(const char* function, const std::vector<std::string>& arguments) {
+        FunctionSpec spec;
+        spec.module = NAPA_STRING_REF("module");
+        spec.function = NAPA_STRING_REF(function);
+        for (const auto& argument : arguments) {
+            spec.arguments.emplace_back(STD_STRING_TO_NAPA_STRING_REF(argument));
+        }
+        return spec;
+    }
+
+    /// <summary> Temporary argument strings would be freed before the spec is used. </summary>
+    FunctionSpec GetSpec(const char* function, std::vector<std::string>&& arguments) = delete;
+
+    /// <summary> Makes a spec calling a function of "module" with string literal arguments. </summary>
+    inline FunctionSpec GetSpec(const char* function, std::initializer_list<const char*> arguments) {
+        FunctionSpec spec;
+        spec.module = NAPA_STRING_REF("module");
+        spec.function = NAPA_STRING_REF(function);
+        for (auto argument : arguments) {
+            spec.arguments.emplace_back(NAPA_STRING_REF(argument));
+        }
+        return spec;
+    }
+
+    /// <summary> Makes a result with an empty transport context. </summary>
+    inline Result GetResult(const std::string& returnValue, ResultCode code = NAPA_RESULT_SUCCESS) {
+        Result result;
+        result.code = code;
+        result.returnValue = returnValue;
+        result.transportContext = std::make_unique<transport::TransportContext>();
+        return result;
+    }
+}
+}
+}
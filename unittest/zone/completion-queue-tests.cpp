@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "call-fixtures.h"
+
+#include <zone/completion-queue.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::test;
+
+namespace {
+
+    int tags[3];
+}
+
+TEST_CASE("completion queue polls completions in order", "[completion-queue]") {
+    auto queue = std::make_shared<CompletionQueue>();
+    std::unique_ptr<Completion> completions[2];
+
+    REQUIRE(queue->Pop(completions, 2, nullptr) == 0);
+
+    for (auto& tag : tags) {
+        CompletionQueue::MakeCallback(queue, &tag)(GetResult(std::to_string(&tag - tags)));
+    }
+
+    REQUIRE(queue->Pop(completions, 2, nullptr) == 2);
+    REQUIRE(completions[0]->tag == &tags[0]);
+    REQUIRE(completions[0]->result.returnValue == "0");
+    REQUIRE(completions[1]->tag == &tags[1]);
+    REQUIRE(completions[1]->result.returnValue == "1");
+
+    REQUIRE(queue->Pop(completions, 2, nullptr) == 1);
+    REQUIRE(completions[0]->tag == &tags[2]);
+    REQUIRE(completions[0]->result.returnValue == "2");
+}
+
+TEST_CASE("completion queue waits for completions", "[completion-queue]") {
+    auto queue = std::make_shared<CompletionQueue>();
+    std::unique_ptr<Completion> completion;
+
+    SECTION("wait times out without completions") {
+        uint32_t timeout = 20;
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(queue->Pop(&completion, 1, &timeout) == 0);
+        REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(timeout));
+    }
+
+    SECTION("wait returns once an execution completes") {
+        auto callback = CompletionQueue::MakeCallback(queue, &tags[0]);
+        std::thread execution([&callback]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            callback(GetResult("done"));
+        });
+
+        uint32_t infinite = 0;
+        REQUIRE(queue->Pop(&completion, 1, &infinite) == 1);
+        REQUIRE(completion->tag == &tags[0]);
+        REQUIRE(completion->result.returnValue == "done");
+        execution.join();
+    }
+}
+
+TEST_CASE("completion queue is held by executions in flight", "[completion-queue]") {
+    auto queue = std::make_shared<CompletionQueue>();
+    std::weak_ptr<CompletionQueue> weakQueue = queue;
+
+    auto callback = CompletionQueue::MakeCallback(queue, &tags[0]);
+    CompletionQueue::MakeCallback(queue, &tags[1])(GetResult("pending"));
+
+    // As released by the embedder, which discards the pending completion.
+    queue->Close();
+    queue.reset();
+    REQUIRE(!weakQueue.expired());
+
+    SECTION("completions of closed queue are discarded") {
+        callback(GetResult("discarded"));
+
+        std::unique_ptr<Completion> completion;
+        REQUIRE(weakQueue.lock()->Pop(&completion, 1, nullptr) == 0);
+    }
+
+    SECTION("queue is destroyed with the last execution") {
+        callback = nullptr;
+        REQUIRE(weakQueue.expired());
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <zone/deadline-queue.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+
+TEST_CASE("deadline queue runs callbacks in order of deadline", "[deadline-queue]") {
+    DeadlineQueue queue;
+    std::mutex access;
+    std::vector<int> order;
+    std::promise<void> done;
+
+    auto record = [&](int value) {
+        std::lock_guard<std::mutex> lock(access);
+        order.push_back(value);
+        if (order.size() == 3) {
+            done.set_value();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    queue.Add(std::chrono::milliseconds(60), [&]() { record(3); });
+    queue.Add(std::chrono::milliseconds(20), [&]() { record(1); });
+    queue.Add(std::chrono::milliseconds(40), [&]() { record(2); });
+
+    REQUIRE(done.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(60));
+    REQUIRE(order == std::vector<int>({ 1, 2, 3 }));
+    REQUIRE(queue.GetPendingCount() == 0);
+}
+
+TEST_CASE("deadline queue holds more callbacks than timer slots", "[deadline-queue]") {
+    // Timer indexes are 16 bits, so this many concurrent timers would wrap them.
+    const size_t COUNT = 70000;
+
+    DeadlineQueue queue;
+    std::atomic<size_t> ran(0);
+    for (size_t i = 0; i < COUNT; ++i) {
+        queue.Add(std::chrono::milliseconds(10), [&ran]() { ++ran; });
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (ran < COUNT && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(ran == COUNT);
+}
+
+TEST_CASE("deadline queue callbacks may add callbacks", "[deadline-queue]") {
+    DeadlineQueue queue;
+    std::promise<void> done;
+
+    queue.Add(std::chrono::milliseconds(1), [&]() {
+        queue.Add(std::chrono::milliseconds(1), [&]() { done.set_value(); });
+    });
+
+    REQUIRE(done.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+}
+
+TEST_CASE("deadline queue drops pending callbacks when destroyed", "[deadline-queue]") {
+    std::atomic<bool> ran(false);
+    {
+        DeadlineQueue queue;
+        queue.Add(std::chrono::seconds(60), [&ran]() { ran = true; });
+        REQUIRE(queue.GetPendingCount() == 1);
+    }
+    REQUIRE(!ran);
+}
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <zone/flow-queue.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> A task that only carries a name, to tell tasks apart when they are popped. </summary>
+    class NamedTask : public Task {
+    public:
+        explicit NamedTask(std::string name) : name(std::move(name)) {}
+
+        void Execute() override {}
+
+        std::string name;
+    };
+
+    void Push(FlowQueue& queue, const std::string& name, FlowId flow, uint32_t weight = 1) {
+        queue.Push(std::make_shared<NamedTask>(name), flow, weight);
+    }
+
+    std::string PopAll(FlowQueue& queue) {
+        std::string order;
+        while (auto task = queue.Pop()) {
+            order += std::static_pointer_cast<NamedTask>(task)->name;
+        }
+        return order;
+    }
+}
+
+TEST_CASE("flow queue is empty by default", "[flow-queue]") {
+    FlowQueue queue;
+
+    REQUIRE(queue.IsEmpty());
+    REQUIRE(queue.Pop() == nullptr);
+    REQUIRE(queue.GetStatistics().empty());
+}
+
+TEST_CASE("flow queue keeps a single flow in order", "[flow-queue]") {
+    FlowQueue queue;
+    Push(queue, "a", 0);
+    Push(queue, "b", 0);
+    Push(queue, "c", 0);
+
+    REQUIRE(!queue.IsEmpty());
+    REQUIRE(PopAll(queue) == "abc");
+    REQUIRE(queue.IsEmpty());
+}
+
+TEST_CASE("flow queue takes flows in turns", "[flow-queue]") {
+    FlowQueue queue;
+
+    // Flow 1 floods the queue before flow 2 queues anything.
+    Push(queue, "a", 1);
+    Push(queue, "b", 1);
+    Push(queue, "c", 1);
+    Push(queue, "d", 1);
+    Push(queue, "x", 2);
+    Push(queue, "y", 2);
+
+    REQUIRE(PopAll(queue) == "axbycd");
+}
+
+TEST_CASE("flow queue hands out tasks by weight", "[flow-queue]") {
+    FlowQueue queue;
+    Push(queue, "a", 1, 2);
+    Push(queue, "b", 1, 2);
+    Push(queue, "c", 1, 2);
+    Push(queue, "d", 1, 2);
+    Push(queue, "x", 2);
+    Push(queue, "y", 2);
+
+    REQUIRE(PopAll(queue) == "abxcdy");
+}
+
+TEST_CASE("flow queue takes weight 0 as 1", "[flow-queue]") {
+    FlowQueue queue;
+    Push(queue, "a", 1, 0);
+    Push(queue, "b", 1, 0);
+    Push(queue, "x", 2, 0);
+
+    REQUIRE(PopAll(queue) == "axb");
+    REQUIRE(queue.GetStatistics()[0].weight == 1u);
+}
+
+TEST_CASE("flow queue starts a drained flow on a fresh turn", "[flow-queue]") {
+    FlowQueue queue;
+    Push(queue, "a", 1, 2);
+    Push(queue, "x", 2);
+    REQUIRE(PopAll(queue) == "ax");
+
+    Push(queue, "y", 2);
+    Push(queue, "b", 1, 2);
+    Push(queue, "c", 1, 2);
+    Push(queue, "z", 2);
+    REQUIRE(PopAll(queue) == "ybcz");
+}
+
+TEST_CASE("flow queue counts tasks per flow", "[flow-queue]") {
+    FlowQueue queue;
+    Push(queue, "x", 2, 3);
+    Push(queue, "a", 1);
+    Push(queue, "b", 1);
+    queue.Pop();
+
+    auto statistics = queue.GetStatistics();
+    REQUIRE(statistics.size() == 2);
+
+    REQUIRE(statistics[0].flow_id == 1u);
+    REQUIRE(statistics[0].weight == 1u);
+    REQUIRE(statistics[0].queued == 2u);
+    REQUIRE(statistics[0].dispatched == 0u);
+
+    REQUIRE(statistics[1].flow_id == 2u);
+    REQUIRE(statistics[1].weight == 3u);
+    REQUIRE(statistics[1].queued == 0u);
+    REQUIRE(statistics[1].dispatched == 1u);
+    REQUIRE(statistics[1].max_wait_us <= statistics[1].total_wait_us);
+
+    PopAll(queue);
+    statistics = queue.GetStatistics();
+    REQUIRE(statistics[0].queued == 0u);
+    REQUIRE(statistics[0].dispatched == 2u);
+}
+
+TEST_CASE("flow queue drops least recently drained flows beyond its limit", "[flow-queue]") {
+    FlowQueue queue(2);
+    Push(queue, "a", 1);
+    Push(queue, "b", 2);
+    Push(queue, "c", 3);
+    Push(queue, "d", 4);
+    REQUIRE(queue.GetStatistics().size() == 4);
+
+    // Flow 1 and 2 drain first, then flow 1 queues again, so flow 2 is the least recently drained one.
+    REQUIRE(queue.Pop() != nullptr);
+    REQUIRE(queue.Pop() != nullptr);
+    Push(queue, "e", 1);
+    REQUIRE(PopAll(queue) == "cde");
+
+    auto statistics = queue.GetStatistics();
+    REQUIRE(statistics.size() == 2);
+    REQUIRE(statistics[0].flow_id == 1u);
+    REQUIRE(statistics[0].dispatched == 2u);
+    REQUIRE(statistics[1].flow_id == 4u);
+}
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <zone/idle-strategy.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace napa::zone;
+using namespace std::chrono;
+
+TEST_CASE("idle strategy with no spin parks right away", "[idle-strategy]") {
+    IdleStrategy strategy(microseconds(0));
+
+    REQUIRE(!strategy.IsEnabled());
+    REQUIRE(strategy.GetSpinBudget().count() == 0);
+
+    auto ready = strategy.Spin([]() { return true; });
+    auto notReady = strategy.Spin([]() { return false; });
+    REQUIRE(ready);
+    REQUIRE(!notReady);
+}
+
+TEST_CASE("idle strategy spins while tasks arrive in quick succession", "[idle-strategy]") {
+    IdleStrategy strategy(microseconds(100));
+    REQUIRE(strategy.IsEnabled());
+    REQUIRE(strategy.GetSpinBudget() == microseconds(100));
+
+    for (int i = 0; i < 32; ++i) {
+        strategy.RecordIdle(microseconds(10));
+    }
+    REQUIRE(strategy.GetSpinBudget() > microseconds(10));
+    REQUIRE(strategy.GetSpinBudget() < microseconds(30));
+}
+
+TEST_CASE("idle strategy stops spinning when tasks arrive sparsely", "[idle-strategy]") {
+    IdleStrategy strategy(microseconds(100));
+
+    for (int i = 0; i < 32; ++i) {
+        strategy.RecordIdle(milliseconds(10));
+    }
+    REQUIRE(strategy.GetSpinBudget().count() == 0);
+
+    // Spinning resumes once arrivals speed up again.
+    for (int i = 0; i < 32; ++i) {
+        strategy.RecordIdle(microseconds(10));
+    }
+    REQUIRE(strategy.GetSpinBudget().count() > 0);
+}
+
+TEST_CASE("idle strategy spin gives up after the budget", "[idle-strategy]") {
+    IdleStrategy strategy(microseconds(200));
+
+    auto start = steady_clock::now();
+    auto spun = strategy.Spin([]() { return false; });
+    REQUIRE(!spun);
+    REQUIRE(steady_clock::now() - start >= microseconds(200));
+}
+
+TEST_CASE("idle strategy spin returns once ready", "[idle-strategy]") {
+    IdleStrategy strategy(seconds(10));
+
+    std::atomic<bool> ready(false);
+    std::thread producer([&ready]() {
+        std::this_thread::sleep_for(milliseconds(1));
+        ready = true;
+    });
+
+    auto start = steady_clock::now();
+    auto spun = strategy.Spin([&ready]() { return ready.load(); });
+    REQUIRE(spun);
+    REQUIRE(steady_clock::now() - start < seconds(5));
+
+    producer.join();
+}
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <zone/object-pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+
+namespace {
+
+    struct PooledObject {
+        explicit PooledObject(int value) : value(value) {}
+        int value;
+        char padding[40];
+    };
+
+}   // End of anonymous namespace.
+
+TEST_CASE("pooled objects reuse freed blocks", "[object-pool]") {
+    auto& statistics = GetBlockPoolStatistics();
+
+    // Warm up the pool of this size.
+    MakePooled<PooledObject>(0).reset();
+
+    size_t heapAllocations = statistics.heapAllocations;
+    for (int i = 0; i < 100; ++i) {
+        auto object = MakePooled<PooledObject>(i);
+        REQUIRE(object->value == i);
+    }
+
+    REQUIRE(statistics.heapAllocations == heapAllocations);
+}
+
+TEST_CASE("pooled objects can be freed on another thread", "[object-pool]") {
+    std::vector<std::shared_ptr<PooledObject>> objects;
+    for (int i = 0; i < 10; ++i) {
+        objects.push_back(MakePooled<PooledObject>(i));
+    }
+
+    std::thread([&objects]() {
+        objects.clear();
+    }).join();
+
+    auto object = MakePooled<PooledObject>(1);
+    REQUIRE(object->value == 1);
+}
+
+TEST_CASE("pooled objects move between threads in batches", "[object-pool]") {
+    auto& statistics = GetBlockPoolStatistics();
+
+    // Objects created on one thread and released on another, like call contexts released on a worker.
+    std::vector<std::shared_ptr<PooledObject>> objects;
+    auto produce = [&objects]() {
+        for (int i = 0; i < 1000; ++i) {
+            objects.push_back(MakePooled<PooledObject>(i));
+        }
+    };
+
+    produce();
+    std::thread([&objects]() { objects.clear(); }).join();
+
+    size_t heapAllocations = statistics.heapAllocations;
+    produce();
+    std::thread([&objects]() { objects.clear(); }).join();
+
+    REQUIRE(statistics.heapAllocations == heapAllocations);
+}
+
+TEST_CASE("pooled allocations with many threads", "[.benchmark][object-pool]") {
+    const size_t REPEAT = 1000000;
+
+    for (size_t threadCount : { 1u, 2u, 4u, 8u, 16u }) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([REPEAT]() {
+                // Keep a few objects alive, like calls in flight on a worker.
+                std::vector<std::shared_ptr<PooledObject>> inFlight(8);
+                for (size_t i = 0; i < REPEAT; ++i) {
+                    inFlight[i % inFlight.size()] = MakePooled<PooledObject>(static_cast<int>(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "Threads: " << threadCount
+            << ", time per allocation: "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / (REPEAT * threadCount) << "ns"
+            << std::endl;
+    }
+}
@@ -0,0 +1,262 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <platform/child-process.h>
+#include <platform/platform.h>
+#include <platform/process.h>
+#include <zone/process-channel.h>
+#include <zone/process-message.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace std::chrono;
+
+namespace {
+
+    std::string GetTestName(const char* name) {
+        return std::string("unittest-channel-") + name + "-" + std::to_string(steady_clock::now().time_since_epoch().count());
+    }
+
+}   // End of anonymous namespace.
+
+TEST_CASE("process channel passes messages both ways", "[process-channel]") {
+    auto name = GetTestName("basic");
+    auto zoneEnd = ProcessChannel::Create(name, 4096, "zone1", "--workers 2");
+    auto helperEnd = ProcessChannel::Open(name);
+    REQUIRE(helperEnd != nullptr);
+    zoneEnd->Unlink();
+
+    REQUIRE(helperEnd->GetZoneId() == "zone1");
+    REQUIRE(helperEnd->GetSettings() == "--workers 2");
+    REQUIRE(helperEnd->GetCreatorProcessId() == platform::Getpid());
+    REQUIRE(!zoneEnd->IsReady());
+    helperEnd->SetReady();
+    REQUIRE(zoneEnd->IsReady());
+
+    std::string message;
+    REQUIRE(!helperEnd->Receive(message, milliseconds(1)));
+
+    REQUIRE(zoneEnd->Send("request", milliseconds(0)));
+    REQUIRE(helperEnd->Receive(message, milliseconds(0)));
+    REQUIRE(message == "request");
+
+    REQUIRE(helperEnd->Send("response", milliseconds(0)));
+    REQUIRE(!helperEnd->Receive(message, milliseconds(0)));
+    REQUIRE(zoneEnd->Receive(message, milliseconds(0)));
+    REQUIRE(message == "response");
+
+    REQUIRE(zoneEnd->Send("", milliseconds(0)));
+    REQUIRE(helperEnd->Receive(message, milliseconds(0)));
+    REQUIRE(message.empty());
+}
+
+TEST_CASE("process channel wraps around its ring", "[process-channel]") {
+    auto name = GetTestName("wrap");
+    auto zoneEnd = ProcessChannel::Create(name, 4096, "zone1", "");
+    auto helperEnd = ProcessChannel::Open(name);
+    zoneEnd->Unlink();
+
+    REQUIRE(zoneEnd->GetMaxMessageSize() < 4096 / 2);
+
+    // Sizes not dividing the capacity make records straddle the end of the ring.
+    for (size_t i = 0; i < 100; ++i) {
+        std::string sent(zoneEnd->GetMaxMessageSize() - i * 7, static_cast<char>('a' + i % 26));
+        REQUIRE(zoneEnd->Send(sent, milliseconds(0)));
+
+        std::string received;
+        REQUIRE(helperEnd->Receive(received, milliseconds(0)));
+        REQUIRE(received == sent);
+    }
+}
+
+TEST_CASE("process channel send times out when the ring is full", "[process-channel]") {
+    auto name = GetTestName("full");
+    auto zoneEnd = ProcessChannel::Create(name, 4096, "zone1", "");
+    auto helperEnd = ProcessChannel::Open(name);
+    zoneEnd->Unlink();
+
+    std::string message(1000, 'x');
+    size_t sent = 0;
+    while (zoneEnd->Send(message, milliseconds(0))) {
+        ++sent;
+    }
+    REQUIRE(sent == 4);
+
+    // Reading a message makes room for one more.
+    std::string received;
+    REQUIRE(helperEnd->Receive(received, milliseconds(0)));
+    REQUIRE(zoneEnd->Send(message, milliseconds(0)));
+}
+
+TEST_CASE("process channel wakes up a waiting reader and writer", "[process-channel]") {
+    auto name = GetTestName("wake");
+    auto zoneEnd = ProcessChannel::Create(name, 4096, "zone1", "");
+    auto helperEnd = ProcessChannel::Open(name);
+    zoneEnd->Unlink();
+
+    // Catch assertions are not thread-safe, so other threads count their failures.
+    const size_t count = 10000;
+    std::atomic<size_t> failures(0);
+    std::thread helper([&helperEnd, &failures]() {
+        std::string message;
+        for (size_t i = 0; i < count; ++i) {
+            if (!helperEnd->Receive(message, seconds(10)) || !helperEnd->Send(message, seconds(10))) {
+                failures++;
+                return;
+            }
+        }
+    });
+
+    // Pipelined requests fill the ring and wait for the helper to drain it.
+    std::thread sender([&zoneEnd, &failures]() {
+        for (size_t i = 0; i < count; ++i) {
+            if (!zoneEnd->Send(std::to_string(i), seconds(10))) {
+                failures++;
+                return;
+            }
+        }
+    });
+
+    std::string message;
+    for (size_t i = 0; i < count; ++i) {
+        REQUIRE(zoneEnd->Receive(message, seconds(10)));
+        REQUIRE(message == std::to_string(i));
+    }
+
+    sender.join();
+    helper.join();
+    REQUIRE(failures == 0);
+}
+
+TEST_CASE("process channel close wakes up the other end", "[process-channel]") {
+    auto name = GetTestName("close");
+    auto zoneEnd = ProcessChannel::Create(name, 4096, "zone1", "");
+    auto helperEnd = ProcessChannel::Open(name);
+    zoneEnd->Unlink();
+
+    std::thread closer([&zoneEnd]() {
+        std::this_thread::sleep_for(milliseconds(10));
+        zoneEnd->Close();
+    });
+
+    auto start = steady_clock::now();
+    std::string message;
+    REQUIRE(!helperEnd->Receive(message, seconds(10)));
+    REQUIRE(steady_clock::now() - start < seconds(5));
+    REQUIRE(helperEnd->IsClosed());
+
+    closer.join();
+}
+
+TEST_CASE("process channel open fails on missing channel", "[process-channel]") {
+    REQUIRE(ProcessChannel::Open(GetTestName("missing")) == nullptr);
+}
+
+TEST_CASE("process request round trips", "[process-message]") {
+    ProcessRequest request;
+    request.type = ProcessRequest::Type::Broadcast;
+    request.callId = 42;
+    request.timeout = 100;
+    request.hedgeAfterMs = 20;
+    request.cacheTtlMs = 1000;
+    request.singleFlight = 1;
+    request.flowId = 7;
+    request.flowWeight = 3;
+    request.accounting = 1;
+    request.module = "module";
+    request.function = "function";
+    request.arguments = { "1", "", "\"two\"" };
+    request.functionDefinition = std::string("{\0}\0", 4);
+
+    ProcessRequest parsed;
+    REQUIRE(ProcessRequest::Parse(request.Serialize(), parsed));
+    REQUIRE(parsed.type == ProcessRequest::Type::Broadcast);
+    REQUIRE(parsed.callId == 42);
+    REQUIRE(parsed.timeout == 100);
+    REQUIRE(parsed.hedgeAfterMs == 20);
+    REQUIRE(parsed.cacheTtlMs == 1000);
+    REQUIRE(parsed.singleFlight == 1u);
+    REQUIRE(parsed.flowId == 7u);
+    REQUIRE(parsed.flowWeight == 3u);
+    REQUIRE(parsed.accounting == 1u);
+    REQUIRE(parsed.module == "module");
+    REQUIRE(parsed.function == "function");
+    REQUIRE(parsed.arguments == request.arguments);
+    REQUIRE(parsed.functionDefinition == request.functionDefinition);
+
+    auto truncated = request.Serialize();
+    truncated.pop_back();
+    REQUIRE(!ProcessRequest::Parse(truncated, parsed));
+    REQUIRE(!ProcessRequest::Parse(request.Serialize() + "x", parsed));
+}
+
+TEST_CASE("process response round trips", "[process-message]") {
+    ProcessResponse response;
+    response.callId = 7;
+    response.code = NAPA_RESULT_EXECUTE_FUNC_ERROR;
+    response.errorMessage = "error";
+    response.returnValue = "";
+
+    ProcessResponse parsed;
+    REQUIRE(ProcessResponse::Parse(response.Serialize(), parsed));
+    REQUIRE(parsed.callId == 7);
+    REQUIRE(parsed.code == NAPA_RESULT_EXECUTE_FUNC_ERROR);
+    REQUIRE(parsed.errorMessage == "error");
+    REQUIRE(parsed.returnValue.empty());
+    REQUIRE(parsed.accounting == nullptr);
+
+    REQUIRE(!ProcessResponse::Parse("", parsed));
+}
+
+TEST_CASE("process response round trips with accounting", "[process-message]") {
+    ProcessResponse response;
+    response.callId = 8;
+    response.returnValue = "1";
+    response.accounting = std::make_shared<const CallAccounting>(CallAccounting { 1, 2, 3, 4, 5, 6 });
+
+    ProcessResponse parsed;
+    REQUIRE(ProcessResponse::Parse(response.Serialize(), parsed));
+    REQUIRE(parsed.returnValue == "1");
+    REQUIRE(parsed.accounting != nullptr);
+    REQUIRE(parsed.accounting->queue_wait_us == 1u);
+    REQUIRE(parsed.accounting->execution_us == 2u);
+    REQUIRE(parsed.accounting->cpu_us == 3u);
+    REQUIRE(parsed.accounting->heap_bytes == 4u);
+    REQUIRE(parsed.accounting->argument_bytes == 5u);
+    REQUIRE(parsed.accounting->result_bytes == 6u);
+
+    auto truncated = response.Serialize();
+    truncated.pop_back();
+    REQUIRE(!ProcessResponse::Parse(truncated, parsed));
+}
+
+#ifdef SUPPORT_POSIX
+TEST_CASE("child process can be killed", "[child-process]") {
+    auto child = platform::ChildProcess::Spawn({ "sleep", "10" });
+    REQUIRE(child->IsRunning());
+    REQUIRE(platform::IsProcessRunning(child->GetId()));
+
+    child->Kill();
+    REQUIRE(!child->IsRunning());
+}
+
+TEST_CASE("child process exits", "[child-process]") {
+    auto child = platform::ChildProcess::Spawn({ "true" });
+
+    auto start = steady_clock::now();
+    while (child->IsRunning() && steady_clock::now() - start < seconds(5)) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    REQUIRE(!child->IsRunning());
+
+    REQUIRE_THROWS(platform::ChildProcess::Spawn({ "napa-command-does-not-exist" }));
+}
+#endif
@@ -0,0 +1,231 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "call-fixtures.h"
+
+#include <platform/local-socket.h>
+#include <zone/forwarded-call.h>
+#include <zone/framed-connection.h>
+#include <zone/remote-zone.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::test;
+using namespace std::chrono;
+
+namespace {
+
+    std::string GetSocketPath(const char* name) {
+        return std::string("unittest-remote-") + name + "-" + std::to_string(steady_clock::now().time_since_epoch().count() % 1000000) + ".sock";
+    }
+
+    /// <summary> A zone that returns the function name and arguments it was called with. </summary>
+    class EchoZone : public Zone {
+    public:
+        const std::string& GetId() const override {
+            return _id;
+        }
+
+        void Broadcast(const FunctionSpec& /*spec*/, BroadcastCallback callback) override {
+            broadcasts++;
+            callback(MakeResult(NAPA_RESULT_SUCCESS, ""));
+        }
+
+        void Execute(const FunctionSpec& spec, ExecuteCallback callback) override {
+            auto function = NAPA_STRING_REF_TO_STD_STRING(spec.function);
+            if (function == "fail") {
+                callback(MakeResult(NAPA_RESULT_EXECUTE_FUNC_ERROR, "failed"));
+                return;
+            }
+
+            auto result = MakeResult(NAPA_RESULT_SUCCESS, "");
+            result.returnValue = function + "(";
+            for (const auto& argument : spec.arguments) {
+                result.returnValue += NAPA_STRING_REF_TO_STD_STRING(argument) + ",";
+            }
+            result.returnValue += ")";
+            callback(std::move(result));
+        }
+
+        std::atomic<int> broadcasts { 0 };
+
+    private:
+        std::string _id = "echo";
+    };
+
+    settings::ZoneSettings GetSettings(const std::string& id, const std::string& remote, uint32_t connections) {
+        settings::ZoneSettings settings;
+        settings.id = id;
+        settings.remote = remote;
+        settings.connections = connections;
+        return settings;
+    }
+
+    /// <summary> Starts calls on a zone and waits for their results. </summary>
+    class Calls {
+    public:
+        void Execute(Zone& zone, const FunctionSpec& spec) {
+            auto promise = std::make_shared<std::promise<Result>>();
+            _results.emplace_back(promise->get_future());
+            zone.Execute(spec, [promise](Result result) {
+                promise->set_value(std::move(result));
+            });
+        }
+
+        void Broadcast(Zone& zone, const FunctionSpec& spec) {
+            auto promise = std::make_shared<std::promise<Result>>();
+            _results.emplace_back(promise->get_future());
+            zone.Broadcast(spec, [promise](Result result) {
+                promise->set_value(std::move(result));
+            });
+        }
+
+        /// <summary> Returns results in order of calls, or a TIMEOUT result for calls that don't complete. </summary>
+        std::vector<Result> Wait() {
+            std::vector<Result> results;
+            for (auto& future : _results) {
+                if (future.wait_for(seconds(10)) == std::future_status::ready) {
+                    results.emplace_back(future.get());
+                } else {
+                    results.emplace_back(MakeResult(NAPA_RESULT_TIMEOUT, "timed out"));
+                }
+            }
+            _results.clear();
+            return results;
+        }
+
+    private:
+        std::vector<std::future<Result>> _results;
+    };
+
+}   // End of anonymous namespace.
+
+TEST_CASE("framed connection passes messages in order", "[remote-zone]") {
+    auto path = GetSocketPath("framed");
+    auto listener = platform::LocalSocketListener::Listen(path);
+    auto clientSocket = platform::LocalSocket::Connect(path);
+    auto serverSocket = listener->Accept(seconds(1));
+    REQUIRE(serverSocket != nullptr);
+
+    // The server end echoes every message back.
+    FramedConnection* serverEnd = nullptr;
+    FramedConnection server(std::move(serverSocket), [&serverEnd](std::string message) {
+        serverEnd->Send(std::move(message));
+    }, []() {});
+    serverEnd = &server;
+    server.Start();
+
+    std::mutex access;
+    std::condition_variable received;
+    std::vector<std::string> messages;
+    bool closed = false;
+    FramedConnection client(std::move(clientSocket), [&](std::string message) {
+        std::lock_guard<std::mutex> lock(access);
+        messages.push_back(std::move(message));
+        received.notify_one();
+    }, [&]() {
+        std::lock_guard<std::mutex> lock(access);
+        closed = true;
+        received.notify_one();
+    });
+    client.Start();
+
+    std::vector<std::string> sent = { "", std::string(1024 * 1024, 'x') };
+    for (int i = 0; i < 1000; ++i) {
+        sent.push_back(std::to_string(i));
+    }
+    for (const auto& message : sent) {
+        REQUIRE(client.Send(message));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(access);
+        received.wait_for(lock, seconds(10), [&]() { return messages.size() == sent.size(); });
+        REQUIRE(messages == sent);
+    }
+
+    // Closing one end is reported on the other.
+    server.Close();
+    {
+        std::unique_lock<std::mutex> lock(access);
+        received.wait_for(lock, seconds(10), [&]() { return closed; });
+        REQUIRE(closed);
+    }
+    REQUIRE(client.IsClosed());
+    REQUIRE(!client.Send("dropped"));
+}
+
+TEST_CASE("remote zone forwards calls to a served zone", "[remote-zone]") {
+    auto path = GetSocketPath("forward");
+    auto echo = std::make_shared<EchoZone>();
+    RemoteZoneServer server(echo, path);
+
+    auto zone = RemoteZone::Create(GetSettings("remote-forward", path, 2));
+    REQUIRE(zone != nullptr);
+    REQUIRE(zone->GetId() == "remote-forward");
+    REQUIRE(RemoteZone::Get("remote-forward") == zone);
+    REQUIRE(RemoteZone::Create(GetSettings("remote-forward", path, 1)) == nullptr);
+
+    SECTION("calls in flight are matched to their responses") {
+        Calls calls;
+        for (int i = 0; i < 500; ++i) {
+            std::vector<std::string> arguments { std::to_string(i), "x" };
+            calls.Execute(*zone, GetSpec("f", arguments));
+        }
+        auto results = calls.Wait();
+        for (int i = 0; i < 500; ++i) {
+            REQUIRE(results[i].code == NAPA_RESULT_SUCCESS);
+            REQUIRE(results[i].returnValue == "f(" + std::to_string(i) + ",x,)");
+            REQUIRE(results[i].transportContext != nullptr);
+        }
+    }
+
+    SECTION("errors and broadcasts are forwarded") {
+        Calls calls;
+        calls.Execute(*zone, GetSpec("fail", {}));
+        calls.Broadcast(*zone, GetSpec("setup", {}));
+        auto results = calls.Wait();
+        REQUIRE(results[0].code == NAPA_RESULT_EXECUTE_FUNC_ERROR);
+        REQUIRE(results[0].errorMessage == "failed");
+        REQUIRE(results[1].code == NAPA_RESULT_SUCCESS);
+        REQUIRE(echo->broadcasts == 1);
+    }
+}
+
+TEST_CASE("remote zone fails calls without a server and reconnects", "[remote-zone]") {
+    auto path = GetSocketPath("reconnect");
+    auto echo = std::make_shared<EchoZone>();
+    REQUIRE(RemoteZone::Create(GetSettings("remote-unreachable", path, 1)) == nullptr);
+
+    auto server = std::make_unique<RemoteZoneServer>(echo, path);
+    auto zone = RemoteZone::Create(GetSettings("remote-reconnect", path, 1));
+    REQUIRE(zone != nullptr);
+
+    Calls calls;
+    calls.Execute(*zone, GetSpec("f", {}));
+    auto results = calls.Wait();
+    REQUIRE(results[0].code == NAPA_RESULT_SUCCESS);
+
+    // Calls fail once the server is gone, whether the close was seen yet or not.
+    server.reset();
+    calls.Execute(*zone, GetSpec("f", {}));
+    results = calls.Wait();
+    REQUIRE(results[0].code == NAPA_RESULT_INTERNAL_ERROR);
+
+    server = std::make_unique<RemoteZoneServer>(echo, path);
+    calls.Execute(*zone, GetSpec("f", { "again" }));
+    results = calls.Wait();
+    REQUIRE(results[0].code == NAPA_RESULT_SUCCESS);
+    REQUIRE(results[0].returnValue == "f(again,)");
+}
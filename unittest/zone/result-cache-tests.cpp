@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "call-fixtures.h"
+
+#include <zone/result-cache.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::test;
+
+namespace {
+
+    std::shared_ptr<const CallKey> GetKey(const FunctionSpec& spec) {
+        return std::make_shared<const CallKey>(spec);
+    }
+
+}   // End of anonymous namespace.
+
+TEST_CASE("result cache returns results of identical calls", "[result-cache]") {
+    ResultCache cache(1024);
+    REQUIRE(cache.IsEnabled());
+
+    std::vector<std::string> arguments = { "1", "2" };
+    auto spec = GetSpec("add", arguments);
+
+    Result result;
+    REQUIRE(!cache.Get(spec, result));
+    cache.Set(GetKey(spec), GetResult("3"), 60000);
+
+    // Arguments are matched by value, not by address.
+    std::vector<std::string> copied = arguments;
+    REQUIRE(cache.Get(GetSpec("add", copied), result));
+    REQUIRE(result.code == NAPA_RESULT_SUCCESS);
+    REQUIRE(result.returnValue == "3");
+    REQUIRE(result.transportContext != nullptr);
+
+    // Function, arguments and their boundaries are all part of the key.
+    REQUIRE(!cache.Get(GetSpec("sub", arguments), result));
+    REQUIRE(!cache.Get(GetSpec("add", { "12" }), result));
+    REQUIRE(!cache.Get(GetSpec("add", { "1", "2", "" }), result));
+    REQUIRE(!cache.Get(GetSpec("add", { "12", "" }), result));
+
+    auto statistics = cache.GetStatistics();
+    REQUIRE(statistics.hits == 1u);
+    REQUIRE(statistics.misses == 5u);
+    REQUIRE(statistics.bytes == std::strlen("module") + std::strlen("add") + 2 + 1);
+}
+
+TEST_CASE("result cache only keeps successful results", "[result-cache]") {
+    ResultCache cache(1024);
+    auto spec = GetSpec("f", {});
+    Result result;
+
+    cache.Set(GetKey(spec), GetResult("", NAPA_RESULT_EXECUTE_FUNC_ERROR), 60000);
+    REQUIRE(!cache.Get(spec, result));
+
+    cache.Set(GetKey(spec), GetResult("1"), 0);
+    REQUIRE(!cache.Get(spec, result));
+
+    REQUIRE(!ResultCache(0).IsEnabled());
+    REQUIRE(cache.GetStatistics().bytes == 0u);
+}
+
+TEST_CASE("result cache expires results after their time to live", "[result-cache]") {
+    ResultCache cache(1024);
+    auto spec = GetSpec("f", { "x" });
+    cache.Set(GetKey(spec), GetResult("1"), 20);
+
+    Result result;
+    REQUIRE(cache.Get(spec, result));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(!cache.Get(spec, result));
+
+    auto statistics = cache.GetStatistics();
+    REQUIRE(statistics.expirations == 1u);
+    REQUIRE(statistics.bytes == 0u);
+}
+
+TEST_CASE("result cache evicts least recently used results over its size", "[result-cache]") {
+    // Each entry takes 6 + 1 + 1 + 10 bytes, so 3 of them fit.
+    ResultCache cache(60);
+    std::string value(10, 'v');
+    for (const char* function : { "a", "b", "c" }) {
+        cache.Set(GetKey(GetSpec(function, { "x" })), GetResult(value), 60000);
+    }
+
+    Result result;
+    REQUIRE(cache.Get(GetSpec("a", { "x" }), result));
+
+    cache.Set(GetKey(GetSpec("d", { "x" })), GetResult(value), 60000);
+    REQUIRE(cache.Get(GetSpec("a", { "x" }), result));
+    REQUIRE(!cache.Get(GetSpec("b", { "x" }), result));
+    REQUIRE(cache.Get(GetSpec("c", { "x" }), result));
+    REQUIRE(cache.Get(GetSpec("d", { "x" }), result));
+
+    // A result larger than the cache is not kept, and evicts nothing.
+    cache.Set(GetKey(GetSpec("e", { "x" })), GetResult(std::string(100, 'v')), 60000);
+    REQUIRE(!cache.Get(GetSpec("e", { "x" }), result));
+    REQUIRE(cache.Get(GetSpec("a", { "x" }), result));
+
+    auto statistics = cache.GetStatistics();
+    REQUIRE(statistics.evictions == 1u);
+    REQUIRE(statistics.bytes == 54u);
+}
@@ -6,7 +6,11 @@
 
 #include <cstddef>
 #include <atomic>
+#include <chrono>
 #include <future>
+#include <mutex>
+#include <string>
+#include <thread>
 
 using namespace napa;
 using namespace napa::zone;
@@ -37,6 +41,9 @@ private:
 };
 
 
+// The test worker whose task is running on the current thread.
+static thread_local const void* currentTestWorker = nullptr;
+
 template <uint32_t I>
 class TestWorker {
 public:
@@ -44,10 +51,13 @@ public:
     TestWorker(WorkerId id,
                const ZoneSettings &settings,
                std::function<void(WorkerId)> setupCompleteCallback,
-               std::function<void(WorkerId)> idleCallback) : _id(id) {
+               std::function<void(WorkerId)> idleCallback,
+               std::function<void(WorkerId)> busyCallback) : _id(id) {
         
         numberOfWorkers++;
+        lastConstructed = this;
         _idleNotificationCallback = idleCallback;
+        _busyNotificationCallback = busyCallback;
         setupCompleteCallback(id);
     }
 
@@ -66,22 +76,63 @@ public:
         testTask->SetCurrentWorkerId(_id);
 
         _futures.emplace_back(std::async(std::launch::async, [this, task]() {
+            currentTestWorker = this;
             task->Execute();
             _idleNotificationCallback(_id);
         }));
     }
 
+    void ScheduleLocal(std::shared_ptr<Task> task, SchedulePhase /*phase*/=SchedulePhase::DefaultPhase) {
+        auto testTask = std::dynamic_pointer_cast<TestTask>(task);
+        testTask->SetCurrentWorkerId(_id);
+
+        numberOfLocalSchedules++;
+        task->Execute();
+    }
+
+    Worker::TimerId ScheduleLocalAfter(std::shared_ptr<Task> task, std::chrono::milliseconds delay) {
+        std::this_thread::sleep_for(delay);
+        ScheduleLocal(std::move(task));
+        return ++_timerSequence;
+    }
+
+    void CancelLocalTimer(Worker::TimerId /*timerId*/) {
+    }
+
+    // Simulates a worker that waits idle for a timer, then wakes up to run it.
+    void FireTimerWhileIdle(std::function<void()> timer) {
+        _busyNotificationCallback(_id);
+        timer();
+        _idleNotificationCallback(_id);
+    }
+
+    bool IsCurrentThread() const {
+        return currentTestWorker == this;
+    }
+
     static uint32_t numberOfWorkers;
 
+    static TestWorker* lastConstructed;
+
+    static std::atomic<uint32_t> numberOfLocalSchedules;
+
 private:
     WorkerId _id;
     std::vector<std::shared_future<void>> _futures;
     std::function<void(WorkerId)> _idleNotificationCallback;
+    std::function<void(WorkerId)> _busyNotificationCallback;
+    Worker::TimerId _timerSequence = 0;
 };
 
 template <uint32_t I>
 uint32_t TestWorker<I>::numberOfWorkers = 0;
 
+template <uint32_t I>
+TestWorker<I>* TestWorker<I>::lastConstructed = nullptr;
+
+template <uint32_t I>
+std::atomic<uint32_t> TestWorker<I>::numberOfLocalSchedules(0);
+
 
 TEST_CASE("scheduler creates correct number of worker", "[scheduler]") {
     ZoneSettings settings;
@@ -165,3 +216,150 @@ TEST_CASE("scheduler distributes and schedules all tasks", "[scheduler]") {
         REQUIRE(flag);
     }
 }
+
+TEST_CASE("scheduler schedules on the calling worker locally", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<4>>>(settings, [](WorkerId) {});
+
+    auto schedulerPtr = scheduler.get();
+    auto innerTask = std::make_shared<TestTask>();
+    auto outerTask = std::make_shared<TestTask>([schedulerPtr, &innerTask]() {
+        schedulerPtr->ScheduleOnWorker(1, innerTask, SchedulePhase::ImmediatePhase);
+    });
+
+    scheduler->ScheduleOnWorker(1, outerTask);
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(outerTask->numberOfExecutions == 1);
+    REQUIRE(innerTask->numberOfExecutions == 1);
+    REQUIRE(innerTask->lastExecutedWorkerId == 1);
+    REQUIRE(TestWorker<4>::numberOfLocalSchedules == 1);
+}
+
+TEST_CASE("scheduler schedules delayed tasks on the calling worker", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<5>>>(settings, [](WorkerId) {});
+
+    auto schedulerPtr = scheduler.get();
+    auto innerTask = std::make_shared<TestTask>();
+    auto start = std::chrono::steady_clock::now();
+    auto outerTask = std::make_shared<TestTask>([schedulerPtr, &innerTask]() {
+        schedulerPtr->ScheduleOnWorkerAfter(0, innerTask, std::chrono::milliseconds(50));
+    });
+
+    scheduler->ScheduleOnWorker(0, outerTask);
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(50));
+    REQUIRE(innerTask->numberOfExecutions == 1);
+    REQUIRE(innerTask->lastExecutedWorkerId == 0);
+    REQUIRE(TestWorker<5>::numberOfLocalSchedules == 1);
+}
+
+TEST_CASE("scheduler counts idle workers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<6>>>(settings, [](WorkerId) {});
+
+    // The count is updated asynchronously by the synchronizer.
+    auto waitForCount = [&scheduler](uint32_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (scheduler->GetIdleWorkerCount() != count && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        return scheduler->GetIdleWorkerCount() == count;
+    };
+    REQUIRE(waitForCount(2));
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    auto blockingTask = [released]() {
+        return std::make_shared<TestTask>([released]() { released.wait(); });
+    };
+
+    scheduler->Schedule(blockingTask());
+    REQUIRE(waitForCount(1));
+
+    scheduler->Schedule(blockingTask());
+    REQUIRE(waitForCount(0));
+
+    release.set_value();
+    REQUIRE(waitForCount(2));
+}
+
+TEST_CASE("scheduler takes a worker running its timers off the idle list", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<8>>>(settings, [](WorkerId) {});
+
+    auto waitForCount = [&scheduler](uint32_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (scheduler->GetIdleWorkerCount() != count && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        return scheduler->GetIdleWorkerCount() == count;
+    };
+    REQUIRE(waitForCount(1));
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    auto worker = TestWorker<8>::lastConstructed;
+    auto timer = std::async(std::launch::async, [worker, released]() {
+        worker->FireTimerWhileIdle([released]() { released.wait(); });
+    });
+    REQUIRE(waitForCount(0));
+
+    release.set_value();
+    timer.get();
+    REQUIRE(waitForCount(1));
+}
+
+TEST_CASE("scheduler takes turns across flows while workers are busy", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<7>>>(settings, [](WorkerId) {});
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    scheduler->Schedule(std::make_shared<TestTask>([released]() { released.wait(); }));
+
+    std::mutex orderLock;
+    std::string order;
+    auto namedTask = [&orderLock, &order](char name) {
+        return std::make_shared<TestTask>([&orderLock, &order, name]() {
+            std::lock_guard<std::mutex> lock(orderLock);
+            order += name;
+        });
+    };
+
+    scheduler->Schedule(namedTask('a'), 1);
+    scheduler->Schedule(namedTask('b'), 1);
+    scheduler->Schedule(namedTask('c'), 1);
+    scheduler->Schedule(namedTask('x'), 2);
+
+    // Tasks reach their flows asynchronously through the synchronizer.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto queued = [&scheduler]() {
+        uint64_t count = 0;
+        for (const auto& flow : scheduler->GetFlowStatistics()) {
+            count += flow.queued;
+        }
+        return count;
+    };
+    while (queued() != 4 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    REQUIRE(queued() == 4);
+
+    release.set_value();
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(order == "axbc");
+}
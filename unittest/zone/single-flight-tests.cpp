@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "call-fixtures.h"
+
+#include <zone/single-flight.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::test;
+
+namespace {
+
+    /// <summary> Records results passed to the callbacks it makes. </summary>
+    class Receiver {
+    public:
+        ExecuteCallback MakeCallback() {
+            return [this](Result result) {
+                REQUIRE(result.transportContext != nullptr);
+                results.emplace_back(std::move(result));
+            };
+        }
+
+        std::vector<Result> results;
+    };
+
+}   // End of anonymous namespace.
+
+TEST_CASE("single flight completes identical calls with one execution", "[single-flight]") {
+    auto flights = std::make_shared<SingleFlight>();
+    Receiver receiver;
+
+    std::vector<std::string> arguments = { "1", "2" };
+    auto first = receiver.MakeCallback();
+    REQUIRE(!flights->Join(GetSpec("add", arguments), first));
+
+    // Identical calls join, while calls to other functions or with other arguments start their own flights.
+    std::vector<std::string> copied = arguments;
+    for (int i = 0; i < 3; ++i) {
+        auto callback = receiver.MakeCallback();
+        REQUIRE(flights->Join(GetSpec("add", copied), callback));
+    }
+    auto other = receiver.MakeCallback();
+    REQUIRE(!flights->Join(GetSpec("add", { "1" }), other));
+    auto another = receiver.MakeCallback();
+    REQUIRE(!flights->Join(GetSpec("sub", arguments), another));
+    REQUIRE(flights->GetJoinCount() == 3u);
+    REQUIRE(receiver.results.empty());
+
+    first(GetResult("3", NAPA_RESULT_EXECUTE_FUNC_ERROR));
+    REQUIRE(receiver.results.size() == 4u);
+    for (const auto& result : receiver.results) {
+        REQUIRE(result.code == NAPA_RESULT_EXECUTE_FUNC_ERROR);
+        REQUIRE(result.returnValue == "3");
+    }
+
+    // The flight ended, so the next identical call executes again.
+    auto next = receiver.MakeCallback();
+    REQUIRE(!flights->Join(GetSpec("add", arguments), next));
+    next(GetResult("3"));
+    REQUIRE(receiver.results.size() == 5u);
+
+    other(GetResult("1"));
+    another(GetResult("-1"));
+    REQUIRE(receiver.results.size() == 7u);
+    REQUIRE(receiver.results[5].returnValue == "1");
+    REQUIRE(receiver.results[6].returnValue == "-1");
+}